@@ -0,0 +1,191 @@
+// Бенчмарк ядер диспетчеризації FakeCpu: Switch (еталон) проти Threaded (таблиця обробників),
+// кожне — через віртуальну IMemoryBus (FakeCpu) і з конкретною MemoryBus (MemoryBusFakeCpu, як у Simulator),
+// а на x86-64 Linux — ще й DbtCpu (трансляція в машинний код, пакетний run()).
+//
+// Проганяє кожну програму examples/*.elsim-bin фіксовану кількість кроків у кожному режимі
+// та друкує кроки/сек. Якщо програма завершилась (HALT) або вийшла за межі пам'яті —
+// CPU скидається на entry point і виконання продовжується, щоб навантаження було сталим.
+//
+// Використання: fakecpu_dispatch_benchmark [steps]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/Logger.hpp"
+#include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/MemoryBusAdapter.hpp"
+#include "elsim/core/ProgramLoader.hpp"
+
+#ifndef PROJECT_SOURCE_DIR
+#define PROJECT_SOURCE_DIR "."
+#endif
+
+using elsim::core::DbtCpu;
+using elsim::core::FakeCpu;
+using elsim::core::Logger;
+using elsim::core::LogLevel;
+using elsim::core::MemoryBus;
+using elsim::core::MemoryBusAdapter;
+using elsim::core::MemoryBusFakeCpu;
+using elsim::core::ProgramLoader;
+
+namespace {
+
+constexpr std::size_t kMemorySize = 64 * 1024;
+constexpr std::uint64_t kDefaultSteps = 5'000'000;
+
+const char* modeName(FakeCpu::DispatchMode mode) {
+    return mode == FakeCpu::DispatchMode::Threaded ? "threaded" : "switch";
+}
+
+// Повертає кількість кроків за секунду. Cpu — FakeCpu або MemoryBusFakeCpu.
+template <typename Cpu>
+double runBenchmark(const std::string& path, FakeCpu::DispatchMode mode, std::uint64_t steps) {
+    MemoryBus memory(kMemorySize);
+    ProgramLoader loader;
+    std::uint32_t entry = 0;
+    loader.loadBinary(path, memory, entry);
+
+    Cpu cpu;
+    cpu.setMemoryBus(std::make_shared<MemoryBusAdapter>(&memory));
+    cpu.setDispatchMode(mode);
+    cpu.reset();
+    cpu.setPc(entry);
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (std::uint64_t i = 0; i < steps; ++i) {
+        try {
+            cpu.step();
+        } catch (const std::exception&) {
+            // Вихід за межі RAM — починаємо програму спочатку.
+            cpu.reset();
+            cpu.setPc(entry);
+            continue;
+        }
+
+        if (cpu.isHalted()) {
+            cpu.reset();
+            cpu.setPc(entry);
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    return seconds > 0.0 ? static_cast<double>(steps) / seconds : 0.0;
+}
+
+// Те саме для DbtCpu: інструкції виконуються пакетами через run(), без step() на кожну.
+double runDbtBenchmark(const std::string& path, std::uint64_t steps) {
+    MemoryBus memory(kMemorySize);
+    ProgramLoader loader;
+    std::uint32_t entry = 0;
+    loader.loadBinary(path, memory, entry);
+
+    DbtCpu cpu;
+    cpu.setMemoryBus(std::make_shared<MemoryBusAdapter>(&memory));
+    cpu.reset();
+    cpu.setPc(entry);
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::uint64_t done = 0;
+    while (done < steps) {
+        try {
+            done += cpu.run(steps - done).retired;
+        } catch (const std::exception&) {
+            cpu.reset();
+            cpu.setPc(entry);
+            ++done;  // як і вище: крок, що впав, теж рахується
+            continue;
+        }
+
+        if (cpu.isHalted()) {
+            cpu.reset();
+            cpu.setPc(entry);
+            ++done;
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    return seconds > 0.0 ? static_cast<double>(steps) / seconds : 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // Логування вимкнене: інакше бенчмарк міряє форматування рядків, а не диспетчеризацію.
+    Logger::instance().set_level(LogLevel::Off);
+
+    std::uint64_t steps = kDefaultSteps;
+    if (argc > 1) {
+        steps = std::strtoull(argv[1], nullptr, 10);
+        if (steps == 0) {
+            std::cerr << "Usage: " << argv[0] << " [steps]\n";
+            return 1;
+        }
+    }
+
+    const std::filesystem::path examplesDir = std::filesystem::path(PROJECT_SOURCE_DIR) / "examples";
+
+    std::vector<std::filesystem::path> programs;
+    for (const auto& entry : std::filesystem::directory_iterator(examplesDir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".elsim-bin") {
+            programs.push_back(entry.path());
+        }
+    }
+    std::sort(programs.begin(), programs.end());
+
+    if (programs.empty()) {
+        std::cerr << "No *.elsim-bin programs found in " << examplesDir << "\n";
+        return 1;
+    }
+
+    std::cout << "FakeCpu dispatch benchmark, " << steps << " steps per run\n";
+
+    try {
+        for (const auto& program : programs) {
+            std::cout << program.filename().string() << "\n";
+
+            double baseline = 0.0;
+            const auto report = [&](const std::string& name, double rate) {
+                std::cout << "  " << std::setw(12) << std::left << name << std::right << std::fixed
+                          << std::setprecision(2) << std::setw(10) << rate / 1e6 << " Msteps/s";
+                if (baseline > 0.0) {
+                    std::cout << "  (x" << std::setprecision(2) << rate / baseline << ")";
+                }
+                std::cout << "\n";
+            };
+
+            for (auto mode : {FakeCpu::DispatchMode::Switch, FakeCpu::DispatchMode::Threaded}) {
+                const double rate = runBenchmark<FakeCpu>(program.string(), mode, steps);
+                if (mode == FakeCpu::DispatchMode::Switch) {
+                    baseline = rate;
+                }
+                report(modeName(mode), rate);
+                report(std::string(modeName(mode)) + "+bus",
+                       runBenchmark<MemoryBusFakeCpu>(program.string(), mode, steps));
+            }
+
+            if (DbtCpu::hostSupported()) {
+                report("dbt", runDbtBenchmark(program.string(), steps));
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "ERROR: " << ex.what() << "\n";
+        return 2;
+    }
+
+    return 0;
+}
@@ -12,6 +12,7 @@ struct CpuDescription {
     std::string type;           // Наприклад: "test-cpu", "riscv32", "armv7"
     std::uint64_t frequencyHz;  // Частота в герцах
     std::string endianness;  // "little" або "big" (поки як рядок, можна буде замінити на enum)
+    std::string dispatch{"switch"};  // Ядро диспетчеризації FakeCpu: "switch" або "threaded"
 };
 
 // Тип регіону пам'яті (можна розширяти пізніше)
@@ -23,6 +24,13 @@ struct MemoryRegion {
     std::uint64_t baseAddress;  // Базова адреса
     std::uint64_t sizeBytes;    // Розмір у байтах
     MemoryType type;            // Тип пам'яті
+
+    // Права сторінок RAM/ROM: "rwx", "r-x", "rw"... Порожньо — за типом: RAM — "rwx", ROM — "rx".
+    std::string permissions{};
+
+    // Лише ROM: файл-образ, відображений у регіон без копіювання (MemoryBus::mapImage). Відносний шлях
+    // у YAML рахується від теки файла конфігурації. Порожньо — регіон заповнено нулями.
+    std::string file{};
 };
 
 // Опис одного пристрою (UART, таймер тощо).
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/ICpu.hpp"
+#include "elsim/core/IMemoryBus.hpp"
+
+namespace elsim::core {
+
+// DbtCpu — той самий FakeCPU ISA, але виконується через динамічну бінарну трансляцію (x86-64).
+//
+// Код гостя транслюється в машинний код хоста по базових блоках і кладеться у виконуваний
+// кеш коду. Переходи між блоками зшиваються (block chaining): після першого проходу
+// вихідний jmp блоку патчиться прямо на цільовий блок, без повернення в диспетчер.
+// Кеш дотримується W^X: він записуваний (RW) лише під час трансляції й патчів і виконуваний (RX)
+// лише під час виконання.
+//
+// Пам'ять:
+//  - LOAD/STORE у вікно звичайної RAM (IMemoryBus::hostWindow) йдуть напряму в буфер MemoryBus;
+//  - усе інше (MMIO, поза RAM) — через повільний хелпер, який викликає read32/write32 шини.
+//
+// Семантика збігається з FakeCpu (інтерпретатор лишається еталоном; див. диференційні тести).
+// Підтримується лише x86-64 Linux; на інших хостах конструктор кидає std::runtime_error.
+class DbtCpu : public ICpu {
+   public:
+    using Register = FakeCpu::Register;
+    using Flag = FakeCpu::Flag;
+    using CpuState = FakeCpu::CpuState;
+
+    // Максимальна довжина одного транслюваного блоку (в інструкціях).
+    static constexpr std::size_t kMaxBlockLength = 256;
+
+    // Розмір виконуваного кешу коду; при переповненні кеш повністю скидається.
+    static constexpr std::size_t kCodeCacheSize = 16u * 1024u * 1024u;
+
+    // Чи підтримує поточний хост трансляцію.
+    [[nodiscard]] static bool hostSupported() noexcept;
+
+    DbtCpu();
+    ~DbtCpu() override;
+
+    DbtCpu(const DbtCpu&) = delete;
+    DbtCpu& operator=(const DbtCpu&) = delete;
+
+    // ===== ICpu =====
+    void step() override;
+    void reset() override;
+    bool loadImage(const std::string& path) override;
+    void setMemoryBus(std::shared_ptr<IMemoryBus> bus) override;
+    bool isHalted() const noexcept override { return halted_; }
+
+    std::uint32_t getPc() const noexcept override { return ctx_.pc; }
+    void setPc(std::uint32_t value) noexcept override;
+
+    // Формат стану спільний з FakeCpu: checkpoint можна переносити між інтерпретатором і DBT.
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+
+    // ===== DbtCpu API =====
+
+    // Виконати до budget інструкцій у транслованому коді (семантика — див. ICpu::run).
+    // PC після помилки доступу до пам'яті лишається на інструкції, що впала, як і в FakeCpu.
+    RunResult run(std::uint64_t budget) override;
+    std::uint64_t retiredInRun() const noexcept override {
+        return runBudget_ != 0 ? runBudget_ - ctx_.budget : 0;
+    }
+
+    // Скинути весь кеш коду. Потрібно, якщо код гостя змінено в обхід CPU
+    // (напряму через MemoryBus) або змінилась карта пам'яті.
+    void invalidateCodeCache() noexcept;
+
+    [[nodiscard]] std::size_t translatedBlockCount() const noexcept { return blockCount_; }
+    [[nodiscard]] std::size_t codeCacheUsed() const noexcept { return codeUsed_; }
+
+    // --- Доступ до стану CPU (для тестів / дебагу), як у FakeCpu ---
+    [[nodiscard]] CpuState state() const noexcept;
+
+    Register getRegister(std::size_t index) const;
+    void setRegister(std::size_t index, Register value);
+
+    [[nodiscard]] Register getSp() const noexcept { return sp_; }
+    void setSp(Register value) noexcept { sp_ = value; }
+
+    [[nodiscard]] Register getFlags() const noexcept { return ctx_.flags; }
+    void setFlags(Register value) noexcept { ctx_.flags = value; }
+
+    void clearFlags() noexcept { ctx_.flags = 0; }
+    void setFlag(Flag flag, bool value) noexcept;
+    [[nodiscard]] bool isFlagSet(Flag flag) const noexcept;
+
+    [[nodiscard]] std::size_t stepCount() const noexcept { return stepCount_; }
+    [[nodiscard]] bool imageLoaded() const noexcept { return imageLoaded_; }
+    [[nodiscard]] const std::string& lastImagePath() const noexcept { return lastImagePath_; }
+
+    // Контекст, з яким працює згенерований код (регістр rbx вказує на нього).
+    // Зсуви полів зашиті в генератор — змінювати лише разом з DbtCpu.cpp.
+    struct Context {
+        std::uint32_t regs[FakeCpu::kNumRegisters]{};  // 0x00: R0..R7
+        std::uint32_t pc{0};                           // 0x20
+        std::uint32_t flags{0};                        // 0x24
+        std::uint64_t budget{0};                       // 0x28: скільки інструкцій ще можна виконати
+        std::uint8_t* ramHost{nullptr};                // 0x30: хост-адреса вікна прямого доступу
+        std::uint32_t ramBase{0};                      // 0x38: гостьова адреса початку вікна
+        std::uint32_t ramLimit{0};                     // 0x3C: (розмір вікна - 3), 0 — вікна немає
+        std::uint32_t codeLow{0xFFFFFFFFu};            // 0x40: межі транслованого коду [codeLow, codeHigh)
+        std::uint32_t codeHigh{0};                     // 0x44
+        std::uint32_t exitReason{0};                   // 0x48: див. ExitReason у DbtCpu.cpp
+        std::uint32_t ramPageOffset{0};                // 0x4C: зсув ramHost у його сторінці обліку
+        std::uint8_t* patchSite{nullptr};              // 0x50: jmp, який можна зшити з наступним блоком
+        DbtCpu* self{nullptr};                         // 0x58
+        std::uint64_t* ramEpochs{nullptr};             // 0x60: епохи сторінок вікна (HostMemoryWindow::pageEpochs)
+        const std::uint64_t* epoch{nullptr};           // 0x68: поточна епоха шини
+    };
+
+   private:
+    // Генератор коду та хелпери повільного шляху живуть у DbtCpu.cpp.
+    friend struct DbtTranslator;
+    friend struct DbtRuntime;
+
+    // Знайти (або транслювати) машинний код для гостьової адреси pc.
+    std::uint8_t* entryFor(std::uint32_t pc);
+    std::uint8_t* translate(std::uint32_t pc);
+
+    // Перемкнути кеш коду між RW (трансляція, патчі) і RX (виконання); mprotect лише при зміні.
+    void setCodeWritable(bool writable);
+
+    // Оновити вікно прямого доступу до RAM з поточної шини.
+    void refreshRamWindow();
+    void setRamWindow(const HostMemoryWindow& window);
+
+    Context ctx_{};
+    Register sp_{0};
+
+    std::shared_ptr<IMemoryBus> memoryBus_{};
+
+    bool halted_{false};
+    std::size_t stepCount_{0};
+    bool imageLoaded_{false};
+    std::string lastImagePath_{};
+
+    // Кеш коду: [codeBase_, codeBase_ + kCodeCacheSize), зайнято codeUsed_ байт.
+    std::uint8_t* codeBase_{nullptr};
+    std::size_t codeUsed_{0};
+    std::size_t stubsSize_{0};  // вхідний/вихідний трамплін на початку кешу
+    std::uint8_t* exitStub_{nullptr};
+    bool codeWritable_{false};  // поточні права кешу: true — RW, false — RX
+
+    // Точки входу: гостьова адреса інструкції -> її машинний код (включно з серединою блоків).
+    std::unordered_map<std::uint32_t, std::uint8_t*> entries_;
+    std::size_t blockCount_{0};
+
+    // Збільшується при кожному скиданні кешу (щоб не патчити jmp у вже звільненому коді).
+    std::uint64_t cacheGeneration_{0};
+
+    // Виняток, пійманий у хелпері повільного шляху (або відкладений run()); прокидається пізніше.
+    std::exception_ptr pendingFault_{};
+
+    // Бюджет поточного run() (0 поза run()); виконано = runBudget_ - ctx_.budget.
+    std::uint64_t runBudget_{0};
+};
+
+}  // namespace elsim::core
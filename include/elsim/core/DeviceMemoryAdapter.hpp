@@ -1,15 +1,20 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <utility>
 
 #include "elsim/core/IMemoryMappedDevice.hpp"
 #include "elsim/device/IDevice.hpp"
 
 namespace elsim::core {
-// Адаптер, який дозволяє використовувати elsim::IDevice як IMemoryMappedDevice
+// Адаптер, який дозволяє використовувати elsim::IDevice як IMemoryMappedDevice.
+// onWrite (якщо задано) викликається після кожного запису в пристрій — Simulator так дізнається,
+// що розклад пристрою міг змінитись.
 class DeviceMemoryAdapter : public IMemoryMappedDevice {
    public:
-    explicit DeviceMemoryAdapter(elsim::IDevice* device) : device_(device) {}
+    explicit DeviceMemoryAdapter(elsim::IDevice* device, std::function<void()> onWrite = {})
+        : device_(device), onWrite_(std::move(onWrite)) {}
 
     std::uint8_t read8(std::uint32_t offset) override {
         if (!device_) {
@@ -23,9 +28,18 @@ class DeviceMemoryAdapter : public IMemoryMappedDevice {
             return;
         }
         device_->write(offset, value);
+        if (onWrite_) {
+            onWrite_();
+        }
+    }
+
+    bool hasStableReads() const override { return device_ != nullptr && device_->readsAreStable(); }
+    bool isCycleCounter(std::uint32_t offset) const override {
+        return device_ != nullptr && device_->isCycleCounter(offset);
     }
 
    private:
     elsim::IDevice* device_;  // не володіємо, життям керує Simulator через unique_ptr
+    std::function<void()> onWrite_;
 };
 }  // namespace elsim::core
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace elsim::core {
+
+/**
+ * @brief Планувальник дискретних подій за симульованим циклом (min-heap).
+ *
+ * Зберігає пари (цикл, handle) і віддає їх у порядку зростання циклу; події на одному
+ * циклі — в порядку планування. Handle — довільний індекс власника (Simulator кладе
+ * туди індекс пристрою). Скасування немає: власник сам ігнорує застарілі події.
+ */
+class EventScheduler {
+   public:
+    using Handle = std::size_t;
+
+    // Значення nextDeadline(), коли подій немає.
+    static constexpr std::uint64_t kNever = std::numeric_limits<std::uint64_t>::max();
+
+    // Запланувати подію handle на абсолютний цикл cycle.
+    void schedule(Handle handle, std::uint64_t cycle);
+
+    // Забрати найближчу подію, якщо її цикл <= now. Повертає false, якщо таких немає.
+    bool popDue(std::uint64_t now, Handle& handle);
+    // Те саме, плюс цикл, на який подію було заплановано (щоб розпізнати застарілу).
+    bool popDue(std::uint64_t now, Handle& handle, std::uint64_t& cycle);
+
+    // Цикл найближчої події або kNever.
+    [[nodiscard]] std::uint64_t nextDeadline() const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return heap_.empty(); }
+    [[nodiscard]] std::size_t size() const noexcept { return heap_.size(); }
+
+    void clear() noexcept;
+
+   private:
+    struct Event {
+        std::uint64_t cycle;
+        std::uint64_t seq;  // порядок планування, щоб рівні цикли виходили стабільно
+        Handle handle;
+    };
+
+    // Компаратор для std::push_heap/pop_heap: на вершині — найменший (cycle, seq).
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const noexcept {
+            return a.cycle != b.cycle ? a.cycle > b.cycle : a.seq > b.seq;
+        }
+    };
+
+    std::vector<Event> heap_;
+    std::uint64_t nextSeq_{0};
+};
+
+}  // namespace elsim::core
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "elsim/core/HostMemory.hpp"
+
+namespace elsim::core {
+
+/**
+ * @brief Профіль виконання: скільки разів виконано кожен opcode і кожну адресу коду.
+ *
+ * Лічильники PC — плоский масив, індексований (pc - base) / 4 по профільованому діапазону
+ * (зазвичай RAM плати); інструкції поза ним рахуються разом в outsideCount(). Для JZ/JNZ
+ * окремо рахуються виконані переходи — на opcode і на адресу. Масиви лежать у HostMemory, тож фізичну
+ * пам'ять займають лише сторінки лічильників, які справді інкрементували: профіль RAM на 512 MiB,
+ * де виконується кілька KiB коду, коштує кілька сторінок хоста.
+ *
+ * CPU наповнює профіль через record()/recordTaken() (ICpu::setProfile); сам профіль нічого
+ * не знає про CPU, тож його можна будувати й з інших джерел (тести, трасування).
+ */
+class ExecutionProfile {
+   public:
+    static constexpr std::size_t kDefaultTopCount = 20;
+
+    // Діапазон [baseAddress, baseAddress + sizeBytes); sizeBytes > 0 (інакше std::invalid_argument).
+    ExecutionProfile(std::uint32_t baseAddress, std::size_t sizeBytes);
+
+    // Виконано інструкцію opcode за адресою pc.
+    void record(std::uint32_t pc, std::uint8_t opcode) noexcept {
+        ++opcodeCounts_[opcode];
+        const std::uint32_t index = (pc - baseAddress_) >> 2;
+        if (index < slots_) {
+            ++counters(pcCounts_)[index];
+        } else {
+            ++outside_;
+        }
+    }
+
+    // Умовний перехід opcode за адресою pc виконався (на додачу до record()).
+    void recordTaken(std::uint32_t pc, std::uint8_t opcode) noexcept {
+        ++opcodeTaken_[opcode];
+        const std::uint32_t index = (pc - baseAddress_) >> 2;
+        if (index < slots_) {
+            ++counters(pcTaken_)[index];
+        }
+    }
+
+    void clear() noexcept;
+
+    [[nodiscard]] std::uint32_t baseAddress() const noexcept { return baseAddress_; }
+    [[nodiscard]] std::uint64_t totalCount() const noexcept;
+    [[nodiscard]] std::uint64_t opcodeCount(std::uint8_t opcode) const noexcept { return opcodeCounts_[opcode]; }
+    [[nodiscard]] std::uint64_t opcodeTakenCount(std::uint8_t opcode) const noexcept { return opcodeTaken_[opcode]; }
+    // 0 для адрес поза діапазоном.
+    [[nodiscard]] std::uint64_t pcCount(std::uint32_t pc) const noexcept;
+    [[nodiscard]] std::uint64_t pcTakenCount(std::uint32_t pc) const noexcept;
+    [[nodiscard]] std::uint64_t outsideCount() const noexcept { return outside_; }
+
+    // Скільки байтів лічильників PC справді займає фізичну пам'ять (див. HostMemory::residentBytes).
+    [[nodiscard]] std::size_t residentBytes() const { return pcCounts_.residentBytes() + pcTaken_.residentBytes(); }
+
+    // До count найчастіших адрес (pc, лічильник) за спаданням лічильника, при рівності — за адресою.
+    [[nodiscard]] std::vector<std::pair<std::uint32_t, std::uint64_t>> topPcs(std::size_t count) const;
+
+    // Текстовий звіт: топ адрес, гістограма opcode, частка виконаних переходів JZ/JNZ.
+    // code — пам'ять, що починається з baseAddress() (наприклад, MemoryBus::ram()): якщо задана,
+    // біля кожної адреси друкується дизасембльована інструкція.
+    void report(std::ostream& out, std::size_t topCount = kDefaultTopCount,
+                std::span<const std::uint8_t> code = {}) const;
+
+   private:
+    std::uint32_t baseAddress_;
+    std::size_t slots_;
+    HostMemory pcCounts_;  // slots_ лічильників std::uint64_t
+    HostMemory pcTaken_;
+    std::array<std::uint64_t, 256> opcodeCounts_{};
+    std::array<std::uint64_t, 256> opcodeTaken_{};
+    std::uint64_t outside_{0};
+
+    static std::uint64_t* counters(HostMemory& memory) noexcept {
+        return reinterpret_cast<std::uint64_t*>(memory.data());
+    }
+    static const std::uint64_t* counters(const HostMemory& memory) noexcept {
+        return reinterpret_cast<const std::uint64_t*>(memory.data());
+    }
+};
+
+}  // namespace elsim::core
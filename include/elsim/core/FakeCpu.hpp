@@ -3,16 +3,23 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "elsim/core/ExecutionProfile.hpp"
 #include "elsim/core/ICpu.hpp"
+#include "elsim/core/IMemoryBus.hpp"
+#include "elsim/core/InstructionTrace.hpp"
 
 namespace elsim::core {
 
-class FakeCpu : public ICpu {
-   public:
-    // === Архітектура FakeCPU згідно ISA ===
+class MemoryBus;
+
+// Архітектура FakeCPU згідно ISA — спільна для всіх варіантів FakeCpuT (стан можна порівнювати й переносити).
+struct FakeCpuArch {
     static constexpr std::size_t kNumRegisters = 8;
     using Register = std::uint32_t;
 
@@ -30,15 +37,78 @@ class FakeCpu : public ICpu {
         Register pc{0};                              // Program Counter
         Register sp{0};                              // Stack Pointer
         Register flags{0};                           // FLAGS
+
+        friend bool operator==(const CpuState&, const CpuState&) = default;
     };
 
-    FakeCpu() = default;
-    ~FakeCpu() override = default;
+    // Ядро диспетчеризації інструкцій:
+    //  - Switch   — еталонний switch за opcode (поведінка за замовчуванням);
+    //  - Threaded — обробник знаходиться один раз у decode() через таблицю на 256 opcode,
+    //               виконання — один непрямий виклик без розбору opcode.
+    enum class DispatchMode { Switch, Threaded };
+};
+
+// Інтерпретатор FakeCPU, параметризований типом шини, яку викликає гарячий шлях (fetch, LOAD, STORE):
+//  - FakeCpu          = FakeCpuT<IMemoryBus> — будь-яка IMemoryBus через віртуальні виклики (тести, інструменти);
+//  - MemoryBusFakeCpu = FakeCpuT<MemoryBus>  — конкретна MemoryBus (її так створює Simulator): без віртуальних
+//    викликів і перевірок адаптера, доступ до RAM вбудовується в обробник інструкції.
+// Обидва варіанти — ICpu з однаковою поведінкою; реалізація і явні інстанціювання — у FakeCpu.cpp.
+template <typename Bus>
+class FakeCpuT : public ICpu, public FakeCpuArch {
+   public:
+    struct DecodedInstruction;
+    using Handler = void (FakeCpuT::*)(const DecodedInstruction&);
+
+    // Попередньо декодована інструкція: усі поля розібрані один раз,
+    // imm16 уже розширений зі знаком, ціль переходу обчислена заздалегідь.
+    struct DecodedInstruction {
+        Handler handler{nullptr};  // обробник з handlerTable() для Threaded-режиму
+        std::uint32_t raw{0};     // сире 32-бітне слово інструкції
+        std::uint32_t pc{0};      // адреса інструкції
+        std::uint32_t target{0};  // JMP/JZ/JNZ: PC + 4 + (offset16 << 2)
+        Register imm{0};          // sign_extend(imm16)
+        std::uint8_t opcode{0};
+        std::uint8_t rd{0};
+        std::uint8_t rs{0};
+        bool isImm{false};
+    };
+
+    // Базовий блок декодованих інструкцій: лінійна послідовність,
+    // що закінчується переходом/HALT (або обрізана за kMaxBlockLength).
+    struct DecodedBlock {
+        std::uint32_t startPc{0};
+        std::vector<DecodedInstruction> ops;
+        bool complete{false};  // блок закритий — далі інструкції не дописуються
+    };
+
+    // Максимальна довжина одного блоку (в інструкціях).
+    static constexpr std::size_t kMaxBlockLength = 256;
+
+    // Ліміт кількості блоків у кеші; при переповненні кеш повністю скидається.
+    static constexpr std::size_t kMaxCachedBlocks = 4096;
+
+    // Найдовший цикл (в інструкціях, включно з переходом), який run() розглядає як idle-цикл.
+    static constexpr std::uint32_t kMaxIdleLoopLength = 16;
+
+    // Найдовший цикл затримки (NOP... SUB Rn,#1 ... JNZ), який run() згортає в один крок.
+    static constexpr std::uint32_t kMaxCountedLoopLength = 16;
+
+    FakeCpuT() = default;
+    ~FakeCpuT() override = default;
 
     // ===== ICpu =====
     void step() override;
+    RunResult run(std::uint64_t budget) override;
+    std::uint64_t retiredInRun() const noexcept override { return runRetired_; }
+    void setIdleLoopSkipping(bool enabled) override { idleLoopSkipping_ = enabled; }
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+    void setTraceWriter(TraceWriter* trace) override { trace_ = trace; }
+    void setProfile(ExecutionProfile* profile) override { profile_ = profile; }
     void reset() override;
     bool loadImage(const std::string& path) override;
+    // FakeCpuT<MemoryBus> приймає лише MemoryBusAdapter (його дає Simulator) і викликає MemoryBus під ним;
+    // іншу шину відхиляє з std::invalid_argument.
     void setMemoryBus(std::shared_ptr<IMemoryBus> bus) override;
     bool isHalted() const noexcept override { return halted_; }
 
@@ -50,6 +120,28 @@ class FakeCpu : public ICpu {
     // Декодування та виконання однієї 32-бітної інструкції
     void decodeAndExecute(std::uint32_t instruction);
 
+    // Розбір 32-бітного слова без виконання (pc потрібен для обчислення цілі переходу).
+    [[nodiscard]] static DecodedInstruction decode(std::uint32_t instruction, std::uint32_t pc) noexcept;
+
+    // --- Кеш декодованих блоків ---
+    //
+    // step() під час першого проходу фетчить і декодує інструкції як завжди,
+    // але складає їх у базові блоки за адресою PC. Повторні проходи того ж коду
+    // виконуються прямо з кешу, без звернень до шини пам'яті.
+    //
+    // Кеш скидається автоматично, коли сам CPU пише (STORE) у діапазон закешованого коду,
+    // а також при reset()/setPc()/setMemoryBus(). Якщо код змінюється в обхід CPU
+    // (наприклад, напряму через MemoryBus) або змінюється карта пам'яті (mapDevice),
+    // треба викликати invalidateDecodeCache() — він же скидає вікно прямого fetch.
+    void setDecodeCacheEnabled(bool enabled) noexcept;
+    [[nodiscard]] bool decodeCacheEnabled() const noexcept { return decodeCacheEnabled_; }
+    void invalidateDecodeCache() noexcept;
+    [[nodiscard]] std::size_t cachedBlockCount() const noexcept { return blocks_.size(); }
+
+    // Вибір ядра диспетчеризації (можна перемикати між step()/run(); діє з наступного виклику).
+    void setDispatchMode(DispatchMode mode) noexcept { dispatchMode_ = mode; }
+    [[nodiscard]] DispatchMode dispatchMode() const noexcept { return dispatchMode_; }
+
     // --- Доступ до стану CPU (для тестів / дебагу) ---
     [[nodiscard]] const CpuState& state() const noexcept { return state_; }
 
@@ -69,6 +161,9 @@ class FakeCpu : public ICpu {
 
     // Debug API (як було раніше)
     [[nodiscard]] std::size_t stepCount() const noexcept { return stepCount_; }
+
+    // Скільки інструкцій run() "виконав" згортанням циклів затримки (вони входять у stepCount/retired).
+    [[nodiscard]] std::uint64_t collapsedInstructionCount() const noexcept { return collapsedInstructions_; }
     [[nodiscard]] bool imageLoaded() const noexcept { return imageLoaded_; }
     [[nodiscard]] const std::string& lastImagePath() const noexcept { return lastImagePath_; }
 
@@ -90,17 +185,162 @@ class FakeCpu : public ICpu {
     // Статус HALT для нового виконуючого ядра
     bool halted_{false};
 
+    // Виняток, відкладений run() (див. ICpu::run); кидається наступним run()/step().
+    std::exception_ptr pendingFault_{};
+
+    // Лічильник інструкцій поточного run() (див. retiredInRun()).
+    std::uint64_t runRetired_{0};
+
+    // --- Пропуск idle-циклів (ICpu::setIdleLoopSkipping) ---
+    //
+    // Кандидат — зворотний перехід tail -> head, тіло якого вже лежить у кеші декодування одним блоком
+    // [head, tail] не довшим за kMaxIdleLoopLength: лише NOP/MOV/ADD/SUB/LOAD і перехід наприкінці.
+    // На кожному такому переході skipIdleLoop() прораховує наступну ітерацію від поточного стану:
+    // LOAD зі стабільних адрес дають сталі, LOAD лічильника циклів (IMemoryBus::isCycleCounter) —
+    // значення, що росте на 1 за інструкцію. Якщо регістри, які ітерація читає до запису, після неї
+    // не змінюються, усі ітерації однакові з точністю до лічильника, і run() перемотує їх одразу
+    // до тієї, що вийде з циклу, або до кінця бюджету. Без кешу декодування цикли не пропускаються.
+    struct IdleLoop {
+        bool analyzed{false};
+        const DecodedBlock* body{nullptr};  // блок [head, tail]; nullptr — тіло не підходить
+        std::uint32_t head{0};
+        std::uint32_t tail{0};
+        std::uint32_t recheckIn{0};  // скільки переходів пропустити після невдалої перевірки стану
+    };
+
+    // Після невдалої перевірки (стан змінюється між ітераціями) цикл перевіряється знову лише
+    // через стільки переходів — звичайні обчислювальні цикли майже не платять за пошук.
+    static constexpr std::uint32_t kIdleLoopRecheckInterval = 16;
+
+    IdleLoop idleLoop_{};
+    bool idleLoopSkipping_{false};
+
+    // --- Цикли затримки: MOV Rn,#N; loop: [NOP...] SUB Rn,#1 [NOP...] JNZ loop ---
+    //
+    // На зворотному JNZ усередині run() тіло циклу розбирається (результат кешується для останнього
+    // циклу) і, якщо воно підходить, усі повні ітерації, що вміщуються в бюджет, застосовуються
+    // одразу: Rn, Z/N, PC, retired і stepCount — ті самі, що при покроковому виконанні.
+    struct CountedLoop {
+        bool analyzed{false};
+        bool valid{false};
+        std::uint32_t head{0};
+        std::uint32_t tail{0};    // адреса JNZ
+        std::uint32_t length{0};  // інструкцій в ітерації, включно з JNZ
+        std::uint8_t reg{0};      // Rn
+    };
+
+    CountedLoop countedLoop_{};
+    std::uint64_t runBudget_{0};  // бюджет поточного run() (0 поза run() — тоді цикли не згортаються)
+    std::uint64_t collapsedInstructions_{0};
+
+    void collapseCountedLoop(std::uint32_t tail, std::uint32_t head);
+    void analyzeCountedLoop(std::uint32_t tail, std::uint32_t head);
+
+    // Цикл run() з пошуком idle-циклів; результат — у runRetired_ і result.
+    template <bool Threaded>
+    void runSkippingIdleLoops(std::uint64_t budget, RunResult& result);
+
+    // Щойно виконано зворотний перехід з tail на PC: якщо це idle-цикл — перемотати його ітерації.
+    void skipIdleLoop(std::uint32_t tail, std::uint64_t budget, RunResult& result);
+    void analyzeIdleLoop(std::uint32_t tail, std::uint32_t head);
+
     // Хелпери для роботи з регістрами та прапорцями
     Register readReg(std::size_t index) const;
     void writeReg(std::size_t index, Register value);
     void updateZNFlags(Register value);
 
-    // Абстрактна шина пам'яті
+    // Шина пам'яті: memoryBus_ тримає її живою, bus_ — те, що викликає гарячий шлях
+    // (для Bus = MemoryBus — MemoryBus під адаптером, без віртуальних викликів).
     std::shared_ptr<IMemoryBus> memoryBus_{};
+    Bus* bus_{nullptr};
 
     // Допоміжні функції для роботи з 32-бітними словами в пам'яті (little-endian).
     Register read32(std::uint32_t address);
     void write32(std::uint32_t address, Register value);
+
+    // Fetch інструкції: слово з виконуваного вікна (IMemoryBus::hostWindow, HostAccess::Execute) читається
+    // одним завантаженням з хост-пам'яті; MMIO, межі вікна та адреси поза ним — через шину (fetch32).
+    std::uint32_t fetch32(std::uint32_t pc);
+
+    // Поточне вікно прямого fetch; скидається разом з кешем декодування.
+    HostMemoryWindow fetchWindow_{};
+
+    // Виконання вже декодованої інструкції; Threaded — через op.handler, інакше dispatchSwitch().
+    // Режим — параметр шаблону: step()/run() обирають ядро раз, а не на кожну інструкцію.
+    template <bool Threaded>
+    void execute(const DecodedInstruction& op);
+
+    // Трасування (setTraceWriter): запис поточної інструкції складається в execute(),
+    // LOAD/STORE дописують у нього адресу й значення.
+    TraceWriter* trace_{nullptr};
+    TraceRecord traceRecord_{};
+
+    // Профіль (setProfile). step()/run() один раз обирають варіант stepImpl за профілем і dispatchMode_,
+    // тож у циклі виконання немає жодної перевірки на інструкцію.
+    ExecutionProfile* profile_{nullptr};
+
+    // Тіло step(); Profiled — рахувати інструкцію в profile_ перед виконанням,
+    // Threaded — ядро диспетчеризації (див. execute()).
+    template <bool Profiled, bool Threaded>
+    void stepImpl();
+
+    // Звичайний цикл run() (без пропуску idle-циклів); результат — у runRetired_ і result.
+    template <bool Profiled, bool Threaded>
+    void runLoop(std::uint64_t budget, RunResult& result);
+
+    // Вибір циклу run() (профіль / idle-цикли / звичайний) для вже обраного ядра диспетчеризації.
+    template <bool Threaded>
+    void runWithDispatch(std::uint64_t budget, RunResult& result);
+
+    void profileInstruction(const DecodedInstruction& op) noexcept;
+
+    // Еталонне ядро диспетчеризації (DispatchMode::Switch).
+    void dispatchSwitch(const DecodedInstruction& op);
+
+    // Обробники окремих інструкцій (спільні для Switch і Threaded).
+    void execNop(const DecodedInstruction& op);
+    void execMov(const DecodedInstruction& op);
+    void execAdd(const DecodedInstruction& op);
+    void execSub(const DecodedInstruction& op);
+    void execLoad(const DecodedInstruction& op);
+    void execStore(const DecodedInstruction& op);
+    void execJmp(const DecodedInstruction& op);
+    void execJz(const DecodedInstruction& op);
+    void execJnz(const DecodedInstruction& op);
+    void execHalt(const DecodedInstruction& op);
+    void execUnknown(const DecodedInstruction& op);
+
+    // Таблиця обробників, індексована opcode (невідомі opcode -> execUnknown).
+    static const std::array<Handler, 256>& handlerTable() noexcept;
+
+    DispatchMode dispatchMode_{DispatchMode::Switch};
+
+    // Пошук наступної інструкції в кеші; nullptr — промах (треба фетчити).
+    const DecodedInstruction* nextCachedInstruction();
+
+    // Дописати щойно декодовану інструкцію в поточний (відкритий) блок.
+    void recordInstruction(const DecodedInstruction& op);
+
+    // Якщо запис [address, address + size) зачіпає закешований код — скинути кеш.
+    void invalidateOnWrite(std::uint32_t address, std::uint32_t size) noexcept;
+
+    // Кеш декодованих блоків за стартовою адресою
+    bool decodeCacheEnabled_{true};
+    std::unordered_map<std::uint32_t, std::unique_ptr<DecodedBlock>> blocks_;
+
+    // Курсор: блок і індекс інструкції, яку очікуємо виконати наступною
+    DecodedBlock* cursorBlock_{nullptr};
+    std::size_t cursorIndex_{0};
+
+    // Межі адрес, зайнятих закешованим кодом: [codeLow_, codeHigh_)
+    std::uint32_t codeLow_{0xFFFFFFFFu};
+    std::uint32_t codeHigh_{0};
 };
 
+extern template class FakeCpuT<IMemoryBus>;
+extern template class FakeCpuT<MemoryBus>;
+
+using FakeCpu = FakeCpuT<IMemoryBus>;
+using MemoryBusFakeCpu = FakeCpuT<MemoryBus>;
+
 }  // namespace elsim::core
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace elsim::core {
+
+/**
+ * @brief Вміст файла лише для читання, без копіювання в купу.
+ *
+ * На POSIX-хостах файл відображається в пам'ять (mmap, PROT_READ): сторінки читаються з кешу ОС
+ * по мірі доступу й не займають приватної пам'яті процесу. Дескриптор відображеного файла лишається
+ * відкритим (nativeHandle()), тож той самий файл можна відобразити ще раз, навіть якщо шлях відтоді
+ * перейменували чи замінили. Якщо відображення неможливе (не POSIX, спеціальна ФС) — файл читається в буфер.
+ */
+class FileView {
+   public:
+    // Файл не відкривається чи не є звичайним файлом — std::runtime_error.
+    explicit FileView(const std::string& path);
+    ~FileView();
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    [[nodiscard]] std::span<const std::uint8_t> bytes() const noexcept {
+        return {mapped_ != nullptr ? mapped_ : buffer_.data(), size_};
+    }
+
+    // Дескриптор відкритого файла (POSIX) або -1, якщо вміст прочитано в буфер.
+    [[nodiscard]] int nativeHandle() const noexcept { return fd_; }
+
+   private:
+    const std::uint8_t* mapped_{nullptr};
+    int fd_{-1};
+    std::size_t size_{0};
+    std::vector<std::uint8_t> buffer_;
+};
+
+}  // namespace elsim::core
@@ -12,6 +12,7 @@ class GpioController final {
     using GpioMask = std::uint64_t;
     using OutputCallback = std::function<void(std::size_t pin, bool level)>;
     using SubscriptionId = std::size_t;
+    using InputObserver = std::function<void(std::size_t pin, bool level)>;
 
     explicit GpioController(std::size_t pinCount);
 
@@ -23,10 +24,18 @@ class GpioController final {
 
     void injectInput(std::size_t pin, bool level);
 
+    // Спостерігач усіх injectInput() (запис зовнішніх впливів, Simulator::startRecording).
+    // Один на контролер; порожня функція знімає його.
+    void setInputObserver(InputObserver observer);
+
     GpioMask getDirectionMask() const noexcept;
     GpioMask getOutputMask() const noexcept;
     GpioMask getInputMask() const noexcept;
 
+    // Відновити всі регістри разом (checkpoint). Підписники отримують сповіщення
+    // лише для пінів, чий зовнішній рівень змінився.
+    void restoreMasks(GpioMask dir, GpioMask out, GpioMask in);
+
     SubscriptionId subscribeOnOutputChanged(OutputCallback cb);
     void unsubscribe(SubscriptionId id);
 
@@ -42,6 +51,7 @@ class GpioController final {
 
     SubscriptionId next_sub_id_{1};
     std::unordered_map<SubscriptionId, OutputCallback> out_subs_;
+    InputObserver input_observer_;
 };
 
 }  // namespace elsim::core
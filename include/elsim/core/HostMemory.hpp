@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace elsim::core {
+
+class FileView;
+
+/**
+ * @brief Суцільний нульовий буфер гостьової пам'яті, що займає фізичну пам'ять лише під сторінки, в які писали.
+ *
+ * На POSIX-хостах конструктор резервує capacity байтів віртуальних адрес (mmap PROT_NONE, MAP_NORESERVE),
+ * а resize() відкриває початок резервації на читання/запис. Ядро віддає спільну нульову сторінку при читанні
+ * й виділяє фізичну лише при першому записі, тож RAM на 512 MiB, з якої прошивка торкається кількох MiB,
+ * коштує кілька MiB. data() не змінюється при resize().
+ *
+ * Якщо резервація недоступна (не POSIX, ліміт адресного простору) — звичайний буфер у купі: data() може
+ * переїхати при resize(), а residentBytes() дорівнює size().
+ */
+class HostMemory {
+   public:
+    HostMemory() noexcept = default;
+
+    // Резервація на capacity байтів; size() == 0.
+    explicit HostMemory(std::size_t capacity);
+
+    ~HostMemory();
+
+    HostMemory(HostMemory&& other) noexcept;
+    HostMemory& operator=(HostMemory&& other) noexcept;
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    [[nodiscard]] std::uint8_t* data() noexcept { return data_; }
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] std::span<std::uint8_t> bytes() noexcept { return {data_, size_}; }
+    [[nodiscard]] std::span<const std::uint8_t> bytes() const noexcept { return {data_, size_}; }
+
+    // Пам'ять виділяється сторінками при першому записі (резервація вдалась).
+    [[nodiscard]] bool isSparse() const noexcept { return reservation_ != nullptr; }
+
+    // Новий розмір (<= capacity(), інакше std::length_error). Нові байти — нулі; при зменшенні хвіст
+    // обнуляється (і повертається ОС), тож наступне збільшення знову бачить нулі.
+    void resize(std::size_t size);
+
+    // Обнулити [offset, offset + size): цілі сторінки хоста повертаються ОС, краї обнуляються memset.
+    void zero(std::size_t offset, std::size_t size);
+
+    // Стати копією bytes (розмір — bytes.size()). Нульові сторінки не копіюються, тож лишаються
+    // невиділеними: копія розрідженої пам'яті теж розріджена.
+    void assign(std::span<const std::uint8_t> bytes);
+
+    // Відобразити вміст файла path у [offset, offset + розмір файла) без копіювання: приватне (copy-on-write)
+    // відображення файла поверх резервації. Сторінки, яких ніхто не змінював, — спільні зі сторінковим кешем
+    // ОС (і з іншими процесами, що відобразили той самий файл); запис створює приватну копію сторінки, файл
+    // не змінюється. offset має бути кратним hostPageSize(), файл — вміщатися в size() (інакше
+    // std::invalid_argument). Без резервації або якщо mmap неможливий — файл читається в буфер.
+    // Помилка відкриття/читання файла — std::runtime_error. Повертає розмір файла.
+    std::size_t mapFile(std::size_t offset, const std::string& path);
+
+    // Те саме для вже відкритого файла: відображається саме той файл, що тримає file (його дескриптор),
+    // навіть якщо шлях відтоді замінили. Без дескриптора чи якщо mmap неможливий — вміст file копіюється.
+    std::size_t mapFile(std::size_t offset, const FileView& file);
+
+    // Скільки байтів буфера справді займає фізичну пам'ять цього процесу (сторінки хоста, записані
+    // хоч раз). Linux — /proc/self/pagemap (сторінки, не спільні з іншими відображеннями й не з кешу
+    // файлів, тож незмінений образ mapFile() не рахується); інші POSIX —
+    // mincore() (рахує й прочитані нульові сторінки); без резервації — size().
+    [[nodiscard]] std::size_t residentBytes() const;
+
+    // Розмір сторінки хоста.
+    static std::size_t hostPageSize() noexcept;
+
+   private:
+    std::uint8_t* reservation_{nullptr};  // початок резервації (nullptr — буфер у купі)
+    std::size_t capacity_{0};
+    std::size_t committed_{0};  // байтів резервації, відкритих на читання/запис (кратно сторінці хоста)
+    std::vector<std::uint8_t> heap_;
+    std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+
+    void release() noexcept;
+
+    // Відобразити fileSize байтів відкритого файла fd в [offset, ...) поверх резервації. false — mmap
+    // неможливий: діапазон обнулено, вміст копіює викликач.
+    bool mapDescriptor(std::size_t offset, int fd, std::size_t fileSize);
+};
+
+}  // namespace elsim::core
@@ -2,11 +2,30 @@
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace elsim::core {
 
+class ExecutionProfile;
 class IMemoryBus;
+class StateReader;
+class StateWriter;
+class TraceWriter;
+
+// Чому ICpu::run() повернув керування.
+enum class StopReason {
+    BudgetExhausted,  // виконано весь бюджет інструкцій
+    Halted,           // CPU виконав HALT (або вже був зупинений)
+    Fault             // інструкція впала; виняток кине наступний виклик run()/step()
+};
+
+// Результат пакетного виконання: скільки інструкцій виконано і чому зупинились.
+struct RunResult {
+    std::uint64_t retired{0};
+    StopReason reason{StopReason::BudgetExhausted};
+    std::uint64_t skipped{0};  // скільки з retired пропущено перемотуванням idle-циклу (див. setIdleLoopSkipping)
+};
 
 class ICpu {
    public:
@@ -15,6 +34,67 @@ class ICpu {
     // Виконати один крок симуляції CPU
     virtual void step() = 0;
 
+    // Виконати до budget інструкцій за один виклик.
+    // HALT не рахується у retired. Якщо інструкція впала, а до неї вже щось виконано —
+    // повертається StopReason::Fault, а виняток кидає наступний виклик run()/step();
+    // якщо не виконано нічого — виняток прокидається одразу.
+    //
+    // Базова реалізація просто викликає step() у циклі (і прокидає виняток одразу);
+    // конкретні CPU перевизначають її, щоб прибрати віртуальний виклик на кожну інструкцію.
+    virtual RunResult run(std::uint64_t budget) {
+        RunResult result{};
+        while (result.retired < budget) {
+            step();
+            if (isHalted()) {
+                result.reason = StopReason::Halted;
+                return result;
+            }
+            ++result.retired;
+        }
+        return result;
+    }
+
+    // Скільки інструкцій уже виконано поточним викликом run() (0 поза run()).
+    // Пристрої читають це посеред пакету через SimClock, щоб бачити точний цикл.
+    // Базова реалізація run() не веде цей лічильник.
+    virtual std::uint64_t retiredInRun() const noexcept { return 0; }
+
+    // Пропуск idle-циклів у run(): короткий цикл без записів, що читає лише стабільні адреси
+    // (IMemoryBus::isStableRead) чи лічильник циклів (IMemoryBus::isCycleCounter) і кожну ітерацію починає
+    // з тих самих вхідних регістрів, перемотується цілими ітераціями до виходу з циклу або до кінця бюджету.
+    // Архітектурний стан і retired — ті самі, що при покроковому виконанні, доки жоден пристрій
+    // не змінюється в межах бюджету (Simulator обмежує бюджет наступною подією).
+    // CPU без підтримки ігнорують цей режим.
+    virtual void setIdleLoopSkipping(bool /*enabled*/) {}
+
+    // Checkpoint: архітектурний стан CPU (регістри, PC, прапорці, HALT). Відкладена помилка run()
+    // не зберігається. Після loadState() CPU сам скидає кеші коду — пам'ять могла змінитись.
+    // Розмір стану не залежить від значень: Simulator звіряє з ним payload checkpoint-а до loadState().
+    virtual void saveState(StateWriter& /*out*/) const {
+        throw std::runtime_error("ICpu::saveState: checkpoints are not supported by this CPU");
+    }
+    virtual void loadState(StateReader& /*in*/) {
+        throw std::runtime_error("ICpu::loadState: checkpoints are not supported by this CPU");
+    }
+
+    // Двійкове трасування інструкцій (InstructionTrace.hpp): кожна виконана інструкція — запис
+    // у trace; nullptr вимикає. Поки трасування увімкнене, CPU не згортає й не пропускає цикли.
+    // CPU без підтримки кидають std::runtime_error на ненульовий trace.
+    virtual void setTraceWriter(TraceWriter* trace) {
+        if (trace != nullptr) {
+            throw std::runtime_error("ICpu::setTraceWriter: instruction tracing is not supported by this CPU");
+        }
+    }
+
+    // Профілювання (ExecutionProfile.hpp): кожна виконана інструкція рахується в profile — на opcode
+    // і на PC, для JZ/JNZ ще й виконані переходи; nullptr вимикає. Як і з трасуванням, цикли тоді
+    // не згортаються й не пропускаються. CPU без підтримки кидають std::runtime_error на ненульовий profile.
+    virtual void setProfile(ExecutionProfile* profile) {
+        if (profile != nullptr) {
+            throw std::runtime_error("ICpu::setProfile: execution profiling is not supported by this CPU");
+        }
+    }
+
     // Скинути стан CPU до початкового
     virtual void reset() = 0;
 
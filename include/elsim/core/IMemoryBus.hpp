@@ -1,9 +1,28 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 namespace elsim::core {
 
+// Безперервний шматок звичайної RAM, до якого CPU може звертатися напряму, минаючи read8/write8.
+struct HostMemoryWindow {
+    std::uint32_t base{0};            // глобальна адреса першого байта вікна
+    std::span<std::uint8_t> bytes{};  // хост-пам'ять вікна; порожній span — прямого доступу немає
+
+    // Облік змінених сторінок шини (лише ReadWrite-вікна). Записи через вікно минають шину, тож той,
+    // хто пише, сам ставить *epoch у pageEpochs[(pageOffset + зсув у вікні) >> kEpochPageBits].
+    static constexpr std::uint32_t kEpochPageBits = 12;
+    std::uint64_t* pageEpochs{nullptr};   // епоха сторінки з першим байтом вікна; nullptr — обліку немає
+    const std::uint64_t* epoch{nullptr};  // поточна епоха шини
+    std::uint32_t pageOffset{0};          // зсув першого байта вікна в його сторінці
+};
+
+// Як CPU збирається користуватись вікном прямого доступу. Писати дозволено лише через ReadWrite-вікно,
+// відмічаючи сторінки в його pageEpochs.
+// Execute — лише fetch інструкцій: вікно з виконуваних сторінок (читати дані через нього не можна).
+enum class HostAccess { ReadOnly, ReadWrite, Execute };
+
 class IMemoryBus {
    public:
     virtual ~IMemoryBus() = default;
@@ -13,6 +32,54 @@ class IMemoryBus {
 
     // Запис 1 байта в глобальну адресу.
     virtual void write8(std::uint32_t address, std::uint8_t value) = 0;
+
+    // 16/32-бітні транзакції (little-endian). Базова реалізація — послідовність read8/write8
+    // від молодшого байта; шини з прямим доступом до RAM/MMIO перевизначають їх.
+    virtual std::uint16_t read16(std::uint32_t address) {
+        const std::uint32_t b0 = read8(address + 0);
+        const std::uint32_t b1 = read8(address + 1);
+        return static_cast<std::uint16_t>(b0 | (b1 << 8));
+    }
+
+    virtual std::uint32_t read32(std::uint32_t address) {
+        const std::uint32_t b0 = read8(address + 0);
+        const std::uint32_t b1 = read8(address + 1);
+        const std::uint32_t b2 = read8(address + 2);
+        const std::uint32_t b3 = read8(address + 3);
+        return b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
+    }
+
+    // Fetch 32-бітної інструкції. Шини з правами доступу (MemoryBus) вимагають тут права виконання
+    // замість читання; базова реалізація — звичайне read32.
+    virtual std::uint32_t fetch32(std::uint32_t address) { return read32(address); }
+
+    virtual void write16(std::uint32_t address, std::uint16_t value) {
+        write8(address + 0, static_cast<std::uint8_t>(value & 0xFFu));
+        write8(address + 1, static_cast<std::uint8_t>((value >> 8) & 0xFFu));
+    }
+
+    virtual void write32(std::uint32_t address, std::uint32_t value) {
+        write8(address + 0, static_cast<std::uint8_t>(value & 0xFFu));
+        write8(address + 1, static_cast<std::uint8_t>((value >> 8) & 0xFFu));
+        write8(address + 2, static_cast<std::uint8_t>((value >> 16) & 0xFFu));
+        write8(address + 3, static_cast<std::uint8_t>((value >> 24) & 0xFFu));
+    }
+
+    // Максимальне вікно звичайної RAM, що містить address і не перекрите жодним MMIO-девайсом.
+    // Вікно дійсне, доки не змінюється карта пам'яті (mapDevice). За замовчуванням прямого доступу немає.
+    // access = ReadOnly — обіцянка не писати через вікно (напр. лише fetch інструкцій).
+    virtual HostMemoryWindow hostWindow(std::uint32_t /*address*/, HostAccess /*access*/ = HostAccess::ReadWrite) {
+        return {};
+    }
+
+    // Чи "стабільне" читання [address, address + size): без побічних ефектів, і значення може
+    // змінитись лише від запису, події пристрою чи зовнішнього входу (не саме собою з часом).
+    // Потрібно для пропуску idle-циклів; за замовчуванням — ні (консервативно).
+    virtual bool isStableRead(std::uint32_t /*address*/, std::uint32_t /*size*/) { return false; }
+
+    // Чи 32-бітне слово за address — лічильник циклів: читається без побічних ефектів і росте рівно
+    // на 1 за виконану інструкцію (за модулем 2^32), доки в нього не пишуть. За замовчуванням — ні.
+    virtual bool isCycleCounter(std::uint32_t /*address*/) { return false; }
 };
 
 }  // namespace elsim::core
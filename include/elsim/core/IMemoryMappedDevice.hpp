@@ -22,6 +22,42 @@ class IMemoryMappedDevice {
     // Запис 1 байта в девайс.
     // offset — це зсув від базової MMIO-адреси девайса.
     virtual void write8(std::uint32_t offset, std::uint8_t value) = 0;
+
+    // Широкі транзакції (little-endian). MemoryBus викликає їх лише тоді, коли весь
+    // діапазон [offset, offset + N) лежить усередині девайса. Базова реалізація
+    // розбиває доступ на read8/write8 від молодшого байта до старшого; девайси з
+    // 16/32-бітними регістрами можуть перевизначити їх і обробити доступ атомарно.
+    virtual std::uint16_t read16(std::uint32_t offset) {
+        const std::uint32_t b0 = read8(offset + 0);
+        const std::uint32_t b1 = read8(offset + 1);
+        return static_cast<std::uint16_t>(b0 | (b1 << 8));
+    }
+
+    virtual std::uint32_t read32(std::uint32_t offset) {
+        const std::uint32_t b0 = read8(offset + 0);
+        const std::uint32_t b1 = read8(offset + 1);
+        const std::uint32_t b2 = read8(offset + 2);
+        const std::uint32_t b3 = read8(offset + 3);
+        return b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
+    }
+
+    virtual void write16(std::uint32_t offset, std::uint16_t value) {
+        write8(offset + 0, static_cast<std::uint8_t>(value & 0xFFu));
+        write8(offset + 1, static_cast<std::uint8_t>((value >> 8) & 0xFFu));
+    }
+
+    virtual void write32(std::uint32_t offset, std::uint32_t value) {
+        write8(offset + 0, static_cast<std::uint8_t>(value & 0xFFu));
+        write8(offset + 1, static_cast<std::uint8_t>((value >> 8) & 0xFFu));
+        write8(offset + 2, static_cast<std::uint8_t>((value >> 16) & 0xFFu));
+        write8(offset + 3, static_cast<std::uint8_t>((value >> 24) & 0xFFu));
+    }
+
+    // Читання девайса без побічних ефектів і не залежать від часу (див. IMemoryBus::isStableRead).
+    virtual bool hasStableReads() const { return false; }
+
+    // 32-бітний регістр за offset — лічильник циклів (див. IMemoryBus::isCycleCounter).
+    virtual bool isCycleCounter(std::uint32_t /*offset*/) const { return false; }
 };
 
 }  // namespace elsim::core
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace elsim::core {
+
+// Джерело зовнішнього впливу на плату.
+enum class InputKind : std::uint8_t {
+    GpioLevel = 1,  // GpioController::injectInput: channel — пін, value — рівень (0/1)
+};
+
+// Один зовнішній вплив із точним симульованим часом (SimClock::now() на момент подачі).
+struct InputEvent {
+    std::uint64_t cycle{0};
+    InputKind kind{InputKind::GpioLevel};
+    std::uint32_t channel{0};
+    std::uint32_t value{0};
+
+    bool operator==(const InputEvent&) const = default;
+};
+
+/**
+ * @brief Запис зовнішніх впливів сесії для детермінованого відтворення.
+ *
+ * Simulator::startRecording() наповнює лог, Simulator::startReplay() подає ті самі впливи
+ * на тих самих циклах — без очікування реального часу, на повній швидкості симуляції.
+ *
+ * Файл (little-endian): u32 magic "ELRP", u32 версія (1), рядок — ім'я плати, u32 кількість подій,
+ * далі події: LEB128 дельта циклу від попередньої, u8 kind, LEB128 channel, LEB128 value.
+ * Типова подія займає 4-6 байт.
+ */
+class InputLog {
+   public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    InputLog() = default;
+    explicit InputLog(std::string boardName) : boardName_(std::move(boardName)) {}
+
+    // Події мають іти в порядку неспадання cycle; інакше std::invalid_argument.
+    void append(const InputEvent& event);
+
+    [[nodiscard]] const std::vector<InputEvent>& events() const noexcept { return events_; }
+    [[nodiscard]] std::size_t size() const noexcept { return events_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return events_.empty(); }
+
+    [[nodiscard]] const std::string& boardName() const noexcept { return boardName_; }
+
+    [[nodiscard]] std::vector<std::uint8_t> serialize() const;
+    // Кидає std::runtime_error на чужому, обрізаному чи пошкодженому вмісті.
+    static InputLog deserialize(std::span<const std::uint8_t> bytes);
+
+    void saveToFile(const std::string& path) const;
+    static InputLog loadFromFile(const std::string& path);
+
+   private:
+    std::string boardName_;
+    std::vector<InputEvent> events_;
+};
+
+}  // namespace elsim::core
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace elsim::core {
+
+class SimClock;
+
+// Звернення інструкції до пам'яті (LOAD/STORE), яке потрапляє в запис трасування.
+enum class TraceMemAccess : std::uint8_t { None = 0, Read = 1, Write = 2 };
+
+// Один запис трасування: фіксовані 32 байти, у файлі — little-endian у порядку полів.
+struct TraceRecord {
+    std::uint64_t cycle{0};        // SimClock::now() на початку інструкції
+    std::uint32_t pc{0};
+    std::uint32_t instruction{0};  // сире 32-бітне слово
+    std::uint32_t memAddress{0};   // лише якщо memAccess != None
+    std::uint32_t memValue{0};
+    TraceMemAccess memAccess{TraceMemAccess::None};
+    std::uint8_t reserved[7]{};
+
+    bool operator==(const TraceRecord&) const = default;
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must stay 32 bytes: it is the on-disk record");
+
+/**
+ * @brief Двійкове трасування інструкцій: lock-free кільце + фоновий запис у файл великими блоками.
+ *
+ * CPU (єдиний producer) кладе записи через push() — без м'ютексів і форматування, лише копія
+ * 32 байт і атомарний зсув голови. Фоновий потік (єдиний consumer) скидає кільце у файл блоками
+ * по kFlushBlockRecords. Якщо кільце заповнене, push() чекає, доки потік звільнить місце:
+ * трасування повне, записи не губляться.
+ *
+ * Файл: заголовок 16 байт (u32 magic "ELTR", u32 версія, u32 розмір запису = 32, u32 0),
+ * далі записи до кінця файлу. Читає його TraceReader / `elsim trace-dump`.
+ */
+class TraceWriter {
+   public:
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kDefaultRingRecords = std::size_t{1} << 16;  // 2 MiB
+    static constexpr std::size_t kFlushBlockRecords = std::size_t{1} << 12;   // 128 KiB на один запис у файл
+
+    // ringRecords — степінь двійки, не менше kFlushBlockRecords (інакше std::invalid_argument).
+    // Кидає std::runtime_error, якщо файл не відкривається.
+    explicit TraceWriter(const std::string& path, std::size_t ringRecords = kDefaultRingRecords);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Джерело поля cycle (Simulator прив'язує свій SimClock); без клока — порядковий номер запису.
+    void attachClock(const SimClock* clock) noexcept { clock_ = clock; }
+    [[nodiscard]] std::uint64_t now() const noexcept;
+
+    void push(const TraceRecord& record) noexcept {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        while (head - tail_.load(std::memory_order_acquire) == ring_.size()) {
+            std::this_thread::yield();  // кільце повне — чекаємо фоновий запис
+        }
+        ring_[head & mask_] = record;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Дописати все з кільця, зупинити потік і закрити файл. Кидає std::runtime_error,
+    // якщо запис у файл не вдався. Повторний виклик нічого не робить.
+    void close();
+
+    [[nodiscard]] std::uint64_t recordCount() const noexcept { return head_.load(std::memory_order_relaxed); }
+
+   private:
+    void flushLoop();
+
+    std::string path_;
+    std::FILE* file_{nullptr};
+    const SimClock* clock_{nullptr};
+
+    std::vector<TraceRecord> ring_;
+    std::uint64_t mask_{0};
+
+    // head_ пише лише producer, tail_ — лише consumer; окремі кеш-лінії, щоб не заважати одне одному.
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    std::atomic<bool> closing_{false};
+    std::atomic<bool> failed_{false};
+
+    std::thread flusher_;
+};
+
+/**
+ * @brief Послідовне читання файлу трасування блоками.
+ */
+class TraceReader {
+   public:
+    // Кидає std::runtime_error, якщо файл не відкривається або це не файл трасування.
+    explicit TraceReader(const std::string& path);
+
+    // Наступний запис; false — кінець файлу. Обрізаний останній запис — std::runtime_error.
+    bool next(TraceRecord& out);
+
+   private:
+    std::string path_;
+    std::ifstream file_;
+    std::vector<std::uint8_t> buffer_;
+    std::size_t position_{0};
+};
+
+// Мнемоніка opcode FakeCPU ("STORE"); nullopt — невідомий opcode.
+std::optional<std::string_view> traceOpcodeName(std::uint8_t opcode) noexcept;
+
+// Opcode за мнемонікою (без урахування регістру); nullopt — невідома мнемоніка.
+std::optional<std::uint8_t> traceOpcodeFromName(std::string_view name) noexcept;
+
+// Дизасемблер одного слова FakeCPU ("STORE R1, [R0 + 256]"); pc — для цілі переходу.
+std::string disassembleInstruction(std::uint32_t raw, std::uint32_t pc);
+
+// Текстовий рядок запису: цикл, PC, сире слово, дизасемблер і звернення до пам'яті.
+std::string formatTraceRecord(const TraceRecord& record);
+
+}  // namespace elsim::core
@@ -2,8 +2,15 @@
 
 #include <mutex>
 #include <ostream>
+#include <sstream>
 #include <string_view>
 
+// ELSIM_LOG_STRIP_DEBUG=1 (CMake-опція ELSIM_STRIP_DEBUG_LOGS) повністю вирізає Debug-логи,
+// зроблені через макроси ELSIM_LOG_*: повідомлення навіть не компілюються в перевірку рівня.
+#ifndef ELSIM_LOG_STRIP_DEBUG
+#define ELSIM_LOG_STRIP_DEBUG 0
+#endif
+
 namespace elsim::core {
 
 enum class LogLevel { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
@@ -17,6 +24,9 @@ class Logger {
     void set_level(LogLevel level) noexcept;
     LogLevel level() const noexcept;
 
+    // Чи буде повідомлення цього рівня виведене (дешева перевірка перед форматуванням).
+    bool isEnabled(LogLevel level) const noexcept { return level >= current_level_; }
+
     // Базовий метод логування
     void log(LogLevel level, std::string_view component, std::string_view message);
 
@@ -41,3 +51,35 @@ class Logger {
 std::string_view to_string(LogLevel level);
 
 }  // namespace elsim::core
+
+// ----------------------------------------------
+// Макроси логування для гарячих шляхів
+// ----------------------------------------------
+//
+// Повідомлення задається як ланцюжок для operator<< і форматується лише тоді,
+// коли рівень увімкнено:
+//
+//   ELSIM_LOG_DEBUG("CPU", "FETCH32 addr=0x" << std::hex << address);
+//
+// Для складнішого форматування (snprintf тощо) — перевірка ELSIM_LOG_ENABLED(level).
+
+#if ELSIM_LOG_STRIP_DEBUG
+#define ELSIM_LOG_ENABLED(level) \
+    ((level) != ::elsim::core::LogLevel::Debug && ::elsim::core::Logger::instance().isEnabled(level))
+#else
+#define ELSIM_LOG_ENABLED(level) (::elsim::core::Logger::instance().isEnabled(level))
+#endif
+
+#define ELSIM_LOG(level, component, message)                                                \
+    do {                                                                                    \
+        if (ELSIM_LOG_ENABLED(level)) {                                                     \
+            std::ostringstream elsimLogStream_;                                             \
+            elsimLogStream_ << message;                                                     \
+            ::elsim::core::Logger::instance().log(level, component, elsimLogStream_.str()); \
+        }                                                                                   \
+    } while (false)
+
+#define ELSIM_LOG_DEBUG(component, message) ELSIM_LOG(::elsim::core::LogLevel::Debug, component, message)
+#define ELSIM_LOG_INFO(component, message) ELSIM_LOG(::elsim::core::LogLevel::Info, component, message)
+#define ELSIM_LOG_WARN(component, message) ELSIM_LOG(::elsim::core::LogLevel::Warn, component, message)
+#define ELSIM_LOG_ERROR(component, message) ELSIM_LOG(::elsim::core::LogLevel::Error, component, message)
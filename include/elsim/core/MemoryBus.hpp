@@ -1,35 +1,170 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "elsim/core/FileView.hpp"
+#include "elsim/core/HostMemory.hpp"
+#include "elsim/core/IMemoryBus.hpp"
 #include "elsim/core/IMemoryMappedDevice.hpp"
+#include "elsim/core/Logger.hpp"
 
 // MemoryBus
 // ---------
 // Модуль пам'яті, який поєднує:
-//  - звичайну RAM (масив байтів),
+//  - регіони пам'яті (RAM, ROM/flash, TCM...) за довільними базовими адресами, вирівняними на сторінку,
+//    з правами читання/запису/виконання на кожну сторінку;
 //  - набір MMIO-девайсів, змеплених у певні діапазони адрес.
 //
+// Декодування адреси — через двохрівневу таблицю сторінок (4 KiB) над усім 32-бітним простором:
+// кожна сторінка знає хост-адресу своєї пам'яті (якщо вона є), свої права і чи є в ній MMIO-девайс
+// (і який саме). Вміст усіх регіонів лежить підряд в одному сховищі (ram()), кожен регіон — з
+// вирівняного на сторінку зсуву. Сховище — HostMemory: фізична пам'ять виділяється лише під сторінки,
+// в які писали, тож задекларована RAM (declaredBytes) може бути набагато більшою за зайняту (residentBytes).
+//
 // При читанні/записі байта:
 //  1. Спочатку шукається MMIO-девайс, що закриває адресу.
 //  2. Якщо девайс знайдено — делегуємо операцію йому.
-//  3. Якщо ні — працюємо з RAM.
-//  4. Якщо адреса за межами RAM — кидаємо exception.
+//  3. Якщо ні — працюємо з пам'яттю регіону; права сторінки перевіряються (R для читання, W для запису,
+//     X для fetch32). Порушення прав — std::runtime_error.
+//  4. Якщо адреса не належить жодному регіону — кидаємо std::out_of_range.
+//
+// 16/32-бітні транзакції (little-endian):
+//  - весь діапазон в одній сторінці пам'яті — одне читання/запис буфера;
+//  - весь діапазон усередині одного девайса — один виклик read16/read32/write16/write32 девайса;
+//  - інакше (перетин межі сторінки, девайса або кінця регіону) — послідовність read8/write8 від молодшого байта,
+//    тобто рівно та сама поведінка, що й при ручному розбитті на байти.
+//
+// Широкі транзакції вбудовані (inline): доступ до пам'яті без девайсів у сторінці — один запис таблиці
+// сторінок і memcpy прямо в коді виклику (FakeCpuT<MemoryBus>); решта — у MemoryBus.cpp.
 namespace elsim::core {
 
 class MemoryBus {
    public:
-    // Створюємо шину з заданим розміром RAM у байтах.
+    // Права доступу до сторінок пам'яті (бітова маска).
+    using Permissions = std::uint8_t;
+    static constexpr Permissions kRead = 1u << 0;
+    static constexpr Permissions kWrite = 1u << 1;
+    static constexpr Permissions kExecute = 1u << 2;
+    static constexpr Permissions kReadWriteExecute = kRead | kWrite | kExecute;
+
+    // Регіон пам'яті в глобальному адресному просторі.
+    struct Region {
+        std::string name;
+        std::uint32_t base{0};      // вирівняна на kPageSize
+        std::uint64_t size{0};      // байтів; кінець може бути посеред сторінки
+        Permissions permissions{0};  // права, з якими регіон змеплено (protect() змінює окремі сторінки)
+        std::size_t offset{0};      // зсув вмісту регіону в ram()
+        std::string image{};        // файл-образ, з якого відображено вміст (mapImage()), інакше порожньо
+        std::uint64_t imageSize{0};    // розмір образу на момент підключення
+        std::uint64_t imageDigest{0};  // FNV-1a вмісту образу на момент підключення (checkpoint звіряє його)
+    };
+
+    // Шина без пам'яті: регіони додаються mapRegion(), девайси — mapDevice().
+    MemoryBus() = default;
+
+    // Шина з одним регіоном RAM "ram" [0, size) з правами rwx.
     explicit MemoryBus(std::size_t size);
 
+    MemoryBus(const MemoryBus&) = delete;
+    MemoryBus& operator=(const MemoryBus&) = delete;
+
     // Читання 1 байта з глобальної адреси.
     std::uint8_t read8(std::uint32_t address) const;
 
     // Запис 1 байта в глобальну адресу.
     void write8(std::uint32_t address, std::uint8_t value);
 
+    // Широкі транзакції (little-endian), див. опис вище.
+    std::uint16_t read16(std::uint32_t address) const {
+        std::uint16_t value;
+        return tryReadFast<kRead>(address, value) ? value : readWide<std::uint16_t>(address, kRead);
+    }
+
+    std::uint32_t read32(std::uint32_t address) const {
+        std::uint32_t value;
+        return tryReadFast<kRead>(address, value) ? value : readWide<std::uint32_t>(address, kRead);
+    }
+
+    // Fetch інструкції: як read32, але сторінка пам'яті має бути виконуваною (X), а не читабельною.
+    std::uint32_t fetch32(std::uint32_t address) const {
+        std::uint32_t value;
+        return tryReadFast<kExecute>(address, value) ? value : readWide<std::uint32_t>(address, kExecute);
+    }
+
+    void write16(std::uint32_t address, std::uint16_t value) {
+        if (!tryWriteFast(address, value)) {
+            writeWide<std::uint16_t>(address, value);
+        }
+    }
+
+    void write32(std::uint32_t address, std::uint32_t value) {
+        if (!tryWriteFast(address, value)) {
+            writeWide<std::uint32_t>(address, value);
+        }
+    }
+
+    // --- Регіони пам'яті ---
+    //
+    // Додати регіон [base, base + size) з правами permissions. Вимоги: base вирівняна на kPageSize,
+    // size > 0, регіон не виходить за 32-бітний простір і не перетинається з іншими регіонами
+    // (інакше std::invalid_argument). Девайси можуть перекривати регіон — вони мають пріоритет.
+    // Нова пам'ять заповнена нулями. Вікна hostWindow(), видані раніше, стають недійсними.
+    void mapRegion(std::string name, std::uint32_t base, std::uint64_t size, Permissions permissions) {
+        addRegion(std::move(name), base, size, permissions, {});
+    }
+
+    // Те саме, але вміст регіону — файл-образ imagePath (ROM/flash), відображений у пам'ять без копіювання
+    // (див. HostMemory::mapFile): незмінені сторінки спільні зі сторінковим кешем ОС, тож кілька симуляторів
+    // з однією прошивкою тримають її в пам'яті один раз. Запис (loadBytes(), регіон з правом w) змінює лише
+    // приватну копію сторінки, не файл. Хвіст регіону за кінцем файла — нулі. Файл більший за регіон —
+    // std::invalid_argument; файл не відкривається — std::runtime_error.
+    void mapImage(std::string name, std::uint32_t base, std::uint64_t size, const std::string& imagePath,
+                  Permissions permissions) {
+        addRegion(std::move(name), base, size, permissions, imagePath);
+    }
+
+    // Змінити права сторінок, що перетинають [address, address + size): address вирівняна на kPageSize,
+    // size > 0, усі сторінки належать регіонам (інакше std::invalid_argument). Як і mapDevice, змінює
+    // карту пам'яті: CPU з кешованими вікнами треба скинути (FakeCpu::invalidateDecodeCache).
+    void protect(std::uint32_t address, std::uint64_t size, Permissions permissions);
+
+    [[nodiscard]] const std::vector<Region>& regions() const noexcept { return m_regions; }
+
+    // Регіон, що містить address, або nullptr.
+    [[nodiscard]] const Region* findRegion(std::uint32_t address) const noexcept;
+
+    // Вміст регіону (частина ram()).
+    [[nodiscard]] std::span<const std::uint8_t> regionBytes(const Region& region) const noexcept {
+        return m_memory.bytes().subspan(region.offset, static_cast<std::size_t>(region.size));
+    }
+
+    // Права сторінки, що містить address (0 — поза регіонами).
+    [[nodiscard]] Permissions permissionsAt(std::uint32_t address) const noexcept;
+
+    // Записати bytes з address з боку хоста (завантаження прошивки, у т.ч. в ROM): як writeBlock(), але права
+    // сторінок не перевіряються. Байт поза регіонами і девайсами — std::out_of_range.
+    void loadBytes(std::uint32_t address, std::span<const std::uint8_t> bytes);
+
+    // Блокові транзакції: те саме, що послідовність write8/read8 (ті самі права й винятки), але пам'ять
+    // копіюється memcpy посторінково, а девайси отримують вирівняні 32-бітні транзакції (краї — по байту).
+    // При винятку байти перед проблемною адресою вже передані.
+    void writeBlock(std::uint32_t address, std::span<const std::uint8_t> bytes);
+    void readBlock(std::uint32_t address, std::span<std::uint8_t> out) const;
+
+    // "rwx", "rx", "r-x", "rw"... у Permissions; порожній рядок чи інші символи — std::invalid_argument.
+    static Permissions parsePermissions(std::string_view text);
+    // Permissions у вигляді "rwx" / "r-x" / "---".
+    static std::string formatPermissions(Permissions permissions);
+
     // Підключити MMIO-девайс до діапазону [baseAddress, baseAddress + size).
     //
     // Вимоги:
@@ -37,6 +172,90 @@ class MemoryBus {
     //  - діапазон не перетинається з уже змепленими девайсами
     void mapDevice(std::uint32_t baseAddress, std::uint32_t size, std::shared_ptr<IMemoryMappedDevice> device);
 
+    // Найбільше вікно пам'яті навколо address в межах одного регіону, без MMIO-девайсів і лише зі
+    // сторінок, що дозволяють access (ReadOnly — R, ReadWrite — RW, Execute — X).
+    // Якщо address належить девайсу, лежить поза регіонами чи сторінка не має прав — порожнє вікно.
+    // ReadWrite-вікно несе облік змінених сторінок (HostMemoryWindow::pageEpochs) — хто пише через нього,
+    // відмічає сторінки сам.
+    HostMemoryWindow hostWindow(std::uint32_t address, HostAccess access = HostAccess::ReadWrite);
+
+    // Читання [address, address + size) (size <= kPageSize) стабільне: це пам'ять регіонів або один девайс
+    // з IMemoryMappedDevice::hasStableReads(). Див. IMemoryBus::isStableRead.
+    bool isStableRead(std::uint32_t address, std::uint32_t size) const;
+
+    // Слово [address, address + 4) цілком в одному девайсі, і це його лічильник циклів
+    // (IMemoryMappedDevice::isCycleCounter). Див. IMemoryBus::isCycleCounter.
+    bool isCycleCounter(std::uint32_t address) const;
+
+    // Вміст усіх регіонів пам'яті (без MMIO) підряд, кожен з Region::offset, — для checkpoint-ів
+    // і знімків стану. Для шини з одним регіоном від адреси 0 це рівно його байти.
+    // Неконстантний доступ вважає зміненою всю пам'ять.
+    std::span<const std::uint8_t> ram() const noexcept { return m_memory.bytes(); }
+    std::span<std::uint8_t> ram() noexcept;
+
+    // --- Облік змінених сторінок RAM ---
+    //
+    // Сторінки нумеруються за зсувом у ram(). Кожна сторінка пам'ятає епоху свого останнього запису через шину
+    // (write8/16/32, loadBytes, ram()) чи через ReadWrite-вікно hostWindow() (DbtCpu відмічає сторінки сам).
+    // openDirtyEpoch() починає нову епоху; dirtyPagesSince(e) — сторінки, записані в епоху e чи пізніше.
+    // Так кілька споживачів (базовий знімок, TimeTravel) відстежують зміни незалежно один від одного.
+    using DirtyEpoch = std::uint64_t;
+    DirtyEpoch openDirtyEpoch() noexcept { return ++m_epoch; }
+    [[nodiscard]] std::vector<std::uint32_t> dirtyPagesSince(DirtyEpoch epoch) const;
+    [[nodiscard]] std::size_t pageCount() const noexcept { return m_pageEpoch.size(); }
+
+    // Переписати сторінку RAM page цілком (bytes — її повний розмір; остання сторінка може бути коротшою).
+    // Сторінка відмічається записаною в поточній епосі.
+    void loadPage(std::uint32_t page, std::span<const std::uint8_t> bytes);
+
+    // --- Спостереження за записами ---
+    //
+    // Поки спостереження встановлене, кожен запис у пам'ять через шину (write8/16/32, loadBytes, writeBlock),
+    // що зачіпає [address, address + size), викликає onWrite одразу після запису — навіть якщо значення
+    // не змінилось. Записи повз шину неможливі: сторінки діапазону йдуть лише повільним шляхом і не
+    // потрапляють у ReadWrite-вікна hostWindow(). Вікна, видані раніше, про спостереження не знають, тож
+    // встановлювати його слід між запусками CPU (DbtCpu оновлює вікно на початку кожного run()).
+    // Одночасно діє одне спостереження; нове замінює попереднє.
+    void setWriteWatch(std::uint32_t address, std::uint32_t size, std::function<void()> onWrite);
+    void clearWriteWatch();
+
+    // --- Базовий знімок RAM ---
+    //
+    // markBaseline() копіює сторінки, що мають право запису (ROM/flash у знімок не потрапляють;
+    // сторінку, якій protect() дав право запису пізніше, до знімка додає сам protect());
+    // restoreBaseline() повертає до знімка лише ці сторінки, записані після нього, і повертає кількість
+    // тих, що справді відрізнялись. Регіони, підключені після знімка, не відновлюються.
+    void markBaseline();
+    std::size_t restoreBaseline();
+    [[nodiscard]] bool hasBaseline() const noexcept { return m_hasBaseline; }
+
+    // Кількість сторінок, записаних з останнього markBaseline()/restoreBaseline().
+    [[nodiscard]] std::size_t dirtyPageCount() const;
+
+    // --- Використання пам'яті хоста ---
+    //
+    // declaredBytes() — сума розмірів регіонів; residentBytes() — скільки з них справді займає фізичну
+    // пам'ять (див. HostMemory::residentBytes). Для звітів, не для гарячого шляху.
+    [[nodiscard]] std::uint64_t declaredBytes() const noexcept;
+    [[nodiscard]] std::size_t residentBytes() const { return m_memory.residentBytes(); }
+
+    // Повернути пам'ять регіонів до початкового вмісту (напр. перед відновленням checkpoint-а): RAM
+    // обнуляється з поверненням сторінок ОС, регіони з образом знову відображаються з того самого файла,
+    // що й при підключенні (дескриптор тримається відкритим), хоч би шлях відтоді й замінили.
+    // Усі сторінки вважаються записаними.
+    void resetMemory();
+
+    // [offset, offset + size) у ram() збігається з вмістом одразу після підключення регіонів:
+    // байти образу в межах файла, нулі — решта. Такі сторінки resetMemory() відтворює сам.
+    [[nodiscard]] bool isInitialContent(std::size_t offset, std::size_t size) const;
+
+    // Розмір сторінки таблиці декодування.
+    static constexpr std::uint32_t kPageBits = 12;
+    static constexpr std::uint32_t kPageSize = 1u << kPageBits;
+
+    // Місткість сховища регіонів: 4 GiB регіонів + до сторінки вирівнювання на кожен з них.
+    static constexpr std::uint64_t kMaxBackingBytes = std::uint64_t{2} << 32;
+
    private:
     // Внутрішній опис підключеного девайса.
     struct MappedDevice {
@@ -45,15 +264,168 @@ class MemoryBus {
         std::shared_ptr<IMemoryMappedDevice> device;
     };
 
-    // Власне RAM (суцільний байтовий буфер).
-    std::vector<std::uint8_t> m_memory;
+    // Вміст усіх регіонів (суцільний розріджений буфер) і їхні описи.
+    HostMemory m_memory;
+    std::vector<Region> m_regions;
+    // Образи регіонів (паралельно m_regions; nullptr — регіон без образу): еталон для isInitialContent().
+    std::vector<std::unique_ptr<const FileView>> m_images;
+
+    // Облік змінених сторінок: епоха останнього запису кожної сторінки kPageSize.
+    std::vector<DirtyEpoch> m_pageEpoch;
+    DirtyEpoch m_epoch{1};
+
+    // Базовий знімок (порожній, доки не викликано markBaseline()).
+    HostMemory m_baseline;
+    std::vector<bool> m_baselinePages;  // сторінки ram(), що увійшли в знімок (мали право запису)
+    DirtyEpoch m_baselineEpoch{1};
+    bool m_hasBaseline{false};
+
+    // Скопіювати поточний вміст сторінки page ram() у знімок (там, де вона ще нульова) і відмітити її
+    // в m_baselinePages.
+    void snapshotBaselinePage(std::size_t page);
+
+    // Спостереження за записами: [m_watchBegin, m_watchEnd) (порожній — спостереження немає).
+    std::uint64_t m_watchBegin{0};
+    std::uint64_t m_watchEnd{0};
+    std::function<void()> m_onWatchedWrite;
+
+    // Запис у [address, address + size) — повідомити спостерігача, якщо діапазони перетинаються.
+    void notifyWrite(std::uint64_t address, std::uint64_t size) const {
+        if (address < m_watchEnd && address + size > m_watchBegin) {
+            m_onWatchedWrite();
+        }
+    }
+
+    // Сторінка page перетинає діапазон спостереження.
+    bool isWatchedPage(std::uint64_t page) const noexcept {
+        return (page << kPageBits) < m_watchEnd && ((page + 1) << kPageBits) > m_watchBegin;
+    }
 
     // Список усіх MMIO-девайсів.
     std::vector<MappedDevice> m_devices;
 
+    // --- Таблиця сторінок ---
+    //
+    // Поле devices запису сторінки (PageEntry):
+    //  - kNoDevice          — у сторінці немає девайсів;
+    //  - i + 1              — сторінку перетинає рівно один девайс m_devices[i];
+    //  - kSharedPage | j    — кілька девайсів у сторінці, їхні індекси в m_sharedPages[j].
+    //
+    // Верхній рівень — 1024 вказівники на листи по 1024 записи; лист створюється лише для
+    // сторінок, де є пам'ять або девайси.
+    using PageEntry = std::uint32_t;
+    static constexpr PageEntry kNoDevice = 0;
+    static constexpr PageEntry kSharedPage = 0x80000000u;
+    static constexpr std::uint32_t kLeafBits = 10;
+    static constexpr std::uint32_t kLeafSize = 1u << kLeafBits;
+
+    struct PageSlot {
+        std::uint8_t* host{nullptr};     // хост-адреса першого байта сторінки; nullptr — пам'яті немає
+        PageEntry devices{kNoDevice};    // MMIO-девайси сторінки
+        std::uint32_t dirtyIndex{0};     // номер сторінки в ram() (облік змінених сторінок)
+        std::uint16_t limit{0};          // скільки байтів сторінки належить регіону
+        Permissions permissions{0};      // права сторінки
+        Permissions fast{0};             // права для швидкого шляху (fastPermissions)
+    };
+
+    using PageLeaf = std::array<PageSlot, kLeafSize>;
+    std::array<std::unique_ptr<PageLeaf>, kLeafSize> m_pageDirectory{};
+    std::vector<std::vector<std::uint32_t>> m_sharedPages;
+
+    // Права швидкого шляху сторінки page: без девайсів — її права, крім запису під спостереженням.
+    Permissions fastPermissions(const PageSlot& slot, std::uint64_t page) const noexcept {
+        if (slot.devices != kNoDevice) {
+            return 0;
+        }
+        return isWatchedPage(page) ? static_cast<Permissions>(slot.permissions & ~kWrite) : slot.permissions;
+    }
+
+    // Запис таблиці для сторінки, що містить address (nullptr — у сторінці нічого немає).
+    const PageSlot* pageSlot(std::uint32_t address) const noexcept {
+        const auto& leaf = m_pageDirectory[address >> (kPageBits + kLeafBits)];
+        return leaf ? &(*leaf)[(address >> kPageBits) & (kLeafSize - 1)] : nullptr;
+    }
+
+    PageSlot& ensurePageSlot(std::uint32_t page);
+
+    PageEntry pageEntry(std::uint32_t address) const noexcept {
+        const PageSlot* slot = pageSlot(address);
+        return slot != nullptr ? slot->devices : kNoDevice;
+    }
+
+    // Спільна частина loadBytes()/writeBlock(): need == 0 — права сторінок не перевіряються.
+    void copyIn(std::uint32_t address, std::span<const std::uint8_t> bytes, Permissions need, const char* operation);
+    static void checkBlockRange(std::uint32_t address, std::size_t size, const char* operation);
+
+    // Спільна частина mapRegion()/mapImage(): imagePath порожній — регіон заповнено нулями.
+    void addRegion(std::string name, std::uint32_t base, std::uint64_t size, Permissions permissions,
+                   const std::string& imagePath);
+
+    // Перерахувати host/dirtyIndex сторінок усіх регіонів (після зміни m_memory).
+    void refreshRegionPages();
+
+    // Перерахувати PageSlot::fast сторінок діапазону [begin, end) (після зміни спостереження за записами).
+    void refreshFastPermissions(std::uint64_t begin, std::uint64_t end);
+
+    // Додати девайс m_devices[index] у всі сторінки діапазону [base, end).
+    void addDevicePages(std::uint32_t index, std::uint64_t base, std::uint64_t end);
+
     // Пошук девайса за глобальною адресою.
     // Повертає вказівник на MappedDevice або nullptr, якщо не знайдено.
     const MappedDevice* findDevice(std::uint32_t address) const;
+
+    // Перший девайс, що перетинається з діапазоном [address, address + size), або nullptr.
+    const MappedDevice* findOverlap(std::uint32_t address, std::uint32_t size) const;
+
+    // Сторінка пам'яті з байтом address (девайси вже виключені): перевіряє, що байт належить регіону
+    // (std::out_of_range), і права need (std::runtime_error). operation — ім'я методу для повідомлення.
+    const PageSlot& memorySlot(std::uint32_t address, Permissions need, const char* operation) const;
+
+    // read8 з правом need (kRead або kExecute для побайтового fetch32).
+    std::uint8_t readByte(std::uint32_t address, Permissions need, const char* operation) const;
+
+    // Спільна реалізація широких транзакцій (N = 2 або 4); need — kRead або kExecute.
+    template <typename T>
+    T readWide(std::uint32_t address, Permissions need) const;
+    template <typename T>
+    void writeWide(std::uint32_t address, T value);
+
+    // Швидкий шлях широкої транзакції: [address, address + sizeof(T)) в одній сторінці пам'яті з правом need
+    // і без девайсів. false — треба readWide/writeWide (MMIO, межа сторінки чи регіону, права, big-endian хост
+    // або debug-лог шини).
+    template <Permissions Need, typename T>
+    const PageSlot* fastSlot(std::uint32_t address) const noexcept {
+        if constexpr (std::endian::native != std::endian::little) {
+            return nullptr;
+        }
+        const PageSlot* slot = pageSlot(address);
+        if (slot == nullptr || (slot->fast & Need) == 0 ||
+            (address & (kPageSize - 1)) + sizeof(T) > slot->limit || ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+            return nullptr;
+        }
+        return slot;
+    }
+
+    template <Permissions Need, typename T>
+    bool tryReadFast(std::uint32_t address, T& value) const noexcept {
+        const PageSlot* slot = fastSlot<Need, T>(address);
+        if (slot == nullptr) {
+            return false;
+        }
+        std::memcpy(&value, slot->host + (address & (kPageSize - 1)), sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    bool tryWriteFast(std::uint32_t address, T value) noexcept {
+        const PageSlot* slot = fastSlot<kWrite, T>(address);
+        if (slot == nullptr) {
+            return false;
+        }
+        m_pageEpoch[slot->dirtyIndex] = m_epoch;
+        std::memcpy(slot->host + (address & (kPageSize - 1)), &value, sizeof(T));
+        return true;
+    }
 };
 
 }  // namespace elsim::core
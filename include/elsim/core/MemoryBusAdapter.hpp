@@ -14,6 +14,17 @@ class MemoryBusAdapter : public IMemoryBus {
 
     std::uint8_t read8(std::uint32_t address) override;
     void write8(std::uint32_t address, std::uint8_t value) override;
+    std::uint16_t read16(std::uint32_t address) override;
+    std::uint32_t read32(std::uint32_t address) override;
+    std::uint32_t fetch32(std::uint32_t address) override;
+    void write16(std::uint32_t address, std::uint16_t value) override;
+    void write32(std::uint32_t address, std::uint32_t value) override;
+    HostMemoryWindow hostWindow(std::uint32_t address, HostAccess access = HostAccess::ReadWrite) override;
+    bool isStableRead(std::uint32_t address, std::uint32_t size) override;
+    bool isCycleCounter(std::uint32_t address) override;
+
+    // MemoryBus під адаптером — FakeCpuT<MemoryBus> викликає її напряму, минаючи віртуальні методи.
+    [[nodiscard]] MemoryBus* target() const noexcept { return bus_; }
 
    private:
     // Не володіємо MemoryBus, просто вказівник.
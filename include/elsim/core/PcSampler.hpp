@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+
+namespace elsim::core {
+
+class SymbolMap;
+
+/**
+ * @brief Семпли гостьового PC, зняті кожні interval симульованих циклів (Simulator::startSampling).
+ *
+ * На відміну від ExecutionProfile, не рахує кожну інструкцію: Simulator лише закінчує пакет CPU
+ * на циклі наступного семплу, тож семплінг працює з будь-яким CPU (і з DbtCpu) майже без втрат швидкості.
+ *
+ * writeCollapsedStacks() видає формат "collapsed stacks" (`кадр;кадр;... кількість` на рядок),
+ * який читають flamegraph.pl, speedscope, inferno тощо. Стек адреси береться з SymbolMap;
+ * адреса поза символами (або без карти) — один кадр `0x0000abcd`.
+ */
+class PcSampler {
+   public:
+    static constexpr std::uint64_t kDefaultInterval = 1000;
+
+    // interval > 0, інакше std::invalid_argument.
+    explicit PcSampler(std::uint64_t interval = kDefaultInterval);
+
+    void record(std::uint32_t pc) {
+        ++samples_[pc];
+        ++total_;
+    }
+
+    [[nodiscard]] std::uint64_t interval() const noexcept { return interval_; }
+    [[nodiscard]] std::uint64_t sampleCount() const noexcept { return total_; }
+    // Кількість семплів на PC, за зростанням адреси.
+    [[nodiscard]] const std::map<std::uint32_t, std::uint64_t>& samples() const noexcept { return samples_; }
+
+    // Рядки відсортовані за стеком, однакові стеки різних PC об'єднані.
+    void writeCollapsedStacks(std::ostream& out, const SymbolMap* symbols = nullptr) const;
+
+   private:
+    std::uint64_t interval_;
+    std::uint64_t total_{0};
+    std::map<std::uint32_t, std::uint64_t> samples_;
+};
+
+}  // namespace elsim::core
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 #include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/SymbolMap.hpp"
 
 namespace elsim::core {
 /**
@@ -30,10 +32,10 @@ static_assert(sizeof(ElsimBinaryHeader) == 12, "ElsimBinaryHeader must be exactl
  * ProgramLoader відповідає за завантаження файлів формату elsim-bin у MemoryBus.
  *
  * Завдання:
- *  - прочитати заголовок ElsimBinaryHeader з файлу;
- *  - провалідувати magic та code_size;
- *  - прочитати code_size байт коду;
- *  - записати байти коду в память через MemoryBus, починаючи з адреси entry_point;
+ *  - відобразити файл у пам'ять (mmap на POSIX; інакше — прочитати в буфер);
+ *  - провалідувати заголовок ElsimBinaryHeader (magic, code_size, чи не обрізаний файл) прямо у відображенні;
+ *  - скопіювати code_size байт коду з відображення в MemoryBus (loadBytes), починаючи з адреси entry_point,
+ *    без проміжної копії всього коду;
  *  - повернути entryPoint через вихідний параметр для подальшого встановлення PC у CPU.
  *
  * У разі помилок (файл не відкрився, некоректний формат, обрізаний код,
@@ -53,9 +55,22 @@ class ProgramLoader {
      *                   зчитана з поля header.entry_point.
      *
      * @throws std::runtime_error у разі помилки вводу/виводу або некоректного формату.
-     * @throws std::out_of_range, якщо MemoryBus::write8 викине виняток при виході за межі RAM.
+     * @throws std::out_of_range, якщо код виходить за межі пам'яті (MemoryBus::loadBytes).
      */
     void loadBinary(const std::string& path, MemoryBus& memory, std::uint32_t& entryPoint);
+
+    /**
+     * Шлях до sidecar-файлу символів програми: `prog.elsim-bin` -> `prog.sym` (поруч з бінарником).
+     */
+    static std::string symbolSidecarPath(const std::string& binaryPath);
+
+    /**
+     * Завантажує необов'язкову карту символів програми з sidecar-файлу (формат — SymbolMap).
+     *
+     * @return nullopt, якщо sidecar-файлу немає.
+     * @throws std::runtime_error, якщо файл є, але пошкоджений.
+     */
+    std::optional<SymbolMap> loadSidecarSymbols(const std::string& binaryPath) const;
 };
 
 }  // namespace elsim::core
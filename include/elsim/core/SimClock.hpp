@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+#include "elsim/core/ICpu.hpp"
+
+namespace elsim::core {
+
+/**
+ * @brief Глобальний симульований час для пристроїв.
+ *
+ * now() — скільки циклів минуло від завантаження плати, з точністю до інструкції навіть
+ * посеред пакету ICpu::run(): до лічильника Simulator додається ICpu::retiredInRun().
+ * Час монотонний: перезапуск start() не повертає його назад.
+ *
+ * Клок належить Simulator; пристрої отримують вказівник через IDevice::attachClock().
+ */
+class SimClock {
+   public:
+    SimClock() = default;
+
+    // Прив'язати до лічильника циклів Simulator і CPU, що зараз виконує код.
+    void bind(const std::uint64_t* cycles, const ICpu* cpu) noexcept {
+        cycles_ = cycles;
+        cpu_ = cpu;
+        epoch_ = 0;
+    }
+
+    // Лічильник Simulator переходить на нове значення (start() скидає його в 0):
+    // зсуваємо епоху, щоб now() не змінився.
+    void rebase(std::uint64_t oldCycles, std::uint64_t newCycles) noexcept { epoch_ += oldCycles - newCycles; }
+
+    // Встановити поточний час (відновлення checkpoint-у поза run()).
+    void setNow(std::uint64_t now) noexcept {
+        const std::uint64_t cycles = cycles_ != nullptr ? *cycles_ : 0;
+        epoch_ = now - cycles;
+    }
+
+    [[nodiscard]] std::uint64_t now() const noexcept {
+        const std::uint64_t cycles = cycles_ != nullptr ? *cycles_ : 0;
+        const std::uint64_t inRun = cpu_ != nullptr ? cpu_->retiredInRun() : 0;
+        return epoch_ + cycles + inRun;
+    }
+
+   private:
+    const std::uint64_t* cycles_{nullptr};
+    const ICpu* cpu_{nullptr};
+    std::uint64_t epoch_{0};
+};
+
+}  // namespace elsim::core
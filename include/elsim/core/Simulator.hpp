@@ -4,11 +4,19 @@
 #include <iosfwd>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "elsim/core/EventScheduler.hpp"
+#include "elsim/core/ExecutionProfile.hpp"
 #include "elsim/core/GpioController.hpp"
 #include "elsim/core/ICpu.hpp"
+#include "elsim/core/InputLog.hpp"
 #include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/PcSampler.hpp"
+#include "elsim/core/SimClock.hpp"
 #include "elsim/device/IDevice.hpp"
 
 namespace elsim {
@@ -19,25 +27,52 @@ class VirtualButtonDevice;
 namespace elsim::core {
 
 class BoardDescription;
+class StateReader;
+class StateWriter;
+class TraceWriter;
 
 /**
- * @brief Головний цикл симуляції: виконує крок CPU та оновлює всі пристрої.
+ * @brief Головний цикл симуляції: виконує крок CPU та будить пристрої на їхніх подіях.
  *
  * Simulator сам створює CPU/RAM/пристрої
  * на основі BoardDescription у методі loadBoard().
+ *
+ * Пристрої тактуються через EventScheduler: кожен пристрій повідомляє, через скільки циклів
+ * його треба розбудити (IDevice::cyclesUntilNextEvent), і отримує advance() лише на цьому циклі.
+ * Пасивні пристрої (kNoEvent) не тікаються; MMIO-запис у пристрій змушує перепитати його розклад.
  */
 class Simulator {
    public:
+    // Квант за замовчуванням: скільки інструкцій CPU виконує між синхронізаціями пристроїв у start().
+    static constexpr std::uint64_t kDefaultQuantum = 1000;
+
+    // Режим start():
+    //  - Exact    — кожна інструкція виконується;
+    //  - SkipIdle — idle-цикли опитування (ICpu::setIdleLoopSkipping) перемотуються до наступної
+    //               події пристрою або maxCycles; стан CPU і cycleCount() ті самі, що в Exact.
+    enum class RunMode { Exact, SkipIdle };
+
     explicit Simulator(std::ostream& log = std::cout);
     ~Simulator();
 
     /// Ініціалізує плату на основі опису: CPU, RAM, пристрої, MemoryBus (MMIO).
     void loadBoard(const BoardDescription& board);
 
-    void start(std::uint64_t maxCycles = 0);
+    /// Головний цикл: CPU виконує інструкції пакетами (ICpu::run) до найближчої події пристрою,
+    /// але не більше quantum(); після пакету розбуджуються пристрої, чий цикл настав.
+    /// У режимі SkipIdle пакет обмежують лише подія та maxCycles (quantum() — якщо обох немає).
+    void start(std::uint64_t maxCycles = 0, RunMode mode = RunMode::Exact);
     void stop();
     void runOneTick();
 
+    /// Виконати рівно cycles циклів (менше — лише через HALT) від поточного стану, без скидання
+    /// cycleCount() і без логів start(). Основа детермінованого replay (TimeTravel). Повертає виконане.
+    std::uint64_t runFor(std::uint64_t cycles);
+
+    /// Розмір кванту (у циклах/інструкціях) для start(). Має бути > 0.
+    void setQuantum(std::uint64_t quantum);
+    [[nodiscard]] std::uint64_t quantum() const noexcept;
+
     // Доступ до компонентів симулятора
     ICpu* cpu() noexcept;
     const ICpu* cpu() const noexcept;
@@ -47,23 +82,156 @@ class Simulator {
     [[nodiscard]] bool isRunning() const noexcept;
     [[nodiscard]] std::uint64_t cycleCount() const noexcept;
 
+    /// Скільки з cycleCount() останнього start() пропущено перемотуванням idle-циклів.
+    [[nodiscard]] std::uint64_t skippedCycles() const noexcept;
+
+    /// Глобальний час пристроїв (монотонний, точний і посеред пакету CPU).
+    [[nodiscard]] const SimClock& clock() const noexcept;
+
+    /// Зберегти повний стан плати (CPU, RAM, GPIO, пристрої, час) у двійковий файл.
+    /// Формат — docs/checkpoint_format.md. Викликати поза start().
+    void saveCheckpoint(const std::string& path) const;
+
+    /// Відновити стан з checkpoint-у. Плата має бути завантажена loadBoard() з тим самим
+    /// описом (RAM і список пристроїв перевіряються); тип CPU може відрізнятись.
+    /// Кидає std::runtime_error на пошкодженому чи несумісному файлі.
+    void loadCheckpoint(const std::string& path);
+
+    /// Стан плати без RAM (CPU, GPIO, пристрої, час) у форматі checkpoint-у — для знімків у пам'яті.
+    /// RAM окремо веде викликач через облік змінених сторінок MemoryBus.
+    [[nodiscard]] std::vector<std::uint8_t> saveMachineState() const;
+    void loadMachineState(std::span<const std::uint8_t> state);
+
+    /// Запам'ятати поточний стан плати як базовий (зазвичай одразу після завантаження програми).
+    void markBaseline();
+
+    /// Повернути плату до базового стану без перебудови: CPU, пристрої, GPIO і час — з компактного
+    /// знімка, RAM — лише сторінки, змінені після markBaseline(). Повертає кількість відновлених сторінок.
+    /// Кидає std::runtime_error, якщо markBaseline() не викликали після loadBoard().
+    std::size_t resetToBaseline();
+
+    /// Запис зовнішніх впливів: кожен GpioController::injectInput() (кнопки, тести) потрапляє в лог
+    /// з точним SimClock::now(). stopRecording() повертає накопичене й зупиняє запис.
+    void startRecording();
+    InputLog stopRecording();
+    [[nodiscard]] bool isRecording() const noexcept;
+
+    /// Відтворення лога: start()/runFor()/runOneTick() подають кожну подію рівно на її циклі
+    /// (пакет CPU закінчується на наступній події) — без очікування реального часу.
+    /// Кидає std::runtime_error, якщо лог записано на іншій платі або його події вже в минулому.
+    /// Відновлення стану (checkpoint, TimeTravel) переставляє відтворення на поточний час.
+    void startReplay(InputLog log);
+    void stopReplay() noexcept;
+    /// Чи лишились неподані події.
+    [[nodiscard]] bool isReplaying() const noexcept;
+
+    /// Двійкове трасування кожної виконаної інструкції у файл (формат — InstructionTrace.hpp).
+    /// Поки воно увімкнене, CPU не згортає й не пропускає цикли. Кидає std::runtime_error,
+    /// якщо файл не відкривається або CPU не підтримує трасування (DbtCpu).
+    void startTrace(const std::string& path);
+    /// Дописати й закрити файл трасування; повертає кількість записів (0 — трасування не було).
+    std::uint64_t stopTrace();
+    [[nodiscard]] bool isTracing() const noexcept { return trace_ != nullptr; }
+
+    /// Профіль виконання (лічильники на opcode і PC по RAM плати) — наповнюється, доки не викликано
+    /// stopProfile(). Поки він увімкнений, CPU не згортає й не пропускає цикли.
+    /// Кидає std::runtime_error, якщо CPU не підтримує профілювання (DbtCpu).
+    void startProfile();
+    /// Зупинити профілювання й повернути накопичене (nullopt — профілювання не було).
+    std::optional<ExecutionProfile> stopProfile();
+    [[nodiscard]] bool isProfiling() const noexcept { return profile_ != nullptr; }
+    /// Звіт ExecutionProfile::report() з дизасемблером із RAM; no-op, якщо профілювання вимкнене.
+    void printProfile(std::ostream& out, std::size_t topCount = ExecutionProfile::kDefaultTopCount) const;
+
+    /// Семплінг PC: на кожному циклі, кратному interval (SimClock::now()), PC наступної інструкції
+    /// потрапляє в PcSampler. Пакети CPU закінчуються на циклі семплу, тож цикли не згортаються
+    /// лише на цій межі; працює з будь-яким CPU. Кидає std::invalid_argument на interval == 0.
+    void startSampling(std::uint64_t interval = PcSampler::kDefaultInterval);
+    /// Зупинити семплінг і повернути семпли (nullopt — семплінгу не було).
+    std::optional<PcSampler> stopSampling();
+    [[nodiscard]] bool isSampling() const noexcept { return sampler_.has_value(); }
+
     std::shared_ptr<const elsim::core::GpioController> gpioController() const noexcept;
     std::vector<const elsim::VirtualLedDevice*> ledDevices() const;
     std::vector<elsim::VirtualButtonDevice*> buttonDevices();
     std::vector<const elsim::VirtualButtonDevice*> buttonDevices() const;
 
    private:
+    // Додати cycles до лічильника циклів і розбудити пристрої, чия подія настала.
+    void syncDevices(std::uint64_t cycles);
+
+    // Догнати пристрої до cycleCount_, перейти на цикл cycle і заново запланувати всі пристрої.
+    void resetDeviceSchedule(std::uint64_t cycle);
+
+    // Спільний цикл start()/runFor(): пакети CPU до абсолютного cycleCount_ == endCycle
+    // (EventScheduler::kNever — без ліміту), HALT або stop(). Повертає Halted або BudgetExhausted.
+    StopReason runUntil(std::uint64_t endCycle, bool skipIdle);
+
+    // Подати всі події replay-лога з cycle <= clock_.now().
+    void injectDueInputs();
+
+    // Цикл наступної неподаної події replay-лога (EventScheduler::kNever — немає).
+    [[nodiscard]] std::uint64_t nextInputCycle() const noexcept;
+
+    // Зняти семпл PC, якщо настав його цикл, і запланувати наступний.
+    void takeDueSample();
+
+    // Поставити наступну подію пристрою index (або позначити його пасивним).
+    void scheduleDevice(std::size_t index);
+
+    // MMIO-запис у пристрій index (можливо, посеред пакета CPU): перепитати cyclesUntilNextEvent()
+    // від поточного циклу. Пасивний пристрій стає тактованим, тактованому подія лише наближається.
+    void rescheduleDevice(std::size_t index);
+
+    // Серіалізація стану плати (основа checkpoint-ів).
+    // includeRam = false — без чанка RAM (базовий стан, де RAM відновлює MemoryBus).
+    void writeState(StateWriter& out, bool includeRam) const;
+    void readState(StateReader& in, bool includeRam);
+
     // Логування
     std::ostream& log_;
 
     // Стан симуляції
     bool running_{false};
     std::uint64_t cycleCount_{0};
+    std::uint64_t skippedCycles_{0};
+    std::uint64_t quantum_{kDefaultQuantum};
+    SimClock clock_;
+
+    // Опис плати, з яким звіряються checkpoint-и.
+    std::string boardName_;
+    std::vector<std::string> deviceNames_;
+
+    // Стан без RAM, збережений markBaseline() (порожній — базового стану немає).
+    std::vector<std::uint8_t> baselineState_;
+
+    // Запис і відтворення зовнішніх впливів; replayPos_ — перша неподана подія replay_.
+    bool recording_{false};
+    InputLog recorded_;
+    InputLog replay_;
+    std::size_t replayPos_{0};
+
+    // Активне трасування інструкцій (CPU тримає сирий вказівник на нього).
+    std::unique_ptr<TraceWriter> trace_;
+
+    // Активний профіль виконання (CPU тримає сирий вказівник на нього).
+    std::unique_ptr<ExecutionProfile> profile_;
+
+    // Семплінг PC; nextSampleCycle_ — цикл наступного семплу (кратний інтервалу).
+    std::optional<PcSampler> sampler_;
+    std::uint64_t nextSampleCycle_{0};
 
     // "Залізо" плати
     std::unique_ptr<MemoryBus> memoryBus_;
     std::unique_ptr<ICpu> cpu_;
     std::vector<std::unique_ptr<elsim::IDevice>> devices_;
+
+    // Тактування пристроїв: події в scheduler_ несуть індекс у devices_;
+    // deviceSyncCycle_[i] — цикл останнього advance() пристрою i (kNoEvent — пасивний);
+    // deviceDeadline_[i] — цикл його актуальної події (події з іншим циклом застарілі).
+    EventScheduler scheduler_;
+    std::vector<std::uint64_t> deviceSyncCycle_;
+    std::vector<std::uint64_t> deviceDeadline_;
     std::shared_ptr<elsim::core::GpioController> gpio_;
 };
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace elsim::core {
+
+/**
+ * Двійкова серіалізація стану симулятора (checkpoint-и, знімки).
+ *
+ * Усі числа — little-endian фіксованої ширини, рядки — u32 довжина + байти.
+ * Дані групуються в чанки: u32 tag + u32 size + size байт payload (див. docs/checkpoint_format.md).
+ * StateReader перевіряє межі й кидає std::runtime_error на обрізаних даних.
+ */
+
+// Тег чанка з чотирьох ASCII-символів, напр. makeChunkTag("CPU ").
+constexpr std::uint32_t makeChunkTag(const char (&text)[5]) noexcept {
+    return static_cast<std::uint32_t>(static_cast<std::uint8_t>(text[0])) |
+           (static_cast<std::uint32_t>(static_cast<std::uint8_t>(text[1])) << 8) |
+           (static_cast<std::uint32_t>(static_cast<std::uint8_t>(text[2])) << 16) |
+           (static_cast<std::uint32_t>(static_cast<std::uint8_t>(text[3])) << 24);
+}
+
+class StateWriter {
+   public:
+    void writeU8(std::uint8_t value);
+    void writeU16(std::uint16_t value);
+    void writeU32(std::uint32_t value);
+    void writeU64(std::uint64_t value);
+    void writeBool(bool value) { writeU8(value ? 1u : 0u); }
+    void writeBytes(std::span<const std::uint8_t> bytes);
+    void writeString(const std::string& text);
+    // LEB128: 7 біт на байт, старший біт — "далі ще байт". Малі числа (дельти циклів) займають 1-2 байти.
+    void writeVarU64(std::uint64_t value);
+
+    // Почати чанк: пише тег і місце під розмір; повертає позицію для endChunk().
+    std::size_t beginChunk(std::uint32_t tag);
+    // Закрити чанк: дописати розмір payload, записаного після beginChunk().
+    void endChunk(std::size_t position);
+
+    [[nodiscard]] const std::vector<std::uint8_t>& data() const noexcept { return buffer_; }
+    [[nodiscard]] std::vector<std::uint8_t> release() noexcept { return std::move(buffer_); }
+
+   private:
+    std::vector<std::uint8_t> buffer_;
+};
+
+class StateReader {
+   public:
+    explicit StateReader(std::span<const std::uint8_t> data) noexcept : data_(data) {}
+
+    std::uint8_t readU8();
+    std::uint16_t readU16();
+    std::uint32_t readU32();
+    std::uint64_t readU64();
+    bool readBool() { return readU8() != 0; }
+    std::span<const std::uint8_t> readBytes(std::size_t count);
+    std::string readString();
+    std::uint64_t readVarU64();
+
+    // Наступний чанк: тег і окремий reader над його payload (основний reader переходить за чанк).
+    struct Chunk {
+        std::uint32_t tag;
+        std::span<const std::uint8_t> payload;
+    };
+    Chunk readChunk();
+
+    [[nodiscard]] std::size_t remaining() const noexcept { return data_.size() - position_; }
+    [[nodiscard]] bool atEnd() const noexcept { return position_ == data_.size(); }
+
+   private:
+    std::span<const std::uint8_t> take(std::size_t count);
+
+    std::span<const std::uint8_t> data_;
+    std::size_t position_{0};
+};
+
+}  // namespace elsim::core
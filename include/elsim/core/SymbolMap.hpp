@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace elsim::core {
+
+/**
+ * @brief Карта символів гостьового коду: діапазони адрес [start, end) -> імена функцій.
+ *
+ * Діапазони можуть вкладатися один в одного, але не перетинатися частково. У ISA FakeCPU
+ * поки немає викликів, тож "стек" адреси — ланцюжок діапазонів, що її містять, від
+ * найширшого до найвужчого: `main` 0x0..0x100 з вкладеним `delay` 0x40..0x60 дає для
+ * PC = 0x48 стек main;delay.
+ *
+ * Текстовий формат (sidecar `.sym` до `.elsim-bin`, див. docs/elsim_binary_format.md):
+ * рядок `<start> <end> <name>`, числа — десяткові або 0x-hex, `#` — коментар до кінця рядка.
+ */
+class SymbolMap {
+   public:
+    struct Symbol {
+        std::uint32_t start{0};
+        std::uint32_t end{0};  // не включно
+        std::string name;
+
+        bool operator==(const Symbol&) const = default;
+    };
+
+    // end > start, name без пробілів і ';' (роздільник кадрів collapsed-стеків); діапазон або
+    // вкладається в уже наявні, або не перетинається з ними. Інакше std::invalid_argument.
+    void add(std::uint32_t start, std::uint32_t end, std::string name);
+
+    // Кидають std::runtime_error з номером рядка на синтаксичній помилці чи недопустимому діапазоні.
+    static SymbolMap parse(std::istream& in, const std::string& sourceName = "<symbols>");
+    static SymbolMap loadFromFile(const std::string& path);
+
+    // Символи за зростанням start (при рівному start — ширший раніше).
+    [[nodiscard]] const std::vector<Symbol>& symbols() const noexcept { return symbols_; }
+    [[nodiscard]] bool empty() const noexcept { return symbols_.empty(); }
+
+    // Імена діапазонів, що містять pc, від зовнішнього до внутрішнього (порожньо — поза символами).
+    [[nodiscard]] std::vector<std::string_view> stackAt(std::uint32_t pc) const;
+
+   private:
+    std::vector<Symbol> symbols_;
+};
+
+}  // namespace elsim::core
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "elsim/core/HostMemory.hpp"
+#include "elsim/core/MemoryBus.hpp"
+
+namespace elsim::core {
+
+class Simulator;
+
+/**
+ * @brief Зворотне виконання (time-travel) поверх Simulator: періодичні знімки + детермінований replay.
+ *
+ * run() виконує плату вперед і кожні interval циклів кладе в обмежене кільце легкий знімок:
+ * стан без RAM (Simulator::saveMachineState) і лише сторінки RAM, змінені з попереднього знімка
+ * (облік епох MemoryBus). Найстаріший знімок при витісненні вливається в повний базовий образ RAM.
+ *
+ * Навігація назад (gotoCycle, stepBack, runBackToWrite) відновлює найближчий знімок не пізніше
+ * цілі й доганяє ціль через Simulator::runFor() — виконання детерміноване, тож стан той самий,
+ * що й при першому проході. Час — SimClock::now().
+ *
+ * Зовнішні впливи (injectInput, запис у шину з тестів) дозволені лише між викликами run():
+ * run() починається зі знімка, тож replay ніколи не перетинає таку зміну. Після навігації назад
+ * run() продовжує вже нову гілку історії — знімки "з майбутнього" відкидаються.
+ * Відтворення InputLog (Simulator::startReplay) теж детерміноване: події подаються всередині runFor().
+ */
+class TimeTravel {
+   public:
+    static constexpr std::uint64_t kDefaultInterval = 100'000;
+    static constexpr std::size_t kDefaultCapacity = 64;
+
+    // sim має бути з уже завантаженою платою; TimeTravel не володіє ним.
+    // Поки TimeTravel живий, плату не можна перезавантажувати (loadBoard) — він тримає посилання на шину.
+    // interval > 0, capacity >= 2.
+    explicit TimeTravel(Simulator& sim, std::uint64_t interval = kDefaultInterval,
+                        std::size_t capacity = kDefaultCapacity);
+
+    // Виконати cycles циклів уперед (менше — лише через HALT), знімаючи знімки. Повертає виконане.
+    std::uint64_t run(std::uint64_t cycles);
+
+    // Перейти в момент cycle. Назад — у межах історії (не раніше oldestCycle()), уперед — як run().
+    // false — ціль раніше за oldestCycle() (стан тоді не змінюється) або недосяжна через HALT.
+    bool gotoCycle(std::uint64_t cycle);
+
+    // На count інструкцій назад.
+    bool stepBack(std::uint64_t count = 1);
+
+    // Назад до останньої інструкції, що писала в RAM [address, address + size) (хоч би й те саме значення):
+    // стан — прямо перед нею, тобто наступний крок уперед знову виконує цей запис. Записи ловить
+    // MemoryBus::setWriteWatch; сегменти між знімками проганяються цілком, від найновішого, до першого
+    // з записом. Повертає цикл зупинки або nullopt (у збереженій історії записів не було — стан тоді
+    // не змінюється).
+    std::optional<std::uint64_t> runBackToWrite(std::uint32_t address, std::uint32_t size = 4);
+
+    [[nodiscard]] std::uint64_t now() const noexcept;
+    [[nodiscard]] std::uint64_t oldestCycle() const noexcept;
+    [[nodiscard]] std::size_t snapshotCount() const noexcept { return snapshots_.size(); }
+
+   private:
+    struct PageImage {
+        std::uint32_t page;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    struct Snapshot {
+        std::uint64_t cycle;
+        std::vector<std::uint8_t> machine;  // Simulator::saveMachineState()
+        std::vector<PageImage> pages;       // сторінки, змінені з попереднього знімка (за зростанням page)
+    };
+
+    // Зняти знімок поточного стану з уже отриманим станом машини
+    // (поточний стан походить від anchor_ == останній знімок).
+    void takeSnapshot(std::vector<std::uint8_t> machine);
+
+    // Сторінки, що могли змінитись з моменту знімка anchor_.
+    std::vector<std::uint32_t> pagesChangedSinceAnchor() const;
+
+    // Вміст сторінки page на момент знімка index.
+    std::span<const std::uint8_t> pageAt(std::size_t index, std::uint32_t page) const;
+
+    // Відновити знімок index (RAM + стан машини).
+    void restore(std::size_t index);
+
+    // Індекс останнього знімка з cycle <= target (snapshots_ не порожній, target >= oldestCycle()).
+    std::size_t snapshotAtOrBefore(std::uint64_t target) const;
+
+    // Відкинути знімки після anchor_ і все, що було після поточного моменту (нова гілка історії).
+    void truncateFuture();
+
+    Simulator& sim_;
+    MemoryBus& bus_;
+    std::uint64_t interval_;
+    std::size_t capacity_;
+
+    std::deque<Snapshot> snapshots_;
+    HostMemory baseRam_;  // RAM на момент snapshots_.front()
+
+    // Знімок, від якого походить поточний стан, і епоха MemoryBus, відкрита одразу після нього.
+    std::size_t anchor_{0};
+    MemoryBus::DirtyEpoch anchorEpoch_{0};
+
+    // Найпізніший момент поточної гілки історії (куди можна повернутись replay-ем).
+    std::uint64_t headCycle_{0};
+
+    // Стан на кінець останнього run(): якщо до наступного run() він не змінився ззовні,
+    // новий знімок на старті не потрібен.
+    struct RunEnd {
+        bool valid{false};
+        std::uint64_t cycle{0};
+        std::vector<std::uint8_t> machine;
+        MemoryBus::DirtyEpoch epoch{0};
+    };
+    RunEnd lastRun_;
+};
+
+}  // namespace elsim::core
@@ -20,6 +20,12 @@ class GpioDevice final : public BaseDevice {
     void write(std::uint32_t offset, std::uint8_t value) override;
     void tick() override;
 
+    // Поведінки в часі немає — Simulator не тікає цей пристрій.
+    std::uint64_t cyclesUntilNextEvent() const override { return kNoEvent; }
+
+    // DATA_IN змінюється лише зовнішнім входом, решта регістрів — записами CPU.
+    bool readsAreStable() const override { return true; }
+
     std::uint32_t pinCount() const noexcept { return pinCount_; }
 
    private:
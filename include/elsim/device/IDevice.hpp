@@ -1,11 +1,21 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
+
+namespace elsim::core {
+class SimClock;
+class StateReader;
+class StateWriter;
+}  // namespace elsim::core
 
 namespace elsim {
 
 class IDevice {
    public:
+    // Значення cyclesUntilNextEvent() для пристроїв без поведінки в часі.
+    static constexpr std::uint64_t kNoEvent = std::numeric_limits<std::uint64_t>::max();
+
     virtual ~IDevice() = default;
 
     // Читання одного байта з регістру/офсету всередині пристрою.
@@ -16,6 +26,42 @@ class IDevice {
 
     // Один "крок часу" для пристрою (оновлення внутрішнього стану).
     virtual void tick() = 0;
+
+    // Просунути час пристрою одразу на cycles тіків (Simulator будить пристрій лише на його
+    // подіях і передає весь час, що минув з попереднього пробудження). Базова реалізація
+    // еквівалентна cycles викликам tick(); пристрої з простим станом можуть перевизначити її арифметикою.
+    virtual void advance(std::uint64_t cycles) {
+        for (std::uint64_t i = 0; i < cycles; ++i) {
+            tick();
+        }
+    }
+
+    // Через скільки циклів від поточного пристрій треба розбудити наступного разу (>= 1).
+    // Simulator питає це після кожного пробудження й після кожного MMIO-запису в пристрій
+    // і ставить подію в EventScheduler.
+    // kNoEvent — пристрій пасивний (уся логіка в read/write): його не тікають, доки запис не змінить відповідь.
+    // Базова реалізація — 1, тобто тік кожного циклу, як у старому головному циклі.
+    virtual std::uint64_t cyclesUntilNextEvent() const { return 1; }
+
+    // Simulator передає свій глобальний клок одразу після створення пристрою.
+    // Пристрій, що рахує час від клока, може не тікатись зовсім (див. TimerDevice).
+    virtual void attachClock(const core::SimClock* /*clock*/) {}
+
+    // true — read() не має побічних ефектів, а значення регістрів змінюються лише від write(),
+    // advance() чи зовнішнього входу (GPIO-кнопка), але не самі собою з часом.
+    // Такі регістри CPU може опитувати в idle-циклі, який Simulator перемотує до наступної події.
+    virtual bool readsAreStable() const { return false; }
+
+    // true — 32-бітний регістр за offset читається без побічних ефектів і росте рівно на 1 за цикл
+    // (за модулем 2^32), доки його не змінить write(). Цикл, що опитує такий лічильник, CPU перемотує
+    // одразу до ітерації, на якій лічильник досягне потрібного значення (див. ICpu::setIdleLoopSkipping).
+    virtual bool isCycleCounter(std::uint32_t /*offset*/) const { return false; }
+
+    // Checkpoint: внутрішній стан пристрою, якого не видно з GpioController і пам'яті.
+    // loadState() читає рівно те, що записав saveState(); розмір стану не залежить від значень (Simulator
+    // звіряє з ним payload checkpoint-а до loadState()). Пристрої без власного стану не перевизначають.
+    virtual void saveState(core::StateWriter& /*out*/) const {}
+    virtual void loadState(core::StateReader& /*in*/) {}
 };
 
 }  // namespace elsim
@@ -4,9 +4,17 @@
 
 #include "BaseDevice.hpp"
 #include "elsim/core/Logger.hpp"
+#include "elsim/core/SimClock.hpp"
 
 namespace elsim {
 
+// Таймер: COUNTER рахує цикли з останнього reset (CONTROL=1).
+//
+// Якщо підключено SimClock (так робить Simulator), лічильник лінивий: reset запам'ятовує
+// базовий цикл, а COUNTER обчислюється при читанні як now() - base. Між читаннями таймер
+// нічого не коштує; Simulator будить його лише на межах m_logPeriod, і то лише коли ввімкнені Debug-логи
+// (увімкнені пізніше Simulator помічає на наступному записі в таймер або start()).
+// Без клока (окремий пристрій у тестах) лічильник, як і раніше, росте в tick()/advance().
 class TimerDevice : public BaseDevice {
    public:
     static constexpr std::uint32_t RegisterSize = 8;  // COUNTER(4) + CONTROL(4)
@@ -22,10 +30,28 @@ class TimerDevice : public BaseDevice {
     std::uint8_t read(std::uint32_t offset) override;
     void write(std::uint32_t offset, std::uint8_t value) override;
     void tick() override;
+    void advance(std::uint64_t cycles) override;
+    std::uint64_t cyclesUntilNextEvent() const override;
+    void attachClock(const core::SimClock* clock) override;
+    void saveState(core::StateWriter& out) const override;
+    void loadState(core::StateReader& in) override;
+
+    // З клоком COUNTER — лінивий лічильник циклів (now() - base), без нього росте лише від tick().
+    bool isCycleCounter(std::uint32_t offset) const override {
+        return m_clock != nullptr && offset == REG_COUNTER;
+    }
+
+    // Поточне значення регістру COUNTER.
+    std::uint32_t counter() const;
 
    private:
-    std::uint32_t m_counter = 0;    // внутрішній лічильник тікiв
+    void logTick(std::uint32_t value) const;
+
+    std::uint32_t m_counter = 0;    // внутрішній лічильник тікiв (режим без клока)
     std::uint32_t m_logPeriod = 0;  // період логування, 0 = вимкнено
+
+    const core::SimClock* m_clock = nullptr;  // глобальний час; nullptr — лічильник ведуть tick()/advance()
+    std::uint64_t m_baseCycle = 0;            // цикл клока, на якому COUNTER дорівнював 0
 };
 
 }  // namespace elsim
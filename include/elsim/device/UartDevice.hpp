@@ -27,6 +27,12 @@ class UartDevice : public BaseDevice {
     void write(std::uint32_t offset, std::uint8_t value) override;
     void tick() override;
 
+    // Поведінки в часі немає — Simulator не тікає цей пристрій.
+    std::uint64_t cyclesUntilNextEvent() const override { return kNoEvent; }
+
+    // RX ще не моделюється: читання завжди повертає 0.
+    bool readsAreStable() const override { return true; }
+
    private:
     // Пізніше тут будуть внутрішні поля:
     //  - TX buffer
@@ -27,6 +27,11 @@ class VirtualButtonDevice final : public BaseDevice {
     std::uint8_t read(std::uint32_t /*offset*/) override { return 0; }
     void write(std::uint32_t /*offset*/, std::uint8_t /*value*/) override {}
     void tick() override {}  // no timing
+    std::uint64_t cyclesUntilNextEvent() const override { return kNoEvent; }
+
+    // Рівень на піні відновлює GpioController; тут лише стан самої кнопки.
+    void saveState(core::StateWriter& out) const override;
+    void loadState(core::StateReader& in) override;
 
    private:
     bool levelForPressed_(bool pressed) const noexcept;
@@ -25,6 +25,7 @@ class VirtualLedDevice final : public BaseDevice {
     std::uint8_t read(std::uint32_t /*offset*/) override { return 0; }
     void write(std::uint32_t /*offset*/, std::uint8_t /*value*/) override {}
     void tick() override {}
+    std::uint64_t cyclesUntilNextEvent() const override { return kNoEvent; }
 
    private:
     std::shared_ptr<elsim::core::GpioController> gpio_;
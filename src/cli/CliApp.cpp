@@ -8,6 +8,7 @@
 #include "commands/MonitorCommand.hpp"
 #include "commands/PressCommand.hpp"
 #include "commands/RunCommand.hpp"
+#include "commands/TraceDumpCommand.hpp"
 
 namespace elsim::cli {
 
@@ -71,6 +72,12 @@ int CliApp::run(const std::vector<std::string>& args) {
         return cmd.execute(subargs);
     }
 
+    if (first == "trace-dump") {
+        TraceDumpCommand cmd;
+        std::vector<std::string> subargs(args.begin() + 2, args.end());
+        return cmd.execute(subargs);
+    }
+
     // Unknown command
     std::cerr << "Unknown command: " << first << "\n";
     std::cerr << "Run: elsim help\n";
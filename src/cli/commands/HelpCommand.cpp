@@ -17,6 +17,7 @@ void printGeneralHelp() {
     std::cout << "  list-boards List available example board YAML files.\n";
     std::cout << "  monitor     Watch GPIO/LED state (one-shot or periodic).\n";
     std::cout << "  press       Press a virtual button (inject GPIO input).\n";
+    std::cout << "  trace-dump  Decode a binary instruction trace to text.\n";
     std::cout << "  help        Show help (general or per-command).\n\n";
 
     std::cout << "Aliases:\n";
@@ -72,6 +73,7 @@ void printHelpHelp() {
     std::cout << "  help\n";
     std::cout << "  monitor\n";
     std::cout << "  press\n";
+    std::cout << "  trace-dump\n";
 }
 
 }  // namespace
@@ -114,6 +116,15 @@ int HelpCommand::execute(const std::vector<std::string>& args) {
         std::cout << "Run: elsim press --help\n";
         return 0;
     }
+    if (cmd == "trace-dump") {
+        std::cout << "elsim trace-dump\n\n";
+        std::cout << "Decodes a binary instruction trace (elsim run --trace <path>) to text.\n\n";
+        std::cout << "Usage:\n";
+        std::cout << "  elsim trace-dump <trace-file> [--from <cycle>] [--to <cycle>] [--pc <addr>[:<addr>]] "
+                     "[--opcode <name>] [--mem] [--limit <n>] [--format <text|csv>]\n\n";
+        std::cout << "Run: elsim trace-dump --help\n";
+        return 0;
+    }
 
     std::cerr << "Unknown command for help: " << cmd << "\n";
     std::cerr << "Run: elsim help\n";
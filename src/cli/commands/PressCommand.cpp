@@ -28,7 +28,7 @@ constexpr int kExitRuntimeError = 2;
 void printUsage() {
     std::cerr << "Usage:\n";
     std::cerr << "  elsim press --config <path> --button <name> [--program <path>] [--hold-ms <N>] [--steps <K>] "
-                 "[--repeat <R>]\n";
+                 "[--repeat <R>] [--record-inputs <path>]\n";
 }
 
 bool parseU64(std::string_view s, std::uint64_t& out) {
@@ -106,7 +106,7 @@ void PressCommand::printHelp() {
     std::cout << "Presses a virtual button from board.yaml during simulation.\n\n";
     std::cout << "Usage:\n";
     std::cout << "  elsim press --config <path> --button <name> [--program <path>] [--hold-ms <N>] [--steps <K>] "
-                 "[--repeat <R>]\n\n";
+                 "[--repeat <R>] [--record-inputs <path>]\n\n";
     std::cout << "Options:\n";
     std::cout << "  --config <path>       Required. Path to board YAML config.\n";
     std::cout << "  --button <name>       Required. Button name (devices[].name).\n";
@@ -114,6 +114,8 @@ void PressCommand::printHelp() {
     std::cout << "  --hold-ms <N>         Optional. Hold duration in ms (default: 100).\n";
     std::cout << "  --steps <K>           Optional. CPU steps after press and after release (default: 100).\n";
     std::cout << "  --repeat <R>          Optional. Repeat press R times (default: 1).\n";
+    std::cout << "  --record-inputs <path> Optional. Save presses/releases with their simulated cycles\n";
+    std::cout << "                        (replay with: elsim run --replay-inputs <path>).\n";
     std::cout << "  --help                Show this help.\n";
 }
 
@@ -140,6 +142,8 @@ int PressCommand::execute(const std::vector<std::string>& args) {
     std::uint64_t steps = 100;
     std::uint64_t repeat = 1;
 
+    std::string recordPath;
+
     // Parse args
     for (std::size_t i = 0; i < args.size(); ++i) {
         std::string_view a = args[i];
@@ -204,6 +208,13 @@ int PressCommand::execute(const std::vector<std::string>& args) {
                 return kExitUsageError;
             }
             repeat = v;
+        } else if (a == "--record-inputs") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for --record-inputs\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            recordPath = args[++i];
         } else {
             std::cerr << "Unknown argument: " << a << "\n";
             printUsage();
@@ -270,6 +281,10 @@ int PressCommand::execute(const std::vector<std::string>& args) {
         std::cout << "Pressed button '" << btn->name() << "' (hold " << holdMs << "ms, steps " << steps << ", repeat "
                   << repeat << ")\n";
 
+        if (!recordPath.empty()) {
+            sim.startRecording();
+        }
+
         for (std::uint64_t i = 0; i < repeat; ++i) {
             btn->press();
             runSteps(sim, steps);
@@ -286,6 +301,12 @@ int PressCommand::execute(const std::vector<std::string>& args) {
             }
         }
 
+        if (!recordPath.empty()) {
+            const auto inputs = sim.stopRecording();
+            inputs.saveToFile(recordPath);
+            std::cout << "Recorded " << inputs.size() << " input(s) to '" << recordPath << "'\n";
+        }
+
         return kExitSuccess;
 
     } catch (const elsim::core::BoardConfigException& ex) {
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <string>
@@ -60,10 +61,30 @@ elsim::core::BoardDescription loadBoardConfig(const fs::path& configPath) {
     return board;
 }
 
+// Додатне ціле (десяткове або 0x-hex); nullopt — не число, 0 чи від'ємне.
+std::optional<std::uint64_t> parsePositive(const std::string& value) {
+    if (value.empty() || value.front() == '-') {
+        return std::nullopt;
+    }
+    try {
+        std::size_t pos = 0;
+        const std::uint64_t parsed = std::stoull(value, &pos, 0);
+        if (pos != value.size() || parsed == 0) {
+            return std::nullopt;
+        }
+        return parsed;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
 void printUsage() {
     std::cerr << "Usage:\n";
     std::cerr << "  elsim run --config <path> [--program <path>] [--log-level <trace|debug|info|warn|error|off>] "
-                 "[--dry-run]\n";
+                 "[--quantum <n>] [--max-cycles <n>] [--skip-idle]\n"
+                 "            [--load-checkpoint <path>] [--save-checkpoint <path>] [--replay-inputs <path>]\n"
+                 "            [--trace <path>] [--profile] [--flamegraph <path>] [--sample-interval <n>]\n"
+                 "            [--symbols <path>] [--dry-run]\n";
     std::cerr << "  elsim --config <path> [--program <path>] [--log-level <trace|debug|info|warn|error|off>] "
                  "[--dry-run]   (backward-compatible)\n";
 }
@@ -75,12 +96,38 @@ void RunCommand::printHelp() {
     std::cout << "Starts the simulator (same as the legacy elsim CLI).\n\n";
     std::cout << "Usage:\n";
     std::cout << "  elsim run --config <path> [--program <path>] [--log-level <trace|debug|info|warn|error|off>] "
-                 "[--dry-run]\n\n";
+                 "[--quantum <n>] [--max-cycles <n>] [--skip-idle]\n"
+                 "            [--load-checkpoint <path>] [--save-checkpoint <path>] [--replay-inputs <path>]\n"
+                 "            [--trace <path>] [--profile] [--flamegraph <path>] [--sample-interval <n>]\n"
+                 "            [--symbols <path>] [--dry-run]\n\n";
     std::cout << "Options:\n";
     std::cout << "  --config <path>            Required. Path to board YAML config.\n";
     std::cout << "  --program <path>           Optional. Path to .elsim-bin program.\n";
     std::cout
         << "  --log-level <level>        Optional. trace|debug|info|warn|error|off (default: info). trace==debug.\n";
+    if (ELSIM_LOG_STRIP_DEBUG) {
+        std::cout << "                             This build compiles out debug messages (ELSIM_STRIP_DEBUG_LOGS in a "
+                     "Release build): trace|debug print nothing extra.\n";
+    }
+    std::cout << "  --quantum <n>              Optional. Instructions executed between device syncs (default: "
+              << elsim::core::Simulator::kDefaultQuantum << "). 1 == exact per-cycle sync.\n";
+    std::cout << "  --max-cycles <n>           Optional. Stop after n cycles (default: run until HALT).\n";
+    std::cout << "  --skip-idle                Optional. Fast-forward MMIO polling loops to the next device event; "
+                 "final state and cycle count are unchanged.\n";
+    std::cout << "  --load-checkpoint <path>   Optional. Restore board state from a checkpoint before starting.\n";
+    std::cout << "  --save-checkpoint <path>   Optional. Save board state to a checkpoint when the simulation stops.\n";
+    std::cout << "  --replay-inputs <path>     Optional. Re-inject inputs recorded by 'elsim press --record-inputs' "
+                 "at their exact cycles, without wall-clock waits.\n";
+    std::cout << "  --trace <path>             Optional. Write a binary per-instruction trace "
+                 "(decode with 'elsim trace-dump').\n";
+    std::cout << "  --profile                  Optional. Count executed instructions per PC and opcode and print "
+                 "a report (hot PCs, opcode histogram, JZ/JNZ taken ratios) when the simulation stops.\n";
+    std::cout << "  --flamegraph <path>        Optional. Sample the guest PC and write collapsed stacks for "
+                 "flamegraph.pl.\n";
+    std::cout << "  --sample-interval <n>      Optional. Cycles between PC samples for --flamegraph (default: "
+              << elsim::core::PcSampler::kDefaultInterval << ").\n";
+    std::cout << "  --symbols <path>           Optional. Symbol map for --flamegraph (default: <program>.sym next to "
+                 "the program, if present).\n";
     std::cout << "  --dry-run                  Optional. Validate config/program and construct simulator, but do not "
                  "start.\n";
 }
@@ -95,6 +142,19 @@ int RunCommand::execute(const std::vector<std::string>& args) {
     fs::path programPath;
     bool hasProgram = false;
 
+    std::uint64_t quantum = elsim::core::Simulator::kDefaultQuantum;
+    bool skipIdle = false;
+    std::uint64_t maxCycles = 0;
+
+    std::string loadCheckpointPath;
+    std::string saveCheckpointPath;
+    std::string replayInputsPath;
+    std::string tracePath;
+    bool profile = false;
+    std::string flamegraphPath;
+    std::string symbolsPath;
+    std::uint64_t sampleInterval = elsim::core::PcSampler::kDefaultInterval;
+
     // Allow: "elsim run --help"
     for (std::size_t i = 0; i < args.size(); ++i) {
         std::string_view arg = args[i];
@@ -129,6 +189,51 @@ int RunCommand::execute(const std::vector<std::string>& args) {
                 return kExitUsageError;
             }
             logLevel = *lvl;
+        } else if (arg == "--quantum" || arg == "--max-cycles" || arg == "--sample-interval") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << arg << "\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            const std::string& value = args[++i];
+            const auto parsed = parsePositive(value);
+            if (!parsed) {
+                std::cerr << "Invalid value for " << arg << ": " << value << " (expected positive integer)\n";
+                return kExitUsageError;
+            }
+            (arg == "--quantum" ? quantum : arg == "--max-cycles" ? maxCycles : sampleInterval) = *parsed;
+        } else if (arg == "--load-checkpoint" || arg == "--save-checkpoint") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << arg << "\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            (arg == "--load-checkpoint" ? loadCheckpointPath : saveCheckpointPath) = args[++i];
+        } else if (arg == "--replay-inputs") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for --replay-inputs\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            replayInputsPath = args[++i];
+        } else if (arg == "--trace") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for --trace\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            tracePath = args[++i];
+        } else if (arg == "--flamegraph" || arg == "--symbols") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << arg << "\n";
+                printUsage();
+                return kExitUsageError;
+            }
+            (arg == "--flamegraph" ? flamegraphPath : symbolsPath) = args[++i];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--skip-idle") {
+            skipIdle = true;
         } else if (arg == "--dry-run") {
             dryRun = true;
         } else if (arg == "--program") {
@@ -176,6 +281,7 @@ int RunCommand::execute(const std::vector<std::string>& args) {
         // 2) Construct simulator and load board
         elsim::core::Simulator sim(std::cout);
         sim.loadBoard(board);
+        sim.setQuantum(quantum);
 
         // 3) Optionally load program
         if (hasProgram) {
@@ -203,6 +309,18 @@ int RunCommand::execute(const std::vector<std::string>& args) {
                                     "[elsim] No program specified via --program. CPU will start from its reset PC.");
         }
 
+        // 3b) Optionally restore a checkpoint (overrides the program image and CPU state)
+        if (!loadCheckpointPath.empty()) {
+            Logger::instance().info("CLI", "[elsim] Loading checkpoint from '" + loadCheckpointPath + "'");
+            sim.loadCheckpoint(loadCheckpointPath);
+        }
+
+        // 3c) Optionally replay recorded external inputs
+        if (!replayInputsPath.empty()) {
+            Logger::instance().info("CLI", "[elsim] Replaying inputs from '" + replayInputsPath + "'");
+            sim.startReplay(elsim::core::InputLog::loadFromFile(replayInputsPath));
+        }
+
         // 4) Dry-run ends here
         if (dryRun) {
             if (hasProgram) {
@@ -217,10 +335,58 @@ int RunCommand::execute(const std::vector<std::string>& args) {
         }
 
         // 5) Start simulation
-        sim.start();
+        if (!tracePath.empty()) {
+            sim.startTrace(tracePath);
+        }
+        if (profile) {
+            sim.startProfile();
+        }
+
+        std::optional<elsim::core::SymbolMap> symbols;
+        if (!flamegraphPath.empty()) {
+            if (!symbolsPath.empty()) {
+                symbols = elsim::core::SymbolMap::loadFromFile(symbolsPath);
+            } else if (hasProgram) {
+                symbols = elsim::core::ProgramLoader{}.loadSidecarSymbols(programPath.string());
+            }
+            sim.startSampling(sampleInterval);
+        }
+
+        using RunMode = elsim::core::Simulator::RunMode;
+        sim.start(maxCycles, skipIdle ? RunMode::SkipIdle : RunMode::Exact);
+
+        if (!tracePath.empty()) {
+            const auto records = sim.stopTrace();
+            Logger::instance().info(
+                "CLI", "[elsim] Trace written to '" + tracePath + "' (" + std::to_string(records) + " records)");
+        }
+        if (profile) {
+            sim.printProfile(std::cout);
+            sim.stopProfile();
+        }
+        if (!flamegraphPath.empty()) {
+            const auto samples = sim.stopSampling();
+            std::ofstream out(flamegraphPath);
+            samples->writeCollapsedStacks(out, symbols ? &*symbols : nullptr);
+            if (!out) {
+                throw std::runtime_error("failed to write '" + flamegraphPath + "'");
+            }
+            Logger::instance().info("CLI", "[elsim] Collapsed stacks written to '" + flamegraphPath + "' (" +
+                                               std::to_string(samples->sampleCount()) + " samples)");
+        }
 
         Logger::instance().info("CLI",
                                 "[elsim] Simulation finished. Total cycles: " + std::to_string(sim.cycleCount()));
+        if (const auto bus = sim.memoryBus()) {
+            Logger::instance().info("CLI", "[elsim] Guest memory: " + std::to_string(bus->residentBytes() / 1024) +
+                                               " KiB resident of " + std::to_string(bus->declaredBytes() / 1024) +
+                                               " KiB declared");
+        }
+
+        if (!saveCheckpointPath.empty()) {
+            sim.saveCheckpoint(saveCheckpointPath);
+            Logger::instance().info("CLI", "[elsim] Checkpoint saved to '" + saveCheckpointPath + "'");
+        }
         return kExitSuccess;
 
     } catch (const YAML::Exception& ex) {
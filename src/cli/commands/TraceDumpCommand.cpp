@@ -0,0 +1,191 @@
+#include "TraceDumpCommand.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "elsim/core/InstructionTrace.hpp"
+
+namespace elsim::cli {
+
+namespace {
+
+constexpr int kExitSuccess = 0;
+constexpr int kExitUsageError = 1;
+constexpr int kExitRuntimeError = 2;
+
+void printUsage() {
+    std::cerr << "Usage:\n";
+    std::cerr << "  elsim trace-dump <trace-file> [--from <cycle>] [--to <cycle>] [--pc <addr>[:<addr>]] "
+                 "[--opcode <name>] [--mem] [--limit <n>] [--format <text|csv>]\n";
+}
+
+std::optional<std::uint64_t> parseU64(std::string_view s) {
+    if (s.empty() || s.front() == '-') {
+        return std::nullopt;
+    }
+    try {
+        std::size_t pos = 0;
+        const unsigned long long v = std::stoull(std::string{s}, &pos, 0);
+        if (pos != s.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint64_t>(v);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+// Фільтр записів; усі умови поєднуються через "і".
+struct Filter {
+    std::uint64_t fromCycle{0};
+    std::uint64_t toCycle{std::numeric_limits<std::uint64_t>::max()};
+    std::uint32_t pcLow{0};
+    std::uint32_t pcHigh{std::numeric_limits<std::uint32_t>::max()};
+    std::optional<std::uint8_t> opcode;
+    bool memOnly{false};
+
+    [[nodiscard]] bool matches(const elsim::core::TraceRecord& r) const noexcept {
+        return r.cycle >= fromCycle && r.cycle <= toCycle && r.pc >= pcLow && r.pc <= pcHigh &&
+               (!opcode || static_cast<std::uint8_t>(r.instruction >> 24) == *opcode) &&
+               (!memOnly || r.memAccess != elsim::core::TraceMemAccess::None);
+    }
+};
+
+void printCsv(const elsim::core::TraceRecord& r) {
+    const char* access = r.memAccess == elsim::core::TraceMemAccess::Read    ? "R"
+                         : r.memAccess == elsim::core::TraceMemAccess::Write ? "W"
+                                                                             : "";
+    std::cout << r.cycle << ',' << r.pc << ',' << r.instruction << ',' << access << ',';
+    if (r.memAccess != elsim::core::TraceMemAccess::None) {
+        std::cout << r.memAddress << ',' << r.memValue;
+    } else {
+        std::cout << ',';
+    }
+    std::cout << '\n';
+}
+
+}  // namespace
+
+void TraceDumpCommand::printHelp() {
+    std::cout << "elsim trace-dump\n\n";
+    std::cout << "Decodes a binary instruction trace (elsim run --trace <path>) to text.\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  elsim trace-dump <trace-file> [--from <cycle>] [--to <cycle>] [--pc <addr>[:<addr>]] "
+                 "[--opcode <name>] [--mem] [--limit <n>] [--format <text|csv>]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --from <cycle>         Optional. Skip records before this cycle.\n";
+    std::cout << "  --to <cycle>           Optional. Skip records after this cycle.\n";
+    std::cout << "  --pc <addr>[:<addr>]   Optional. Only this PC (or inclusive PC range).\n";
+    std::cout << "  --opcode <name>        Optional. Only this instruction (e.g. STORE, JNZ).\n";
+    std::cout << "  --mem                  Optional. Only instructions that accessed memory (LOAD/STORE).\n";
+    std::cout << "  --limit <n>            Optional. Print at most n records.\n";
+    std::cout << "  --format <text|csv>    Optional. Output format (default: text).\n";
+    std::cout << "                         csv columns: cycle,pc,instruction,access,address,value\n";
+    std::cout << "  --help                 Show this help.\n";
+}
+
+int TraceDumpCommand::execute(const std::vector<std::string>& args) {
+    for (const auto& a : args) {
+        if (a == "--help" || a == "-h") {
+            printHelp();
+            return kExitSuccess;
+        }
+    }
+
+    std::string tracePath;
+    Filter filter;
+    std::uint64_t limit = std::numeric_limits<std::uint64_t>::max();
+    bool csv = false;
+
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        std::string_view a = args[i];
+        const bool needsValue = a == "--from" || a == "--to" || a == "--pc" || a == "--opcode" || a == "--limit" ||
+                                a == "--format";
+        if (needsValue && i + 1 >= args.size()) {
+            std::cerr << "Missing value for " << a << "\n";
+            printUsage();
+            return kExitUsageError;
+        }
+
+        if (a == "--from" || a == "--to" || a == "--limit") {
+            const auto v = parseU64(args[++i]);
+            if (!v) {
+                std::cerr << "Invalid value for " << a << " (expected non-negative integer)\n";
+                return kExitUsageError;
+            }
+            (a == "--from" ? filter.fromCycle : a == "--to" ? filter.toCycle : limit) = *v;
+        } else if (a == "--pc") {
+            const std::string_view value = args[++i];
+            const auto colon = value.find(':');
+            const auto low = parseU64(value.substr(0, colon));
+            const auto high = colon == std::string_view::npos ? low : parseU64(value.substr(colon + 1));
+            if (!low || !high || *low > *high || *high > std::numeric_limits<std::uint32_t>::max()) {
+                std::cerr << "Invalid value for --pc (expected <addr> or <low>:<high>)\n";
+                return kExitUsageError;
+            }
+            filter.pcLow = static_cast<std::uint32_t>(*low);
+            filter.pcHigh = static_cast<std::uint32_t>(*high);
+        } else if (a == "--opcode") {
+            filter.opcode = elsim::core::traceOpcodeFromName(args[++i]);
+            if (!filter.opcode) {
+                std::cerr << "Unknown opcode: " << args[i] << "\n";
+                return kExitUsageError;
+            }
+        } else if (a == "--mem") {
+            filter.memOnly = true;
+        } else if (a == "--format") {
+            const std::string_view value = args[++i];
+            if (value != "text" && value != "csv") {
+                std::cerr << "Invalid value for --format (expected text|csv)\n";
+                return kExitUsageError;
+            }
+            csv = value == "csv";
+        } else if (!a.empty() && a.front() != '-' && tracePath.empty()) {
+            tracePath = args[i];
+        } else {
+            std::cerr << "Unknown argument: " << a << "\n";
+            printUsage();
+            return kExitUsageError;
+        }
+    }
+
+    if (tracePath.empty()) {
+        std::cerr << "Missing trace file\n";
+        printUsage();
+        return kExitUsageError;
+    }
+
+    try {
+        elsim::core::TraceReader reader(tracePath);
+        elsim::core::TraceRecord record;
+        std::uint64_t printed = 0;
+
+        if (csv) {
+            std::cout << "cycle,pc,instruction,access,address,value\n";
+        }
+        while (printed < limit && reader.next(record)) {
+            if (record.cycle > filter.toCycle) {
+                break;  // записи йдуть за зростанням циклу
+            }
+            if (!filter.matches(record)) {
+                continue;
+            }
+            if (csv) {
+                printCsv(record);
+            } else {
+                std::cout << elsim::core::formatTraceRecord(record) << '\n';
+            }
+            ++printed;
+        }
+        return kExitSuccess;
+    } catch (const std::exception& ex) {
+        std::cerr << "trace-dump failed: " << ex.what() << "\n";
+        return kExitRuntimeError;
+    }
+}
+
+}  // namespace elsim::cli
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace elsim::cli {
+
+class TraceDumpCommand final {
+   public:
+    void printHelp();
+    int execute(const std::vector<std::string>& args);
+};
+
+}  // namespace elsim::cli
@@ -3,13 +3,17 @@
 #include <yaml-cpp/yaml.h>
 
 #include <cstdint>
+#include <filesystem>
 #include <set>
+#include <stdexcept>
 #include <sstream>
 #include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "elsim/core/MemoryBus.hpp"
+
 namespace elsim::core {
 
 // ===== BoardConfigException =====
@@ -151,6 +155,19 @@ CpuDescription parseCpu(const YAML::Node& root) {
         }
     }
 
+    // cpu.dispatch (опційне, за замовчуванням "switch")
+    {
+        auto dispatchNode = cpuNode["dispatch"];
+        if (dispatchNode) {
+            cpu.dispatch = readScalar<std::string>(dispatchNode, makePath(sectionPath, "dispatch"));
+            if (cpu.dispatch != "switch" && cpu.dispatch != "threaded") {
+                throwInvalidValue(makePath(sectionPath, "dispatch"), "must be 'switch' or 'threaded'");
+            }
+        } else {
+            cpu.dispatch = "switch";
+        }
+    }
+
     return cpu;
 }
 
@@ -206,6 +223,32 @@ std::vector<MemoryRegion> parseMemory(const YAML::Node& root) {
             }
         }
 
+        // permissions (опційне; лише для RAM/ROM — права MMIO задає сам девайс)
+        if (auto permNode = item["permissions"]) {
+            const std::string permPath = makePath(path.str(), "permissions");
+            region.permissions = readScalar<std::string>(permNode, permPath);
+            if (region.type == MemoryType::Mmio) {
+                throwInvalidValue(permPath, "is not supported for mmio regions");
+            }
+            try {
+                MemoryBus::parsePermissions(region.permissions);
+            } catch (const std::invalid_argument& ex) {
+                throwInvalidValue(permPath, ex.what());
+            }
+        }
+
+        // file (опційне; лише для ROM — образ прошивки, відображений у регіон)
+        if (auto fileNode = item["file"]) {
+            const std::string filePath = makePath(path.str(), "file");
+            region.file = readScalar<std::string>(fileNode, filePath);
+            if (region.type != MemoryType::Rom) {
+                throwInvalidValue(filePath, "is only supported for rom/flash regions");
+            }
+            if (region.file.empty()) {
+                throwInvalidValue(filePath, "must not be empty");
+            }
+        }
+
         regions.push_back(region);
     }
 
@@ -676,7 +719,16 @@ BoardDescription BoardConfigParser::loadFromFile(const std::string& path) {
     }
 
     // 2. Розпарсити та провалідувати структуру
-    return parseBoard(boardNode);
+    BoardDescription board = parseBoard(boardNode);
+
+    // 3. Відносні шляхи до образів ROM — від теки файла конфігурації, а не від поточної теки
+    const std::filesystem::path configDir = std::filesystem::path(path).parent_path();
+    for (auto& region : board.memory) {
+        if (!region.file.empty() && std::filesystem::path(region.file).is_relative()) {
+            region.file = (configDir / region.file).lexically_normal().string();
+        }
+    }
+    return board;
 }
 
 }  // namespace elsim::core
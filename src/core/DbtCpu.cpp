@@ -0,0 +1,859 @@
+#include "elsim/core/DbtCpu.hpp"
+
+#include <algorithm>  // std::fill, std::min, std::max
+#include <cstddef>    // offsetof
+#include <cstring>    // std::memcpy
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <utility>  // std::exchange
+
+#include "elsim/core/Logger.hpp"
+#include "elsim/core/StateStream.hpp"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#define ELSIM_DBT_HOST_SUPPORTED 1
+#else
+#define ELSIM_DBT_HOST_SUPPORTED 0
+#endif
+
+namespace elsim::core {
+
+namespace {
+
+constexpr std::string_view COMPONENT = "DBT";
+
+// Опкоди (див. docs/fakecpu_isa.md)
+constexpr std::uint8_t OPC_NOP = 0x00;
+constexpr std::uint8_t OPC_MOV = 0x01;
+constexpr std::uint8_t OPC_ADD = 0x02;
+constexpr std::uint8_t OPC_SUB = 0x03;
+constexpr std::uint8_t OPC_LOAD = 0x04;
+constexpr std::uint8_t OPC_STORE = 0x05;
+constexpr std::uint8_t OPC_JMP = 0x06;
+constexpr std::uint8_t OPC_JZ = 0x07;
+constexpr std::uint8_t OPC_JNZ = 0x08;
+constexpr std::uint8_t OPC_HALT = 0xFF;
+
+// Причина виходу з машинного коду в диспетчер (Context::exitReason).
+enum ExitReason : std::uint32_t {
+    kExitNone = 0,          // бюджет вичерпано або потрібен ще не транслований блок
+    kExitHalt = 1,          // виконано HALT
+    kExitFault = 2,         // хелпер пам'яті кинув виняток (див. pendingFault_)
+    kExitCodeModified = 3,  // STORE зачепив транслований код — кеш треба скинути
+};
+
+// Зсуви полів Context, зашиті в згенерований код як disp8 відносно rbx.
+using Context = DbtCpu::Context;
+constexpr std::uint8_t OFF_PC = 0x20;
+constexpr std::uint8_t OFF_FLAGS = 0x24;
+constexpr std::uint8_t OFF_BUDGET = 0x28;
+constexpr std::uint8_t OFF_RAM_HOST = 0x30;
+constexpr std::uint8_t OFF_RAM_BASE = 0x38;
+constexpr std::uint8_t OFF_RAM_LIMIT = 0x3C;
+constexpr std::uint8_t OFF_CODE_LOW = 0x40;
+constexpr std::uint8_t OFF_CODE_HIGH = 0x44;
+constexpr std::uint8_t OFF_EXIT = 0x48;
+constexpr std::uint8_t OFF_RAM_PAGE_OFFSET = 0x4C;
+constexpr std::uint8_t OFF_PATCH = 0x50;
+constexpr std::uint8_t OFF_RAM_EPOCHS = 0x60;
+constexpr std::uint8_t OFF_EPOCH = 0x68;
+
+static_assert(offsetof(Context, regs) == 0x00);
+static_assert(offsetof(Context, pc) == OFF_PC);
+static_assert(offsetof(Context, flags) == OFF_FLAGS);
+static_assert(offsetof(Context, budget) == OFF_BUDGET);
+static_assert(offsetof(Context, ramHost) == OFF_RAM_HOST);
+static_assert(offsetof(Context, ramBase) == OFF_RAM_BASE);
+static_assert(offsetof(Context, ramLimit) == OFF_RAM_LIMIT);
+static_assert(offsetof(Context, codeLow) == OFF_CODE_LOW);
+static_assert(offsetof(Context, codeHigh) == OFF_CODE_HIGH);
+static_assert(offsetof(Context, exitReason) == OFF_EXIT);
+static_assert(offsetof(Context, ramPageOffset) == OFF_RAM_PAGE_OFFSET);
+static_assert(offsetof(Context, patchSite) == OFF_PATCH);
+static_assert(offsetof(Context, ramEpochs) == OFF_RAM_EPOCHS);
+static_assert(offsetof(Context, epoch) == OFF_EPOCH);
+
+constexpr std::uint8_t regOffset(std::uint8_t index) noexcept { return static_cast<std::uint8_t>(index * 4u); }
+
+// Біти Z/N у FLAGS (C/V транслятор не чіпає, як і інтерпретатор).
+constexpr std::uint32_t kFlagZ = static_cast<std::uint32_t>(FakeCpu::Flag::Zero);
+constexpr std::uint32_t kFlagN = static_cast<std::uint32_t>(FakeCpu::Flag::Negative);
+
+// Верхня межа розміру машинного коду однієї гостьової інструкції (з запасом).
+constexpr std::size_t kMaxInstructionBytes = 192;
+constexpr std::size_t kMaxBlockBytes = (DbtCpu::kMaxBlockLength + 2) * kMaxInstructionBytes;
+
+// Коди умов для jcc rel32 (другий байт після 0x0F).
+constexpr std::uint8_t JCC_E = 0x84;
+constexpr std::uint8_t JCC_NE = 0x85;
+constexpr std::uint8_t JCC_AE = 0x83;
+constexpr std::uint8_t JCC_A = 0x87;
+
+// Мінімальний емітер x86-64. Регістр rbx весь час вказує на DbtCpu::Context;
+// eax/ecx/edx/esi/edi/r8 — скретч (caller-saved), тож виклики хелперів їх не зберігають.
+class Emitter {
+   public:
+    explicit Emitter(std::uint8_t* begin) : cur_(begin) {}
+
+    [[nodiscard]] std::uint8_t* cursor() const noexcept { return cur_; }
+
+    void u8(std::uint8_t v) { *cur_++ = v; }
+    void u32(std::uint32_t v) {
+        std::memcpy(cur_, &v, sizeof(v));
+        cur_ += sizeof(v);
+    }
+    void u64(std::uint64_t v) {
+        std::memcpy(cur_, &v, sizeof(v));
+        cur_ += sizeof(v);
+    }
+    void bytes(std::initializer_list<std::uint8_t> list) {
+        for (auto b : list) {
+            u8(b);
+        }
+    }
+
+    static void patchRel32(std::uint8_t* field, const std::uint8_t* target) {
+        const auto rel = static_cast<std::int32_t>(target - (field + 4));
+        std::memcpy(field, &rel, sizeof(rel));
+    }
+
+    // --- Переходи ---
+    void jmp(const std::uint8_t* target) {
+        u8(0xE9);
+        std::uint8_t* field = cur_;
+        u32(0);
+        patchRel32(field, target);
+    }
+    std::uint8_t* jmpForward() {
+        u8(0xE9);
+        std::uint8_t* field = cur_;
+        u32(0);
+        return field;
+    }
+    std::uint8_t* jccForward(std::uint8_t cc) {
+        bytes({0x0F, cc});
+        std::uint8_t* field = cur_;
+        u32(0);
+        return field;
+    }
+    void bind(std::uint8_t* field) { patchRel32(field, cur_); }
+
+    // --- Операнди [rbx + disp8] ---
+    void movEaxCtx(std::uint8_t off) { bytes({0x8B, 0x43, off}); }
+    void movEdxCtx(std::uint8_t off) { bytes({0x8B, 0x53, off}); }
+    void movCtxEax(std::uint8_t off) { bytes({0x89, 0x43, off}); }
+    void movCtxImm(std::uint8_t off, std::uint32_t imm) {
+        bytes({0xC7, 0x43, off});
+        u32(imm);
+    }
+    void addEaxCtx(std::uint8_t off) { bytes({0x03, 0x43, off}); }
+    void subEaxCtx(std::uint8_t off) { bytes({0x2B, 0x43, off}); }
+    void subEcxCtx(std::uint8_t off) { bytes({0x2B, 0x4B, off}); }
+    void cmpEaxCtx(std::uint8_t off) { bytes({0x3B, 0x43, off}); }
+    void cmpEcxCtx(std::uint8_t off) { bytes({0x3B, 0x4B, off}); }
+    void cmpEdxCtx(std::uint8_t off) { bytes({0x3B, 0x53, off}); }
+    void cmpCtxImm8(std::uint8_t off, std::uint8_t imm) { bytes({0x83, 0x7B, off, imm}); }
+    void movRdxCtx(std::uint8_t off) { bytes({0x48, 0x8B, 0x53, off}); }
+    void movR8Ctx(std::uint8_t off) { bytes({0x4C, 0x8B, 0x43, off}); }
+    void movRaxCtx(std::uint8_t off) { bytes({0x48, 0x8B, 0x43, off}); }
+    void movCtxRax(std::uint8_t off) { bytes({0x48, 0x89, 0x43, off}); }
+
+    void decBudget() { bytes({0x48, 0x83, 0x6B, OFF_BUDGET, 0x01}); }  // sub qword [rbx+budget], 1
+    void testZeroFlag() { bytes({0xF6, 0x43, OFF_FLAGS, static_cast<std::uint8_t>(kFlagZ)}); }
+
+    // --- Регістрові операції ---
+    void addEaxImm(std::uint32_t imm) {
+        u8(0x05);
+        u32(imm);
+    }
+    void subEaxImm(std::uint32_t imm) {
+        u8(0x2D);
+        u32(imm);
+    }
+    void movEcxEax() { bytes({0x89, 0xC1}); }
+    void leaEdxRaxPlus4() { bytes({0x8D, 0x50, 0x04}); }
+    void movEaxMemRdxRcx() { bytes({0x8B, 0x04, 0x0A}); }        // mov eax, [rdx + rcx]
+    void movMemR8RcxEdx() { bytes({0x41, 0x89, 0x14, 0x08}); }  // mov [r8 + rcx], edx
+    void addRdxRcx() { bytes({0x48, 0x01, 0xCA}); }
+    void leaRcxRdxPlus3() { bytes({0x48, 0x8D, 0x4A, 0x03}); }
+    void shrRdxImm(std::uint8_t imm) { bytes({0x48, 0xC1, 0xEA, imm}); }
+    void shrRcxImm(std::uint8_t imm) { bytes({0x48, 0xC1, 0xE9, imm}); }
+    void movRaxMemRax() { bytes({0x48, 0x8B, 0x00}); }             // mov rax, [rax]
+    void movMemR8Rdx8Rax() { bytes({0x49, 0x89, 0x04, 0xD0}); }  // mov [r8 + rdx*8], rax
+    void movMemR8Rcx8Rax() { bytes({0x49, 0x89, 0x04, 0xC8}); }  // mov [r8 + rcx*8], rax
+
+    // --- Виклик хелпера: rdi = ctx, esi/edx — аргументи ---
+    void movRdiRbx() { bytes({0x48, 0x89, 0xDF}); }
+    void movEsiEax() { bytes({0x89, 0xC6}); }
+    void movRaxImm64(std::uint64_t imm) {
+        bytes({0x48, 0xB8});
+        u64(imm);
+    }
+    void callRax() { bytes({0xFF, 0xD0}); }
+
+    // FLAGS.Z/N = f(eax), C/V без змін.
+    void updateZnFromEax() {
+        bytes({0x89, 0xC1});                    // mov ecx, eax
+        bytes({0xC1, 0xE9, 0x1F});              // shr ecx, 31
+        bytes({0x01, 0xC9});                    // add ecx, ecx        ; N -> біт 1
+        bytes({0x85, 0xC0});                    // test eax, eax
+        bytes({0x0F, 0x94, 0xC2});              // setz dl
+        bytes({0x0F, 0xB6, 0xD2});              // movzx edx, dl       ; Z -> біт 0
+        bytes({0x09, 0xD1});                    // or ecx, edx
+        bytes({0x83, 0x63, OFF_FLAGS, 0xFC});   // and dword [rbx+flags], ~(Z|N)
+        bytes({0x09, 0x4B, OFF_FLAGS});         // or [rbx+flags], ecx
+    }
+
+    // FLAGS.Z/N для значення, відомого на етапі трансляції.
+    void updateZnConst(std::uint32_t value) {
+        bytes({0x83, 0x63, OFF_FLAGS, 0xFC});  // and dword [rbx+flags], ~(Z|N)
+        std::uint8_t bits = 0;
+        if (value == 0) {
+            bits |= static_cast<std::uint8_t>(kFlagZ);
+        }
+        if (static_cast<std::int32_t>(value) < 0) {
+            bits |= static_cast<std::uint8_t>(kFlagN);
+        }
+        if (bits != 0) {
+            bytes({0x83, 0x4B, OFF_FLAGS, bits});  // or dword [rbx+flags], imm8
+        }
+    }
+
+   private:
+    std::uint8_t* cur_;
+};
+
+#if ELSIM_DBT_HOST_SUPPORTED
+using EnterFn = void (*)(Context*, std::uint8_t*);
+#endif
+
+}  // namespace
+
+// === Хелпери повільного шляху (викликаються зі згенерованого коду) ===
+//
+// Винятки не можна пропускати крізь кадри машинного коду, тому хелпери їх ловлять,
+// зберігають у DbtCpu::pendingFault_ і виставляють kExitFault; диспетчер прокидає виняток далі.
+struct DbtRuntime {
+    // Вікна даних немає (напр. код виконується з ROM, а RAM лежить деінде) — беремо вікно регіону,
+    // до якого щойно звернулись. Поки вікно є, MMIO-доступи сюди не заходять повторно.
+    static void adoptRamWindow(DbtCpu& cpu, std::uint32_t address) {
+        if (cpu.ctx_.ramLimit == 0) {
+            cpu.setRamWindow(cpu.memoryBus_->hostWindow(address));
+        }
+    }
+
+    static std::uint32_t load32(Context* ctx, std::uint32_t address) noexcept {
+        DbtCpu& cpu = *ctx->self;
+        try {
+            const std::uint32_t value = cpu.memoryBus_->read32(address);
+            adoptRamWindow(cpu, address);
+            return value;
+        } catch (...) {
+            cpu.pendingFault_ = std::current_exception();
+            ctx->exitReason = kExitFault;
+            return 0;
+        }
+    }
+
+    static void store32(Context* ctx, std::uint32_t address, std::uint32_t value) noexcept {
+        DbtCpu& cpu = *ctx->self;
+        try {
+            cpu.memoryBus_->write32(address, value);
+            adoptRamWindow(cpu, address);
+        } catch (...) {
+            cpu.pendingFault_ = std::current_exception();
+            ctx->exitReason = kExitFault;
+            return;
+        }
+
+        // Самомодифікований код: запис у транслований діапазон.
+        const std::uint64_t begin = address;
+        if (begin < ctx->codeHigh && begin + 4 > ctx->codeLow) {
+            ctx->exitReason = kExitCodeModified;
+        }
+    }
+};
+
+// === Транслятор одного базового блоку ===
+struct DbtTranslator {
+    DbtCpu& cpu;
+    Emitter& e;
+
+    void exitTo(std::uint32_t pc) {
+        e.movCtxImm(OFF_PC, pc);
+        e.jmp(cpu.exitStub_);
+    }
+
+    // Після кожної інструкції: --budget; на нулі — вихід з PC наступної інструкції.
+    void budgetTick(std::uint32_t nextPc) {
+        e.decBudget();
+        e.bytes({0x75, 12});  // jnz +12 (розмір exitTo)
+        exitTo(nextPc);
+    }
+
+    // Перехід на гостьову адресу: прямий jmp, якщо код уже є, інакше — слот для зшивання.
+    void chainTo(std::uint32_t targetPc) {
+        if (auto it = cpu.entries_.find(targetPc); it != cpu.entries_.end()) {
+            e.jmp(it->second);
+            return;
+        }
+
+        // jmp rel32 = 0 — спочатку "провалюємось" у заглушку нижче; диспетчер потім
+        // перепише rel32 на адресу цільового блоку.
+        std::uint8_t* slot = e.cursor();
+        e.bytes({0xE9, 0x00, 0x00, 0x00, 0x00});
+        e.movCtxImm(OFF_PC, targetPc);
+        e.movRaxImm64(reinterpret_cast<std::uintptr_t>(slot));
+        e.movCtxRax(OFF_PATCH);
+        e.jmp(cpu.exitStub_);
+    }
+
+    void emitLoad(const FakeCpu::DecodedInstruction& op) {
+        e.movEaxCtx(regOffset(op.rs));
+        if (op.imm != 0) {
+            e.addEaxImm(op.imm);  // eax = EA
+        }
+
+        // Швидкий шлях: (EA - ramBase) < ramLimit -> пряме читання з буфера RAM.
+        e.movEcxEax();
+        e.subEcxCtx(OFF_RAM_BASE);
+        e.cmpEcxCtx(OFF_RAM_LIMIT);
+        std::uint8_t* slow = e.jccForward(JCC_AE);
+        e.movRdxCtx(OFF_RAM_HOST);
+        e.movEaxMemRdxRcx();
+        std::uint8_t* done = e.jmpForward();
+
+        // Повільний шлях: MMIO / поза вікном.
+        e.bind(slow);
+        e.movRdiRbx();
+        e.movEsiEax();
+        e.movRaxImm64(reinterpret_cast<std::uintptr_t>(&DbtRuntime::load32));
+        e.callRax();
+        e.cmpCtxImm8(OFF_EXIT, kExitNone);
+        std::uint8_t* ok = e.jccForward(JCC_E);
+        exitTo(op.pc);  // виняток: PC лишається на LOAD
+
+        e.bind(ok);
+        e.bind(done);
+        e.movCtxEax(regOffset(op.rd));
+        e.updateZnFromEax();
+    }
+
+    void emitStore(const FakeCpu::DecodedInstruction& op) {
+        e.movEaxCtx(regOffset(op.rd));
+        if (op.imm != 0) {
+            e.addEaxImm(op.imm);  // eax = EA
+        }
+
+        e.movEcxEax();
+        e.subEcxCtx(OFF_RAM_BASE);
+        e.cmpEcxCtx(OFF_RAM_LIMIT);
+        std::uint8_t* slowOutside = e.jccForward(JCC_AE);
+
+        // Запис, що перетинає [codeLow, codeHigh), йде повільним шляхом (там ловиться SMC).
+        e.cmpEaxCtx(OFF_CODE_HIGH);
+        std::uint8_t* fast = e.jccForward(JCC_AE);
+        e.leaEdxRaxPlus4();
+        e.cmpEdxCtx(OFF_CODE_LOW);
+        std::uint8_t* slowCode = e.jccForward(JCC_A);
+
+        e.bind(fast);
+        e.movEdxCtx(regOffset(op.rs));
+        e.movR8Ctx(OFF_RAM_HOST);
+        e.movMemR8RcxEdx();
+
+        // Облік змінених сторінок: *epoch у ramEpochs для першого й останнього байта запису
+        // (сторінка i вікна — (ramPageOffset + EA - ramBase) >> kEpochPageBits).
+        e.movEdxCtx(OFF_RAM_PAGE_OFFSET);
+        e.addRdxRcx();
+        e.leaRcxRdxPlus3();
+        e.shrRdxImm(HostMemoryWindow::kEpochPageBits);
+        e.shrRcxImm(HostMemoryWindow::kEpochPageBits);
+        e.movRaxCtx(OFF_EPOCH);
+        e.movRaxMemRax();
+        e.movR8Ctx(OFF_RAM_EPOCHS);
+        e.movMemR8Rdx8Rax();
+        e.movMemR8Rcx8Rax();
+        std::uint8_t* done = e.jmpForward();
+
+        e.bind(slowOutside);
+        e.bind(slowCode);
+        e.movRdiRbx();
+        e.movEsiEax();
+        e.movEdxCtx(regOffset(op.rs));
+        e.movRaxImm64(reinterpret_cast<std::uintptr_t>(&DbtRuntime::store32));
+        e.callRax();
+        e.cmpCtxImm8(OFF_EXIT, kExitNone);
+        std::uint8_t* ok = e.jccForward(JCC_E);
+        e.cmpCtxImm8(OFF_EXIT, kExitCodeModified);
+        std::uint8_t* modified = e.jccForward(JCC_E);
+        exitTo(op.pc);  // виняток: PC лишається на STORE
+
+        // Код змінено: інструкція виконана, виходимо на наступну — диспетчер скине кеш.
+        e.bind(modified);
+        e.decBudget();
+        exitTo(op.pc + 4);
+
+        e.bind(ok);
+        e.bind(done);
+    }
+
+    // Повертає true, якщо інструкція завершує блок.
+    bool emit(const FakeCpu::DecodedInstruction& op) {
+        const std::uint32_t nextPc = op.pc + 4;
+
+        switch (op.opcode) {
+            case OPC_MOV:
+                if (op.isImm) {
+                    e.movCtxImm(regOffset(op.rd), op.imm);
+                    e.updateZnConst(op.imm);
+                } else {
+                    e.movEaxCtx(regOffset(op.rs));
+                    e.movCtxEax(regOffset(op.rd));
+                    e.updateZnFromEax();
+                }
+                break;
+            case OPC_ADD:
+            case OPC_SUB:
+                e.movEaxCtx(regOffset(op.rd));
+                if (op.opcode == OPC_ADD && op.isImm) {
+                    e.addEaxImm(op.imm);
+                } else if (op.opcode == OPC_ADD) {
+                    e.addEaxCtx(regOffset(op.rs));
+                } else if (op.isImm) {
+                    e.subEaxImm(op.imm);
+                } else {
+                    e.subEaxCtx(regOffset(op.rs));
+                }
+                e.movCtxEax(regOffset(op.rd));
+                e.updateZnFromEax();
+                break;
+            case OPC_LOAD:
+                emitLoad(op);
+                break;
+            case OPC_STORE:
+                emitStore(op);
+                break;
+            case OPC_JMP:
+                budgetTickThen(op.target);
+                chainTo(op.target);
+                return true;
+            case OPC_JZ:
+            case OPC_JNZ:
+                emitConditional(op);
+                return true;
+            case OPC_HALT:
+                // HALT не рахується як виконана інструкція; PC лишається на HALT.
+                e.movCtxImm(OFF_EXIT, kExitHalt);
+                exitTo(op.pc);
+                return true;
+            case OPC_NOP:
+            default:
+                // Невідомий opcode — як NOP (так само, як в інтерпретаторі).
+                break;
+        }
+
+        budgetTick(nextPc);
+        return false;
+    }
+
+    // --budget для переходу: на нулі виходимо одразу з PC цілі.
+    void budgetTickThen(std::uint32_t targetPc) {
+        e.decBudget();
+        e.bytes({0x75, 12});
+        exitTo(targetPc);
+    }
+
+    void emitConditional(const FakeCpu::DecodedInstruction& op) {
+        const bool isJz = op.opcode == OPC_JZ;
+        const std::uint32_t nextPc = op.pc + 4;
+
+        // test [flags], Z: x86 ZF=0 <=> FLAGS.Z=1.
+        const std::uint8_t takenCc = isJz ? JCC_NE : JCC_E;
+        const std::uint8_t notTakenCc = isJz ? JCC_E : JCC_NE;
+
+        e.decBudget();
+        std::uint8_t* go = e.jccForward(JCC_NE);
+
+        // Бюджет вичерпано: обчислюємо новий PC і виходимо.
+        e.testZeroFlag();
+        e.movCtxImm(OFF_PC, nextPc);
+        std::uint8_t* skip = e.jccForward(notTakenCc);
+        e.movCtxImm(OFF_PC, op.target);
+        e.bind(skip);
+        e.jmp(cpu.exitStub_);
+
+        e.bind(go);
+        e.testZeroFlag();
+        std::uint8_t* taken = e.jccForward(takenCc);
+        chainTo(nextPc);
+        e.bind(taken);
+        chainTo(op.target);
+    }
+};
+
+// === DbtCpu ===
+
+bool DbtCpu::hostSupported() noexcept { return ELSIM_DBT_HOST_SUPPORTED != 0; }
+
+DbtCpu::DbtCpu() {
+#if ELSIM_DBT_HOST_SUPPORTED
+    // W^X: кеш ніколи не буває водночас записуваним і виконуваним — RW під час трансляції й патчів,
+    // RX під час виконання (див. setCodeWritable).
+    void* mem = ::mmap(nullptr, kCodeCacheSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        throw std::runtime_error("DbtCpu: failed to allocate executable code cache");
+    }
+    codeBase_ = static_cast<std::uint8_t*>(mem);
+    codeWritable_ = true;
+
+    // Трамплін входу/виходу: void enter(Context* ctx /*rdi*/, void* code /*rsi*/).
+    // rbx (callee-saved) тримає ctx; після push rbx стек вирівняний на 16 для викликів хелперів.
+    Emitter e(codeBase_);
+    e.u8(0x53);                     // push rbx
+    e.bytes({0x48, 0x89, 0xFB});    // mov rbx, rdi
+    e.bytes({0xFF, 0xE6});          // jmp rsi
+    exitStub_ = e.cursor();
+    e.u8(0x5B);                     // pop rbx
+    e.u8(0xC3);                     // ret
+
+    stubsSize_ = static_cast<std::size_t>(e.cursor() - codeBase_);
+    codeUsed_ = stubsSize_;
+    ctx_.self = this;
+#else
+    throw std::runtime_error("DbtCpu: dynamic binary translation requires an x86-64 Linux host");
+#endif
+}
+
+DbtCpu::~DbtCpu() {
+#if ELSIM_DBT_HOST_SUPPORTED
+    if (codeBase_ != nullptr) {
+        ::munmap(codeBase_, kCodeCacheSize);
+    }
+#endif
+}
+
+void DbtCpu::reset() {
+    stepCount_ = 0;
+    imageLoaded_ = false;
+    lastImagePath_.clear();
+    halted_ = false;
+    pendingFault_ = nullptr;
+
+    std::fill(std::begin(ctx_.regs), std::end(ctx_.regs), 0u);
+    ctx_.pc = 0;
+    ctx_.flags = 0;
+    sp_ = 0;
+
+    invalidateCodeCache();
+}
+
+bool DbtCpu::loadImage(const std::string& path) {
+    lastImagePath_ = path;
+    imageLoaded_ = !path.empty();
+    return imageLoaded_;
+}
+
+void DbtCpu::setMemoryBus(std::shared_ptr<IMemoryBus> bus) {
+    memoryBus_ = std::move(bus);
+    invalidateCodeCache();
+}
+
+void DbtCpu::setPc(std::uint32_t value) noexcept {
+    ctx_.pc = value;
+    pendingFault_ = nullptr;
+
+    // Як і в FakeCpu: зміну PC ззовні трактуємо як можливе перезавантаження коду.
+    invalidateCodeCache();
+}
+
+void DbtCpu::saveState(StateWriter& out) const {
+    for (const std::uint32_t reg : ctx_.regs) {
+        out.writeU32(reg);
+    }
+    out.writeU32(ctx_.pc);
+    out.writeU32(sp_);
+    out.writeU32(ctx_.flags);
+    out.writeBool(halted_);
+    out.writeU64(stepCount_);
+}
+
+void DbtCpu::loadState(StateReader& in) {
+    for (std::uint32_t& reg : ctx_.regs) {
+        reg = in.readU32();
+    }
+    ctx_.pc = in.readU32();
+    sp_ = in.readU32();
+    ctx_.flags = in.readU32();
+    halted_ = in.readBool();
+    stepCount_ = static_cast<std::size_t>(in.readU64());
+    pendingFault_ = nullptr;
+
+    invalidateCodeCache();
+}
+
+void DbtCpu::setCodeWritable(bool writable) {
+    if (codeWritable_ == writable) {
+        return;
+    }
+#if ELSIM_DBT_HOST_SUPPORTED
+    if (::mprotect(codeBase_, kCodeCacheSize, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) != 0) {
+        throw std::runtime_error("DbtCpu: failed to change code cache protection");
+    }
+#endif
+    codeWritable_ = writable;
+}
+
+void DbtCpu::invalidateCodeCache() noexcept {
+    entries_.clear();
+    blockCount_ = 0;
+    codeUsed_ = stubsSize_;
+    ctx_.codeLow = 0xFFFFFFFFu;
+    ctx_.codeHigh = 0;
+    ++cacheGeneration_;
+}
+
+DbtCpu::CpuState DbtCpu::state() const noexcept {
+    CpuState s{};
+    std::copy(std::begin(ctx_.regs), std::end(ctx_.regs), s.regs.begin());
+    s.pc = ctx_.pc;
+    s.sp = sp_;
+    s.flags = ctx_.flags;
+    return s;
+}
+
+DbtCpu::Register DbtCpu::getRegister(std::size_t index) const {
+    if (index >= FakeCpu::kNumRegisters) {
+        return 0;
+    }
+    return ctx_.regs[index];
+}
+
+void DbtCpu::setRegister(std::size_t index, Register value) {
+    if (index >= FakeCpu::kNumRegisters) {
+        return;
+    }
+    ctx_.regs[index] = value;
+}
+
+void DbtCpu::setFlag(Flag flag, bool value) noexcept {
+    const auto bit = static_cast<std::uint32_t>(flag);
+    if (value) {
+        ctx_.flags |= bit;
+    } else {
+        ctx_.flags &= ~bit;
+    }
+}
+
+bool DbtCpu::isFlagSet(Flag flag) const noexcept { return (ctx_.flags & static_cast<std::uint32_t>(flag)) != 0; }
+
+void DbtCpu::refreshRamWindow() {
+    HostMemoryWindow window = memoryBus_->hostWindow(ctx_.pc);
+    if (window.bytes.empty()) {
+        window = memoryBus_->hostWindow(0);
+    }
+    setRamWindow(window);
+}
+
+void DbtCpu::setRamWindow(const HostMemoryWindow& window) {
+    // Обрізаємо вікно так, щоб EA + 4 не переповнювало 32 біти.
+    std::uint64_t size = window.bytes.size();
+    size = std::min<std::uint64_t>(size, 0xFFFFFFFCull - window.base);
+
+    // Вікно без обліку змінених сторінок не беремо: прямі записи в нього шина б не побачила.
+    if (window.pageEpochs == nullptr) {
+        size = 0;
+    }
+
+    ctx_.ramHost = window.bytes.data();
+    ctx_.ramBase = window.base;
+    ctx_.ramLimit = size >= 4 ? static_cast<std::uint32_t>(size - 3) : 0u;
+    ctx_.ramPageOffset = window.pageOffset;
+    ctx_.ramEpochs = window.pageEpochs;
+    ctx_.epoch = window.epoch;
+}
+
+std::uint8_t* DbtCpu::entryFor(std::uint32_t pc) {
+    if (auto it = entries_.find(pc); it != entries_.end()) {
+        return it->second;
+    }
+    return translate(pc);
+}
+
+std::uint8_t* DbtCpu::translate(std::uint32_t startPc) {
+    if (kCodeCacheSize - codeUsed_ < kMaxBlockBytes) {
+        ELSIM_LOG_DEBUG(COMPONENT, "Code cache full — flushing");
+        invalidateCodeCache();
+    }
+
+    setCodeWritable(true);
+    Emitter e(codeBase_ + codeUsed_);
+    DbtTranslator translator{*this, e};
+
+    std::uint8_t* const blockStart = e.cursor();
+    std::uint32_t pc = startPc;
+    std::size_t count = 0;
+
+    for (; count < kMaxBlockLength; ++count) {
+        // Далі вже транслований код — просто переходимо в нього.
+        if (count > 0) {
+            if (auto it = entries_.find(pc); it != entries_.end()) {
+                e.jmp(it->second);
+                break;
+            }
+        }
+
+        std::uint32_t raw = 0;
+        try {
+            raw = memoryBus_->fetch32(pc);
+        } catch (...) {
+            if (count == 0) {
+                throw;  // як в інтерпретаторі: fetch з PC кидає виняток
+            }
+            // Помилка fetch посеред блоку — виходимо в диспетчер перед цією адресою.
+            translator.exitTo(pc);
+            break;
+        }
+
+        entries_[pc] = e.cursor();
+        ctx_.codeLow = std::min(ctx_.codeLow, pc);
+        ctx_.codeHigh = std::max(ctx_.codeHigh, pc + 4);
+
+        const auto op = FakeCpu::decode(raw, pc);
+        if (translator.emit(op)) {
+            ++count;
+            break;
+        }
+
+        pc += 4;
+        if (count + 1 == kMaxBlockLength) {
+            translator.chainTo(pc);
+        }
+    }
+
+    codeUsed_ = static_cast<std::size_t>(e.cursor() - codeBase_);
+    ++blockCount_;
+
+    ELSIM_LOG_DEBUG(COMPONENT, "Translated block @0x" << std::hex << startPc << std::dec << ": " << count
+                    << " instr, " << (e.cursor() - blockStart) << " bytes");
+
+    return blockStart;
+}
+
+RunResult DbtCpu::run(std::uint64_t budget) {
+    // Без шини — стара поведінка step() (попередження на кожен крок).
+    if (!memoryBus_) {
+        return ICpu::run(budget);
+    }
+    if (halted_) {
+        return RunResult{0, StopReason::Halted};
+    }
+    if (budget == 0) {
+        return RunResult{};
+    }
+
+    // Помилка, відкладена попереднім run(): PC уже стоїть на інструкції, що впала, а крок з нею
+    // зараховано, коли помилку відклали (див. fault нижче), — як у FakeCpu, вдруге не рахуємо.
+    if (pendingFault_) {
+        std::rethrow_exception(std::exchange(pendingFault_, nullptr));
+    }
+
+#if ELSIM_DBT_HOST_SUPPORTED
+    refreshRamWindow();
+    ctx_.budget = budget;
+
+    // retiredInRun() має сенс лише всередині run(): на будь-якому виході бюджет забуваємо.
+    struct RunScope {
+        std::uint64_t& runBudget;
+        ~RunScope() { runBudget = 0; }
+    } scope{runBudget_};
+    runBudget_ = budget;
+
+    const auto enter = reinterpret_cast<EnterFn>(codeBase_);
+
+    std::uint8_t* patchSite = nullptr;
+    std::uint64_t patchGeneration = 0;
+
+    // Виняток кидаємо одразу, лише якщо ще нічого не виконано; інакше повертаємо
+    // кількість виконаних інструкцій, а виняток — на наступному виклику run()/step().
+    // stepCount() рахує, як FakeCpu, і виконані інструкції, і HALT чи інструкцію, що впала.
+    auto fault = [&](std::exception_ptr error) -> RunResult {
+        const std::uint64_t retired = budget - ctx_.budget;
+        stepCount_ += static_cast<std::size_t>(retired) + 1;
+        if (retired == 0) {
+            std::rethrow_exception(error);
+        }
+        pendingFault_ = std::move(error);
+        return RunResult{retired, StopReason::Fault};
+    };
+
+    while (ctx_.budget > 0) {
+        std::uint8_t* entry = nullptr;
+        try {
+            entry = entryFor(ctx_.pc);
+        } catch (...) {
+            return fault(std::current_exception());
+        }
+
+        // Зшиваємо попередній блок з цим, якщо кеш за цей час не скидався.
+        // Кеш перемикається RW/RX лише після трансляції чи патча: зшитий цикл обходиться без mprotect.
+        try {
+            if (patchSite != nullptr && patchGeneration == cacheGeneration_) {
+                setCodeWritable(true);
+                Emitter::patchRel32(patchSite + 1, entry);
+            }
+            setCodeWritable(false);
+        } catch (...) {
+            return fault(std::current_exception());
+        }
+        patchSite = nullptr;
+
+        ctx_.exitReason = kExitNone;
+        ctx_.patchSite = nullptr;
+        enter(&ctx_, entry);
+
+        switch (ctx_.exitReason) {
+            case kExitHalt:
+                halted_ = true;
+                stepCount_ += static_cast<std::size_t>(budget - ctx_.budget) + 1;
+                return RunResult{budget - ctx_.budget, StopReason::Halted};
+            case kExitFault:
+                return fault(std::exchange(pendingFault_, nullptr));
+            case kExitCodeModified:
+                invalidateCodeCache();
+                break;
+            default:
+                patchSite = ctx_.patchSite;
+                patchGeneration = cacheGeneration_;
+                break;
+        }
+    }
+
+    const std::uint64_t retired = budget - ctx_.budget;
+    stepCount_ += static_cast<std::size_t>(retired);
+    return RunResult{retired, StopReason::BudgetExhausted};
+#else
+    return RunResult{};
+#endif
+}
+
+void DbtCpu::step() {
+    // Виконані інструкції рахує run(); тут — лише кроки, що до нього не доходять (як у FakeCpu).
+    if (halted_) {
+        ++stepCount_;
+        ELSIM_LOG_DEBUG(COMPONENT, "step() called while HALTED — skipping");
+        return;
+    }
+
+    if (!memoryBus_) {
+        ++stepCount_;
+        Logger::instance().warn(COMPONENT, "step() called without memoryBus attached");
+        return;
+    }
+
+    DbtCpu::run(1);
+}
+
+}  // namespace elsim::core
@@ -0,0 +1,36 @@
+#include "elsim/core/EventScheduler.hpp"
+
+#include <algorithm>
+
+namespace elsim::core {
+
+void EventScheduler::schedule(Handle handle, std::uint64_t cycle) {
+    heap_.push_back(Event{cycle, nextSeq_++, handle});
+    std::push_heap(heap_.begin(), heap_.end(), Later{});
+}
+
+bool EventScheduler::popDue(std::uint64_t now, Handle& handle) {
+    std::uint64_t cycle = 0;
+    return popDue(now, handle, cycle);
+}
+
+bool EventScheduler::popDue(std::uint64_t now, Handle& handle, std::uint64_t& cycle) {
+    if (heap_.empty() || heap_.front().cycle > now) {
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), Later{});
+    handle = heap_.back().handle;
+    cycle = heap_.back().cycle;
+    heap_.pop_back();
+    return true;
+}
+
+std::uint64_t EventScheduler::nextDeadline() const noexcept { return heap_.empty() ? kNever : heap_.front().cycle; }
+
+void EventScheduler::clear() noexcept {
+    heap_.clear();
+    nextSeq_ = 0;
+}
+
+}  // namespace elsim::core
@@ -0,0 +1,180 @@
+#include "elsim/core/ExecutionProfile.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "elsim/core/InstructionTrace.hpp"
+
+namespace elsim::core {
+
+namespace {
+
+constexpr std::uint8_t OPC_JZ = 0x07;
+constexpr std::uint8_t OPC_JNZ = 0x08;
+
+std::string opcodeLabel(std::uint8_t opcode) {
+    if (const auto name = traceOpcodeName(opcode)) {
+        return std::string(*name);
+    }
+    std::ostringstream label;
+    label << "0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned>(opcode);
+    return label.str();
+}
+
+// Частка part від whole у відсотках, "12.34%".
+std::string percent(std::uint64_t part, std::uint64_t whole) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2)
+         << (whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole)) << '%';
+    return text.str();
+}
+
+std::string hexAddress(std::uint32_t address) {
+    std::ostringstream text;
+    text << "0x" << std::hex << std::setw(8) << std::setfill('0') << address;
+    return text.str();
+}
+
+}  // namespace
+
+ExecutionProfile::ExecutionProfile(std::uint32_t baseAddress, std::size_t sizeBytes)
+    : baseAddress_(baseAddress),
+      slots_((sizeBytes + 3) / 4),
+      pcCounts_(slots_ * sizeof(std::uint64_t)),
+      pcTaken_(slots_ * sizeof(std::uint64_t)) {
+    if (sizeBytes == 0) {
+        throw std::invalid_argument("ExecutionProfile: profiled range must not be empty");
+    }
+    pcCounts_.resize(pcCounts_.capacity());
+    pcTaken_.resize(pcTaken_.capacity());
+}
+
+void ExecutionProfile::clear() noexcept {
+    pcCounts_.zero(0, pcCounts_.size());
+    pcTaken_.zero(0, pcTaken_.size());
+    opcodeCounts_.fill(0);
+    opcodeTaken_.fill(0);
+    outside_ = 0;
+}
+
+std::uint64_t ExecutionProfile::totalCount() const noexcept {
+    return std::accumulate(opcodeCounts_.begin(), opcodeCounts_.end(), std::uint64_t{0});
+}
+
+std::uint64_t ExecutionProfile::pcCount(std::uint32_t pc) const noexcept {
+    const std::uint32_t index = (pc - baseAddress_) >> 2;
+    return index < slots_ ? counters(pcCounts_)[index] : 0;
+}
+
+std::uint64_t ExecutionProfile::pcTakenCount(std::uint32_t pc) const noexcept {
+    const std::uint32_t index = (pc - baseAddress_) >> 2;
+    return index < slots_ ? counters(pcTaken_)[index] : 0;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint64_t>> ExecutionProfile::topPcs(std::size_t count) const {
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> hot;
+    const std::uint64_t* pcCounts = counters(pcCounts_);
+    for (std::size_t i = 0; i < slots_; ++i) {
+        if (pcCounts[i] != 0) {
+            hot.emplace_back(baseAddress_ + static_cast<std::uint32_t>(i * 4), pcCounts[i]);
+        }
+    }
+
+    const auto hotter = [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    const std::size_t keep = std::min(count, hot.size());
+    std::partial_sort(hot.begin(), hot.begin() + static_cast<std::ptrdiff_t>(keep), hot.end(), hotter);
+    hot.resize(keep);
+    return hot;
+}
+
+void ExecutionProfile::report(std::ostream& out, std::size_t topCount, std::span<const std::uint8_t> code) const {
+    const std::uint64_t total = totalCount();
+
+    // Слово інструкції за адресою pc з code (nullopt — поза code).
+    const auto wordAt = [&](std::uint32_t pc) -> std::optional<std::uint32_t> {
+        const std::size_t offset = pc - baseAddress_;
+        if (offset + 4 > code.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint32_t>(code[offset]) | (static_cast<std::uint32_t>(code[offset + 1]) << 8) |
+               (static_cast<std::uint32_t>(code[offset + 2]) << 16) |
+               (static_cast<std::uint32_t>(code[offset + 3]) << 24);
+    };
+    const auto disassemble = [&](std::uint32_t pc) -> std::string {
+        const auto raw = wordAt(pc);
+        return raw ? disassembleInstruction(*raw, pc) : std::string{};
+    };
+
+    out << "=== Execution profile: " << total << " instructions ===\n";
+
+    const auto hot = topPcs(topCount);
+    out << "\nTop " << hot.size() << " PCs:\n";
+    for (const auto& [pc, count] : hot) {
+        out << "  " << hexAddress(pc) << "  " << std::setw(12) << count << "  " << std::setw(7)
+            << percent(count, total);
+        if (const std::string text = disassemble(pc); !text.empty()) {
+            out << "  " << text;
+        }
+        out << '\n';
+    }
+    if (outside_ != 0) {
+        out << "  (outside profiled range: " << outside_ << ", " << percent(outside_, total) << ")\n";
+    }
+
+    // Гістограма за спаданням.
+    std::vector<std::uint8_t> opcodes;
+    for (unsigned opcode = 0; opcode < opcodeCounts_.size(); ++opcode) {
+        if (opcodeCounts_[opcode] != 0) {
+            opcodes.push_back(static_cast<std::uint8_t>(opcode));
+        }
+    }
+    std::stable_sort(opcodes.begin(), opcodes.end(),
+                     [&](std::uint8_t a, std::uint8_t b) { return opcodeCounts_[a] > opcodeCounts_[b]; });
+
+    out << "\nOpcode histogram:\n";
+    for (const std::uint8_t opcode : opcodes) {
+        out << "  " << std::left << std::setw(6) << opcodeLabel(opcode) << std::right << std::setw(12)
+            << opcodeCounts_[opcode] << "  " << std::setw(7) << percent(opcodeCounts_[opcode], total) << '\n';
+    }
+
+    out << "\nConditional branches:\n";
+    for (const std::uint8_t opcode : {OPC_JZ, OPC_JNZ}) {
+        const std::uint64_t executed = opcodeCounts_[opcode];
+        const std::uint64_t taken = opcodeTaken_[opcode];
+        out << "  " << std::left << std::setw(6) << opcodeLabel(opcode) << std::right << "taken " << taken
+            << ", not taken " << (executed - taken) << "  (" << percent(taken, executed) << " taken)\n";
+    }
+
+    // Найгарячіші окремі переходи. Без code переходи, що жодного разу не виконались, не розпізнати —
+    // тоді в список потрапляють лише адреси з taken > 0.
+    std::size_t listed = 0;
+    for (const auto& [pc, executed] : topPcs(slots_)) {
+        if (listed == topCount) {
+            break;
+        }
+        const auto raw = wordAt(pc);
+        const bool isBranch =
+            raw ? ((*raw >> 24) == OPC_JZ || (*raw >> 24) == OPC_JNZ) : pcTakenCount(pc) != 0;
+        if (!isBranch) {
+            continue;
+        }
+        const std::uint64_t taken = pcTakenCount(pc);
+        out << "  " << hexAddress(pc) << "  taken " << taken << ", not taken " << (executed - taken) << "  ("
+            << percent(taken, executed) << " taken)";
+        if (raw) {
+            out << "  " << disassembleInstruction(*raw, pc);
+        }
+        out << '\n';
+        ++listed;
+    }
+}
+
+}  // namespace elsim::core
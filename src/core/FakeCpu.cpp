@@ -1,17 +1,87 @@
 #include "elsim/core/FakeCpu.hpp"
 
 #include <algorithm>  // std::fill
+#include <bit>        // std::countr_zero
 #include <cstdint>
-#include <sstream>  // std::ostringstream
+#include <limits>
+#include <stdexcept>    // std::invalid_argument
+#include <type_traits>  // std::is_same_v
+#include <utility>      // std::exchange
 
 #include "elsim/core/IMemoryBus.hpp"
 #include "elsim/core/Logger.hpp"
+#include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/MemoryBusAdapter.hpp"
+#include "elsim/core/StateStream.hpp"
 
 namespace elsim::core {
 
+namespace {
+
+// Опкоди (див. docs/fakecpu_isa.md)
+constexpr std::uint8_t OPC_NOP = 0x00;
+constexpr std::uint8_t OPC_MOV = 0x01;
+constexpr std::uint8_t OPC_ADD = 0x02;
+constexpr std::uint8_t OPC_SUB = 0x03;
+constexpr std::uint8_t OPC_LOAD = 0x04;
+constexpr std::uint8_t OPC_STORE = 0x05;
+constexpr std::uint8_t OPC_JMP = 0x06;
+constexpr std::uint8_t OPC_JZ = 0x07;
+constexpr std::uint8_t OPC_JNZ = 0x08;
+constexpr std::uint8_t OPC_HALT = 0xFF;
+
+// Інструкції, що завершують базовий блок (зміна потоку керування).
+constexpr bool endsBlock(std::uint8_t opcode) noexcept {
+    return opcode == OPC_JMP || opcode == OPC_JZ || opcode == OPC_JNZ || opcode == OPC_HALT;
+}
+
+// Значення регістру в ітерації idle-циклу як функція лічильника циклів t на її початку:
+// coef * t + offset (за модулем 2^32). coef == 0 — стала.
+struct CounterLinear {
+    std::uint32_t coef{0};
+    std::uint32_t offset{0};
+
+    [[nodiscard]] std::uint32_t at(std::uint32_t t) const noexcept { return coef * t + offset; }
+
+    friend CounterLinear operator+(CounterLinear a, CounterLinear b) noexcept {
+        return {a.coef + b.coef, a.offset + b.offset};
+    }
+    friend CounterLinear operator-(CounterLinear a, CounterLinear b) noexcept {
+        return {a.coef - b.coef, a.offset - b.offset};
+    }
+};
+
+constexpr std::uint64_t kNeverSolved = std::numeric_limits<std::uint64_t>::max();
+
+// Найменше k >= 0, для якого a * k == b (mod 2^32); kNeverSolved, якщо такого немає.
+std::uint64_t solveModular(std::uint32_t a, std::uint32_t b) noexcept {
+    if (b == 0) {
+        return 0;
+    }
+    if (a == 0) {
+        return kNeverSolved;
+    }
+    // a = odd * 2^shift: розв'язок є, лише якщо b ділиться на 2^shift; тоді k = (b >> shift) / odd
+    // за модулем 2^(32 - shift).
+    const int shift = std::countr_zero(a);
+    if (std::countr_zero(b) < shift) {
+        return kNeverSolved;
+    }
+    const std::uint32_t odd = a >> shift;
+    std::uint32_t inverse = odd;  // odd * odd == 1 (mod 8); кожен крок Ньютона подвоює точні біти
+    for (int i = 0; i < 4; ++i) {
+        inverse *= 2u - odd * inverse;
+    }
+    const std::uint64_t mask = (std::uint64_t{1} << (32 - shift)) - 1;
+    return static_cast<std::uint32_t>((b >> shift) * inverse) & mask;
+}
+
+}  // namespace
+
 // === Допоміжні хелпери для регістрів та прапорців ===
 
-FakeCpu::Register FakeCpu::getRegister(std::size_t index) const {
+template <typename Bus>
+typename FakeCpuT<Bus>::Register FakeCpuT<Bus>::getRegister(std::size_t index) const {
     // Проста перевірка меж. У майбутньому можна замінити на assert або виняток.
     if (index >= kNumRegisters) {
         return 0;
@@ -19,22 +89,27 @@ FakeCpu::Register FakeCpu::getRegister(std::size_t index) const {
     return state_.regs[index];
 }
 
-void FakeCpu::setRegister(std::size_t index, Register value) {
+template <typename Bus>
+void FakeCpuT<Bus>::setRegister(std::size_t index, Register value) {
     if (index >= kNumRegisters) {
         return;
     }
     state_.regs[index] = value;
 }
 
-FakeCpu::Register FakeCpu::readReg(std::size_t index) const { return getRegister(index); }
+template <typename Bus>
+typename FakeCpuT<Bus>::Register FakeCpuT<Bus>::readReg(std::size_t index) const { return getRegister(index); }
 
-void FakeCpu::writeReg(std::size_t index, Register value) { setRegister(index, value); }
+template <typename Bus>
+void FakeCpuT<Bus>::writeReg(std::size_t index, Register value) { setRegister(index, value); }
 
 // --- Операції з FLAGS ---
 
-void FakeCpu::clearFlags() noexcept { state_.flags = 0; }
+template <typename Bus>
+void FakeCpuT<Bus>::clearFlags() noexcept { state_.flags = 0; }
 
-void FakeCpu::setFlag(Flag flag, bool value) noexcept {
+template <typename Bus>
+void FakeCpuT<Bus>::setFlag(Flag flag, bool value) noexcept {
     auto bit = static_cast<std::uint32_t>(flag);
     if (value) {
         state_.flags |= bit;
@@ -43,12 +118,14 @@ void FakeCpu::setFlag(Flag flag, bool value) noexcept {
     }
 }
 
-bool FakeCpu::isFlagSet(Flag flag) const noexcept {
+template <typename Bus>
+bool FakeCpuT<Bus>::isFlagSet(Flag flag) const noexcept {
     auto bit = static_cast<std::uint32_t>(flag);
     return (state_.flags & bit) != 0;
 }
 
-void FakeCpu::updateZNFlags(Register value) {
+template <typename Bus>
+void FakeCpuT<Bus>::updateZNFlags(Register value) {
     // Оновлюємо Zero та Negative, не чіпаючи Carry/Overflow
     setFlag(Flag::Zero, value == 0);
 
@@ -59,376 +136,964 @@ void FakeCpu::updateZNFlags(Register value) {
 
 // --- Допоміжні функції роботи з пам'яттю (32-бітні слова) ---
 
-FakeCpu::Register FakeCpu::read32(std::uint32_t address) {
-    if (!memoryBus_) {
+template <typename Bus>
+typename FakeCpuT<Bus>::Register FakeCpuT<Bus>::read32(std::uint32_t address) {
+    if (bus_ == nullptr) {
         Logger::instance().warn("CPU", "read32 called without memoryBus attached");
         return 0;
     }
 
-    // Little-endian: молодший байт за найменшою адресою.
-    const std::uint32_t b0 = memoryBus_->read8(address + 0);
-    const std::uint32_t b1 = memoryBus_->read8(address + 1);
-    const std::uint32_t b2 = memoryBus_->read8(address + 2);
-    const std::uint32_t b3 = memoryBus_->read8(address + 3);
+    // Little-endian 32-бітна транзакція шини (RAM — одне читання, MMIO — один виклик девайса).
+    const std::uint32_t value = bus_->read32(address);
+
+    ELSIM_LOG_DEBUG("CPU", "FETCH32 addr=0x" << std::hex << address << " -> 0x" << value);
+
+    return static_cast<Register>(value);
+}
 
-    const std::uint32_t value = (b0) | (b1 << 8) | (b2 << 16) | (b3 << 24);
+template <typename Bus>
+std::uint32_t FakeCpuT<Bus>::fetch32(std::uint32_t pc) {
+    // Швидкий шлях: слово цілком у вікні RAM — одне читання хост-пам'яті.
+    std::uint64_t offset = static_cast<std::uint64_t>(pc) - fetchWindow_.base;
+    if (pc < fetchWindow_.base || offset + 4 > fetchWindow_.bytes.size()) {
+        // Без шини вікно порожнє (setMemoryBus скидає його), тож перевірки досить лише тут.
+        if (bus_ == nullptr) {
+            Logger::instance().warn("CPU", "fetch32 called without memoryBus attached");
+            return 0;
+        }
+        fetchWindow_ = bus_->hostWindow(pc, HostAccess::Execute);
+        offset = static_cast<std::uint64_t>(pc) - fetchWindow_.base;
+    }
 
-    {
-        std::ostringstream oss;
-        oss << "FETCH32 addr=0x" << std::hex << address << " -> 0x" << value;
-        Logger::instance().debug("CPU", oss.str());
+    if (pc >= fetchWindow_.base && offset + 4 <= fetchWindow_.bytes.size()) {
+        const std::uint8_t* p = fetchWindow_.bytes.data() + offset;
+        const std::uint32_t value = static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+                                    (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+        ELSIM_LOG_DEBUG("CPU", "FETCH32 addr=0x" << std::hex << pc << " -> 0x" << value);
+        return value;
     }
 
-    return static_cast<Register>(value);
+    // MMIO, межа вікна, поза RAM або сторінка без права виконання — fetch через шину (з її винятками).
+    const std::uint32_t value = bus_->fetch32(pc);
+    ELSIM_LOG_DEBUG("CPU", "FETCH32 addr=0x" << std::hex << pc << " -> 0x" << value);
+    return value;
 }
 
-void FakeCpu::write32(std::uint32_t address, Register value) {
-    if (!memoryBus_) {
+template <typename Bus>
+void FakeCpuT<Bus>::write32(std::uint32_t address, Register value) {
+    if (bus_ == nullptr) {
         Logger::instance().warn("CPU", "write32 called without memoryBus attached");
         return;
     }
 
     const std::uint32_t v = static_cast<std::uint32_t>(value);
 
-    memoryBus_->write8(address + 0, static_cast<std::uint8_t>(v & 0xFFu));
-    memoryBus_->write8(address + 1, static_cast<std::uint8_t>((v >> 8) & 0xFFu));
-    memoryBus_->write8(address + 2, static_cast<std::uint8_t>((v >> 16) & 0xFFu));
-    memoryBus_->write8(address + 3, static_cast<std::uint8_t>((v >> 24) & 0xFFu));
+    bus_->write32(address, v);
 
-    {
-        std::ostringstream oss;
-        oss << "WRITE32 addr=0x" << std::hex << address << " value=0x" << v;
-        Logger::instance().debug("CPU", oss.str());
-    }
+    // Самомодифікований код: запис поверх закешованих інструкцій скидає кеш.
+    invalidateOnWrite(address, 4);
+
+    ELSIM_LOG_DEBUG("CPU", "WRITE32 addr=0x" << std::hex << address << " value=0x" << v);
 }
 
 // --- Декодування та виконання інструкцій ---
 
-void FakeCpu::decodeAndExecute(std::uint32_t instruction) {
-    // Якщо CPU вже в HALT — нічого не робимо
-    if (halted_) {
-        Logger::instance().debug("CPU", "decodeAndExecute called while HALTED — ignoring instruction");
-        return;
-    }
+template <typename Bus>
+typename FakeCpuT<Bus>::DecodedInstruction FakeCpuT<Bus>::decode(std::uint32_t instruction,
+                                                                std::uint32_t pc) noexcept {
+    DecodedInstruction op{};
+    op.raw = instruction;
+    op.pc = pc;
 
     // Витягуємо opcode (старший байт)
-    const std::uint8_t opcode = static_cast<std::uint8_t>(instruction >> 24);
+    op.opcode = static_cast<std::uint8_t>(instruction >> 24);
 
     // Розбір полів аргументів (для ALU-інструкцій)
-    const std::uint32_t rdIndex = (instruction >> 21) & 0x7u;  // 3 біти
-    const std::uint32_t rsIndex = (instruction >> 18) & 0x7u;  // 3 біти
-    const bool isImm = ((instruction >> 17) & 0x1u) != 0;
+    op.rd = static_cast<std::uint8_t>((instruction >> 21) & 0x7u);  // 3 біти
+    op.rs = static_cast<std::uint8_t>((instruction >> 18) & 0x7u);  // 3 біти
+    op.isImm = ((instruction >> 17) & 0x1u) != 0;
+
+    // sign-extend 16-бітного значення до 32 біт
     const std::int16_t imm16 = static_cast<std::int16_t>(instruction & 0xFFFFu);
+    op.imm = static_cast<Register>(static_cast<std::int32_t>(imm16));
 
-    // Невеликий хелпер для sign-extend 16-бітного значення до 32 біт
-    const auto signExtendImm16 = [imm16]() -> Register {
-        return static_cast<Register>(static_cast<std::int32_t>(imm16));
-    };
+    // Ціль PC-відносного переходу: PC + 4 + (sign_extend(offset16) << 2)
+    const std::int32_t offsetBytes = static_cast<std::int32_t>(imm16) * 4;
+    op.target = static_cast<std::uint32_t>(pc + 4u + static_cast<std::uint32_t>(offsetBytes));
+
+    op.handler = handlerTable()[op.opcode];
+
+    return op;
+}
+
+template <typename Bus>
+const std::array<typename FakeCpuT<Bus>::Handler, 256>& FakeCpuT<Bus>::handlerTable() noexcept {
+    static const std::array<Handler, 256> table = [] {
+        std::array<Handler, 256> t{};
+        t.fill(&FakeCpuT::execUnknown);
+        t[OPC_NOP] = &FakeCpuT::execNop;
+        t[OPC_MOV] = &FakeCpuT::execMov;
+        t[OPC_ADD] = &FakeCpuT::execAdd;
+        t[OPC_SUB] = &FakeCpuT::execSub;
+        t[OPC_LOAD] = &FakeCpuT::execLoad;
+        t[OPC_STORE] = &FakeCpuT::execStore;
+        t[OPC_JMP] = &FakeCpuT::execJmp;
+        t[OPC_JZ] = &FakeCpuT::execJz;
+        t[OPC_JNZ] = &FakeCpuT::execJnz;
+        t[OPC_HALT] = &FakeCpuT::execHalt;
+        return t;
+    }();
+    return table;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::decodeAndExecute(std::uint32_t instruction) {
+    // Якщо CPU вже в HALT — нічого не робимо
+    if (halted_) {
+        ELSIM_LOG_DEBUG("CPU", "decodeAndExecute called while HALTED — ignoring instruction");
+        return;
+    }
+
+    if (dispatchMode_ == DispatchMode::Threaded) {
+        execute<true>(decode(instruction, state_.pc));
+    } else {
+        execute<false>(decode(instruction, state_.pc));
+    }
+}
 
+template <typename Bus>
+template <bool Threaded>
+void FakeCpuT<Bus>::execute(const DecodedInstruction& op) {
     // Лог поточного інструкшена (opcode + PC)
-    {
-        std::ostringstream oss;
-        oss << "Executing instruction: opcode=0x" << std::hex << static_cast<int>(opcode) << " PC=0x" << state_.pc
-            << " Rd=" << std::dec << rdIndex << " Rs=" << rsIndex << " isImm=" << (isImm ? 1 : 0) << " imm16=" << imm16;
-        Logger::instance().debug("CPU", oss.str());
-    }
-
-    // Опкоди
-    constexpr std::uint8_t OPC_NOP = 0x00;
-    constexpr std::uint8_t OPC_MOV = 0x01;
-    constexpr std::uint8_t OPC_ADD = 0x02;
-    constexpr std::uint8_t OPC_SUB = 0x03;
-    constexpr std::uint8_t OPC_LOAD = 0x04;
-    constexpr std::uint8_t OPC_STORE = 0x05;
-    // Стрибки додамо трохи пізніше:
-    constexpr std::uint8_t OPC_JMP = 0x06;
-    constexpr std::uint8_t OPC_JZ = 0x07;
-    constexpr std::uint8_t OPC_JNZ = 0x08;
-    constexpr std::uint8_t OPC_HALT = 0xFF;
-
-    switch (opcode) {
-        case OPC_NOP: {
-            Logger::instance().debug("CPU", "NOP");
-            // Нічого не робимо, просто рухаємо PC
-            state_.pc += 4;
-            break;
-        }
+    ELSIM_LOG_DEBUG("CPU", "Executing instruction: opcode=0x" << std::hex << static_cast<int>(op.opcode) << " PC=0x"
+                    << state_.pc << " Rd=" << std::dec << static_cast<int>(op.rd) << " Rs=" << static_cast<int>(op.rs)
+                    << " isImm=" << (op.isImm ? 1 : 0) << " imm16=" << static_cast<std::int32_t>(op.imm));
 
-        case OPC_MOV: {
-            // MOV Rd, Rs  або  MOV Rd, #imm16
-            Register src = 0;
-
-            if (isImm) {
-                src = signExtendImm16();
-                std::ostringstream oss;
-                oss << "MOV R" << rdIndex << ", #" << src;
-                Logger::instance().debug("CPU", oss.str());
-            } else {
-                src = readReg(rsIndex);
-                std::ostringstream oss;
-                oss << "MOV R" << rdIndex << ", R" << rsIndex << " (src=" << src << ")";
-                Logger::instance().debug("CPU", oss.str());
-            }
+    if (trace_ != nullptr) [[unlikely]] {
+        traceRecord_ = TraceRecord{trace_->now(), op.pc, op.raw};
+    }
 
-            writeReg(rdIndex, src);
-            updateZNFlags(src);
-            state_.pc += 4;
+    if constexpr (Threaded) {
+        // Обробник уже знайдено в decode() — один непрямий виклик без розбору opcode.
+        (this->*op.handler)(op);
+    } else {
+        dispatchSwitch(op);
+    }
+
+    if (trace_ != nullptr) [[unlikely]] {
+        trace_->push(traceRecord_);
+    }
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::dispatchSwitch(const DecodedInstruction& op) {
+    // Еталонне ядро: класичний switch за opcode.
+    switch (op.opcode) {
+        case OPC_NOP:
+            execNop(op);
             break;
-        }
+        case OPC_MOV:
+            execMov(op);
+            break;
+        case OPC_ADD:
+            execAdd(op);
+            break;
+        case OPC_SUB:
+            execSub(op);
+            break;
+        case OPC_LOAD:
+            execLoad(op);
+            break;
+        case OPC_STORE:
+            execStore(op);
+            break;
+        case OPC_JMP:
+            execJmp(op);
+            break;
+        case OPC_JZ:
+            execJz(op);
+            break;
+        case OPC_JNZ:
+            execJnz(op);
+            break;
+        case OPC_HALT:
+            execHalt(op);
+            break;
+        default:
+            execUnknown(op);
+            break;
+    }
+}
 
-        case OPC_ADD: {
-            // ADD Rd, Rs  або  ADD Rd, #imm16
-            const Register lhs = readReg(rdIndex);
-            Register rhs = 0;
+// --- Обробники інструкцій (спільні для обох ядер диспетчеризації) ---
 
-            if (isImm) {
-                rhs = signExtendImm16();
-            } else {
-                rhs = readReg(rsIndex);
-            }
+template <typename Bus>
+void FakeCpuT<Bus>::execNop(const DecodedInstruction& /*op*/) {
+    ELSIM_LOG_DEBUG("CPU", "NOP");
+    // Нічого не робимо, просто рухаємо PC
+    state_.pc += 4;
+}
 
-            const Register result = static_cast<Register>(lhs + rhs);
+template <typename Bus>
+void FakeCpuT<Bus>::execMov(const DecodedInstruction& op) {
+    const std::uint32_t rdIndex = op.rd;
+    const std::uint32_t rsIndex = op.rs;
+    const bool isImm = op.isImm;
 
-            {
-                std::ostringstream oss;
-                if (isImm) {
-                    oss << "ADD R" << rdIndex << ", #" << rhs << " (old=" << lhs << ", new=" << result << ")";
-                } else {
-                    oss << "ADD R" << rdIndex << ", R" << rsIndex << " (" << lhs << " + " << rhs << " = " << result
-                        << ")";
-                }
-                Logger::instance().debug("CPU", oss.str());
-            }
+    // MOV Rd, Rs  або  MOV Rd, #imm16
+    Register src = 0;
 
-            writeReg(rdIndex, result);
-            updateZNFlags(result);
-            // TODO: за потреби пізніше оновити Carry/Overflow
-            state_.pc += 4;
-            break;
-        }
+    if (isImm) {
+        src = op.imm;
+        ELSIM_LOG_DEBUG("CPU", "MOV R" << rdIndex << ", #" << src);
+    } else {
+        src = readReg(rsIndex);
+        ELSIM_LOG_DEBUG("CPU", "MOV R" << rdIndex << ", R" << rsIndex << " (src=" << src << ")");
+    }
 
-        case OPC_SUB: {
-            // SUB Rd, Rs  або  SUB Rd, #imm16
-            const Register lhs = readReg(rdIndex);
-            Register rhs = 0;
+    writeReg(rdIndex, src);
+    updateZNFlags(src);
+    state_.pc += 4;
+}
 
-            if (isImm) {
-                rhs = signExtendImm16();
-            } else {
-                rhs = readReg(rsIndex);
-            }
+template <typename Bus>
+void FakeCpuT<Bus>::execAdd(const DecodedInstruction& op) {
+    const std::uint32_t rdIndex = op.rd;
+    const std::uint32_t rsIndex = op.rs;
+    const bool isImm = op.isImm;
 
-            const Register result = static_cast<Register>(lhs - rhs);
+    // ADD Rd, Rs  або  ADD Rd, #imm16
+    const Register lhs = readReg(rdIndex);
+    Register rhs = 0;
 
-            {
-                std::ostringstream oss;
-                if (isImm) {
-                    oss << "SUB R" << rdIndex << ", #" << rhs << " (old=" << lhs << ", new=" << result << ")";
-                } else {
-                    oss << "SUB R" << rdIndex << ", R" << rsIndex << " (" << lhs << " - " << rhs << " = " << result
-                        << ")";
-                }
-                Logger::instance().debug("CPU", oss.str());
-            }
+    if (isImm) {
+        rhs = op.imm;
+    } else {
+        rhs = readReg(rsIndex);
+    }
 
-            writeReg(rdIndex, result);
-            updateZNFlags(result);
-            // TODO: за потреби пізніше оновити Carry/Overflow
-            state_.pc += 4;
-            break;
-        }
+    const Register result = static_cast<Register>(lhs + rhs);
 
-        case OPC_LOAD: {
-            // LOAD Rd, [Rs + imm16]
-            // EA = Rs + sign_extend(imm16)
-            // Rd = MEM32[EA]
+    if (isImm) {
+        ELSIM_LOG_DEBUG("CPU", "ADD R" << rdIndex << ", #" << rhs << " (old=" << lhs << ", new=" << result << ")");
+    } else {
+        ELSIM_LOG_DEBUG("CPU", "ADD R" << rdIndex << ", R" << rsIndex << " (" << lhs << " + " << rhs << " = "
+                        << result << ")");
+    }
 
-            const Register base = readReg(rsIndex);
-            const Register offset = signExtendImm16();
-            const std::uint32_t ea =
-                static_cast<std::uint32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(offset));
+    writeReg(rdIndex, result);
+    updateZNFlags(result);
+    // TODO: за потреби пізніше оновити Carry/Overflow
+    state_.pc += 4;
+}
 
-            const Register value = read32(ea);
+template <typename Bus>
+void FakeCpuT<Bus>::execSub(const DecodedInstruction& op) {
+    const std::uint32_t rdIndex = op.rd;
+    const std::uint32_t rsIndex = op.rs;
+    const bool isImm = op.isImm;
 
-            {
-                std::ostringstream oss;
-                oss << "LOAD R" << rdIndex << ", [R" << rsIndex << " + " << imm16 << "] " << "(EA=0x" << std::hex << ea
-                    << ", value=0x" << value << ")";
-                Logger::instance().debug("CPU", oss.str());
-            }
+    // SUB Rd, Rs  або  SUB Rd, #imm16
+    const Register lhs = readReg(rdIndex);
+    Register rhs = 0;
 
-            writeReg(rdIndex, value);
-            // За ISA: LOAD оновлює Z/N, не чіпаючи Carry/Overflow
-            updateZNFlags(value);
+    if (isImm) {
+        rhs = op.imm;
+    } else {
+        rhs = readReg(rsIndex);
+    }
 
-            // Звичайна інструкція → PC = PC + 4
-            state_.pc += 4;
-            break;
-        }
+    const Register result = static_cast<Register>(lhs - rhs);
 
-        case OPC_STORE: {
-            // STORE Rs, [Rd + imm16]
-            // EA = Rd + sign_extend(imm16)
-            // MEM32[EA] = Rs
+    if (isImm) {
+        ELSIM_LOG_DEBUG("CPU", "SUB R" << rdIndex << ", #" << rhs << " (old=" << lhs << ", new=" << result << ")");
+    } else {
+        ELSIM_LOG_DEBUG("CPU", "SUB R" << rdIndex << ", R" << rsIndex << " (" << lhs << " - " << rhs << " = "
+                        << result << ")");
+    }
 
-            const Register base = readReg(rdIndex);   // база адресації
-            const Register value = readReg(rsIndex);  // значення для запису
-            const Register offset = signExtendImm16();
+    writeReg(rdIndex, result);
+    updateZNFlags(result);
+    // TODO: за потреби пізніше оновити Carry/Overflow
+    state_.pc += 4;
+}
 
-            const std::uint32_t ea =
-                static_cast<std::uint32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(offset));
+template <typename Bus>
+void FakeCpuT<Bus>::execLoad(const DecodedInstruction& op) {
+    const std::uint32_t rdIndex = op.rd;
+    const std::uint32_t rsIndex = op.rs;
+    const std::int32_t imm16 = static_cast<std::int32_t>(op.imm);
 
-            write32(ea, value);
+    // LOAD Rd, [Rs + imm16]
+    // EA = Rs + sign_extend(imm16)
+    // Rd = MEM32[EA]
 
-            {
-                std::ostringstream oss;
-                oss << "STORE R" << rsIndex << " -> [R" << rdIndex << " + " << imm16 << "] " << "(EA=0x" << std::hex
-                    << ea << ", value=0x" << value << ")";
-                Logger::instance().debug("CPU", oss.str());
-            }
+    const Register base = readReg(rsIndex);
+    const Register offset = op.imm;
+    const std::uint32_t ea =
+        static_cast<std::uint32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(offset));
 
-            // За ISA: STORE не змінює FLAGS
+    const Register value = read32(ea);
 
-            state_.pc += 4;
-            break;
-        }
+    if (trace_ != nullptr) [[unlikely]] {
+        traceRecord_.memAccess = TraceMemAccess::Read;
+        traceRecord_.memAddress = ea;
+        traceRecord_.memValue = value;
+    }
 
-        case OPC_JMP: {
-            // JMP offset16
-            // PC = PC + 4 + (sign_extend(offset16) << 2)
+    ELSIM_LOG_DEBUG("CPU", "LOAD R" << rdIndex << ", [R" << rsIndex << " + " << imm16 << "] " << "(EA=0x" << std::hex
+                    << ea << ", value=0x" << value << ")");
 
-            const std::int32_t offsetWords = static_cast<std::int32_t>(imm16);
-            const std::int32_t offsetBytes = offsetWords << 2;  // множимо на розмір інструкції (4 байти)
+    writeReg(rdIndex, value);
+    // За ISA: LOAD оновлює Z/N, не чіпаючи Carry/Overflow
+    updateZNFlags(value);
 
-            const std::uint32_t oldPc = state_.pc;
-            const std::uint32_t nextPc = oldPc + 4;
-            const std::uint32_t targetPc = static_cast<std::uint32_t>(static_cast<std::int32_t>(nextPc) + offsetBytes);
+    // Звичайна інструкція → PC = PC + 4
+    state_.pc += 4;
+}
 
-            {
-                std::ostringstream oss;
-                oss << "JMP " << imm16 << " (words) " << "oldPC=0x" << std::hex << oldPc << " -> targetPC=0x"
-                    << targetPc;
-                Logger::instance().debug("CPU", oss.str());
-            }
+template <typename Bus>
+void FakeCpuT<Bus>::execStore(const DecodedInstruction& op) {
+    const std::uint32_t rdIndex = op.rd;
+    const std::uint32_t rsIndex = op.rs;
+    const std::int32_t imm16 = static_cast<std::int32_t>(op.imm);
 
-            state_.pc = targetPc;
-            break;
-        }
+    // STORE Rs, [Rd + imm16]
+    // EA = Rd + sign_extend(imm16)
+    // MEM32[EA] = Rs
 
-        case OPC_JZ: {
-            // JZ offset16
-            // if Z == 1:
-            //     PC = PC + 4 + (sign_extend(offset16) << 2)
-            // else:
-            //     PC = PC + 4
+    const Register base = readReg(rdIndex);   // база адресації
+    const Register value = readReg(rsIndex);  // значення для запису
+    const Register offset = op.imm;
 
-            const bool zSet = isFlagSet(Flag::Zero);
+    const std::uint32_t ea =
+        static_cast<std::uint32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(offset));
 
-            const std::int32_t offsetWords = static_cast<std::int32_t>(imm16);
-            const std::int32_t offsetBytes = offsetWords << 2;
+    write32(ea, value);
 
-            const std::uint32_t oldPc = state_.pc;
-            const std::uint32_t nextPc = oldPc + 4;
+    if (trace_ != nullptr) [[unlikely]] {
+        traceRecord_.memAccess = TraceMemAccess::Write;
+        traceRecord_.memAddress = ea;
+        traceRecord_.memValue = value;
+    }
 
-            std::uint32_t newPc = nextPc;
+    ELSIM_LOG_DEBUG("CPU", "STORE R" << rsIndex << " -> [R" << rdIndex << " + " << imm16 << "] " << "(EA=0x"
+                    << std::hex << ea << ", value=0x" << value << ")");
 
-            if (zSet) {
-                newPc = static_cast<std::uint32_t>(static_cast<std::int32_t>(nextPc) + offsetBytes);
-            }
+    // За ISA: STORE не змінює FLAGS
 
-            {
-                std::ostringstream oss;
-                oss << "JZ " << imm16 << " (words), Z=" << (zSet ? 1 : 0) << " oldPC=0x" << std::hex << oldPc
-                    << " -> newPC=0x" << newPc << (zSet ? " (taken)" : " (not taken)");
-                Logger::instance().debug("CPU", oss.str());
-            }
+    state_.pc += 4;
+}
 
-            state_.pc = newPc;
-            break;
-        }
+template <typename Bus>
+void FakeCpuT<Bus>::execJmp(const DecodedInstruction& op) {
+    const std::int32_t imm16 = static_cast<std::int32_t>(op.imm);
 
-        case OPC_JNZ: {
-            // JNZ offset16
-            // if Z == 0:
-            //     PC = PC + 4 + (sign_extend(offset16) << 2)
-            // else:
-            //     PC = PC + 4
+    // JMP offset16
+    // PC = PC + 4 + (sign_extend(offset16) << 2)
 
-            const bool zSet = isFlagSet(Flag::Zero);
+    const std::uint32_t oldPc = state_.pc;
+    const std::uint32_t targetPc = op.target;  // обчислено в decode()
 
-            const std::int32_t offsetWords = static_cast<std::int32_t>(imm16);
-            const std::int32_t offsetBytes = offsetWords << 2;
+    ELSIM_LOG_DEBUG("CPU", "JMP " << imm16 << " (words) " << "oldPC=0x" << std::hex << oldPc << " -> targetPC=0x"
+                    << targetPc);
 
-            const std::uint32_t oldPc = state_.pc;
-            const std::uint32_t nextPc = oldPc + 4;
+    state_.pc = targetPc;
+}
 
-            std::uint32_t newPc = nextPc;
+template <typename Bus>
+void FakeCpuT<Bus>::execJz(const DecodedInstruction& op) {
+    const std::int32_t imm16 = static_cast<std::int32_t>(op.imm);
 
-            if (!zSet) {
-                newPc = static_cast<std::uint32_t>(static_cast<std::int32_t>(nextPc) + offsetBytes);
-            }
+    // JZ offset16
+    // if Z == 1:
+    //     PC = PC + 4 + (sign_extend(offset16) << 2)
+    // else:
+    //     PC = PC + 4
 
-            {
-                std::ostringstream oss;
-                oss << "JNZ " << imm16 << " (words), Z=" << (zSet ? 1 : 0) << " oldPC=0x" << std::hex << oldPc
-                    << " -> newPC=0x" << newPc << (!zSet ? " (taken)" : " (not taken)");
-                Logger::instance().debug("CPU", oss.str());
-            }
+    const bool zSet = isFlagSet(Flag::Zero);
 
-            state_.pc = newPc;
-            break;
-        }
+    const std::uint32_t oldPc = state_.pc;
+    const std::uint32_t nextPc = oldPc + 4;
 
-        case OPC_HALT: {
-            Logger::instance().debug("CPU", "HALT");
-            // Переводимо CPU в стан HALT. PC залишаємо як є.
-            halted_ = true;
-            break;
-        }
+    std::uint32_t newPc = nextPc;
 
-        default: {
-            // Невідомий opcode — поводимось як NOP, щоб не зависнути назавжди.
-            std::ostringstream oss;
-            oss << "Unknown opcode 0x" << std::hex << static_cast<int>(opcode) << " — treating as NOP";
-            Logger::instance().debug("CPU", oss.str());
-            state_.pc += 4;
-            break;
-        }
+    if (zSet) {
+        newPc = op.target;
     }
+
+    ELSIM_LOG_DEBUG("CPU", "JZ " << imm16 << " (words), Z=" << (zSet ? 1 : 0) << " oldPC=0x" << std::hex << oldPc
+                    << " -> newPC=0x" << newPc << (zSet ? " (taken)" : " (not taken)"));
+
+    state_.pc = newPc;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::execJnz(const DecodedInstruction& op) {
+    const std::int32_t imm16 = static_cast<std::int32_t>(op.imm);
+
+    // JNZ offset16
+    // if Z == 0:
+    //     PC = PC + 4 + (sign_extend(offset16) << 2)
+    // else:
+    //     PC = PC + 4
+
+    const bool zSet = isFlagSet(Flag::Zero);
+
+    const std::uint32_t oldPc = state_.pc;
+    const std::uint32_t nextPc = oldPc + 4;
+
+    std::uint32_t newPc = nextPc;
+
+    if (!zSet) {
+        newPc = op.target;
+    }
+
+    ELSIM_LOG_DEBUG("CPU", "JNZ " << imm16 << " (words), Z=" << (zSet ? 1 : 0) << " oldPC=0x" << std::hex << oldPc
+                    << " -> newPC=0x" << newPc << (!zSet ? " (taken)" : " (not taken)"));
+
+    state_.pc = newPc;
+
+    // Зворотний перехід усередині run(): можливо, це цикл затримки, який можна згорнути
+    // (не під час трасування чи профілювання — кожна ітерація має потрапити в trace/profile).
+    if (!zSet && runBudget_ != 0 && newPc <= oldPc && trace_ == nullptr && profile_ == nullptr) {
+        collapseCountedLoop(oldPc, newPc);
+    }
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::execHalt(const DecodedInstruction& /*op*/) {
+    ELSIM_LOG_DEBUG("CPU", "HALT");
+    // Переводимо CPU в стан HALT. PC залишаємо як є.
+    halted_ = true;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::execUnknown(const DecodedInstruction& op) {
+    const std::uint8_t opcode = op.opcode;
+
+    // Невідомий opcode — поводимось як NOP, щоб не зависнути назавжди.
+    ELSIM_LOG_DEBUG("CPU", "Unknown opcode 0x" << std::hex << static_cast<int>(opcode) << " — treating as NOP");
+    state_.pc += 4;
 }
 
 // --- Основна логіка CPUEDITOR CPU (нова, 32-бітна) ---
 
-void FakeCpu::step() {
+template <typename Bus>
+void FakeCpuT<Bus>::step() {
+    const bool threaded = dispatchMode_ == DispatchMode::Threaded;
+    if (profile_ != nullptr) [[unlikely]] {
+        threaded ? stepImpl<true, true>() : stepImpl<true, false>();
+    } else {
+        threaded ? stepImpl<false, true>() : stepImpl<false, false>();
+    }
+}
+
+template <typename Bus>
+template <bool Profiled, bool Threaded>
+void FakeCpuT<Bus>::stepImpl() {
+    // Помилка, відкладена run(): PC уже стоїть на інструкції, що впала, а крок з нею run() уже зарахував.
+    if (pendingFault_ && !halted_ && bus_ != nullptr) {
+        std::rethrow_exception(std::exchange(pendingFault_, nullptr));
+    }
+
     // Рахуємо кроки — це важливо для smoke-тестів
     ++stepCount_;
 
     // Якщо CPU вже зупинений — нічого не робимо
     if (halted_) {
-        Logger::instance().debug("CPU", "step() called while HALTED — skipping");
+        ELSIM_LOG_DEBUG("CPU", "step() called while HALTED — skipping");
         return;
     }
 
     // Без підключеної шини пам'яті ми не можемо виконувати інструкції
-    if (!memoryBus_) {
+    if (bus_ == nullptr) {
         Logger::instance().warn("CPU", "step() called without memoryBus attached");
         return;
     }
 
-    // 1. Fetch: читаємо 32-бітну інструкцію з пам'яті за PC
-    const Register rawInstr = read32(state_.pc);
-    const std::uint32_t instruction = static_cast<std::uint32_t>(rawInstr);
+    if (!decodeCacheEnabled_) {
+        // Fetch + decode + execute без кешу (те саме, що decodeAndExecute(), — HALT уже перевірено).
+        const DecodedInstruction op = decode(fetch32(state_.pc), state_.pc);
+        if constexpr (Profiled) {
+            profileInstruction(op);
+        }
+        execute<Threaded>(op);
+        return;
+    }
 
-    // 2. Decode + Execute: передаємо інструкцію у decodeAndExecute()
-    decodeAndExecute(instruction);
+    // Швидкий шлях: інструкція вже декодована (копія — execute() може скинути кеш).
+    if (const DecodedInstruction* cached = nextCachedInstruction()) {
+        const DecodedInstruction op = *cached;
+        ++cursorIndex_;
+        if constexpr (Profiled) {
+            profileInstruction(op);
+        }
+        execute<Threaded>(op);
+        return;
+    }
+
+    // Промах: звичайний fetch + decode, результат дописуємо в поточний блок.
+    const DecodedInstruction op = decode(fetch32(state_.pc), state_.pc);
+    recordInstruction(op);
+    if constexpr (Profiled) {
+        profileInstruction(op);
+    }
+    execute<Threaded>(op);
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::profileInstruction(const DecodedInstruction& op) noexcept {
+    profile_->record(op.pc, op.opcode);
+    // Умовний перехід виконається, якщо Z відповідає умові (прапорці ще до виконання).
+    if ((op.opcode == OPC_JZ || op.opcode == OPC_JNZ) && isFlagSet(Flag::Zero) == (op.opcode == OPC_JZ)) {
+        profile_->recordTaken(op.pc, op.opcode);
+    }
+}
+
+template <typename Bus>
+template <bool Profiled, bool Threaded>
+void FakeCpuT<Bus>::runLoop(std::uint64_t budget, RunResult& result) {
+    // Невіртуальний виклик: компілятор може вбудувати крок у цикл.
+    while (runRetired_ < budget) {
+        stepImpl<Profiled, Threaded>();
+        if (halted_) {
+            result.reason = StopReason::Halted;
+            break;
+        }
+        ++runRetired_;
+    }
+}
+
+template <typename Bus>
+RunResult FakeCpuT<Bus>::run(std::uint64_t budget) {
+    // Без шини — стара поведінка step() (попередження на кожен крок).
+    if (bus_ == nullptr) {
+        return ICpu::run(budget);
+    }
+
+    RunResult result{};
+    if (halted_) {
+        result.reason = StopReason::Halted;
+        return result;
+    }
+
+    // Лічильник — член класу, щоб MMIO-пристрої бачили його посеред пакету (retiredInRun()).
+    // Вибір варіанту циклу й ядра диспетчеризації — раз на пакет: у самому циклі немає перевірок
+    // профілю чи режиму на інструкцію.
+    runRetired_ = 0;
+    runBudget_ = budget;
+    try {
+        if (dispatchMode_ == DispatchMode::Threaded) {
+            runWithDispatch<true>(budget, result);
+        } else {
+            runWithDispatch<false>(budget, result);
+        }
+    } catch (...) {
+        runBudget_ = 0;
+        if (runRetired_ == 0) {
+            throw;
+        }
+        pendingFault_ = std::current_exception();
+        result.reason = StopReason::Fault;
+    }
+
+    runBudget_ = 0;
+    result.retired = std::exchange(runRetired_, 0);
+    return result;
+}
+
+template <typename Bus>
+template <bool Threaded>
+void FakeCpuT<Bus>::runWithDispatch(std::uint64_t budget, RunResult& result) {
+    if (profile_ != nullptr) {
+        runLoop<true, Threaded>(budget, result);
+    } else if (idleLoopSkipping_ && trace_ == nullptr) {
+        runSkippingIdleLoops<Threaded>(budget, result);
+    } else {
+        runLoop<false, Threaded>(budget, result);
+    }
+}
+
+// --- Checkpoint ---
+
+template <typename Bus>
+void FakeCpuT<Bus>::saveState(StateWriter& out) const {
+    for (const Register reg : state_.regs) {
+        out.writeU32(reg);
+    }
+    out.writeU32(state_.pc);
+    out.writeU32(state_.sp);
+    out.writeU32(state_.flags);
+    out.writeBool(halted_);
+    out.writeU64(stepCount_);
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::loadState(StateReader& in) {
+    for (Register& reg : state_.regs) {
+        reg = in.readU32();
+    }
+    state_.pc = in.readU32();
+    state_.sp = in.readU32();
+    state_.flags = in.readU32();
+    halted_ = in.readBool();
+    stepCount_ = static_cast<std::size_t>(in.readU64());
+    pendingFault_ = nullptr;
+
+    // Пам'ять відновлюється разом зі станом CPU — закешований код міг застаріти.
+    invalidateDecodeCache();
+}
+
+// --- Пропуск idle-циклів ---
+
+template <typename Bus>
+template <bool Threaded>
+void FakeCpuT<Bus>::runSkippingIdleLoops(std::uint64_t budget, RunResult& result) {
+    while (runRetired_ < budget) {
+        const std::uint32_t pc = state_.pc;
+        stepImpl<false, Threaded>();
+        if (halted_) {
+            result.reason = StopReason::Halted;
+            return;
+        }
+        ++runRetired_;
+
+        // PC не пішов уперед — виконано зворотний перехід (інші інструкції лише додають 4).
+        if (state_.pc <= pc) [[unlikely]] {
+            skipIdleLoop(pc, budget, result);
+        }
+    }
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::skipIdleLoop(std::uint32_t tail, std::uint64_t budget, RunResult& result) {
+    const std::uint32_t head = state_.pc;
+    if (!idleLoop_.analyzed || idleLoop_.head != head || idleLoop_.tail != tail) {
+        analyzeIdleLoop(tail, head);
+    }
+    if (idleLoop_.body == nullptr) {
+        return;
+    }
+    if (idleLoop_.recheckIn != 0) {
+        --idleLoop_.recheckIn;
+        return;
+    }
+
+    const std::vector<DecodedInstruction>& ops = idleLoop_.body->ops;
+    const std::uint32_t length = static_cast<std::uint32_t>(ops.size());
+    const std::uint64_t fitting = (budget - runRetired_) / length;
+    if (fitting == 0) {
+        return;
+    }
+
+    // Прогін тіла від поточного стану: значення кожного регістру — функція лічильника t на початку ітерації.
+    std::array<CounterLinear, kNumRegisters> regs{};
+    for (std::size_t r = 0; r < kNumRegisters; ++r) {
+        regs[r] = CounterLinear{0, state_.regs[r]};
+    }
+    std::uint32_t written = 0;    // регістри, записані в ітерації
+    std::uint32_t readFirst = 0;  // регістри, прочитані до запису
+    const auto use = [&](std::uint8_t r) {
+        if ((written & (1u << r)) == 0) {
+            readFirst |= 1u << r;
+        }
+        return regs[r];
+    };
+
+    bool flagsSet = false;
+    CounterLinear flagsValue{};  // значення, від якого останнім виставлено Z/N
+    bool haveCounter = false;
+    std::uint32_t counterAddress = 0;
+
+    for (std::uint32_t i = 0; i + 1 < length; ++i) {
+        const DecodedInstruction& op = ops[i];
+        CounterLinear value{};
+        switch (op.opcode) {
+            case OPC_NOP:
+                continue;
+            case OPC_MOV:
+                value = op.isImm ? CounterLinear{0, op.imm} : use(op.rs);
+                break;
+            case OPC_ADD:
+            case OPC_SUB: {
+                const CounterLinear lhs = use(op.rd);
+                const CounterLinear rhs = op.isImm ? CounterLinear{0, op.imm} : use(op.rs);
+                value = op.opcode == OPC_ADD ? lhs + rhs : lhs - rhs;
+                break;
+            }
+            default: {  // OPC_LOAD (інше analyzeIdleLoop() не пропускає)
+                const CounterLinear base = use(op.rs);
+                const std::uint32_t address = base.offset + op.imm;
+                if (base.coef != 0) {
+                    idleLoop_.recheckIn = kIdleLoopRecheckInterval;
+                    return;  // адреса залежить від часу
+                }
+                if ((!haveCounter || counterAddress == address) && bus_->isCycleCounter(address)) {
+                    // i-та інструкція ітерації читає лічильник на i циклів пізніше за її початок.
+                    haveCounter = true;
+                    counterAddress = address;
+                    value = CounterLinear{1, i};
+                } else if (bus_->isStableRead(address, 4)) {
+                    value = CounterLinear{0, bus_->read32(address)};
+                } else {
+                    idleLoop_.recheckIn = kIdleLoopRecheckInterval;
+                    return;
+                }
+                break;
+            }
+        }
+        regs[op.rd] = value;
+        written |= 1u << op.rd;
+        flagsSet = true;
+        flagsValue = value;
+    }
+
+    // Наступна ітерація має стартувати з тих самих вхідних регістрів, інакше це не idle-цикл.
+    for (std::size_t r = 0; r < kNumRegisters; ++r) {
+        if ((readFirst & (1u << r)) != 0 && (regs[r].coef != 0 || regs[r].offset != state_.regs[r])) {
+            idleLoop_.recheckIn = kIdleLoopRecheckInterval;
+            return;
+        }
+    }
+
+    // Значення для Z на переході ітерації k: start + step * k (лічильник за ітерацію росте на length).
+    const std::uint32_t t0 = haveCounter ? bus_->read32(counterAddress) : 0;
+    std::uint32_t start = isFlagSet(Flag::Zero) ? 0u : 1u;
+    std::uint32_t step = 0;
+    if (flagsSet) {
+        start = flagsValue.at(t0);
+        step = flagsValue.coef * length;
+    }
+
+    // Перша ітерація, на якій перехід не спрацює (вихід з циклу).
+    std::uint64_t exitAt = kNeverSolved;
+    if (ops.back().opcode == OPC_JNZ) {
+        exitAt = solveModular(step, 0u - start);
+    } else if (ops.back().opcode == OPC_JZ) {
+        exitAt = start != 0 ? 0 : (step == 0 ? kNeverSolved : 1);
+    }
+
+    const std::uint64_t iterations = std::min(exitAt, fitting);
+    if (iterations == 0) {
+        return;
+    }
+
+    // Стан після останньої перемотаної ітерації; PC уже на head.
+    const std::uint32_t last = t0 + static_cast<std::uint32_t>((iterations - 1) * length);
+    for (std::size_t r = 0; r < kNumRegisters; ++r) {
+        if ((written & (1u << r)) != 0) {
+            state_.regs[r] = regs[r].at(last);
+        }
+    }
+    if (flagsSet) {
+        updateZNFlags(flagsValue.at(last));
+    }
+
+    const std::uint64_t instructions = iterations * length;
+    runRetired_ += instructions;
+    stepCount_ += static_cast<std::size_t>(instructions);
+    result.skipped += instructions;
 }
 
-void FakeCpu::reset() {
+template <typename Bus>
+void FakeCpuT<Bus>::analyzeIdleLoop(std::uint32_t tail, std::uint32_t head) {
+    // Блок на head з'являється лише з другим заходом у цикл — до того нічого не запам'ятовуємо.
+    idleLoop_ = IdleLoop{};
+    if ((tail - head) / 4u >= kMaxIdleLoopLength) {
+        idleLoop_ = IdleLoop{true, nullptr, head, tail, 0};
+        return;
+    }
+    const auto it = blocks_.find(head);
+    if (it == blocks_.end() || !it->second->complete || it->second->ops.back().pc != tail) {
+        return;
+    }
+
+    idleLoop_ = IdleLoop{true, nullptr, head, tail, 0};
+    const std::vector<DecodedInstruction>& ops = it->second->ops;
+    const std::uint8_t branch = ops.back().opcode;
+    if ((branch != OPC_JMP && branch != OPC_JZ && branch != OPC_JNZ) || ops.back().target != head) {
+        return;
+    }
+    for (std::size_t i = 0; i + 1 < ops.size(); ++i) {
+        const std::uint8_t opcode = ops[i].opcode;
+        if (opcode != OPC_NOP && opcode != OPC_MOV && opcode != OPC_ADD && opcode != OPC_SUB && opcode != OPC_LOAD) {
+            return;  // STORE, невідомі opcode
+        }
+    }
+    idleLoop_.body = it->second.get();
+}
+
+// --- Лічильні цикли затримки ---
+
+template <typename Bus>
+void FakeCpuT<Bus>::collapseCountedLoop(std::uint32_t tail, std::uint32_t head) {
+    if (!countedLoop_.analyzed || countedLoop_.tail != tail || countedLoop_.head != head) {
+        analyzeCountedLoop(tail, head);
+    }
+    if (!countedLoop_.valid) {
+        return;
+    }
+
+    // JNZ щойно перейшов, отже лічильник x != 0: ще x - 1 ітерацій повернуться на head,
+    // x-та вийде з циклу. Згортаємо стільки повних ітерацій, скільки вміщує бюджет run()
+    // (сам JNZ run() ще не зарахував); останню ітерацію CPU виконує звичайним шляхом.
+    const Register counter = state_.regs[countedLoop_.reg];
+    const std::uint64_t budgetLeft = runBudget_ - runRetired_ - 1;
+    const std::uint64_t iterations = std::min<std::uint64_t>(counter - 1u, budgetLeft / countedLoop_.length);
+    if (iterations == 0) {
+        return;
+    }
+
+    // NOP нічого не змінюють, SUB оновлює лише Rn і Z/N — кінцевий стан залежить тільки від Rn.
+    const Register result = static_cast<Register>(counter - iterations);
+    state_.regs[countedLoop_.reg] = result;
+    updateZNFlags(result);
+
+    const std::uint64_t instructions = iterations * countedLoop_.length;
+    runRetired_ += instructions;
+    stepCount_ += static_cast<std::size_t>(instructions);
+    collapsedInstructions_ += instructions;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::analyzeCountedLoop(std::uint32_t tail, std::uint32_t head) {
+    countedLoop_ = CountedLoop{};
+    countedLoop_.analyzed = true;
+    countedLoop_.tail = tail;
+    countedLoop_.head = head;
+
+    const std::uint32_t length = (tail - head) / 4u + 1u;
+    if (length > kMaxCountedLoopLength) {
+        return;
+    }
+
+    // Тіло [head, tail): лише NOP і рівно один SUB Rn, #1. Код читаємо тільки зі стабільної пам'яті.
+    bool haveCounter = false;
+    for (std::uint32_t pc = head; pc != tail; pc += 4) {
+        if (!bus_->isStableRead(pc, 4)) {
+            return;
+        }
+        const DecodedInstruction op = decode(fetch32(pc), pc);
+        if (op.opcode == OPC_NOP) {
+            continue;
+        }
+        if (op.opcode != OPC_SUB || !op.isImm || op.imm != 1u || haveCounter) {
+            return;
+        }
+        haveCounter = true;
+        countedLoop_.reg = op.rd;
+    }
+
+    countedLoop_.length = length;
+    countedLoop_.valid = haveCounter;
+}
+
+// --- Кеш декодованих блоків ---
+
+template <typename Bus>
+const typename FakeCpuT<Bus>::DecodedInstruction* FakeCpuT<Bus>::nextCachedInstruction() {
+    // 1. Продовжуємо поточний блок, якщо PC іде за ним.
+    if (cursorBlock_ != nullptr && cursorIndex_ < cursorBlock_->ops.size() &&
+        cursorBlock_->ops[cursorIndex_].pc == state_.pc) {
+        return &cursorBlock_->ops[cursorIndex_];
+    }
+
+    // 2. Відкритий блок, який ми саме записуємо, — наступна інструкція ще не декодована.
+    if (cursorBlock_ != nullptr && !cursorBlock_->complete && cursorIndex_ == cursorBlock_->ops.size() &&
+        !cursorBlock_->ops.empty() && cursorBlock_->ops.back().pc + 4u == state_.pc) {
+        return nullptr;
+    }
+
+    // 3. Перехід (або початок виконання): шукаємо блок, що стартує з PC.
+    auto it = blocks_.find(state_.pc);
+    if (it != blocks_.end()) {
+        cursorBlock_ = it->second.get();
+        cursorIndex_ = 0;
+        if (!cursorBlock_->ops.empty()) {
+            return &cursorBlock_->ops[0];
+        }
+        return nullptr;
+    }
+
+    // 4. Нового блоку немає — відкриваємо його; інструкції допишуться під час виконання.
+    if (blocks_.size() >= kMaxCachedBlocks) {
+        invalidateDecodeCache();
+    }
+
+    auto block = std::make_unique<DecodedBlock>();
+    block->startPc = state_.pc;
+    cursorBlock_ = block.get();
+    cursorIndex_ = 0;
+    blocks_.emplace(state_.pc, std::move(block));
+    return nullptr;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::recordInstruction(const DecodedInstruction& op) {
+    if (cursorBlock_ == nullptr || cursorBlock_->complete) {
+        return;
+    }
+
+    cursorBlock_->ops.push_back(op);
+    cursorIndex_ = cursorBlock_->ops.size();
+
+    if (endsBlock(op.opcode) || cursorBlock_->ops.size() >= kMaxBlockLength) {
+        cursorBlock_->complete = true;
+    }
+
+    codeLow_ = std::min(codeLow_, op.pc);
+    codeHigh_ = std::max(codeHigh_, op.pc + 4u);
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::invalidateOnWrite(std::uint32_t address, std::uint32_t size) noexcept {
+    const std::uint64_t begin = address;
+    const std::uint64_t end = begin + size;
+
+    // Розібраний цикл затримки теж може бути переписаний (кеш декодування може бути вимкнений).
+    if (countedLoop_.analyzed && end > countedLoop_.head && begin < static_cast<std::uint64_t>(countedLoop_.tail) + 4) {
+        countedLoop_ = CountedLoop{};
+    }
+
+    if (blocks_.empty()) {
+        return;
+    }
+    if (end <= codeLow_ || begin >= codeHigh_) {
+        return;
+    }
+
+    ELSIM_LOG_DEBUG("CPU", "write into cached code region — flushing decode cache");
+    invalidateDecodeCache();
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::invalidateDecodeCache() noexcept {
+    fetchWindow_ = {};
+    countedLoop_ = CountedLoop{};
+    idleLoop_ = IdleLoop{};
+    blocks_.clear();
+    cursorBlock_ = nullptr;
+    cursorIndex_ = 0;
+    codeLow_ = 0xFFFFFFFFu;
+    codeHigh_ = 0;
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::setDecodeCacheEnabled(bool enabled) noexcept {
+    decodeCacheEnabled_ = enabled;
+    invalidateDecodeCache();
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::reset() {
     // Скидаємо службові поля
     stepCount_ = 0;
+    collapsedInstructions_ = 0;
     imageLoaded_ = false;
     lastImagePath_.clear();
     halted_ = false;
+    pendingFault_ = nullptr;
 
     // Скидаємо архітектурний стан згідно ISA:
     // R0..R7 = 0
@@ -442,16 +1107,43 @@ void FakeCpu::reset() {
 
     // FLAGS = 0 (Z = N = C = V = 0)
     state_.flags = 0u;
+
+    invalidateDecodeCache();
 }
 
-bool FakeCpu::loadImage(const std::string& path) {
+template <typename Bus>
+bool FakeCpuT<Bus>::loadImage(const std::string& path) {
     lastImagePath_ = path;
     imageLoaded_ = !path.empty();
     return imageLoaded_;
 }
 
-void FakeCpu::setPc(std::uint32_t value) noexcept { state_.pc = value; }
+template <typename Bus>
+void FakeCpuT<Bus>::setPc(std::uint32_t value) noexcept {
+    state_.pc = value;
+    pendingFault_ = nullptr;
+
+    // Зміну PC ззовні (завантаження програми, тести) трактуємо як можливу зміну коду.
+    invalidateDecodeCache();
+}
+
+template <typename Bus>
+void FakeCpuT<Bus>::setMemoryBus(std::shared_ptr<IMemoryBus> bus) {
+    if constexpr (std::is_same_v<Bus, MemoryBus>) {
+        // Спеціалізований варіант: знімаємо адаптер і далі викликаємо MemoryBus напряму.
+        auto* adapter = dynamic_cast<MemoryBusAdapter*>(bus.get());
+        if (bus && (adapter == nullptr || adapter->target() == nullptr)) {
+            throw std::invalid_argument("MemoryBusFakeCpu::setMemoryBus: expected a MemoryBusAdapter over a MemoryBus");
+        }
+        bus_ = adapter != nullptr ? adapter->target() : nullptr;
+    } else {
+        bus_ = bus.get();
+    }
+    memoryBus_ = std::move(bus);
+    invalidateDecodeCache();
+}
 
-void FakeCpu::setMemoryBus(std::shared_ptr<IMemoryBus> bus) { memoryBus_ = std::move(bus); }
+template class FakeCpuT<IMemoryBus>;
+template class FakeCpuT<MemoryBus>;
 
 }  // namespace elsim::core
@@ -0,0 +1,62 @@
+#include "elsim/core/FileView.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ELSIM_FILE_VIEW_MMAP 1
+#else
+#define ELSIM_FILE_VIEW_MMAP 0
+#endif
+
+namespace elsim::core {
+
+FileView::FileView(const std::string& path) {
+#if ELSIM_FILE_VIEW_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open file '" + path + "'");
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error("'" + path + "' is not a regular file");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* mem = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem != MAP_FAILED) {
+            mapped_ = static_cast<const std::uint8_t*>(mem);
+        }
+    }
+    if (mapped_ != nullptr || size_ == 0) {
+        fd_ = fd;
+        return;
+    }
+    ::close(fd);
+#endif
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open file '" + path + "'");
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    size_ = buffer_.size();
+}
+
+FileView::~FileView() {
+#if ELSIM_FILE_VIEW_MMAP
+    if (mapped_ != nullptr) {
+        ::munmap(const_cast<std::uint8_t*>(mapped_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+}  // namespace elsim::core
@@ -1,6 +1,7 @@
 #include "elsim/core/GpioController.hpp"
 
 #include <stdexcept>
+#include <utility>
 
 namespace elsim::core {
 
@@ -91,12 +92,48 @@ void GpioController::injectInput(std::size_t pin, bool level) {
     } else {
         in_ &= ~b;
     }
+
+    if (input_observer_) {
+        input_observer_(pin, level);
+    }
 }
 
+void GpioController::setInputObserver(InputObserver observer) { input_observer_ = std::move(observer); }
+
 GpioController::GpioMask GpioController::getDirectionMask() const noexcept { return dir_; }
 GpioController::GpioMask GpioController::getOutputMask() const noexcept { return out_; }
 GpioController::GpioMask GpioController::getInputMask() const noexcept { return in_; }
 
+void GpioController::restoreMasks(GpioMask dir, GpioMask out, GpioMask in) {
+    const GpioMask valid = (pin_count_ == 64) ? ~static_cast<GpioMask>(0) : (bit_(pin_count_) - 1);
+    dir_ = dir & valid;
+    out_ = out & valid;
+    in_ = in & valid;
+
+    const GpioMask new_effective = dir_ & out_;
+    const GpioMask changed = effective_out_ ^ new_effective;
+    effective_out_ = new_effective;
+
+    if (changed == 0) {
+        return;
+    }
+
+    auto subs = out_subs_;
+    for (std::size_t pin = 0; pin < pin_count_; ++pin) {
+        const auto b = bit_(pin);
+        if ((changed & b) == 0) {
+            continue;
+        }
+        const bool now = (new_effective & b) != 0;
+        for (const auto& [id, cb] : subs) {
+            (void)id;
+            if (cb) {
+                cb(pin, now);
+            }
+        }
+    }
+}
+
 GpioController::SubscriptionId GpioController::subscribeOnOutputChanged(OutputCallback cb) {
     if (!cb) {
         throw std::invalid_argument("GpioController::subscribeOnOutputChanged: callback is empty");
@@ -0,0 +1,314 @@
+#include "elsim/core/HostMemory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "elsim/core/FileView.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ELSIM_HOST_MEMORY_MMAP 1
+#else
+#define ELSIM_HOST_MEMORY_MMAP 0
+#endif
+
+namespace elsim::core {
+namespace {
+
+constexpr std::size_t kZeroChunk = 4096;
+constexpr std::uint8_t kZeros[kZeroChunk] = {};
+
+bool isZero(const std::uint8_t* bytes, std::size_t size) { return std::memcmp(bytes, kZeros, size) == 0; }
+
+std::size_t roundUp(std::size_t value, std::size_t page) { return (value + page - 1) / page * page; }
+
+#if defined(__APPLE__)
+using MincoreFlag = char;
+#else
+using MincoreFlag = unsigned char;
+#endif
+
+}  // namespace
+
+std::size_t HostMemory::hostPageSize() noexcept {
+#if ELSIM_HOST_MEMORY_MMAP
+    static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return page;
+#else
+    return kZeroChunk;
+#endif
+}
+
+HostMemory::HostMemory(std::size_t capacity) : capacity_(capacity) {
+#if ELSIM_HOST_MEMORY_MMAP
+    if (capacity == 0) {
+        return;
+    }
+    // Лише адреси: PROT_NONE + MAP_NORESERVE не займає ні пам'яті, ні ліміту overcommit.
+    void* mem = ::mmap(nullptr, roundUp(capacity, hostPageSize()), PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem != MAP_FAILED) {
+        reservation_ = static_cast<std::uint8_t*>(mem);
+        data_ = reservation_;
+    }
+#endif
+}
+
+HostMemory::~HostMemory() { release(); }
+
+HostMemory::HostMemory(HostMemory&& other) noexcept
+    : reservation_(std::exchange(other.reservation_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      committed_(std::exchange(other.committed_, 0)),
+      heap_(std::move(other.heap_)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {
+    if (reservation_ == nullptr) {
+        data_ = heap_.data();
+    }
+}
+
+HostMemory& HostMemory::operator=(HostMemory&& other) noexcept {
+    if (this != &other) {
+        release();
+        reservation_ = std::exchange(other.reservation_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        committed_ = std::exchange(other.committed_, 0);
+        heap_ = std::move(other.heap_);
+        data_ = reservation_ != nullptr ? reservation_ : heap_.data();
+        size_ = std::exchange(other.size_, 0);
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+void HostMemory::release() noexcept {
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ != nullptr) {
+        ::munmap(reservation_, roundUp(capacity_, hostPageSize()));
+    }
+#endif
+    reservation_ = nullptr;
+    heap_.clear();
+    heap_.shrink_to_fit();
+    data_ = nullptr;
+    capacity_ = committed_ = size_ = 0;
+}
+
+void HostMemory::resize(std::size_t size) {
+    if (size > capacity_) {
+        throw std::length_error("HostMemory::resize: size exceeds reserved capacity");
+    }
+    if (size < size_) {
+        zero(size, size_ - size);
+        size_ = size;
+        return;
+    }
+
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ != nullptr) {
+        const std::size_t needed = roundUp(size, hostPageSize());
+        if (needed > committed_) {
+            if (::mprotect(reservation_ + committed_, needed - committed_, PROT_READ | PROT_WRITE) != 0) {
+                throw std::bad_alloc();
+            }
+            committed_ = needed;
+        }
+        size_ = size;
+        return;
+    }
+#endif
+    heap_.resize(size, 0U);
+    data_ = heap_.data();
+    size_ = size;
+}
+
+void HostMemory::zero(std::size_t offset, std::size_t size) {
+    if (offset > size_ || size > size_ - offset) {
+        throw std::out_of_range("HostMemory::zero: range outside of buffer");
+    }
+
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ != nullptr) {
+        // Цілі сторінки хоста замінюємо свіжими анонімними: вони знову нульові й не займають пам'яті.
+        const std::size_t page = hostPageSize();
+        const std::size_t begin = roundUp(offset, page);
+        const std::size_t end = (offset + size) / page * page;
+        if (begin < end) {
+            void* mem = ::mmap(reservation_ + begin, end - begin, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+            if (mem == MAP_FAILED) {
+                std::memset(reservation_ + begin, 0, end - begin);
+            }
+            std::memset(data_ + offset, 0, begin - offset);
+            std::memset(data_ + end, 0, offset + size - end);
+            return;
+        }
+    }
+#endif
+    std::memset(data_ + offset, 0, size);
+}
+
+void HostMemory::assign(std::span<const std::uint8_t> bytes) {
+    if (bytes.size() > capacity_) {
+        throw std::length_error("HostMemory::assign: size exceeds reserved capacity");
+    }
+    zero(0, size_);
+    resize(bytes.size());
+
+    for (std::size_t offset = 0; offset < bytes.size(); offset += kZeroChunk) {
+        const std::size_t chunk = std::min(kZeroChunk, bytes.size() - offset);
+        if (!isZero(bytes.data() + offset, chunk)) {
+            std::memcpy(data_ + offset, bytes.data() + offset, chunk);
+        }
+    }
+}
+
+std::size_t HostMemory::mapFile(std::size_t offset, const std::string& path) {
+    if (offset % hostPageSize() != 0 || offset > size_) {
+        throw std::invalid_argument("HostMemory::mapFile: offset must be host-page aligned and inside the buffer");
+    }
+
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ != nullptr) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open image file '" + path + "'");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            throw std::runtime_error("image '" + path + "' is not a regular file");
+        }
+        const auto fileSize = static_cast<std::size_t>(st.st_size);
+        if (fileSize > size_ - offset) {
+            ::close(fd);
+            throw std::invalid_argument("image '" + path + "' (" + std::to_string(fileSize) +
+                                        " bytes) does not fit into " + std::to_string(size_ - offset) + " bytes");
+        }
+        const bool mapped = mapDescriptor(offset, fd, fileSize);
+        ::close(fd);
+        if (mapped) {
+            return fileSize;
+        }
+    }
+#endif
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("cannot open image file '" + path + "'");
+    }
+    const auto fileSize = static_cast<std::size_t>(in.tellg());
+    if (fileSize > size_ - offset) {
+        throw std::invalid_argument("image '" + path + "' (" + std::to_string(fileSize) +
+                                    " bytes) does not fit into " + std::to_string(size_ - offset) + " bytes");
+    }
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(data_ + offset), static_cast<std::streamsize>(fileSize))) {
+        throw std::runtime_error("failed to read image file '" + path + "'");
+    }
+    return fileSize;
+}
+
+std::size_t HostMemory::mapFile(std::size_t offset, const FileView& file) {
+    const auto bytes = file.bytes();
+    if (offset % hostPageSize() != 0 || offset > size_) {
+        throw std::invalid_argument("HostMemory::mapFile: offset must be host-page aligned and inside the buffer");
+    }
+    if (bytes.size() > size_ - offset) {
+        throw std::invalid_argument("image (" + std::to_string(bytes.size()) + " bytes) does not fit into " +
+                                    std::to_string(size_ - offset) + " bytes");
+    }
+
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ != nullptr && file.nativeHandle() >= 0 && mapDescriptor(offset, file.nativeHandle(), bytes.size())) {
+        return bytes.size();
+    }
+#endif
+    std::memcpy(data_ + offset, bytes.data(), bytes.size());
+    return bytes.size();
+}
+
+bool HostMemory::mapDescriptor(std::size_t offset, int fd, std::size_t fileSize) {
+#if ELSIM_HOST_MEMORY_MMAP
+    // Спершу обнуляємо діапазон: старий вміст не має прозирати за кінцем файла в останній сторінці.
+    zero(offset, std::min(roundUp(fileSize, hostPageSize()), size_ - offset));
+    if (fileSize == 0) {
+        return true;
+    }
+    void* mem = ::mmap(reservation_ + offset, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (mem != MAP_FAILED) {
+        return true;
+    }
+    // Файл не відображається (напр. спеціальна ФС) — повертаємо анонімні сторінки, вміст скопіює викликач.
+    zero(offset, std::min(roundUp(fileSize, hostPageSize()), size_ - offset));
+#else
+    (void)offset;
+    (void)fd;
+    (void)fileSize;
+#endif
+    return false;
+}
+
+std::size_t HostMemory::residentBytes() const {
+#if ELSIM_HOST_MEMORY_MMAP
+    if (reservation_ == nullptr || size_ == 0) {
+        return size_;
+    }
+
+    const std::size_t page = hostPageSize();
+    const std::size_t pages = roundUp(size_, page) / page;
+    std::size_t resident = 0;
+
+#if defined(__linux__)
+    // pagemap: біт 63 — сторінка в пам'яті, біт 56 — відображена лише тут (спільна нульова
+    // сторінка, яку ядро підставляє при читанні, цей біт не має), біт 61 — сторінка файла з кешу ОС
+    // (незмінені сторінки образу, відображеного mapFile(), належать кешу, а не процесу).
+    const int fd = ::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        std::vector<std::uint64_t> entries(std::min<std::size_t>(pages, 64 * 1024));
+        const std::size_t first = reinterpret_cast<std::uintptr_t>(reservation_) / page;
+        bool ok = true;
+        for (std::size_t done = 0; ok && done < pages;) {
+            const std::size_t count = std::min(entries.size(), pages - done);
+            const auto bytes = static_cast<ssize_t>(count * sizeof(std::uint64_t));
+            ok = ::pread(fd, entries.data(), static_cast<std::size_t>(bytes),
+                         static_cast<off_t>((first + done) * sizeof(std::uint64_t))) == bytes;
+            for (std::size_t i = 0; ok && i < count; ++i) {
+                if ((entries[i] >> 63 & 1U) != 0 && (entries[i] >> 56 & 1U) != 0 && (entries[i] >> 61 & 1U) == 0) {
+                    resident += page;
+                }
+            }
+            done += count;
+        }
+        ::close(fd);
+        if (ok) {
+            return std::min(resident, size_);
+        }
+        resident = 0;
+    }
+#endif
+
+    std::vector<MincoreFlag> residency(pages);
+    if (::mincore(reservation_, pages * page, residency.data()) != 0) {
+        return size_;
+    }
+    for (const auto flag : residency) {
+        if ((flag & 1) != 0) {
+            resident += page;
+        }
+    }
+    return std::min(resident, size_);
+#else
+    return size_;
+#endif
+}
+
+}  // namespace elsim::core
@@ -0,0 +1,117 @@
+#include "elsim/core/InputLog.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#include "elsim/core/StateStream.hpp"
+
+namespace elsim::core {
+
+namespace {
+
+constexpr std::uint32_t kMagic = makeChunkTag("ELRP");
+
+std::uint32_t readVarU32(StateReader& in, const char* field) {
+    const std::uint64_t value = in.readVarU64();
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error(std::string("InputLog: ") + field + " does not fit into 32 bits");
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+}  // namespace
+
+void InputLog::append(const InputEvent& event) {
+    if (!events_.empty() && event.cycle < events_.back().cycle) {
+        throw std::invalid_argument("InputLog: event at cycle " + std::to_string(event.cycle) +
+                                    " is earlier than the previous one (" + std::to_string(events_.back().cycle) +
+                                    ")");
+    }
+    events_.push_back(event);
+}
+
+std::vector<std::uint8_t> InputLog::serialize() const {
+    StateWriter out;
+    out.writeU32(kMagic);
+    out.writeU32(kVersion);
+    out.writeString(boardName_);
+    out.writeU32(static_cast<std::uint32_t>(events_.size()));
+
+    std::uint64_t previous = 0;
+    for (const auto& event : events_) {
+        out.writeVarU64(event.cycle - previous);
+        out.writeU8(static_cast<std::uint8_t>(event.kind));
+        out.writeVarU64(event.channel);
+        out.writeVarU64(event.value);
+        previous = event.cycle;
+    }
+    return out.release();
+}
+
+InputLog InputLog::deserialize(std::span<const std::uint8_t> bytes) {
+    StateReader in(bytes);
+    if (in.remaining() < 8 || in.readU32() != kMagic) {
+        throw std::runtime_error("InputLog: not an input log (bad magic)");
+    }
+    const std::uint32_t version = in.readU32();
+    if (version != kVersion) {
+        throw std::runtime_error("InputLog: unsupported version " + std::to_string(version));
+    }
+
+    InputLog log(in.readString());
+    const std::uint32_t count = in.readU32();
+    std::uint64_t cycle = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const std::uint64_t delta = in.readVarU64();
+        if (delta > std::numeric_limits<std::uint64_t>::max() - cycle) {
+            throw std::runtime_error("InputLog: event cycle overflows 64 bits");
+        }
+        cycle += delta;
+
+        InputEvent event;
+        event.cycle = cycle;
+        const std::uint8_t kind = in.readU8();
+        if (kind != static_cast<std::uint8_t>(InputKind::GpioLevel)) {
+            throw std::runtime_error("InputLog: unknown input kind " + std::to_string(kind));
+        }
+        event.kind = static_cast<InputKind>(kind);
+        event.channel = readVarU32(in, "channel");
+        event.value = readVarU32(in, "value");
+        log.events_.push_back(event);
+    }
+    if (!in.atEnd()) {
+        throw std::runtime_error("InputLog: " + std::to_string(in.remaining()) + " trailing bytes");
+    }
+    return log;
+}
+
+void InputLog::saveToFile(const std::string& path) const {
+    const std::vector<std::uint8_t> bytes = serialize();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("InputLog: cannot open '" + path + "' for writing");
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("InputLog: failed to write '" + path + "'");
+    }
+}
+
+InputLog InputLog::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("InputLog: cannot open '" + path + "'");
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    try {
+        return deserialize(bytes);
+    } catch (const std::runtime_error& ex) {
+        throw std::runtime_error("Input log '" + path + "': " + ex.what());
+    }
+}
+
+}  // namespace elsim::core
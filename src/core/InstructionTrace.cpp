@@ -0,0 +1,309 @@
+#include "elsim/core/InstructionTrace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "elsim/core/SimClock.hpp"
+#include "elsim/core/StateStream.hpp"
+
+namespace elsim::core {
+
+namespace {
+
+constexpr std::uint32_t kMagic = makeChunkTag("ELTR");
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kRecordSize = sizeof(TraceRecord);
+
+// Скільки чекає фоновий потік, якщо в кільці менше блоку.
+constexpr auto kFlushPollInterval = std::chrono::microseconds(200);
+
+// Опкоди (див. docs/fakecpu_isa.md)
+constexpr std::array<std::pair<std::uint8_t, std::string_view>, 10> kOpcodeNames{{
+    {0x00, "NOP"},
+    {0x01, "MOV"},
+    {0x02, "ADD"},
+    {0x03, "SUB"},
+    {0x04, "LOAD"},
+    {0x05, "STORE"},
+    {0x06, "JMP"},
+    {0x07, "JZ"},
+    {0x08, "JNZ"},
+    {0xFF, "HALT"},
+}};
+
+void putU32(std::uint8_t* out, std::uint32_t value) noexcept {
+    for (unsigned i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint32_t getU32(const std::uint8_t* in) noexcept {
+    return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8) |
+           (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+}
+
+// Запис у файловому (little-endian) поданні; на little-endian хості — те саме, що байти структури.
+void encodeRecord(const TraceRecord& record, std::uint8_t* out) noexcept {
+    putU32(out, static_cast<std::uint32_t>(record.cycle));
+    putU32(out + 4, static_cast<std::uint32_t>(record.cycle >> 32));
+    putU32(out + 8, record.pc);
+    putU32(out + 12, record.instruction);
+    putU32(out + 16, record.memAddress);
+    putU32(out + 20, record.memValue);
+    out[24] = static_cast<std::uint8_t>(record.memAccess);
+    std::memset(out + 25, 0, 7);
+}
+
+TraceRecord decodeRecord(const std::uint8_t* in) {
+    TraceRecord record;
+    record.cycle = static_cast<std::uint64_t>(getU32(in)) | (static_cast<std::uint64_t>(getU32(in + 4)) << 32);
+    record.pc = getU32(in + 8);
+    record.instruction = getU32(in + 12);
+    record.memAddress = getU32(in + 16);
+    record.memValue = getU32(in + 20);
+    if (in[24] > static_cast<std::uint8_t>(TraceMemAccess::Write)) {
+        throw std::runtime_error("Trace: corrupted record (memory access kind " + std::to_string(in[24]) + ")");
+    }
+    record.memAccess = static_cast<TraceMemAccess>(in[24]);
+    return record;
+}
+
+std::string hex32(std::uint32_t value) {
+    std::ostringstream out;
+    out << "0x" << std::hex << std::setw(8) << std::setfill('0') << value;
+    return out.str();
+}
+
+}  // namespace
+
+// --- TraceWriter ---
+
+TraceWriter::TraceWriter(const std::string& path, std::size_t ringRecords) : path_(path) {
+    if (ringRecords < kFlushBlockRecords || !std::has_single_bit(ringRecords)) {
+        throw std::invalid_argument("TraceWriter: ring size must be a power of two >= " +
+                                    std::to_string(kFlushBlockRecords) + " records");
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        throw std::runtime_error("Trace: cannot open '" + path + "' for writing");
+    }
+
+    std::uint8_t header[kHeaderSize]{};
+    putU32(header, kMagic);
+    putU32(header + 4, kVersion);
+    putU32(header + 8, static_cast<std::uint32_t>(kRecordSize));
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header)) {
+        std::fclose(file_);
+        throw std::runtime_error("Trace: failed to write '" + path + "'");
+    }
+
+    ring_.resize(ringRecords);
+    mask_ = ringRecords - 1;
+    flusher_ = std::thread(&TraceWriter::flushLoop, this);
+}
+
+TraceWriter::~TraceWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Деструктор не кидає; помилку запису повідомляє явний close().
+    }
+}
+
+std::uint64_t TraceWriter::now() const noexcept {
+    return clock_ != nullptr ? clock_->now() : head_.load(std::memory_order_relaxed);
+}
+
+void TraceWriter::close() {
+    if (!flusher_.joinable()) {
+        return;
+    }
+
+    closing_.store(true, std::memory_order_release);
+    flusher_.join();
+
+    const bool closedOk = std::fclose(file_) == 0;
+    file_ = nullptr;
+    if (failed_.load(std::memory_order_relaxed) || !closedOk) {
+        throw std::runtime_error("Trace: failed to write '" + path_ + "'");
+    }
+}
+
+void TraceWriter::flushLoop() {
+    std::vector<std::uint8_t> encoded;
+    if constexpr (std::endian::native != std::endian::little) {
+        encoded.resize(kFlushBlockRecords * kRecordSize);
+    }
+
+    std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        // closing_ читаємо до head_: після close() producer уже не пише, тож head_ остаточний.
+        const bool closing = closing_.load(std::memory_order_acquire);
+        const std::uint64_t available = head_.load(std::memory_order_acquire) - tail;
+
+        if (available == 0 && closing) {
+            return;
+        }
+        if (available < kFlushBlockRecords && !closing) {
+            std::this_thread::sleep_for(kFlushPollInterval);
+            continue;
+        }
+
+        // Суцільний шматок до кінця кільця, не більше блоку.
+        const std::size_t start = static_cast<std::size_t>(tail & mask_);
+        const std::size_t count =
+            static_cast<std::size_t>(std::min<std::uint64_t>({available, kFlushBlockRecords, ring_.size() - start}));
+
+        if (!failed_.load(std::memory_order_relaxed)) {
+            const void* data = ring_.data() + start;
+            if constexpr (std::endian::native != std::endian::little) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    encodeRecord(ring_[start + i], encoded.data() + i * kRecordSize);
+                }
+                data = encoded.data();
+            }
+            if (std::fwrite(data, kRecordSize, count, file_) != count) {
+                failed_.store(true, std::memory_order_relaxed);  // далі лише звільняємо кільце
+            }
+        }
+
+        tail += count;
+        tail_.store(tail, std::memory_order_release);
+    }
+}
+
+// --- TraceReader ---
+
+TraceReader::TraceReader(const std::string& path) : path_(path), file_(path, std::ios::binary) {
+    if (!file_) {
+        throw std::runtime_error("Trace: cannot open '" + path + "'");
+    }
+
+    std::uint8_t header[kHeaderSize]{};
+    file_.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (file_.gcount() != static_cast<std::streamsize>(sizeof(header)) || getU32(header) != kMagic) {
+        throw std::runtime_error("Trace '" + path + "': not an elsim trace file (bad magic)");
+    }
+    if (getU32(header + 4) != TraceWriter::kVersion) {
+        throw std::runtime_error("Trace '" + path + "': unsupported version " + std::to_string(getU32(header + 4)));
+    }
+    if (getU32(header + 8) != kRecordSize) {
+        throw std::runtime_error("Trace '" + path + "': unexpected record size " + std::to_string(getU32(header + 8)));
+    }
+}
+
+bool TraceReader::next(TraceRecord& out) {
+    if (position_ + kRecordSize > buffer_.size()) {
+        // Дочитуємо наступний блок, зберігаючи недочитаний хвіст.
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(position_));
+        position_ = 0;
+
+        const std::size_t kept = buffer_.size();
+        buffer_.resize(kept + TraceWriter::kFlushBlockRecords * kRecordSize);
+        file_.read(reinterpret_cast<char*>(buffer_.data() + kept),
+                   static_cast<std::streamsize>(buffer_.size() - kept));
+        buffer_.resize(kept + static_cast<std::size_t>(file_.gcount()));
+
+        if (buffer_.empty()) {
+            return false;
+        }
+        if (buffer_.size() < kRecordSize) {
+            throw std::runtime_error("Trace '" + path_ + "': truncated record at the end of file");
+        }
+    }
+
+    out = decodeRecord(buffer_.data() + position_);
+    position_ += kRecordSize;
+    return true;
+}
+
+// --- Декодування ---
+
+std::optional<std::string_view> traceOpcodeName(std::uint8_t opcode) noexcept {
+    for (const auto& [code, name] : kOpcodeNames) {
+        if (code == opcode) {
+            return name;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::uint8_t> traceOpcodeFromName(std::string_view name) noexcept {
+    for (const auto& [code, known] : kOpcodeNames) {
+        if (known.size() == name.size() &&
+            std::equal(known.begin(), known.end(), name.begin(), [](char a, char b) {
+                return a == std::toupper(static_cast<unsigned char>(b));
+            })) {
+            return code;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string disassembleInstruction(std::uint32_t raw, std::uint32_t pc) {
+    const std::uint8_t opcode = static_cast<std::uint8_t>(raw >> 24);
+    const unsigned rd = (raw >> 21) & 0x7u;
+    const unsigned rs = (raw >> 18) & 0x7u;
+    const bool isImm = ((raw >> 17) & 0x1u) != 0;
+    const std::int32_t imm = static_cast<std::int16_t>(raw & 0xFFFFu);
+
+    std::ostringstream disasm;
+    const auto name = traceOpcodeName(opcode);
+    switch (opcode) {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+            disasm << *name << " R" << rd << ", ";
+            if (isImm) {
+                disasm << '#' << imm;
+            } else {
+                disasm << 'R' << rs;
+            }
+            break;
+        case 0x04:
+            disasm << "LOAD R" << rd << ", [R" << rs << " + " << imm << ']';
+            break;
+        case 0x05:
+            disasm << "STORE R" << rs << ", [R" << rd << " + " << imm << ']';
+            break;
+        case 0x06:
+        case 0x07:
+        case 0x08:
+            disasm << *name << ' ' << imm << " (-> " << hex32(pc + 4u + static_cast<std::uint32_t>(imm * 4)) << ')';
+            break;
+        default:
+            if (name) {
+                disasm << *name;
+            } else {
+                disasm << ".word " << hex32(raw);
+            }
+            break;
+    }
+    return disasm.str();
+}
+
+std::string formatTraceRecord(const TraceRecord& record) {
+    std::ostringstream text;
+    text << std::setw(12) << record.cycle << "  " << hex32(record.pc) << "  " << std::hex << std::setw(8)
+         << std::setfill('0') << record.instruction << std::dec << std::setfill(' ') << "  ";
+    text << std::left << std::setw(28) << disassembleInstruction(record.instruction, record.pc) << std::right;
+
+    if (record.memAccess != TraceMemAccess::None) {
+        text << (record.memAccess == TraceMemAccess::Read ? "R " : "W ") << '[' << hex32(record.memAddress)
+             << "] = " << hex32(record.memValue);
+    }
+
+    std::string line = text.str();
+    line.erase(line.find_last_not_of(' ') + 1);
+    return line;
+}
+
+}  // namespace elsim::core
@@ -1,9 +1,15 @@
 #include "elsim/core/MemoryBus.hpp"
 
+#include <algorithm>  // std::max, std::min
+#include <bit>        // std::endian
+#include <cstdint>
 #include <cstdio>
+#include <cstring>  // std::memcpy
 #include <stdexcept>  // std::out_of_range, std::invalid_argument, std::runtime_error
 #include <string>
 #include <string_view>
+#include <type_traits>  // std::is_same_v
+#include <utility>  // std::move
 
 #include "elsim/core/Logger.hpp"
 
@@ -12,26 +18,379 @@ namespace {
 
 constexpr std::string_view COMPONENT = "MMIO";
 
+// Облік у ReadWrite-вікнах (HostMemoryWindow::pageEpochs) ведеться тими самими сторінками, що й у шині.
+static_assert(HostMemoryWindow::kEpochPageBits == MemoryBus::kPageBits);
+static_assert(std::is_same_v<MemoryBus::DirtyEpoch, std::uint64_t>);
+
+// 32-бітний хост не зарезервує 8 GiB адрес — там HostMemory працює буфером у купі.
+std::size_t backingCapacity() {
+    return static_cast<std::size_t>(std::min<std::uint64_t>(MemoryBus::kMaxBackingBytes, SIZE_MAX));
+}
+
+// FNV-1a (64 біти) вмісту образу: прив'язує checkpoint до прошивки, з якою його збережено.
+std::uint64_t contentDigest(std::span<const std::uint8_t> bytes) noexcept {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const std::uint8_t b : bytes) {
+        hash = (hash ^ b) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
 }  // namespace
 
-// Конструктор: виділяємо RAM заданого розміру й заповнюємо нулями.
-MemoryBus::MemoryBus(std::size_t size) : m_memory(size, 0U) {}
+// Конструктор: один регіон RAM від адреси 0, заповнений нулями.
+MemoryBus::MemoryBus(std::size_t size) {
+    if (size > 0) {
+        mapRegion("ram", 0, size, kReadWriteExecute);
+    }
+}
+
+namespace {
+
+bool deviceContains(std::uint32_t base, std::uint32_t size, std::uint64_t address) {
+    return address >= base && address < static_cast<std::uint64_t>(base) + size;
+}
+
+}  // namespace
 
-// Пошук MMIO-девайса за глобальною адресою.
+// Пошук MMIO-девайса за глобальною адресою: один індексований запис таблиці сторінок.
 const MemoryBus::MappedDevice* MemoryBus::findDevice(std::uint32_t address) const {
-    // Лінійний пошук по вектору девайсів.
-    // На цьому етапі цього достатньо (потім можна оптимізувати).
-    for (const auto& dev : m_devices) {
-        // Діапазон девайса: [dev.base, dev.base + dev.size)
-        if (address >= dev.base && address < dev.base + dev.size) {
+    const PageEntry entry = pageEntry(address);
+    if (entry == kNoDevice) {
+        return nullptr;
+    }
+
+    if ((entry & kSharedPage) == 0) {
+        const auto& dev = m_devices[entry - 1];
+        return deviceContains(dev.base, dev.size, address) ? &dev : nullptr;
+    }
+
+    // Кілька дрібних девайсів в одній сторінці — перевіряємо лише їх.
+    for (const std::uint32_t index : m_sharedPages[entry & ~kSharedPage]) {
+        const auto& dev = m_devices[index];
+        if (deviceContains(dev.base, dev.size, address)) {
             return &dev;
         }
     }
     return nullptr;
 }
 
+// Пошук девайса, що перетинається з діапазоном адрес (size <= kPageSize, тобто не більше двох сторінок).
+const MemoryBus::MappedDevice* MemoryBus::findOverlap(std::uint32_t address, std::uint32_t size) const {
+    const std::uint64_t end = static_cast<std::uint64_t>(address) + size;
+
+    auto overlaps = [&](const MappedDevice& dev) {
+        const std::uint64_t devEnd = static_cast<std::uint64_t>(dev.base) + dev.size;
+        return address < devEnd && end > dev.base;
+    };
+
+    auto scanPage = [&](std::uint32_t pageAddress) -> const MappedDevice* {
+        const PageEntry entry = pageEntry(pageAddress);
+        if (entry == kNoDevice) {
+            return nullptr;
+        }
+        if ((entry & kSharedPage) == 0) {
+            const auto& dev = m_devices[entry - 1];
+            return overlaps(dev) ? &dev : nullptr;
+        }
+        for (const std::uint32_t index : m_sharedPages[entry & ~kSharedPage]) {
+            if (overlaps(m_devices[index])) {
+                return &m_devices[index];
+            }
+        }
+        return nullptr;
+    };
+
+    if (const auto* dev = scanPage(address)) {
+        return dev;
+    }
+
+    // Діапазон заходить у наступну сторінку (кінець 32-бітного простору не перетинаємо).
+    const std::uint64_t lastByte = end - 1;
+    if ((lastByte >> kPageBits) != (address >> kPageBits) && lastByte <= 0xFFFFFFFFull) {
+        return scanPage(static_cast<std::uint32_t>(lastByte));
+    }
+    return nullptr;
+}
+
+void MemoryBus::addDevicePages(std::uint32_t index, std::uint64_t base, std::uint64_t end) {
+    for (std::uint64_t page = base >> kPageBits; page <= (end - 1) >> kPageBits; ++page) {
+        PageSlot& slot = ensurePageSlot(static_cast<std::uint32_t>(page));
+        slot.fast = 0;  // доступ до пам'яті сторінки з девайсом — лише повільним шляхом
+
+        PageEntry& entry = slot.devices;
+        if (entry == kNoDevice) {
+            entry = index + 1;
+        } else if ((entry & kSharedPage) == 0) {
+            m_sharedPages.push_back({entry - 1, index});
+            entry = kSharedPage | static_cast<PageEntry>(m_sharedPages.size() - 1);
+        } else {
+            m_sharedPages[entry & ~kSharedPage].push_back(index);
+        }
+    }
+}
+
+// --- Регіони пам'яті ---
+
+MemoryBus::PageSlot& MemoryBus::ensurePageSlot(std::uint32_t page) {
+    auto& leaf = m_pageDirectory[page >> kLeafBits];
+    if (!leaf) {
+        leaf = std::make_unique<PageLeaf>();
+    }
+    return (*leaf)[page & (kLeafSize - 1)];
+}
+
+void MemoryBus::addRegion(std::string name, std::uint32_t base, std::uint64_t size, Permissions permissions,
+                          const std::string& imagePath) {
+    auto& logger = elsim::core::Logger::instance();
+
+    const std::uint64_t end = static_cast<std::uint64_t>(base) + size;
+    if (size == 0 || (base & (kPageSize - 1)) != 0 || end > (std::uint64_t{1} << 32)) {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "Invalid memory region '%s': base=0x%08X size=0x%llX", name.c_str(), base,
+                      static_cast<unsigned long long>(size));
+        logger.error(COMPONENT, buf);
+        throw std::invalid_argument("MemoryBus::mapRegion: region '" + name +
+                                    "' must be non-empty, page-aligned and inside the 32-bit address space");
+    }
+
+    for (const auto& region : m_regions) {
+        if (base < region.base + region.size && end > region.base) {
+            throw std::invalid_argument("MemoryBus::mapRegion: region '" + name + "' overlaps region '" +
+                                        region.name + "'");
+        }
+    }
+
+    // Вміст нового регіону — з наступної сторінки сховища. Резервація адрес створюється один раз;
+    // без неї (буфер у купі) сховище може переїхати, тож хост-адреси сторінок усіх регіонів перераховуються.
+    if (m_memory.capacity() == 0) {
+        m_memory = HostMemory(backingCapacity());
+    }
+    // Файл відображається цілими сторінками хоста, тож його регіон починається з межі сторінки хоста.
+    const std::size_t align =
+        imagePath.empty() ? kPageSize : std::max<std::size_t>(kPageSize, HostMemory::hostPageSize());
+    const std::size_t previousSize = m_memory.size();
+    const std::size_t offset = (previousSize + align - 1) / align * align;
+    m_memory.resize(offset + static_cast<std::size_t>(size));
+    std::unique_ptr<const FileView> image;
+    if (!imagePath.empty()) {
+        try {
+            // Той самий відкритий файл і відображається, і лишається еталоном (resetMemory, isInitialContent).
+            image = std::make_unique<const FileView>(imagePath);
+            m_memory.mapFile(offset, *image);
+        } catch (const std::exception& ex) {
+            m_memory.resize(previousSize);
+            logger.error(COMPONENT, "Cannot map image for memory region '" + name + "': " + ex.what());
+            throw;
+        }
+    }
+    m_pageEpoch.resize((m_memory.size() + kPageSize - 1) / kPageSize, 0U);
+
+    m_regions.push_back(Region{std::move(name), base, size, permissions, offset, imagePath});
+    if (image != nullptr) {
+        m_regions.back().imageSize = image->bytes().size();
+        m_regions.back().imageDigest = contentDigest(image->bytes());
+    }
+    m_images.push_back(std::move(image));
+    for (std::uint64_t page = base >> kPageBits; page <= (end - 1) >> kPageBits; ++page) {
+        PageSlot& slot = ensurePageSlot(static_cast<std::uint32_t>(page));
+        slot.permissions = permissions;
+        slot.fast = fastPermissions(slot, page);
+    }
+    refreshRegionPages();
+
+    if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "Map memory region '%s' [0x%08X..0x%08llX) %s",
+                      m_regions.back().name.c_str(), base, static_cast<unsigned long long>(end),
+                      formatPermissions(permissions).c_str());
+        logger.debug(COMPONENT, buf);
+    }
+}
+
+void MemoryBus::refreshRegionPages() {
+    for (const auto& region : m_regions) {
+        const std::uint32_t firstPage = region.base >> kPageBits;
+        const auto pages = static_cast<std::uint32_t>((region.size + kPageSize - 1) >> kPageBits);
+        for (std::uint32_t i = 0; i < pages; ++i) {
+            PageSlot& slot = ensurePageSlot(firstPage + i);
+            const std::size_t offset = region.offset + static_cast<std::size_t>(i) * kPageSize;
+            slot.host = m_memory.data() + offset;
+            slot.dirtyIndex = static_cast<std::uint32_t>(offset >> kPageBits);
+            slot.limit = static_cast<std::uint16_t>(std::min<std::uint64_t>(kPageSize, region.size - i * kPageSize));
+        }
+    }
+}
+
+void MemoryBus::protect(std::uint32_t address, std::uint64_t size, Permissions permissions) {
+    const std::uint64_t end = static_cast<std::uint64_t>(address) + size;
+    if (size == 0 || (address & (kPageSize - 1)) != 0 || end > (std::uint64_t{1} << 32)) {
+        throw std::invalid_argument("MemoryBus::protect: range must be non-empty and start on a page boundary");
+    }
+    for (std::uint64_t page = address >> kPageBits; page <= (end - 1) >> kPageBits; ++page) {
+        const PageSlot* slot = pageSlot(static_cast<std::uint32_t>(page << kPageBits));
+        if (slot == nullptr || slot->host == nullptr) {
+            throw std::invalid_argument("MemoryBus::protect: range is not fully covered by memory regions");
+        }
+    }
+
+    for (std::uint64_t page = address >> kPageBits; page <= (end - 1) >> kPageBits; ++page) {
+        PageSlot& slot = ensurePageSlot(static_cast<std::uint32_t>(page));
+        slot.permissions = permissions;
+        slot.fast = fastPermissions(slot, page);
+
+        // Сторінка, що отримала право запису після markBaseline(), у знімку ще не має копії: без запису
+        // її вміст не змінювався, тож теперішній і є базовим.
+        if (m_hasBaseline && (permissions & kWrite) != 0 && slot.dirtyIndex < m_baselinePages.size() &&
+            !m_baselinePages[slot.dirtyIndex]) {
+            snapshotBaselinePage(slot.dirtyIndex);
+        }
+    }
+}
+
+void MemoryBus::setWriteWatch(std::uint32_t address, std::uint32_t size, std::function<void()> onWrite) {
+    if (size == 0 || !onWrite) {
+        throw std::invalid_argument("MemoryBus::setWriteWatch: range must be non-empty and callback set");
+    }
+    clearWriteWatch();
+    m_watchBegin = address;
+    m_watchEnd = static_cast<std::uint64_t>(address) + size;
+    m_onWatchedWrite = std::move(onWrite);
+    refreshFastPermissions(m_watchBegin, m_watchEnd);
+}
+
+void MemoryBus::clearWriteWatch() {
+    const std::uint64_t begin = m_watchBegin;
+    const std::uint64_t end = m_watchEnd;
+    m_watchBegin = m_watchEnd = 0;
+    m_onWatchedWrite = nullptr;
+    if (begin < end) {
+        refreshFastPermissions(begin, end);
+    }
+}
+
+void MemoryBus::refreshFastPermissions(std::uint64_t begin, std::uint64_t end) {
+    for (std::uint64_t page = begin >> kPageBits; page <= (end - 1) >> kPageBits; ++page) {
+        if (pageSlot(static_cast<std::uint32_t>(page << kPageBits)) != nullptr) {
+            PageSlot& slot = ensurePageSlot(static_cast<std::uint32_t>(page));
+            slot.fast = fastPermissions(slot, page);
+        }
+    }
+}
+
+const MemoryBus::Region* MemoryBus::findRegion(std::uint32_t address) const noexcept {
+    for (const auto& region : m_regions) {
+        if (address >= region.base && address - region.base < region.size) {
+            return &region;
+        }
+    }
+    return nullptr;
+}
+
+MemoryBus::Permissions MemoryBus::permissionsAt(std::uint32_t address) const noexcept {
+    const PageSlot* slot = pageSlot(address);
+    if (slot == nullptr || slot->host == nullptr || (address & (kPageSize - 1)) >= slot->limit) {
+        return 0;
+    }
+    return slot->permissions;
+}
+
+MemoryBus::Permissions MemoryBus::parsePermissions(std::string_view text) {
+    Permissions permissions = 0;
+    const auto invalid = [&]() {
+        return std::invalid_argument("invalid memory permissions '" + std::string(text) +
+                                     "': expected a combination of 'r', 'w', 'x' (e.g. \"rwx\", \"r-x\")");
+    };
+    if (text.empty()) {
+        throw invalid();
+    }
+
+    for (const char c : text) {
+        Permissions bit = 0;
+        switch (c) {
+            case 'r':
+                bit = kRead;
+                break;
+            case 'w':
+                bit = kWrite;
+                break;
+            case 'x':
+                bit = kExecute;
+                break;
+            case '-':
+                continue;
+            default:
+                throw invalid();
+        }
+        if ((permissions & bit) != 0) {
+            throw invalid();
+        }
+        permissions |= bit;
+    }
+    return permissions;
+}
+
+std::string MemoryBus::formatPermissions(Permissions permissions) {
+    std::string text = "---";
+    if ((permissions & kRead) != 0) {
+        text[0] = 'r';
+    }
+    if ((permissions & kWrite) != 0) {
+        text[1] = 'w';
+    }
+    if ((permissions & kExecute) != 0) {
+        text[2] = 'x';
+    }
+    return text;
+}
+
+namespace {
+
+const char* accessName(MemoryBus::Permissions need) {
+    if (need == MemoryBus::kWrite) {
+        return "WRITE";
+    }
+    return need == MemoryBus::kExecute ? "FETCH" : "READ";
+}
+
+}  // namespace
+
+// Сторінка пам'яті регіону для байта address: межі регіонів і права сторінки.
+const MemoryBus::PageSlot& MemoryBus::memorySlot(std::uint32_t address, Permissions need,
+                                                 const char* operation) const {
+    auto& logger = elsim::core::Logger::instance();
+
+    const PageSlot* slot = pageSlot(address);
+    if (slot == nullptr || slot->host == nullptr || (address & (kPageSize - 1)) >= slot->limit) {
+        // Адреса поза регіонами пам'яті → кидаємо виняток.
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "%s out-of-range addr=0x%08X size=1 (memory_size=%zu)", accessName(need),
+                      address, m_memory.size());
+        logger.error(COMPONENT, buf);
+
+        throw std::out_of_range(std::string("MemoryBus::") + operation + ": address out of range");
+    }
+
+    if ((slot->permissions & need) == 0) {
+        const Region* region = findRegion(address);
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%s permission denied addr=0x%08X region='%s' permissions=%s",
+                      accessName(need), address, region->name.c_str(), formatPermissions(slot->permissions).c_str());
+        logger.error(COMPONENT, buf);
+
+        char message[192];
+        std::snprintf(message, sizeof(message), "MemoryBus::%s: %s access denied at 0x%08X in region '%s' (%s)",
+                      operation, need == kWrite ? "write" : (need == kExecute ? "execute" : "read"), address,
+                      region->name.c_str(), formatPermissions(slot->permissions).c_str());
+        throw std::runtime_error(message);
+    }
+    return *slot;
+}
+
 // Читання 1 байта з глобальної адреси.
-std::uint8_t MemoryBus::read8(std::uint32_t address) const {
+std::uint8_t MemoryBus::read8(std::uint32_t address) const { return readByte(address, kRead, "read8"); }
+
+std::uint8_t MemoryBus::readByte(std::uint32_t address, Permissions need, const char* operation) const {
     auto& logger = elsim::core::Logger::instance();
 
     // 1. Спершу перевіряємо, чи адреса належить MMIO-девайсу.
@@ -39,31 +398,27 @@ std::uint8_t MemoryBus::read8(std::uint32_t address) const {
         const auto offset = address - mapped->base;        // локальний зсув у девайсі
         const auto value = mapped->device->read8(offset);  // MMIO path
 
-        char buf[128];
-        std::snprintf(buf, sizeof(buf), "READ dev_base=0x%08X addr=0x%08X offset=0x%08X size=1 -> 0x%02X", mapped->base,
-                      address, offset, static_cast<unsigned int>(value));
-        logger.debug(COMPONENT, buf);
+        if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+            char buf[128];
+            std::snprintf(buf, sizeof(buf), "READ dev_base=0x%08X addr=0x%08X offset=0x%08X size=1 -> 0x%02X",
+                          mapped->base, address, offset, static_cast<unsigned int>(value));
+            logger.debug(COMPONENT, buf);
+        }
 
         return value;
     }
 
-    // 2. Якщо девайс не знайдено — працюємо з RAM.
-    if (address >= m_memory.size()) {
-        // Адреса поза межами RAM → кидаємо виняток.
-        char buf[128];
-        std::snprintf(buf, sizeof(buf), "READ out-of-range addr=0x%08X size=1 (ram_size=%zu)", address,
-                      m_memory.size());
-        logger.error(COMPONENT, buf);
+    // 2. Якщо девайс не знайдено — працюємо з пам'яттю регіону (межі й права перевіряє memorySlot).
+    const PageSlot& slot = memorySlot(address, need, operation);
+    const auto value = slot.host[address & (kPageSize - 1)];  // RAM path
 
-        throw std::out_of_range("MemoryBus::read8: address out of range");
+    if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "READ RAM addr=0x%08X size=1 -> 0x%02X", address,
+                      static_cast<unsigned int>(value));
+        logger.debug(COMPONENT, buf);
     }
 
-    const auto value = m_memory[address];  // RAM path
-
-    char buf[128];
-    std::snprintf(buf, sizeof(buf), "READ RAM addr=0x%08X size=1 -> 0x%02X", address, static_cast<unsigned int>(value));
-    logger.debug(COMPONENT, buf);
-
     return value;
 }
 
@@ -75,34 +430,131 @@ void MemoryBus::write8(std::uint32_t address, std::uint8_t value) {
     if (const auto* mapped = findDevice(address)) {
         const auto offset = address - mapped->base;  // локальний зсув у девайсі
 
-        char buf[128];
-        std::snprintf(buf, sizeof(buf), "WRITE dev_base=0x%08X addr=0x%08X offset=0x%08X size=1 value=0x%02X",
-                      mapped->base, address, offset, static_cast<unsigned int>(value));
-        logger.debug(COMPONENT, buf);
+        if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+            char buf[128];
+            std::snprintf(buf, sizeof(buf), "WRITE dev_base=0x%08X addr=0x%08X offset=0x%08X size=1 value=0x%02X",
+                          mapped->base, address, offset, static_cast<unsigned int>(value));
+            logger.debug(COMPONENT, buf);
+        }
 
         mapped->device->write8(offset, value);  // MMIO path
         return;
     }
 
-    // 2. Якщо девайса немає — пишемо в RAM.
-    if (address >= m_memory.size()) {
-        // Адреса поза межами RAM → це помилка.
+    // 2. Якщо девайса немає — пишемо в пам'ять регіону (межі й права перевіряє memorySlot).
+    const PageSlot& slot = memorySlot(address, kWrite, "write8");
+
+    if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
         char buf[128];
-        std::snprintf(buf, sizeof(buf), "WRITE out-of-range addr=0x%08X size=1 value=0x%02X (ram_size=%zu)", address,
-                      static_cast<unsigned int>(value), m_memory.size());
-        logger.error(COMPONENT, buf);
+        std::snprintf(buf, sizeof(buf), "WRITE RAM addr=0x%08X size=1 value=0x%02X", address,
+                      static_cast<unsigned int>(value));
+        logger.debug(COMPONENT, buf);
+    }
+
+    slot.host[address & (kPageSize - 1)] = value;  // RAM path
+    m_pageEpoch[slot.dirtyIndex] = m_epoch;
+    notifyWrite(address, 1);
+}
+
+// --- Широкі транзакції (16/32 біти, little-endian) ---
+
+template <typename T>
+T MemoryBus::readWide(std::uint32_t address, Permissions need) const {
+    constexpr std::uint32_t kSize = sizeof(T);
+    const std::uint64_t end = static_cast<std::uint64_t>(address) + kSize;
+
+    if (const auto* mapped = findOverlap(address, kSize)) {
+        // Увесь доступ усередині одного девайса — одна транзакція девайса.
+        if (address >= mapped->base && end <= static_cast<std::uint64_t>(mapped->base) + mapped->size) {
+            const auto offset = address - mapped->base;
+            T value{};
+            if constexpr (kSize == 2) {
+                value = mapped->device->read16(offset);
+            } else {
+                value = mapped->device->read32(offset);
+            }
+
+            ELSIM_LOG_DEBUG(COMPONENT, "READ dev_base=0x" << std::hex << mapped->base << " addr=0x" << address
+                                                          << " offset=0x" << offset << std::dec << " size=" << kSize
+                                                          << " -> 0x" << std::hex << value);
+            return value;
+        }
+    } else if (const PageSlot* slot = pageSlot(address); slot != nullptr && (slot->permissions & need) != 0 &&
+                                                         (address & (kPageSize - 1)) + kSize <= slot->limit) {
+        // Пам'ять в одній сторінці — одне читання буфера.
+        const std::uint8_t* bytes = slot->host + (address & (kPageSize - 1));
+        T value{};
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&value, bytes, kSize);
+        } else {
+            for (std::uint32_t i = 0; i < kSize; ++i) {
+                value |= static_cast<T>(static_cast<T>(bytes[i]) << (8u * i));
+            }
+        }
+
+        ELSIM_LOG_DEBUG(COMPONENT, "READ RAM addr=0x" << std::hex << address << std::dec << " size=" << kSize
+                                                      << " -> 0x" << std::hex << value);
+        return value;
+    }
 
-        throw std::out_of_range("MemoryBus::write8: address out of range");
+    // Доступ перетинає межу сторінки, девайса чи регіону (або прав не вистачає) — побайтово, як раніше.
+    const char* operation = need == kExecute ? "fetch32" : "read8";
+    T value{};
+    for (std::uint32_t i = 0; i < kSize; ++i) {
+        value |= static_cast<T>(static_cast<T>(readByte(address + i, need, operation)) << (8u * i));
     }
+    return value;
+}
 
-    char buf[128];
-    std::snprintf(buf, sizeof(buf), "WRITE RAM addr=0x%08X size=1 value=0x%02X", address,
-                  static_cast<unsigned int>(value));
-    logger.debug(COMPONENT, buf);
+template <typename T>
+void MemoryBus::writeWide(std::uint32_t address, T value) {
+    constexpr std::uint32_t kSize = sizeof(T);
+    const std::uint64_t end = static_cast<std::uint64_t>(address) + kSize;
+
+    if (const auto* mapped = findOverlap(address, kSize)) {
+        if (address >= mapped->base && end <= static_cast<std::uint64_t>(mapped->base) + mapped->size) {
+            const auto offset = address - mapped->base;
+
+            ELSIM_LOG_DEBUG(COMPONENT, "WRITE dev_base=0x" << std::hex << mapped->base << " addr=0x" << address
+                                                           << " offset=0x" << offset << std::dec << " size=" << kSize
+                                                           << " value=0x" << std::hex << value);
+
+            if constexpr (kSize == 2) {
+                mapped->device->write16(offset, value);
+            } else {
+                mapped->device->write32(offset, value);
+            }
+            return;
+        }
+    } else if (const PageSlot* slot = pageSlot(address); slot != nullptr && (slot->permissions & kWrite) != 0 &&
+                                                         (address & (kPageSize - 1)) + kSize <= slot->limit) {
+        ELSIM_LOG_DEBUG(COMPONENT, "WRITE RAM addr=0x" << std::hex << address << std::dec << " size=" << kSize
+                                                       << " value=0x" << std::hex << value);
+
+        std::uint8_t* bytes = slot->host + (address & (kPageSize - 1));
+        m_pageEpoch[slot->dirtyIndex] = m_epoch;
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(bytes, &value, kSize);
+        } else {
+            for (std::uint32_t i = 0; i < kSize; ++i) {
+                bytes[i] = static_cast<std::uint8_t>(value >> (8u * i));
+            }
+        }
+        notifyWrite(address, kSize);
+        return;
+    }
 
-    m_memory[address] = value;  // RAM path
+    for (std::uint32_t i = 0; i < kSize; ++i) {
+        write8(address + i, static_cast<std::uint8_t>(value >> (8u * i)));
+    }
 }
 
+// Повільний шлях вбудованих read16/read32/write16/write32 (MemoryBus.hpp).
+template std::uint16_t MemoryBus::readWide<std::uint16_t>(std::uint32_t address, Permissions need) const;
+template std::uint32_t MemoryBus::readWide<std::uint32_t>(std::uint32_t address, Permissions need) const;
+template void MemoryBus::writeWide<std::uint16_t>(std::uint32_t address, std::uint16_t value);
+template void MemoryBus::writeWide<std::uint32_t>(std::uint32_t address, std::uint32_t value);
+
 // Підключення MMIO-девайса до шини пам'яті.
 void MemoryBus::mapDevice(std::uint32_t baseAddress, std::uint32_t size, std::shared_ptr<IMemoryMappedDevice> device) {
     auto& logger = elsim::core::Logger::instance();
@@ -115,30 +567,396 @@ void MemoryBus::mapDevice(std::uint32_t baseAddress, std::uint32_t size, std::sh
     // Новий діапазон: [baseAddress, baseAddress + size)
     const auto newEnd = baseAddress + size;
 
-    // Перевірка перекриття регіонів.
-    for (const auto& dev : m_devices) {
-        // Існуючий діапазон: [dev.base, dev.base + dev.size)
-        const auto end = dev.base + dev.size;
-
-        const bool overlap = !(newEnd <= dev.base || baseAddress >= end);
+    // Діапазон у 64 бітах, обрізаний кінцем 32-бітного адресного простору.
+    const std::uint64_t rangeBegin = baseAddress;
+    const std::uint64_t rangeEnd = std::min<std::uint64_t>(rangeBegin + size, std::uint64_t{1} << 32);
 
-        if (overlap) {
+    // Перевірка перекриття регіонів: лише девайси зі сторінок, які займає новий діапазон.
+    auto checkOverlap = [&](std::uint32_t index) {
+        const auto& dev = m_devices[index];
+        const std::uint64_t end = static_cast<std::uint64_t>(dev.base) + dev.size;
+        if (rangeBegin < end && rangeEnd > dev.base) {
             char buf[160];
             std::snprintf(buf, sizeof(buf),
                           "Overlapping device region: new [0x%08X..0x%08X) conflicts with "
                           "existing [0x%08X..0x%08X)",
-                          baseAddress, newEnd, dev.base, end);
+                          baseAddress, newEnd, dev.base, static_cast<std::uint32_t>(end));
             logger.error(COMPONENT, buf);
 
             throw std::runtime_error("MemoryBus::mapDevice: overlapping device region");
         }
+    };
+
+    if (rangeEnd > rangeBegin) {
+        for (std::uint64_t page = rangeBegin >> kPageBits; page <= (rangeEnd - 1) >> kPageBits; ++page) {
+            const PageEntry entry = pageEntry(static_cast<std::uint32_t>(page << kPageBits));
+            if (entry == kNoDevice) {
+                continue;
+            }
+            if ((entry & kSharedPage) == 0) {
+                checkOverlap(entry - 1);
+            } else {
+                for (const std::uint32_t index : m_sharedPages[entry & ~kSharedPage]) {
+                    checkOverlap(index);
+                }
+            }
+        }
     }
 
-    char buf[128];
-    std::snprintf(buf, sizeof(buf), "Map device region [0x%08X..0x%08X) size=0x%X", baseAddress, newEnd, size);
-    logger.debug(COMPONENT, buf);
+    if (ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "Map device region [0x%08X..0x%08X) size=0x%X", baseAddress, newEnd, size);
+        logger.debug(COMPONENT, buf);
+    }
 
-    // Якщо перекриття немає — додаємо девайс.
+    // Якщо перекриття немає — додаємо девайс і прописуємо його в таблицю сторінок.
     m_devices.push_back(MappedDevice{baseAddress, size, std::move(device)});
+    if (rangeEnd > rangeBegin) {
+        addDevicePages(static_cast<std::uint32_t>(m_devices.size() - 1), rangeBegin, rangeEnd);
+    }
+}
+
+bool MemoryBus::isStableRead(std::uint32_t address, std::uint32_t size) const {
+    const std::uint64_t end = static_cast<std::uint64_t>(address) + size;
+
+    if (const auto* mapped = findOverlap(address, size)) {
+        // Лише якщо весь діапазон в одному девайсі — інакше частина може бути поза ним.
+        return address >= mapped->base && end <= static_cast<std::uint64_t>(mapped->base) + mapped->size &&
+               mapped->device->hasStableReads();
+    }
+
+    // Пам'ять: обидва крайні байти (діапазон не довший за сторінку) читабельні.
+    return end <= (std::uint64_t{1} << 32) && (permissionsAt(address) & kRead) != 0 &&
+           (permissionsAt(static_cast<std::uint32_t>(end - 1)) & kRead) != 0;
+}
+
+bool MemoryBus::isCycleCounter(std::uint32_t address) const {
+    const auto* mapped = findOverlap(address, 4);
+    return mapped != nullptr && address >= mapped->base &&
+           static_cast<std::uint64_t>(address) + 4 <= static_cast<std::uint64_t>(mapped->base) + mapped->size &&
+           mapped->device->isCycleCounter(address - mapped->base);
+}
+
+// Вікно прямого доступу: сторінки регіону з потрібними правами навколо address,
+// звужені девайсами зліва і справа.
+HostMemoryWindow MemoryBus::hostWindow(std::uint32_t address, HostAccess access) {
+    const Region* region = findRegion(address);
+    Permissions need = kRead;
+    if (access == HostAccess::ReadWrite) {
+        need = kRead | kWrite;
+    } else if (access == HostAccess::Execute) {
+        need = kExecute;
+    }
+    // Сторінки під спостереженням за записами пишуться лише через шину.
+    const bool excludeWatched = access == HostAccess::ReadWrite;
+    if (region == nullptr || (permissionsAt(address) & need) != need ||
+        (excludeWatched && isWatchedPage(address >> kPageBits))) {
+        return {};
+    }
+    const auto allows = [&](std::uint64_t page) {
+        return (pageSlot(static_cast<std::uint32_t>(page << kPageBits))->permissions & need) == need &&
+               !(excludeWatched && isWatchedPage(page));
+    };
+    const std::uint64_t firstPage = region->base >> kPageBits;
+    const std::uint64_t lastPage = (region->base + region->size - 1) >> kPageBits;
+    std::uint64_t beginPage = address >> kPageBits;
+    std::uint64_t endPage = beginPage;
+    while (beginPage > firstPage && allows(beginPage - 1)) {
+        --beginPage;
+    }
+    while (endPage < lastPage && allows(endPage + 1)) {
+        ++endPage;
+    }
+
+    std::uint64_t begin = beginPage << kPageBits;
+    std::uint64_t end = std::min((endPage + 1) << kPageBits, region->base + region->size);
+
+    for (const auto& dev : m_devices) {
+        const std::uint64_t devBegin = dev.base;
+        const std::uint64_t devEnd = devBegin + dev.size;
+
+        if (address >= devBegin && address < devEnd) {
+            return {};  // адреса належить MMIO
+        }
+        if (devEnd <= address) {
+            begin = std::max(begin, devEnd);
+        } else {
+            end = std::min(end, devBegin);
+        }
+    }
+
+    const std::size_t offset = region->offset + static_cast<std::size_t>(begin - region->base);
+    HostMemoryWindow window{};
+    window.base = static_cast<std::uint32_t>(begin);
+    window.bytes = std::span<std::uint8_t>(m_memory.data() + offset, static_cast<std::size_t>(end - begin));
+    if (access == HostAccess::ReadWrite) {
+        window.pageEpochs = m_pageEpoch.data() + (offset >> kPageBits);
+        window.epoch = &m_epoch;
+        window.pageOffset = static_cast<std::uint32_t>(offset & (kPageSize - 1));
+    }
+    return window;
+}
+
+void MemoryBus::loadBytes(std::uint32_t address, std::span<const std::uint8_t> bytes) {
+    copyIn(address, bytes, 0, "loadBytes");
+}
+
+void MemoryBus::writeBlock(std::uint32_t address, std::span<const std::uint8_t> bytes) {
+    copyIn(address, bytes, kWrite, "writeBlock");
+}
+
+void MemoryBus::readBlock(std::uint32_t address, std::span<std::uint8_t> out) const {
+    checkBlockRange(address, out.size(), "readBlock");
+    ELSIM_LOG_DEBUG(COMPONENT, "READ block addr=0x" << std::hex << address << std::dec << " size=" << out.size());
+
+    std::size_t pos = 0;
+    while (pos < out.size()) {
+        const auto current = static_cast<std::uint32_t>(address + pos);
+        const std::uint32_t offset = current & (kPageSize - 1);
+        const PageSlot* slot = pageSlot(current);
+
+        // Сторінка пам'яті без девайсів — копіюємо все, що з неї можна взяти.
+        if (slot != nullptr && slot->host != nullptr && slot->devices == kNoDevice && offset < slot->limit &&
+            (slot->permissions & kRead) != 0) {
+            const std::size_t chunk = std::min<std::size_t>(slot->limit - offset, out.size() - pos);
+            std::memcpy(out.data() + pos, slot->host + offset, chunk);
+            pos += chunk;
+            continue;
+        }
+
+        // Девайс — вирівняними 32-бітними транзакціями, краї — по байту.
+        if (const auto* mapped = findDevice(current)) {
+            const std::uint32_t deviceOffset = current - mapped->base;
+            if ((deviceOffset & 3u) == 0 && out.size() - pos >= 4 && mapped->size - deviceOffset >= 4) {
+                const std::uint32_t value = mapped->device->read32(deviceOffset);
+                for (std::uint32_t i = 0; i < 4; ++i) {
+                    out[pos + i] = static_cast<std::uint8_t>(value >> (8 * i));
+                }
+                pos += 4;
+            } else {
+                out[pos++] = mapped->device->read8(deviceOffset);
+            }
+            continue;
+        }
+
+        out[pos++] = memorySlot(current, kRead, "readBlock").host[offset];
+    }
+}
+
+void MemoryBus::checkBlockRange(std::uint32_t address, std::size_t size, const char* operation) {
+    if (static_cast<std::uint64_t>(address) + size > (std::uint64_t{1} << 32)) {
+        throw std::out_of_range(std::string("MemoryBus::") + operation + ": range exceeds the 32-bit address space");
+    }
+}
+
+void MemoryBus::copyIn(std::uint32_t address, std::span<const std::uint8_t> bytes, Permissions need,
+                       const char* operation) {
+    checkBlockRange(address, bytes.size(), operation);
+    ELSIM_LOG_DEBUG(COMPONENT, "WRITE block addr=0x" << std::hex << address << std::dec << " size=" << bytes.size());
+
+    std::size_t pos = 0;
+    while (pos < bytes.size()) {
+        const auto current = static_cast<std::uint32_t>(address + pos);
+        const std::uint32_t offset = current & (kPageSize - 1);
+        const PageSlot* slot = pageSlot(current);
+
+        // Сторінка пам'яті без девайсів — копіюємо все, що в неї влазить.
+        if (slot != nullptr && slot->host != nullptr && slot->devices == kNoDevice && offset < slot->limit &&
+            (need == 0 || (slot->permissions & need) != 0)) {
+            const std::size_t chunk = std::min<std::size_t>(slot->limit - offset, bytes.size() - pos);
+            std::memcpy(slot->host + offset, bytes.data() + pos, chunk);
+            m_pageEpoch[slot->dirtyIndex] = m_epoch;
+            notifyWrite(current, chunk);
+            pos += chunk;
+            continue;
+        }
+
+        // Девайс — вирівняними 32-бітними транзакціями, краї — по байту.
+        if (const auto* mapped = findDevice(current)) {
+            const std::uint32_t deviceOffset = current - mapped->base;
+            if ((deviceOffset & 3u) == 0 && bytes.size() - pos >= 4 && mapped->size - deviceOffset >= 4) {
+                std::uint32_t value = 0;
+                for (std::uint32_t i = 0; i < 4; ++i) {
+                    value |= static_cast<std::uint32_t>(bytes[pos + i]) << (8 * i);
+                }
+                mapped->device->write32(deviceOffset, value);
+                pos += 4;
+            } else {
+                mapped->device->write8(deviceOffset, bytes[pos++]);
+            }
+            continue;
+        }
+
+        // Пам'ять у сторінці з девайсами (або без потрібного права — тоді memorySlot кине виняток).
+        if (need != 0) {
+            slot = &memorySlot(current, need, operation);
+        } else if (slot == nullptr || slot->host == nullptr || offset >= slot->limit) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "MemoryBus::%s: address 0x%08X out of range", operation, current);
+            throw std::out_of_range(buf);
+        }
+        slot->host[offset] = bytes[pos++];
+        m_pageEpoch[slot->dirtyIndex] = m_epoch;
+    }
+}
+
+// --- Облік змінених сторінок і базовий знімок RAM ---
+
+std::span<std::uint8_t> MemoryBus::ram() noexcept {
+    std::fill(m_pageEpoch.begin(), m_pageEpoch.end(), m_epoch);
+    return m_memory.bytes();
+}
+
+std::uint64_t MemoryBus::declaredBytes() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto& region : m_regions) {
+        total += region.size;
+    }
+    return total;
+}
+
+void MemoryBus::resetMemory() {
+    m_memory.zero(0, m_memory.size());
+    for (std::size_t i = 0; i < m_regions.size(); ++i) {
+        if (m_images[i] == nullptr) {
+            continue;
+        }
+        // З утримуваного образу, не за шляхом: файл могли видалити чи замінити після старту.
+        m_memory.mapFile(m_regions[i].offset, *m_images[i]);
+    }
+    std::fill(m_pageEpoch.begin(), m_pageEpoch.end(), m_epoch);
 }
-}  // namespace elsim::core
\ No newline at end of file
+
+bool MemoryBus::isInitialContent(std::size_t offset, std::size_t size) const {
+    const auto current = m_memory.bytes();
+    if (offset > current.size() || size > current.size() - offset) {
+        throw std::out_of_range("MemoryBus::isInitialContent: range is outside of region memory");
+    }
+
+    std::size_t done = 0;
+    const auto isZero = [&](std::size_t count) {
+        const auto* begin = current.data() + offset + done;
+        return std::all_of(begin, begin + count, [](std::uint8_t b) { return b == 0; });
+    };
+    // Регіони впорядковані за зсувом; проміжки між ними (вирівнювання) — нулі.
+    for (std::size_t i = 0; i < m_regions.size() && done < size; ++i) {
+        if (m_images[i] == nullptr) {
+            continue;
+        }
+        const auto image = m_images[i]->bytes().first(std::min<std::size_t>(m_images[i]->bytes().size(),
+                                                                            m_regions[i].size));
+        const std::size_t imageBegin = m_regions[i].offset;
+        const std::size_t imageEnd = imageBegin + image.size();
+        if (imageEnd <= offset + done) {
+            continue;
+        }
+        if (imageBegin >= offset + size) {
+            break;
+        }
+        if (imageBegin > offset + done) {
+            if (!isZero(imageBegin - offset - done)) {
+                return false;
+            }
+            done = imageBegin - offset;
+        }
+        const std::size_t count = std::min(imageEnd, offset + size) - (offset + done);
+        if (std::memcmp(current.data() + offset + done, image.data() + (offset + done - imageBegin), count) != 0) {
+            return false;
+        }
+        done += count;
+    }
+    return isZero(size - done);
+}
+
+std::vector<std::uint32_t> MemoryBus::dirtyPagesSince(DirtyEpoch epoch) const {
+    std::vector<std::uint32_t> pages;
+    for (std::size_t page = 0; page < m_pageEpoch.size(); ++page) {
+        if (m_pageEpoch[page] >= epoch) {
+            pages.push_back(static_cast<std::uint32_t>(page));
+        }
+    }
+    return pages;
+}
+
+void MemoryBus::loadPage(std::uint32_t page, std::span<const std::uint8_t> bytes) {
+    const std::size_t offset = static_cast<std::size_t>(page) * kPageSize;
+    if (page >= m_pageEpoch.size() || bytes.size() != std::min<std::size_t>(kPageSize, m_memory.size() - offset)) {
+        throw std::out_of_range("MemoryBus::loadPage: page index or size out of range");
+    }
+    std::memcpy(m_memory.data() + offset, bytes.data(), bytes.size());
+    m_pageEpoch[page] = m_epoch;
+}
+
+void MemoryBus::markBaseline() {
+    // Знімок лише сторінок з правом запису: ROM/flash (у т.ч. образи з файлів) і вирівнювання між
+    // регіонами шина не змінює, тож копіювати їх нема чого.
+    m_baselinePages.assign(m_pageEpoch.size(), false);
+    for (const auto& region : m_regions) {
+        const auto pages = static_cast<std::uint32_t>((region.size + kPageSize - 1) >> kPageBits);
+        for (std::uint32_t i = 0; i < pages; ++i) {
+            const PageSlot* slot = pageSlot(region.base + i * kPageSize);
+            if ((slot->permissions & kWrite) != 0) {
+                m_baselinePages[slot->dirtyIndex] = true;
+            }
+        }
+    }
+
+    // Копія теж розріджена: нульові сторінки не копіюються.
+    if (m_baseline.capacity() < m_memory.size()) {
+        m_baseline = HostMemory(m_memory.size());
+    }
+    m_baseline.zero(0, m_baseline.size());
+    m_baseline.resize(m_memory.size());
+    for (std::size_t page = 0; page < m_baselinePages.size(); ++page) {
+        if (m_baselinePages[page]) {
+            snapshotBaselinePage(page);
+        }
+    }
+    m_hasBaseline = true;
+    m_baselineEpoch = openDirtyEpoch();
+}
+
+void MemoryBus::snapshotBaselinePage(std::size_t page) {
+    const std::size_t offset = page * kPageSize;
+    const std::size_t size = std::min<std::size_t>(kPageSize, m_memory.size() - offset);
+    const std::uint8_t* current = m_memory.data() + offset;
+    if (std::any_of(current, current + size, [](std::uint8_t b) { return b != 0; })) {
+        std::memcpy(m_baseline.data() + offset, current, size);
+    }
+    m_baselinePages[page] = true;
+}
+
+std::size_t MemoryBus::restoreBaseline() {
+    if (!hasBaseline()) {
+        throw std::logic_error("MemoryBus::restoreBaseline: no baseline, call markBaseline() first");
+    }
+
+    std::size_t restored = 0;
+    const auto restorePage = [&](std::size_t page) {
+        if (page >= m_baselinePages.size() || !m_baselinePages[page]) {
+            return;  // сторінка без права запису чи з регіону, підключеного після знімка
+        }
+        const std::size_t offset = page * kPageSize;
+        const std::size_t size = std::min<std::size_t>(kPageSize, m_memory.size() - offset);
+        std::uint8_t* current = m_memory.data() + offset;
+        const std::uint8_t* saved = m_baseline.data() + offset;
+
+        // Сторінку могли переписати тими самими байтами — тоді копіювати нічого.
+        if (std::memcmp(current, saved, size) != 0) {
+            std::memcpy(current, saved, size);
+            m_pageEpoch[page] = m_epoch;  // для інших споживачів обліку це теж запис
+            ++restored;
+        }
+    };
+
+    for (const std::uint32_t page : dirtyPagesSince(m_baselineEpoch)) {
+        restorePage(page);
+    }
+
+    m_baselineEpoch = openDirtyEpoch();
+    return restored;
+}
+
+std::size_t MemoryBus::dirtyPageCount() const { return dirtyPagesSince(m_baselineEpoch).size(); }
+
+}  // namespace elsim::core
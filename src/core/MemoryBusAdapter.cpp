@@ -18,4 +18,54 @@ void MemoryBusAdapter::write8(std::uint32_t address, std::uint8_t value) {
     bus_->write8(address, value);
 }
 
+std::uint16_t MemoryBusAdapter::read16(std::uint32_t address) {
+    if (!bus_) {
+        throw std::runtime_error("MemoryBusAdapter::read16: underlying MemoryBus is null");
+    }
+    return bus_->read16(address);
+}
+
+std::uint32_t MemoryBusAdapter::read32(std::uint32_t address) {
+    if (!bus_) {
+        throw std::runtime_error("MemoryBusAdapter::read32: underlying MemoryBus is null");
+    }
+    return bus_->read32(address);
+}
+
+std::uint32_t MemoryBusAdapter::fetch32(std::uint32_t address) {
+    if (!bus_) {
+        throw std::runtime_error("MemoryBusAdapter::fetch32: underlying MemoryBus is null");
+    }
+    return bus_->fetch32(address);
+}
+
+void MemoryBusAdapter::write16(std::uint32_t address, std::uint16_t value) {
+    if (!bus_) {
+        throw std::runtime_error("MemoryBusAdapter::write16: underlying MemoryBus is null");
+    }
+    bus_->write16(address, value);
+}
+
+void MemoryBusAdapter::write32(std::uint32_t address, std::uint32_t value) {
+    if (!bus_) {
+        throw std::runtime_error("MemoryBusAdapter::write32: underlying MemoryBus is null");
+    }
+    bus_->write32(address, value);
+}
+
+HostMemoryWindow MemoryBusAdapter::hostWindow(std::uint32_t address, HostAccess access) {
+    if (!bus_) {
+        return {};
+    }
+    return bus_->hostWindow(address, access);
+}
+
+bool MemoryBusAdapter::isStableRead(std::uint32_t address, std::uint32_t size) {
+    return bus_ != nullptr && bus_->isStableRead(address, size);
+}
+
+bool MemoryBusAdapter::isCycleCounter(std::uint32_t address) {
+    return bus_ != nullptr && bus_->isCycleCounter(address);
+}
+
 }  // namespace elsim::core
@@ -0,0 +1,39 @@
+#include "elsim/core/PcSampler.hpp"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "elsim/core/SymbolMap.hpp"
+
+namespace elsim::core {
+
+PcSampler::PcSampler(std::uint64_t interval) : interval_(interval) {
+    if (interval == 0) {
+        throw std::invalid_argument("PcSampler: sampling interval must be > 0");
+    }
+}
+
+void PcSampler::writeCollapsedStacks(std::ostream& out, const SymbolMap* symbols) const {
+    std::map<std::string, std::uint64_t> stacks;
+    for (const auto& [pc, count] : samples_) {
+        std::ostringstream stack;
+        const auto frames = symbols != nullptr ? symbols->stackAt(pc) : std::vector<std::string_view>{};
+        if (frames.empty()) {
+            stack << "0x" << std::hex << std::setw(8) << std::setfill('0') << pc;
+        } else {
+            for (std::size_t i = 0; i < frames.size(); ++i) {
+                stack << (i == 0 ? "" : ";") << frames[i];
+            }
+        }
+        stacks[stack.str()] += count;
+    }
+
+    for (const auto& [stack, count] : stacks) {
+        out << stack << ' ' << count << '\n';
+    }
+}
+
+}  // namespace elsim::core
@@ -1,11 +1,14 @@
 #include "elsim/core/ProgramLoader.hpp"
 
 #include <cstdio>
-#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
-#include <vector>
 
+#include "elsim/core/FileView.hpp"
 #include "elsim/core/Logger.hpp"
 
 namespace {
@@ -19,20 +22,24 @@ namespace elsim::core {
 void ProgramLoader::loadBinary(const std::string& path, MemoryBus& memory, std::uint32_t& entryPoint) {
     auto& logger = Logger::instance();
 
-    // 1. Відкриваємо файл у двійковому режимі
+    // 1. Відображаємо файл у пам'ять (без проміжного буфера на весь код)
     logger.info(COMPONENT, std::string("Loading program from '") + path + "'");
 
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        throw std::runtime_error("ProgramLoader: failed to open file: " + path);
-    }
+    const std::unique_ptr<const FileView> file = [&path] {
+        try {
+            return std::make_unique<const FileView>(path);
+        } catch (const std::runtime_error&) {
+            throw std::runtime_error("ProgramLoader: failed to open file: " + path);
+        }
+    }();
+    const std::span<const std::uint8_t> bytes = file->bytes();
 
-    // 2. Читаємо заголовок
+    // 2. Заголовок — прямо з відображення
     ElsimBinaryHeader header{};
-    in.read(reinterpret_cast<char*>(&header), sizeof(header));
-    if (in.gcount() != static_cast<std::streamsize>(sizeof(header))) {
+    if (bytes.size() < sizeof(header)) {
         throw std::runtime_error("ProgramLoader: file is too short to contain valid header: " + path);
     }
+    std::memcpy(&header, bytes.data(), sizeof(header));
 
     // 3. Перевіряємо magic
     if (header.magic != ELSIM_BINARY_MAGIC) {
@@ -64,13 +71,13 @@ void ProgramLoader::loadBinary(const std::string& path, MemoryBus& memory, std::
                   header.code_size, header.code_size);
     logger.debug(COMPONENT, hdrBuf);
 
-    // 5. Читаємо блок коду
-    std::vector<std::uint8_t> code(header.code_size);
-    in.read(reinterpret_cast<char*>(code.data()), header.code_size);
-
-    if (in.gcount() != static_cast<std::streamsize>(header.code_size)) {
+    // 5. Блок коду — теж прямо з відображення
+    const std::span<const std::uint8_t> code = bytes.subspan(sizeof(header));
+    if (code.size() < header.code_size) {
         logger.error(COMPONENT, "Program code section is truncated");
-        throw std::runtime_error("ProgramLoader: code section is truncated in file: " + path);
+        throw std::runtime_error("ProgramLoader: code section is truncated in file: " + path + " (expected " +
+                                 std::to_string(header.code_size) + " bytes, got " + std::to_string(code.size()) +
+                                 ")");
     }
 
     // 6. Завантажуємо код у пам'ять, починаючи з entry_point
@@ -81,10 +88,9 @@ void ProgramLoader::loadBinary(const std::string& path, MemoryBus& memory, std::
                   static_cast<unsigned int>(base), header.code_size, header.code_size);
     logger.debug(COMPONENT, loadBuf);
 
-    for (std::uint32_t i = 0; i < header.code_size; ++i) {
-        // Якщо адреса вийде за межі RAM, MemoryBus::write8 кине std::out_of_range.
-        memory.write8(base + i, code[i]);
-    }
+    // Завантаження з боку хоста: код можна класти й у ROM/flash (права сторінок не перевіряються).
+    // Якщо адреса вийде за межі пам'яті, MemoryBus::loadBytes кине std::out_of_range.
+    memory.loadBytes(base, code.first(header.code_size));
 
     // 7. Повертаємо entryPoint назовні
     entryPoint = header.entry_point;
@@ -95,4 +101,21 @@ void ProgramLoader::loadBinary(const std::string& path, MemoryBus& memory, std::
     logger.info(COMPONENT, doneBuf);
 }
 
+std::string ProgramLoader::symbolSidecarPath(const std::string& binaryPath) {
+    return std::filesystem::path(binaryPath).replace_extension(".sym").string();
+}
+
+std::optional<SymbolMap> ProgramLoader::loadSidecarSymbols(const std::string& binaryPath) const {
+    const std::string path = symbolSidecarPath(binaryPath);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return std::nullopt;
+    }
+
+    SymbolMap symbols = SymbolMap::loadFromFile(path);
+    Logger::instance().info(COMPONENT, "Loaded " + std::to_string(symbols.symbols().size()) + " symbol(s) from '" +
+                                           path + "'");
+    return symbols;
+}
+
 }  // namespace elsim::core
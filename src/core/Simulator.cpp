@@ -2,12 +2,21 @@
 
 #include <algorithm>
 #include <cctype>
+#include <fstream>
+#include <iterator>
 #include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
 #include "elsim/core/DeviceMemoryAdapter.hpp"
 #include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/InstructionTrace.hpp"
 #include "elsim/core/MemoryBusAdapter.hpp"
+#include "elsim/core/StateStream.hpp"
 #include "elsim/device/DeviceFactory.hpp"  // знадобиться пізніше в loadBoard
 #include "elsim/device/VirtualButtonDevice.hpp"
 #include "elsim/device/VirtualLedDevice.hpp"
@@ -17,6 +26,26 @@ std::string toLower(std::string s) {
     std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
     return s;
 }
+
+// Checkpoint-формат, див. docs/checkpoint_format.md.
+constexpr std::uint32_t kCheckpointMagic = elsim::core::makeChunkTag("ELCK");
+constexpr std::uint32_t kCheckpointVersion = 2;
+
+constexpr std::uint32_t kChunkBoard = elsim::core::makeChunkTag("BORD");
+constexpr std::uint32_t kChunkSim = elsim::core::makeChunkTag("SIM ");
+constexpr std::uint32_t kChunkCpu = elsim::core::makeChunkTag("CPU ");
+constexpr std::uint32_t kChunkRam = elsim::core::makeChunkTag("RAM ");
+constexpr std::uint32_t kChunkGpio = elsim::core::makeChunkTag("GPIO");
+constexpr std::uint32_t kChunkDevice = elsim::core::makeChunkTag("DEV ");
+
+// Розмір стану, який пише saveState() CPU чи пристрою (стан фіксованого формату, тож і розміру) —
+// щоб перевірити payload checkpoint-а ще до loadState().
+template <typename T>
+std::size_t savedStateSize(const T& component) {
+    elsim::core::StateWriter out;
+    component.saveState(out);
+    return out.data().size();
+}
 }  // namespace
 
 namespace elsim::core {
@@ -30,14 +59,27 @@ Simulator::~Simulator() = default;
 
 void Simulator::loadBoard(const BoardDescription& board) {
     // Скидаємо стан симулятора
+    stopTrace();
+    stopProfile();
+    sampler_.reset();
     running_ = false;
     cycleCount_ = 0;
 
     cpu_.reset();
     devices_.clear();
+    baselineState_.clear();
+    recording_ = false;
+    recorded_ = InputLog();
+    stopReplay();
+    scheduler_.clear();
+    deviceSyncCycle_.clear();
+    deviceDeadline_.clear();
     memoryBus_.reset();
     gpio_.reset();
 
+    boardName_ = board.name;
+    deviceNames_.clear();
+
     log_ << "[Simulator] Loading board: " << board.name << "\n";
     log_ << "[Simulator] Description: " << board.description << "\n";
 
@@ -50,60 +92,91 @@ void Simulator::loadBoard(const BoardDescription& board) {
          << ", endianness: " << board.cpu.endianness << "\n";
 
     // Обираємо реалізацію CPU за типом.
-    // Поки що підтримуємо лише "test-cpu" -> FakeCpu.
+    // "test-cpu" -> FakeCpu (інтерпретатор), "test-cpu-dbt" -> DbtCpu (трансляція в x86-64).
+    // Інтерпретатор інстанційований з конкретною MemoryBus: доступи до RAM вбудовуються, без віртуальних викликів.
     if (board.cpu.type == "test-cpu") {
-        cpu_ = std::make_unique<FakeCpu>();
-        log_ << "[Simulator] Created FakeCpu for type 'test-cpu'\n";
+        auto fakeCpu = std::make_unique<MemoryBusFakeCpu>();
+
+        if (board.cpu.dispatch == "threaded") {
+            fakeCpu->setDispatchMode(MemoryBusFakeCpu::DispatchMode::Threaded);
+        } else if (board.cpu.dispatch.empty() || board.cpu.dispatch == "switch") {
+            fakeCpu->setDispatchMode(MemoryBusFakeCpu::DispatchMode::Switch);
+        } else {
+            throw std::runtime_error("Unsupported CPU dispatch mode: '" + board.cpu.dispatch +
+                                     "'. Expected 'switch' or 'threaded'.");
+        }
+
+        cpu_ = std::move(fakeCpu);
+        log_ << "[Simulator] Created FakeCpu for type 'test-cpu' (dispatch: "
+             << (board.cpu.dispatch.empty() ? "switch" : board.cpu.dispatch) << ")\n";
+    } else if (board.cpu.type == "test-cpu-dbt") {
+        if (!DbtCpu::hostSupported()) {
+            throw std::runtime_error("CPU type 'test-cpu-dbt' requires an x86-64 Linux host");
+        }
+        cpu_ = std::make_unique<DbtCpu>();
+        log_ << "[Simulator] Created DbtCpu (x86-64 translator) for type 'test-cpu-dbt'\n";
     } else {
         throw std::runtime_error("Unsupported CPU type: '" + board.cpu.type +
-                                 "'. Only 'test-cpu' is supported at the moment.");
+                                 "'. Supported types: 'test-cpu', 'test-cpu-dbt'.");
     }
 
-    // --- Обчислюємо розмір RAM і створюємо MemoryBus ---
-    std::size_t ramSize = 0;
-    bool hasRam = false;
+    // --- Створюємо MemoryBus і мепимо в неї всі регіони RAM/ROM ---
+    memoryBus_ = std::make_unique<MemoryBus>();
+    std::uint64_t memoryBytes = 0;
 
     for (const auto& region : board.memory) {
-        if (region.type == MemoryType::Ram) {
-            if (hasRam) {
-                throw std::runtime_error("Multiple RAM regions are not supported yet");
-            }
+        if (region.type == MemoryType::Mmio) {
+            continue;  // MMIO-діапазони займають девайси
+        }
 
-            if (region.baseAddress != 0) {
-                throw std::runtime_error("RAM region '" + region.name +
-                                         "' must start at baseAddress 0 in current implementation");
-            }
+        if (region.sizeBytes == 0) {
+            throw std::runtime_error("Memory region '" + region.name + "' must have non-zero size");
+        }
+        if (region.baseAddress > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("Memory region '" + region.name + "' must start inside the 32-bit address space");
+        }
 
-            if (region.sizeBytes == 0) {
-                throw std::runtime_error("RAM region '" + region.name + "' must have non-zero size");
+        MemoryBus::Permissions permissions = region.type == MemoryType::Ram
+                                                 ? MemoryBus::kReadWriteExecute
+                                                 : MemoryBus::kRead | MemoryBus::kExecute;
+        try {
+            if (!region.permissions.empty()) {
+                permissions = MemoryBus::parsePermissions(region.permissions);
             }
-
-            if (region.sizeBytes > std::numeric_limits<std::size_t>::max()) {
-                throw std::runtime_error("RAM region '" + region.name + "' size does not fit into size_t");
+            const auto base = static_cast<std::uint32_t>(region.baseAddress);
+            if (region.file.empty()) {
+                memoryBus_->mapRegion(region.name, base, region.sizeBytes, permissions);
+            } else {
+                memoryBus_->mapImage(region.name, base, region.sizeBytes, region.file, permissions);
             }
-
-            ramSize = static_cast<std::size_t>(region.sizeBytes);
-            hasRam = true;
+        } catch (const std::invalid_argument& ex) {
+            throw std::runtime_error("Memory region '" + region.name + "': " + ex.what());
+        } catch (const std::runtime_error& ex) {
+            throw std::runtime_error("Memory region '" + region.name + "': " + ex.what());
         }
+        memoryBytes += region.sizeBytes;
     }
 
-    if (!hasRam) {
-        throw std::runtime_error("BoardDescription must define at least one RAM memory region");
+    if (memoryBus_->regions().empty()) {
+        throw std::runtime_error("BoardDescription must define at least one RAM or ROM memory region");
     }
 
-    memoryBus_ = std::make_unique<MemoryBus>(ramSize);
-    log_ << "[Simulator] Created MemoryBus with RAM size " << ramSize << " bytes\n";
+    log_ << "[Simulator] Created MemoryBus with " << memoryBus_->regions().size() << " memory region(s), "
+         << memoryBytes << " bytes\n";
 
     // --- Підключаємо MemoryBus до CPU через адаптер ---
     if (!cpu_) {
         throw std::runtime_error("Simulator::loadBoard: CPU is not initialized");
     }
 
-    // Створюємо адаптер, який реалізує IMemoryBus для CPU.
+    // Створюємо адаптер, який реалізує IMemoryBus для CPU (MemoryBusFakeCpu знімає його й кличе MemoryBus напряму).
     auto busAdapter = std::make_shared<MemoryBusAdapter>(memoryBus_.get());
     cpu_->setMemoryBus(busAdapter);
     log_ << "[Simulator] Connected CPU to MemoryBus via MemoryBusAdapter\n";
 
+    // Глобальний клок для пристроїв: лічильник циклів Simulator + прогрес поточного пакету CPU.
+    clock_.bind(&cycleCount_, cpu_.get());
+
     // --- Логування пам'яті (для дебагу карти) ---
     log_ << "[Simulator] Memory regions: " << board.memory.size() << "\n";
     for (const auto& region : board.memory) {
@@ -121,11 +194,17 @@ void Simulator::loadBoard(const BoardDescription& board) {
         }
 
         log_ << "  - [" << typeStr << "] " << region.name << " @ 0x" << std::hex << region.baseAddress << " size "
-             << std::dec << region.sizeBytes << " bytes\n";
+             << std::dec << region.sizeBytes << " bytes";
+        if (region.type != MemoryType::Mmio) {
+            const auto address = static_cast<std::uint32_t>(region.baseAddress);
+            log_ << " " << MemoryBus::formatPermissions(memoryBus_->permissionsAt(address));
+            if (!region.file.empty()) {
+                log_ << " image '" << region.file << "'";
+            }
+        }
+        log_ << "\n";
     }
 
-    // За потреби можна розширити API MemoryBus для складніших MMIO-пристроїв і регіонів.
-
     // --- Пристрої: створюємо через DeviceFactory ---
     log_ << "[Simulator] Devices: " << board.devices.size() << "\n";
 
@@ -172,6 +251,10 @@ void Simulator::loadBoard(const BoardDescription& board) {
         }
 
         devices_.emplace_back(raw);
+        deviceNames_.push_back(devDesc.name);
+        if (raw != nullptr) {
+            raw->attachClock(&clock_);
+        }
 
         // --- Пошук MMIO-регіону для цього девайса ---
         std::uint32_t mmioSize = 0;
@@ -196,37 +279,105 @@ void Simulator::loadBoard(const BoardDescription& board) {
 
         // --- Мапимо девайс у MemoryBus через DeviceMemoryAdapter ---
         auto* devicePtr = devices_.back().get();
-        auto mmioAdapter = std::make_shared<DeviceMemoryAdapter>(devicePtr);
+        auto mmioAdapter = std::make_shared<DeviceMemoryAdapter>(
+            devicePtr, [this, index = devices_.size() - 1] { rescheduleDevice(index); });
         memoryBus_->mapDevice(static_cast<std::uint32_t>(devDesc.baseAddress), mmioSize, mmioAdapter);
         log_ << "[Simulator] Mapped device '" << devDesc.name << "' to MMIO region @ 0x" << std::hex
              << devDesc.baseAddress << std::dec << " size " << mmioSize << " bytes\n";
     }
 
+    resetDeviceSchedule(0);
+    log_ << "[Simulator] Timed devices: " << scheduler_.size() << " of " << devices_.size() << "\n";
+
     log_ << "[Simulator] Board loaded successfully " << "(CPU created, MemoryBus created, devices instantiated; "
          << "memory wiring & MMIO will be implemented in next steps).\n";
 }
 
-void Simulator::start(std::uint64_t maxCycles) {
+void Simulator::start(std::uint64_t maxCycles, RunMode mode) {
     if (!cpu_) {
         log_ << "[Simulator] ERROR: Cannot start — CPU not initialized!\n";
         return;
     }
 
     running_ = true;
-    cycleCount_ = 0;
+    skippedCycles_ = 0;
+    resetDeviceSchedule(0);
+
+    const bool skipIdle = (mode == RunMode::SkipIdle);
+    cpu_->setIdleLoopSkipping(skipIdle);
+
+    log_ << "[Simulator] Starting simulation" << (skipIdle ? " (idle-loop skipping)" : "") << "...\n";
+
+    const StopReason reason = runUntil(maxCycles != 0 ? maxCycles : EventScheduler::kNever, skipIdle);
+    if (reason == StopReason::Halted) {
+        log_ << "[Simulator] CPU entered HALT state. Stopping simulation.\n";
+        running_ = false;
+    } else if (maxCycles != 0 && cycleCount_ >= maxCycles) {
+        log_ << "[Simulator] Max cycles reached.\n";
+    }
+
+    cpu_->setIdleLoopSkipping(false);
+    if (skipIdle) {
+        log_ << "[Simulator] Idle-loop skipping: " << skippedCycles_ << " of " << cycleCount_ << " cycles skipped.\n";
+    }
+    log_ << "[Simulator] Simulation finished.\n";
+}
+
+std::uint64_t Simulator::runFor(std::uint64_t cycles) {
+    if (!cpu_) {
+        throw std::runtime_error("Simulator::runFor: CPU is not initialized");
+    }
+    if (cycles == 0 || cpu_->isHalted()) {
+        return 0;
+    }
 
-    log_ << "[Simulator] Starting simulation...\n";
+    // Без resetDeviceSchedule(0): лічильник і розклад пристроїв продовжуються з поточного стану.
+    const std::uint64_t begin = cycleCount_;
+    const std::uint64_t remaining = EventScheduler::kNever - begin;
+    running_ = true;
+    runUntil(cycles < remaining ? begin + cycles : EventScheduler::kNever, /*skipIdle=*/false);
+    running_ = false;
+    return cycleCount_ - begin;
+}
 
+StopReason Simulator::runUntil(std::uint64_t endCycle, bool skipIdle) {
     while (running_) {
-        runOneTick();
+        injectDueInputs();
+        takeDueSample();
+
+        // Скільки інструкцій можна виконати до найближчої події пристрою (але не більше кванту).
+        // Перемотаний idle-цикл не може перескочити подію: бюджет закінчується на ній.
+        const std::uint64_t untilEvent = scheduler_.nextDeadline() - cycleCount_;
+        std::uint64_t budget = skipIdle ? untilEvent : std::min(quantum_, untilEvent);
+        if (endCycle != EventScheduler::kNever) {
+            budget = std::min(budget, endCycle - cycleCount_);
+        } else if (budget == EventScheduler::kNever - cycleCount_) {
+            budget = quantum_;  // ні подій, ні ліміту — звичайний квант
+        }
+        if (const std::uint64_t input = nextInputCycle(); input != EventScheduler::kNever) {
+            budget = std::min(budget, input - clock_.now());  // пакет закінчується на наступному впливі
+        }
+        if (sampler_) {
+            budget = std::min(budget, nextSampleCycle_ - clock_.now());  // і на наступному семплі PC
+        }
+
+        const RunResult result = cpu_->run(budget);
+
+        // Синхронізуємо пристрої та лічильник циклів з тим, що реально виконав CPU.
+        skippedCycles_ += result.skipped;
+        syncDevices(result.retired);
+
+        if (result.reason == StopReason::Halted) {
+            return StopReason::Halted;
+        }
+
+        // StopReason::Fault: виняток кине наступний cpu_->run() на початку наступного кванту.
 
-        if (maxCycles != 0 && cycleCount_ >= maxCycles) {
-            log_ << "[Simulator] Max cycles reached.\n";
+        if (endCycle != EventScheduler::kNever && cycleCount_ >= endCycle) {
             break;
         }
     }
-
-    log_ << "[Simulator] Simulation finished.\n";
+    return StopReason::BudgetExhausted;
 }
 
 void Simulator::stop() { running_ = false; }
@@ -238,7 +389,9 @@ void Simulator::runOneTick() {
         return;
     }
 
-    // 1. Дати CPU виконати один крок
+    // 1. Подати заплановані впливи й дати CPU виконати один крок
+    injectDueInputs();
+    takeDueSample();
     cpu_->step();
 
     // 2. Перевірити HALT
@@ -248,21 +401,652 @@ void Simulator::runOneTick() {
         return;  // Важливо: не оновлюємо девайси і не збільшуємо лічильник циклів
     }
 
-    // 3. Оновити всі пристрої
-    for (auto& dev : devices_) {
-        if (dev) {
-            dev->tick();
+    // 3. Збільшити кількість циклів і розбудити пристрої, чия подія настала
+    syncDevices(1);
+}
+
+void Simulator::syncDevices(std::uint64_t cycles) {
+    cycleCount_ += cycles;
+
+    EventScheduler::Handle index = 0;
+    std::uint64_t due = 0;
+    while (scheduler_.popDue(cycleCount_, index, due)) {
+        if (due != deviceDeadline_[index]) {
+            continue;  // застаріла: rescheduleDevice() поставив пристрою ранішу подію
+        }
+        devices_[index]->advance(cycleCount_ - deviceSyncCycle_[index]);
+        deviceSyncCycle_[index] = cycleCount_;
+        scheduleDevice(index);
+    }
+}
+
+void Simulator::resetDeviceSchedule(std::uint64_t cycle) {
+    // Спершу доганяємо пристрої до поточного циклу, щоб не загубити час, що минув з їх останньої події.
+    for (std::size_t i = 0; i < deviceSyncCycle_.size(); ++i) {
+        if (deviceSyncCycle_[i] != ::elsim::IDevice::kNoEvent && deviceSyncCycle_[i] < cycleCount_) {
+            devices_[i]->advance(cycleCount_ - deviceSyncCycle_[i]);
+        }
+    }
+
+    clock_.rebase(cycleCount_, cycle);
+    cycleCount_ = cycle;
+    scheduler_.clear();
+    deviceSyncCycle_.assign(devices_.size(), ::elsim::IDevice::kNoEvent);
+    deviceDeadline_.assign(devices_.size(), EventScheduler::kNever);
+
+    for (std::size_t i = 0; i < devices_.size(); ++i) {
+        if (devices_[i]) {
+            deviceSyncCycle_[i] = cycleCount_;
+            scheduleDevice(i);
+        }
+    }
+}
+
+// --- Трасування інструкцій ---
+
+void Simulator::startTrace(const std::string& path) {
+    if (!cpu_) {
+        throw std::runtime_error("Simulator::startTrace: board is not loaded");
+    }
+    stopTrace();
+
+    auto trace = std::make_unique<TraceWriter>(path);
+    trace->attachClock(&clock_);
+    cpu_->setTraceWriter(trace.get());
+    trace_ = std::move(trace);
+    log_ << "[Simulator] Tracing instructions to '" << path << "'\n";
+}
+
+std::uint64_t Simulator::stopTrace() {
+    if (!trace_) {
+        return 0;
+    }
+
+    if (cpu_) {
+        cpu_->setTraceWriter(nullptr);
+    }
+    auto trace = std::move(trace_);
+    trace->close();
+    log_ << "[Simulator] Trace closed: " << trace->recordCount() << " instruction(s)\n";
+    return trace->recordCount();
+}
+
+void Simulator::startProfile() {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::startProfile: board is not loaded");
+    }
+    stopProfile();
+
+    // Профіль покриває регіон, з якого виконується код: той, де зараз PC, інакше перший виконуваний.
+    const MemoryBus::Region* code = memoryBus_->findRegion(cpu_->getPc());
+    for (const auto& region : memoryBus_->regions()) {
+        if (code == nullptr && (region.permissions & MemoryBus::kExecute) != 0) {
+            code = &region;
+        }
+    }
+    if (code == nullptr) {
+        code = &memoryBus_->regions().front();
+    }
+
+    auto profile = std::make_unique<ExecutionProfile>(code->base, static_cast<std::size_t>(code->size));
+    cpu_->setProfile(profile.get());
+    profile_ = std::move(profile);
+}
+
+std::optional<ExecutionProfile> Simulator::stopProfile() {
+    if (!profile_) {
+        return std::nullopt;
+    }
+
+    if (cpu_) {
+        cpu_->setProfile(nullptr);
+    }
+    ExecutionProfile profile = std::move(*profile_);
+    profile_.reset();
+    return profile;
+}
+
+void Simulator::printProfile(std::ostream& out, std::size_t topCount) const {
+    if (profile_) {
+        const MemoryBus::Region* code = memoryBus_->findRegion(profile_->baseAddress());
+        profile_->report(out, topCount,
+                         code != nullptr ? memoryBus_->regionBytes(*code) : std::span<const std::uint8_t>{});
+    }
+}
+
+// --- Семплінг PC ---
+
+void Simulator::startSampling(std::uint64_t interval) {
+    if (!cpu_) {
+        throw std::runtime_error("Simulator::startSampling: board is not loaded");
+    }
+    sampler_.emplace(interval);
+
+    // Семпли — на циклах, кратних interval, починаючи з найближчого не раніше поточного.
+    const std::uint64_t now = clock_.now();
+    nextSampleCycle_ = (now + interval - 1) / interval * interval;
+}
+
+std::optional<PcSampler> Simulator::stopSampling() { return std::exchange(sampler_, std::nullopt); }
+
+void Simulator::takeDueSample() {
+    if (sampler_ && clock_.now() >= nextSampleCycle_) {
+        sampler_->record(cpu_->getPc());
+        nextSampleCycle_ = (clock_.now() / sampler_->interval() + 1) * sampler_->interval();
+    }
+}
+
+// --- Запис / відтворення зовнішніх впливів ---
+
+void Simulator::startRecording() {
+    if (!gpio_) {
+        throw std::runtime_error("Simulator::startRecording: board is not loaded");
+    }
+
+    recorded_ = InputLog(boardName_);
+    recording_ = true;
+    gpio_->setInputObserver([this](std::size_t pin, bool level) {
+        const std::uint32_t value = level ? 1u : 0u;
+        recorded_.append(InputEvent{clock_.now(), InputKind::GpioLevel, static_cast<std::uint32_t>(pin), value});
+    });
+}
+
+InputLog Simulator::stopRecording() {
+    if (gpio_) {
+        gpio_->setInputObserver(nullptr);
+    }
+    recording_ = false;
+    return std::exchange(recorded_, InputLog());
+}
+
+bool Simulator::isRecording() const noexcept { return recording_; }
+
+void Simulator::startReplay(InputLog log) {
+    if (!gpio_) {
+        throw std::runtime_error("Simulator::startReplay: board is not loaded");
+    }
+    if (!log.boardName().empty() && log.boardName() != boardName_) {
+        throw std::runtime_error("Input log was recorded on board '" + log.boardName() + "', current board is '" +
+                                 boardName_ + "'");
+    }
+    if (!log.empty() && log.events().front().cycle < clock_.now()) {
+        throw std::runtime_error("Input log starts at cycle " + std::to_string(log.events().front().cycle) +
+                                 ", simulation is already at cycle " + std::to_string(clock_.now()));
+    }
+    for (const auto& event : log.events()) {
+        if (event.kind == InputKind::GpioLevel && event.channel >= gpio_->pinCount()) {
+            throw std::runtime_error("Input log refers to GPIO pin " + std::to_string(event.channel) +
+                                     " outside of the board's " + std::to_string(gpio_->pinCount()) + " pins");
+        }
+    }
+
+    replay_ = std::move(log);
+    replayPos_ = 0;
+    log_ << "[Simulator] Replaying " << replay_.size() << " recorded input(s)\n";
+}
+
+void Simulator::stopReplay() noexcept {
+    replay_ = InputLog();
+    replayPos_ = 0;
+}
+
+bool Simulator::isReplaying() const noexcept { return replayPos_ < replay_.size(); }
+
+void Simulator::injectDueInputs() {
+    const auto& events = replay_.events();
+    const std::uint64_t now = clock_.now();
+    while (replayPos_ < events.size() && events[replayPos_].cycle <= now) {
+        const InputEvent& event = events[replayPos_++];
+        switch (event.kind) {
+            case InputKind::GpioLevel:
+                gpio_->injectInput(event.channel, event.value != 0);
+                break;
+        }
+    }
+}
+
+std::uint64_t Simulator::nextInputCycle() const noexcept {
+    return replayPos_ < replay_.size() ? replay_.events()[replayPos_].cycle : EventScheduler::kNever;
+}
+
+void Simulator::scheduleDevice(std::size_t index) {
+    const std::uint64_t delay = devices_[index]->cyclesUntilNextEvent();
+    if (delay == ::elsim::IDevice::kNoEvent) {
+        deviceSyncCycle_[index] = ::elsim::IDevice::kNoEvent;  // пасивний: будить лише MMIO-запис
+        deviceDeadline_[index] = EventScheduler::kNever;
+        return;
+    }
+
+    // Подія не раніше наступного циклу; насичення, щоб не переповнити лічильник.
+    const std::uint64_t step = std::max<std::uint64_t>(delay, 1);
+    const std::uint64_t remaining = EventScheduler::kNever - cycleCount_;
+    deviceDeadline_[index] = step < remaining ? cycleCount_ + step : EventScheduler::kNever;
+    scheduler_.schedule(index, deviceDeadline_[index]);
+}
+
+void Simulator::rescheduleDevice(std::size_t index) {
+    const std::uint64_t delay = devices_[index]->cyclesUntilNextEvent();
+    if (delay == ::elsim::IDevice::kNoEvent) {
+        return;  // тактований пристрій стане пасивним на своїй наступній події
+    }
+
+    // Запис посеред пакета: поточний цикл — з уже виконаними інструкціями пакета. Подія, що випала
+    // всередину пакета, настає в його кінці (advance() отримає весь час, що минув).
+    const std::uint64_t now = cycleCount_ + (cpu_ ? cpu_->retiredInRun() : 0);
+    const std::uint64_t step = std::max<std::uint64_t>(delay, 1);
+    const std::uint64_t remaining = EventScheduler::kNever - now;
+    const std::uint64_t deadline = step < remaining ? now + step : EventScheduler::kNever;
+    if (deadline >= deviceDeadline_[index]) {
+        return;  // наявна подія не пізніша — на ній пристрій і так перепитають
+    }
+
+    if (deviceSyncCycle_[index] == ::elsim::IDevice::kNoEvent) {
+        deviceSyncCycle_[index] = now;  // пасивний пристрій не накопичував часу
+    }
+    deviceDeadline_[index] = deadline;
+    scheduler_.schedule(index, deadline);
+}
+
+// --- Checkpoint ---
+
+void Simulator::saveCheckpoint(const std::string& path) const {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::saveCheckpoint: board is not loaded");
+    }
+
+    StateWriter out;
+    writeState(out, /*includeRam=*/true);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Checkpoint: cannot open '" + path + "' for writing");
+    }
+    file.write(reinterpret_cast<const char*>(out.data().data()), static_cast<std::streamsize>(out.data().size()));
+    if (!file) {
+        throw std::runtime_error("Checkpoint: failed to write '" + path + "'");
+    }
+
+    log_ << "[Simulator] Checkpoint saved to '" << path << "' (" << out.data().size() << " bytes, cycle "
+         << clock_.now() << ")\n";
+}
+
+void Simulator::loadCheckpoint(const std::string& path) {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::loadCheckpoint: board is not loaded");
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Checkpoint: cannot open '" + path + "'");
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    try {
+        StateReader in(bytes);
+        readState(in, /*includeRam=*/true);
+    } catch (const std::runtime_error& ex) {
+        throw std::runtime_error("Checkpoint '" + path + "': " + ex.what());
+    }
+
+    log_ << "[Simulator] Checkpoint loaded from '" << path << "' (cycle " << clock_.now() << ")\n";
+}
+
+void Simulator::writeState(StateWriter& out, bool includeRam) const {
+    out.writeU32(kCheckpointMagic);
+    out.writeU32(kCheckpointVersion);
+
+    const auto ram = std::as_const(*memoryBus_).ram();
+
+    std::size_t chunk = out.beginChunk(kChunkBoard);
+    out.writeString(boardName_);
+    out.writeU64(ram.size());
+    out.writeU32(static_cast<std::uint32_t>(deviceNames_.size()));
+    for (const auto& name : deviceNames_) {
+        out.writeString(name);
+    }
+    // Незмінені сторінки flash у RAM-чанк не пишуться, тож checkpoint дійсний лише з тим самим образом.
+    std::uint32_t imageCount = 0;
+    for (const auto& region : memoryBus_->regions()) {
+        imageCount += region.image.empty() ? 0 : 1;
+    }
+    out.writeU32(imageCount);
+    for (const auto& region : memoryBus_->regions()) {
+        if (!region.image.empty()) {
+            out.writeString(region.name);
+            out.writeU64(region.imageSize);
+            out.writeU64(region.imageDigest);
+        }
+    }
+    out.endChunk(chunk);
+
+    chunk = out.beginChunk(kChunkSim);
+    out.writeU64(cycleCount_);
+    out.writeU64(clock_.now());
+    out.endChunk(chunk);
+
+    chunk = out.beginChunk(kChunkCpu);
+    cpu_->saveState(out);
+    out.endChunk(chunk);
+
+    if (includeRam) {
+        // RAM розріджено: лише сторінки, змінені відносно початкового вмісту (нулі чи образ flash).
+        constexpr std::size_t kPage = MemoryBus::kPageSize;
+        std::vector<std::uint32_t> pages;
+        for (std::size_t offset = 0; offset < ram.size(); offset += kPage) {
+            if (!memoryBus_->isInitialContent(offset, std::min(kPage, ram.size() - offset))) {
+                pages.push_back(static_cast<std::uint32_t>(offset / kPage));
+            }
+        }
+
+        chunk = out.beginChunk(kChunkRam);
+        out.writeU32(static_cast<std::uint32_t>(kPage));
+        out.writeU64(ram.size());
+        out.writeU32(static_cast<std::uint32_t>(pages.size()));
+        for (const std::uint32_t page : pages) {
+            const std::size_t offset = static_cast<std::size_t>(page) * kPage;
+            out.writeU32(page);
+            out.writeBytes(ram.subspan(offset, std::min(kPage, ram.size() - offset)));
         }
+        out.endChunk(chunk);
     }
 
-    // 4. Збільшити кількість циклів
-    ++cycleCount_;
+    if (gpio_) {
+        chunk = out.beginChunk(kChunkGpio);
+        out.writeU64(gpio_->getDirectionMask());
+        out.writeU64(gpio_->getOutputMask());
+        out.writeU64(gpio_->getInputMask());
+        out.endChunk(chunk);
+    }
+
+    // Кожен пристрій пише свій чанк; пристрої без стану дають порожній payload.
+    for (std::size_t i = 0; i < devices_.size(); ++i) {
+        if (!devices_[i]) {
+            continue;
+        }
+        chunk = out.beginChunk(kChunkDevice);
+        out.writeU32(static_cast<std::uint32_t>(i));
+        out.writeString(deviceNames_[i]);
+        devices_[i]->saveState(out);
+        out.endChunk(chunk);
+    }
 }
 
+void Simulator::readState(StateReader& in, bool includeRam) {
+    if (in.readU32() != kCheckpointMagic) {
+        throw std::runtime_error("not an elsim checkpoint (bad magic)");
+    }
+    const std::uint32_t version = in.readU32();
+    if (version != kCheckpointVersion) {
+        throw std::runtime_error("unsupported version " + std::to_string(version) + " (expected " +
+                                 std::to_string(kCheckpointVersion) + ")");
+    }
+
+    // Спершу розбираємо всі чанки: обрізаний файл відхиляється ще до зміни стану.
+    std::optional<StateReader::Chunk> board, sim, cpu, ram, gpio;
+    std::vector<StateReader::Chunk> deviceChunks;
+    while (!in.atEnd()) {
+        const auto chunk = in.readChunk();
+        switch (chunk.tag) {
+            case kChunkBoard:
+                board = chunk;
+                break;
+            case kChunkSim:
+                sim = chunk;
+                break;
+            case kChunkCpu:
+                cpu = chunk;
+                break;
+            case kChunkRam:
+                ram = chunk;
+                break;
+            case kChunkGpio:
+                gpio = chunk;
+                break;
+            case kChunkDevice:
+                deviceChunks.push_back(chunk);
+                break;
+            default:
+                break;  // невідомі чанки пропускаємо (сумісність уперед у межах версії)
+        }
+    }
+    if (!board || !sim || !cpu || (includeRam && !ram)) {
+        throw std::runtime_error("missing required chunk (BORD, SIM, CPU or RAM)");
+    }
+    // Далі — лише через посилання: компілятор бачить, що optional заповнені.
+    const StateReader::Chunk& boardChunk = *board;
+    const StateReader::Chunk& simChunk = *sim;
+    const StateReader::Chunk& cpuChunk = *cpu;
+    const StateReader::Chunk* ramChunk = includeRam ? &*ram : nullptr;
+    const StateReader::Chunk* gpioChunk = gpio ? &*gpio : nullptr;
+
+    // --- Сумісність з поточною платою ---
+    const std::size_t ramSize = std::as_const(*memoryBus_).ram().size();
+    {
+        StateReader r(boardChunk.payload);
+        const std::string name = r.readString();
+        const std::uint64_t savedRamSize = r.readU64();
+        if (name != boardName_ || savedRamSize != ramSize) {
+            throw std::runtime_error("saved for board '" + name + "' with " + std::to_string(savedRamSize) +
+                                     " bytes of RAM, current board is '" + boardName_ + "' with " +
+                                     std::to_string(ramSize) + " bytes");
+        }
+        const std::uint32_t count = r.readU32();
+        if (count != deviceNames_.size()) {
+            throw std::runtime_error("device count mismatch (" + std::to_string(count) + " saved, " +
+                                     std::to_string(deviceNames_.size()) + " on board)");
+        }
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const std::string deviceName = r.readString();
+            if (deviceName != deviceNames_[i]) {
+                throw std::runtime_error("device #" + std::to_string(i) + " is '" + deviceName +
+                                         "' in checkpoint but '" + deviceNames_[i] + "' on board");
+            }
+        }
+
+        std::vector<const MemoryBus::Region*> images;
+        for (const auto& region : memoryBus_->regions()) {
+            if (!region.image.empty()) {
+                images.push_back(&region);
+            }
+        }
+        const std::uint32_t imageCount = r.readU32();
+        if (imageCount != images.size()) {
+            throw std::runtime_error("image count mismatch (" + std::to_string(imageCount) + " saved, " +
+                                     std::to_string(images.size()) + " on board)");
+        }
+        for (const MemoryBus::Region* region : images) {
+            const std::string regionName = r.readString();
+            const std::uint64_t imageSize = r.readU64();
+            const std::uint64_t imageDigest = r.readU64();
+            if (regionName != region->name || imageSize != region->imageSize || imageDigest != region->imageDigest) {
+                throw std::runtime_error("saved with a different image of region '" + regionName + "' (" +
+                                         std::to_string(imageSize) + " bytes), current '" + region->name +
+                                         "' is mapped from '" + region->image + "' (" +
+                                         std::to_string(region->imageSize) + " bytes)");
+            }
+        }
+    }
+
+    // --- Перевірка решти чанків: усе розбирається в тимчасові змінні до першої зміни стану машини,
+    // тож пошкоджений checkpoint відхиляється, а плата лишається як була ---
+    std::uint64_t savedCycles = 0;
+    std::uint64_t savedNow = 0;
+    {
+        StateReader r(simChunk.payload);
+        savedCycles = r.readU64();
+        savedNow = r.readU64();
+    }
+
+    struct SavedPage {
+        std::size_t offset;
+        std::span<const std::uint8_t> bytes;
+    };
+    std::vector<SavedPage> pages;
+    if (ramChunk != nullptr) {
+        StateReader r(ramChunk->payload);
+        const std::uint32_t pageSize = r.readU32();
+        const std::uint64_t savedRamSize = r.readU64();
+        const std::uint32_t count = r.readU32();
+        if (pageSize == 0 || savedRamSize != ramSize) {
+            throw std::runtime_error("malformed RAM chunk");
+        }
+        pages.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const std::uint64_t offset = static_cast<std::uint64_t>(r.readU32()) * pageSize;
+            if (offset >= ramSize) {
+                throw std::runtime_error("RAM page outside of RAM");
+            }
+            const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(pageSize, ramSize - offset));
+            const auto bytes = r.readBytes(size);
+            pages.push_back(SavedPage{static_cast<std::size_t>(offset), bytes});
+        }
+    }
+
+    if (cpuChunk.payload.size() != savedStateSize(*cpu_)) {
+        throw std::runtime_error("CPU state has " + std::to_string(cpuChunk.payload.size()) + " bytes, expected " +
+                                 std::to_string(savedStateSize(*cpu_)));
+    }
+
+    std::uint64_t gpioDir = 0;
+    std::uint64_t gpioOut = 0;
+    std::uint64_t gpioIn = 0;
+    if (gpioChunk != nullptr) {
+        StateReader r(gpioChunk->payload);
+        gpioDir = r.readU64();
+        gpioOut = r.readU64();
+        gpioIn = r.readU64();
+    }
+
+    struct SavedDevice {
+        std::uint32_t index;
+        StateReader state;
+    };
+    std::vector<SavedDevice> deviceStates;
+    deviceStates.reserve(deviceChunks.size());
+    for (const auto& chunk : deviceChunks) {
+        StateReader r(chunk.payload);
+        const std::uint32_t index = r.readU32();
+        const std::string name = r.readString();
+        if (index >= devices_.size() || !devices_[index] || deviceNames_[index] != name) {
+            throw std::runtime_error("unexpected device chunk '" + name + "'");
+        }
+        // loadState() читає рівно те, що записав saveState(), тож розмір стану має збігатися.
+        const std::size_t expected = savedStateSize(*devices_[index]);
+        if (r.remaining() != expected) {
+            throw std::runtime_error("device '" + name + "' state has " + std::to_string(r.remaining()) +
+                                     " bytes, expected " + std::to_string(expected));
+        }
+        deviceStates.push_back(SavedDevice{index, r});
+    }
+
+    // --- Час: пристрої нижче рахують від уже відновленого клока ---
+    cycleCount_ = savedCycles;
+    clock_.setNow(savedNow);
+    // Час, що "висів" у пристроях до відновлення, більше не актуальний.
+    deviceSyncCycle_.assign(devices_.size(), ::elsim::IDevice::kNoEvent);
+
+    // Відтворення продовжується з подій, що ще не настали на відновленому часі.
+    const auto& events = replay_.events();
+    const auto pending = std::lower_bound(events.begin(), events.end(), savedNow,
+                                          [](const InputEvent& e, std::uint64_t cycle) { return e.cycle < cycle; });
+    replayPos_ = static_cast<std::size_t>(std::distance(events.begin(), pending));
+
+    // Семплінг — з найближчого кратного інтервалу циклу, як після startSampling().
+    if (sampler_) {
+        const std::uint64_t interval = sampler_->interval();
+        nextSampleCycle_ = (savedNow + interval - 1) / interval * interval;
+    }
+
+    // --- RAM ---
+    if (ramChunk != nullptr) {
+        // Незмінені сторінки в checkpoint не пишуться: повертаємо пам'ять до початкового вмісту
+        // (RAM — нулі з поверненням ОС, flash — знову відображений образ) і записуємо лише збережені сторінки.
+        memoryBus_->resetMemory();
+        const auto memory = memoryBus_->ram();
+        for (const auto& page : pages) {
+            std::copy(page.bytes.begin(), page.bytes.end(),
+                      memory.begin() + static_cast<std::ptrdiff_t>(page.offset));
+        }
+    }
+
+    // --- CPU (після RAM: CPU скидає кеші коду) ---
+    {
+        StateReader r(cpuChunk.payload);
+        cpu_->loadState(r);
+    }
+
+    // --- GPIO (підписники, напр. LED, оновлюються самі) ---
+    if (gpio && gpio_) {
+        gpio_->restoreMasks(gpioDir, gpioOut, gpioIn);
+    }
+
+    // --- Пристрої ---
+    for (auto& saved : deviceStates) {
+        devices_[saved.index]->loadState(saved.state);
+    }
+
+    resetDeviceSchedule(cycleCount_);
+}
+
+// --- Стан у пам'яті ---
+
+std::vector<std::uint8_t> Simulator::saveMachineState() const {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::saveMachineState: board is not loaded");
+    }
+    StateWriter out;
+    writeState(out, /*includeRam=*/false);
+    return out.release();
+}
+
+void Simulator::loadMachineState(std::span<const std::uint8_t> state) {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::loadMachineState: board is not loaded");
+    }
+    running_ = false;
+    StateReader in(state);
+    readState(in, /*includeRam=*/false);
+}
+
+// --- Базовий стан ---
+
+void Simulator::markBaseline() {
+    if (!cpu_ || !memoryBus_) {
+        throw std::runtime_error("Simulator::markBaseline: board is not loaded");
+    }
+
+    // RAM знімає MemoryBus (з обліком змінених сторінок), решта — той самий формат, що й checkpoint.
+    baselineState_ = saveMachineState();
+    memoryBus_->markBaseline();
+}
+
+std::size_t Simulator::resetToBaseline() {
+    if (!memoryBus_ || baselineState_.empty()) {
+        throw std::runtime_error("Simulator::resetToBaseline: no baseline, call markBaseline() first");
+    }
+
+    const std::size_t restoredPages = memoryBus_->restoreBaseline();
+    loadMachineState(baselineState_);
+    return restoredPages;
+}
+
+void Simulator::setQuantum(std::uint64_t quantum) {
+    if (quantum == 0) {
+        throw std::invalid_argument("Simulator::setQuantum: quantum must be > 0");
+    }
+    quantum_ = quantum;
+}
+
+std::uint64_t Simulator::quantum() const noexcept { return quantum_; }
+
 bool Simulator::isRunning() const noexcept { return running_; }
 
 std::uint64_t Simulator::cycleCount() const noexcept { return cycleCount_; }
 
+std::uint64_t Simulator::skippedCycles() const noexcept { return skippedCycles_; }
+
+const SimClock& Simulator::clock() const noexcept { return clock_; }
+
 ICpu* Simulator::cpu() noexcept { return cpu_.get(); }
 
 const ICpu* Simulator::cpu() const noexcept { return cpu_.get(); }
@@ -0,0 +1,118 @@
+#include "elsim/core/StateStream.hpp"
+
+#include <stdexcept>
+
+namespace elsim::core {
+
+// --- StateWriter ---
+
+void StateWriter::writeU8(std::uint8_t value) { buffer_.push_back(value); }
+
+void StateWriter::writeU16(std::uint16_t value) {
+    writeU8(static_cast<std::uint8_t>(value & 0xFFu));
+    writeU8(static_cast<std::uint8_t>(value >> 8));
+}
+
+void StateWriter::writeU32(std::uint32_t value) {
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        writeU8(static_cast<std::uint8_t>((value >> shift) & 0xFFu));
+    }
+}
+
+void StateWriter::writeU64(std::uint64_t value) {
+    writeU32(static_cast<std::uint32_t>(value & 0xFFFFFFFFu));
+    writeU32(static_cast<std::uint32_t>(value >> 32));
+}
+
+void StateWriter::writeBytes(std::span<const std::uint8_t> bytes) {
+    buffer_.insert(buffer_.end(), bytes.begin(), bytes.end());
+}
+
+void StateWriter::writeString(const std::string& text) {
+    writeU32(static_cast<std::uint32_t>(text.size()));
+    buffer_.insert(buffer_.end(), text.begin(), text.end());
+}
+
+void StateWriter::writeVarU64(std::uint64_t value) {
+    while (value >= 0x80u) {
+        writeU8(static_cast<std::uint8_t>((value & 0x7Fu) | 0x80u));
+        value >>= 7;
+    }
+    writeU8(static_cast<std::uint8_t>(value));
+}
+
+std::size_t StateWriter::beginChunk(std::uint32_t tag) {
+    writeU32(tag);
+    const std::size_t position = buffer_.size();
+    writeU32(0);  // розмір допишемо в endChunk()
+    return position;
+}
+
+void StateWriter::endChunk(std::size_t position) {
+    const std::size_t size = buffer_.size() - position - 4;
+    if (size > 0xFFFFFFFFu) {
+        throw std::length_error("StateWriter: chunk is larger than 4 GiB");
+    }
+    for (unsigned i = 0; i < 4; ++i) {
+        buffer_[position + i] = static_cast<std::uint8_t>((size >> (8 * i)) & 0xFFu);
+    }
+}
+
+// --- StateReader ---
+
+std::span<const std::uint8_t> StateReader::take(std::size_t count) {
+    if (count > remaining()) {
+        throw std::runtime_error("StateReader: unexpected end of data (need " + std::to_string(count) +
+                                 " bytes, have " + std::to_string(remaining()) + ")");
+    }
+    const auto bytes = data_.subspan(position_, count);
+    position_ += count;
+    return bytes;
+}
+
+std::uint8_t StateReader::readU8() { return take(1)[0]; }
+
+std::uint16_t StateReader::readU16() {
+    const auto b = take(2);
+    return static_cast<std::uint16_t>(b[0] | (b[1] << 8));
+}
+
+std::uint32_t StateReader::readU32() {
+    const auto b = take(4);
+    return static_cast<std::uint32_t>(b[0]) | (static_cast<std::uint32_t>(b[1]) << 8) |
+           (static_cast<std::uint32_t>(b[2]) << 16) | (static_cast<std::uint32_t>(b[3]) << 24);
+}
+
+std::uint64_t StateReader::readU64() {
+    const std::uint64_t low = readU32();
+    const std::uint64_t high = readU32();
+    return low | (high << 32);
+}
+
+std::span<const std::uint8_t> StateReader::readBytes(std::size_t count) { return take(count); }
+
+std::string StateReader::readString() {
+    const std::uint32_t size = readU32();
+    const auto bytes = take(size);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+std::uint64_t StateReader::readVarU64() {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const std::uint8_t byte = readU8();
+        value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("StateReader: varint is longer than 64 bits");
+}
+
+StateReader::Chunk StateReader::readChunk() {
+    const std::uint32_t tag = readU32();
+    const std::uint32_t size = readU32();
+    return Chunk{tag, take(size)};
+}
+
+}  // namespace elsim::core
@@ -0,0 +1,112 @@
+#include "elsim/core/SymbolMap.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace elsim::core {
+
+namespace {
+
+bool parseAddress(const std::string& text, std::uint64_t& value) {
+    if (text.empty() || text.front() == '-') {
+        return false;
+    }
+    try {
+        std::size_t pos = 0;
+        value = std::stoull(text, &pos, 0);
+        return pos == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+}  // namespace
+
+void SymbolMap::add(std::uint32_t start, std::uint32_t end, std::string name) {
+    if (end <= start) {
+        throw std::invalid_argument("SymbolMap: symbol '" + name + "' has an empty address range");
+    }
+    if (name.empty() || name.find_first_of(" \t;") != std::string::npos) {
+        throw std::invalid_argument("SymbolMap: invalid symbol name '" + name + "'");
+    }
+
+    for (const Symbol& other : symbols_) {
+        const bool disjoint = end <= other.start || other.end <= start;
+        const bool nested = (start >= other.start && end <= other.end) || (other.start >= start && other.end <= end);
+        if (!disjoint && !nested) {
+            throw std::invalid_argument("SymbolMap: symbol '" + name + "' partially overlaps '" + other.name + "'");
+        }
+    }
+
+    // За зростанням start, ширший діапазон — раніше: тоді зовнішній символ іде перед вкладеними.
+    const auto position = std::upper_bound(symbols_.begin(), symbols_.end(), std::pair{start, end},
+                                           [](const std::pair<std::uint32_t, std::uint32_t>& key, const Symbol& s) {
+                                               return key.first != s.start ? key.first < s.start : key.second > s.end;
+                                           });
+    symbols_.insert(position, Symbol{start, end, std::move(name)});
+}
+
+SymbolMap SymbolMap::parse(std::istream& in, const std::string& sourceName) {
+    SymbolMap map;
+    std::string line;
+    for (std::size_t lineNo = 1; std::getline(in, line); ++lineNo) {
+        if (const auto comment = line.find('#'); comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream fields(line);
+        std::string startText;
+        std::string endText;
+        std::string name;
+        std::string extra;
+        if (!(fields >> startText)) {
+            continue;  // порожній рядок або лише коментар
+        }
+
+        const std::string where = sourceName + ":" + std::to_string(lineNo) + ": ";
+        std::uint64_t start = 0;
+        std::uint64_t end = 0;
+        if (!(fields >> endText >> name) || (fields >> extra)) {
+            throw std::runtime_error(where + "expected '<start> <end> <name>'");
+        }
+        if (!parseAddress(startText, start) || !parseAddress(endText, end) ||
+            end > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error(where + "invalid address range '" + startText + " " + endText + "'");
+        }
+
+        try {
+            map.add(static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(end), std::move(name));
+        } catch (const std::invalid_argument& ex) {
+            throw std::runtime_error(where + ex.what());
+        }
+    }
+    return map;
+}
+
+SymbolMap SymbolMap::loadFromFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("SymbolMap: cannot open '" + path + "'");
+    }
+    return parse(in, path);
+}
+
+std::vector<std::string_view> SymbolMap::stackAt(std::uint32_t pc) const {
+    std::vector<std::string_view> stack;
+    for (const Symbol& symbol : symbols_) {
+        if (symbol.start > pc) {
+            break;
+        }
+        if (pc < symbol.end) {
+            stack.push_back(symbol.name);
+        }
+    }
+    return stack;
+}
+
+}  // namespace elsim::core
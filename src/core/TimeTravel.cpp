@@ -0,0 +1,263 @@
+#include "elsim/core/TimeTravel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "elsim/core/Simulator.hpp"
+
+namespace elsim::core {
+
+namespace {
+
+MemoryBus& requireBus(Simulator& sim) {
+    if (sim.memoryBus() == nullptr || sim.cpu() == nullptr) {
+        throw std::invalid_argument("TimeTravel: simulator has no board loaded");
+    }
+    return *sim.memoryBus();
+}
+
+}  // namespace
+
+TimeTravel::TimeTravel(Simulator& sim, std::uint64_t interval, std::size_t capacity)
+    : sim_(sim), bus_(requireBus(sim)), interval_(interval), capacity_(capacity) {
+    if (interval == 0) {
+        throw std::invalid_argument("TimeTravel: interval must be > 0");
+    }
+    if (capacity < 2) {
+        throw std::invalid_argument("TimeTravel: capacity must be >= 2");
+    }
+
+    takeSnapshot(sim_.saveMachineState());
+}
+
+std::uint64_t TimeTravel::now() const noexcept { return sim_.clock().now(); }
+
+std::uint64_t TimeTravel::oldestCycle() const noexcept { return snapshots_.front().cycle; }
+
+// --- Виконання вперед ---
+
+std::uint64_t TimeTravel::run(std::uint64_t cycles) {
+    truncateFuture();
+
+    // Між run() стан міг змінитись ззовні (кнопка, запис у шину) — тоді replay від попереднього
+    // знімка вже не відтворить його, і потрібен новий знімок у цій точці.
+    std::vector<std::uint8_t> machine = sim_.saveMachineState();
+    const bool untouched = lastRun_.valid && lastRun_.cycle == now() && lastRun_.machine == machine &&
+                           bus_.dirtyPagesSince(lastRun_.epoch).empty();
+    const bool atAnchor = snapshots_.back().cycle == now() && snapshots_.back().machine == machine &&
+                          pagesChangedSinceAnchor().empty();
+    if (!untouched && !atAnchor) {
+        takeSnapshot(std::move(machine));
+    }
+
+    std::uint64_t executed = 0;
+    while (executed < cycles) {
+        const std::uint64_t boundary = snapshots_.back().cycle + interval_;
+        const std::uint64_t step = std::min(cycles - executed, boundary > now() ? boundary - now() : interval_);
+        const std::uint64_t done = sim_.runFor(step);
+        executed += done;
+
+        if (now() >= boundary) {
+            takeSnapshot(sim_.saveMachineState());
+        }
+        if (done < step) {
+            break;  // HALT
+        }
+    }
+
+    headCycle_ = now();
+    lastRun_.valid = true;
+    lastRun_.cycle = headCycle_;
+    lastRun_.machine = sim_.saveMachineState();
+    lastRun_.epoch = bus_.openDirtyEpoch();
+    return executed;
+}
+
+// --- Навігація ---
+
+bool TimeTravel::gotoCycle(std::uint64_t cycle) {
+    const std::uint64_t current = now();
+    if (cycle == current) {
+        return true;
+    }
+    if (cycle < oldestCycle()) {
+        return false;
+    }
+
+    if (cycle > headCycle_) {
+        // За межами історії: доганяємо її кінець і виконуємо далі як звичайний run().
+        if (!gotoCycle(headCycle_)) {
+            return false;
+        }
+        const std::uint64_t remaining = cycle - headCycle_;
+        return run(remaining) == remaining;
+    }
+
+    const std::size_t index = snapshotAtOrBefore(cycle);
+    if (index == anchor_ && current < cycle) {
+        sim_.runFor(cycle - current);  // ціль попереду в тому самому сегменті — просто доганяємо
+    } else {
+        restore(index);
+        sim_.runFor(cycle - snapshots_[index].cycle);
+    }
+    return now() == cycle;
+}
+
+bool TimeTravel::stepBack(std::uint64_t count) {
+    const std::uint64_t current = now();
+    if (count > current) {
+        return false;
+    }
+    return gotoCycle(current - count);
+}
+
+std::optional<std::uint64_t> TimeTravel::runBackToWrite(std::uint32_t address, std::uint32_t size) {
+    // Діапазон має лежати в одному регіоні пам'яті; у ram() він починається з offset.
+    const MemoryBus::Region* region = bus_.findRegion(address);
+    if (size == 0 || region == nullptr ||
+        static_cast<std::uint64_t>(address) + size > static_cast<std::uint64_t>(region->base) + region->size) {
+        throw std::out_of_range("TimeTravel::runBackToWrite: range is outside of RAM");
+    }
+
+    // Спостереження за записами: кожен запис у діапазон запам'ятовує цикл, на якому почалась його
+    // інструкція (clock().now() усередині batch-а точний). Знімається на будь-якому виході.
+    std::optional<std::uint64_t> lastWrite;
+    bus_.setWriteWatch(address, size, [&] { lastWrite = sim_.clock().now(); });
+    struct WatchScope {
+        MemoryBus& bus;
+        ~WatchScope() { bus.clearWriteWatch(); }
+    } scope{bus_};
+
+    const std::uint64_t origin = now();
+    std::uint64_t end = origin;
+
+    // Сегменти між знімками — від найновішого до найстарішого; кожен проганяємо цілком одним runFor,
+    // тож останнім спрацюванням спостереження лишається останній запис сегмента.
+    while (end > oldestCycle()) {
+        const std::size_t index = snapshotAtOrBefore(end - 1);
+        const std::uint64_t start = snapshots_[index].cycle;
+        restore(index);
+        lastWrite.reset();
+        sim_.runFor(end - start);
+
+        if (lastWrite) {
+            const std::uint64_t cycle = *lastWrite;
+            bus_.clearWriteWatch();
+            gotoCycle(cycle);
+            return cycle;
+        }
+        end = start;
+    }
+
+    bus_.clearWriteWatch();
+    gotoCycle(origin);
+    return std::nullopt;
+}
+
+// --- Знімки ---
+
+void TimeTravel::takeSnapshot(std::vector<std::uint8_t> machine) {
+    Snapshot snapshot{now(), std::move(machine), {}};
+    const auto ram = std::as_const(bus_).ram();
+
+    if (snapshots_.empty()) {
+        // Копія не торкається нульових сторінок, тож базовий образ розрідженої RAM теж розріджений.
+        if (baseRam_.capacity() < ram.size()) {
+            baseRam_ = HostMemory(ram.size());
+        }
+        baseRam_.assign(ram);
+    } else {
+        // Лише сторінки, що справді відрізняються від попереднього знімка.
+        for (const std::uint32_t page : pagesChangedSinceAnchor()) {
+            const auto previous = pageAt(anchor_, page);
+            const auto current = ram.subspan(static_cast<std::size_t>(page) * MemoryBus::kPageSize, previous.size());
+            if (!std::equal(current.begin(), current.end(), previous.begin())) {
+                snapshot.pages.push_back(PageImage{page, std::vector<std::uint8_t>(current.begin(), current.end())});
+            }
+        }
+    }
+
+    snapshots_.push_back(std::move(snapshot));
+
+    if (snapshots_.size() > capacity_) {
+        // Найстаріший знімок витісняється: зміни наступного вливаються в базовий образ.
+        for (auto& image : snapshots_[1].pages) {
+            std::copy(image.bytes.begin(), image.bytes.end(),
+                      baseRam_.data() + static_cast<std::size_t>(image.page) * MemoryBus::kPageSize);
+        }
+        snapshots_[1].pages.clear();
+        snapshots_.pop_front();
+    }
+
+    anchor_ = snapshots_.size() - 1;
+    anchorEpoch_ = bus_.openDirtyEpoch();
+    headCycle_ = std::max(headCycle_, snapshots_.back().cycle);
+}
+
+std::vector<std::uint32_t> TimeTravel::pagesChangedSinceAnchor() const {
+    return bus_.dirtyPagesSince(anchorEpoch_);
+}
+
+std::span<const std::uint8_t> TimeTravel::pageAt(std::size_t index, std::uint32_t page) const {
+    for (std::size_t i = index + 1; i-- > 0;) {
+        const auto& pages = snapshots_[i].pages;
+        const auto it = std::lower_bound(pages.begin(), pages.end(), page, [](const PageImage& image, std::uint32_t v) {
+            return image.page < v;
+        });
+        if (it != pages.end() && it->page == page) {
+            return it->bytes;
+        }
+    }
+
+    const std::size_t offset = static_cast<std::size_t>(page) * MemoryBus::kPageSize;
+    const std::size_t size = std::min<std::size_t>(MemoryBus::kPageSize, baseRam_.size() - offset);
+    return std::as_const(baseRam_).bytes().subspan(offset, size);
+}
+
+void TimeTravel::restore(std::size_t index) {
+    // Сторінки, що відрізняють поточну RAM від знімка index: змінені після anchor_ і ті,
+    // що змінювались між anchor_ та index (у будь-який бік).
+    std::vector<bool> candidate(bus_.pageCount(), false);
+    for (const std::uint32_t page : pagesChangedSinceAnchor()) {
+        candidate[page] = true;
+    }
+    for (std::size_t i = std::min(index, anchor_) + 1; i <= std::max(index, anchor_); ++i) {
+        for (const auto& image : snapshots_[i].pages) {
+            candidate[image.page] = true;
+        }
+    }
+
+    const auto ram = std::as_const(bus_).ram();
+    for (std::uint32_t page = 0; page < candidate.size(); ++page) {
+        if (!candidate[page]) {
+            continue;
+        }
+        const auto saved = pageAt(index, page);
+        const auto current = ram.subspan(static_cast<std::size_t>(page) * MemoryBus::kPageSize, saved.size());
+        if (!std::equal(current.begin(), current.end(), saved.begin())) {
+            bus_.loadPage(page, saved);
+        }
+    }
+
+    sim_.loadMachineState(snapshots_[index].machine);
+    anchor_ = index;
+    anchorEpoch_ = bus_.openDirtyEpoch();
+    lastRun_.valid = false;
+}
+
+std::size_t TimeTravel::snapshotAtOrBefore(std::uint64_t target) const {
+    // Кілька знімків на одному циклі можливі (зовнішня зміна між run()) — беремо найпізніший.
+    const auto it = std::upper_bound(snapshots_.begin(), snapshots_.end(), target,
+                                     [](std::uint64_t value, const Snapshot& s) { return value < s.cycle; });
+    return static_cast<std::size_t>(std::distance(snapshots_.begin(), it)) - 1;
+}
+
+void TimeTravel::truncateFuture() {
+    if (anchor_ + 1 < snapshots_.size()) {
+        snapshots_.erase(snapshots_.begin() + static_cast<std::ptrdiff_t>(anchor_) + 1, snapshots_.end());
+    }
+    headCycle_ = now();
+}
+
+}  // namespace elsim::core
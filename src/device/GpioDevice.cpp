@@ -128,9 +128,11 @@ std::uint8_t GpioDevice::read(std::uint32_t offset) {
 
         const std::uint8_t value = static_cast<std::uint8_t>((regValue >> (8u * byteOff)) & 0xFFu);
 
-        char buf[96];
-        std::snprintf(buf, sizeof(buf), "READ offset=0x%X -> 0x%02X", offset, static_cast<unsigned int>(value));
-        logger.debug(COMPONENT, buf);
+        if (ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "READ offset=0x%X -> 0x%02X", offset, static_cast<unsigned int>(value));
+            logger.debug(COMPONENT, buf);
+        }
 
         return value;
     }
@@ -221,9 +223,12 @@ void GpioDevice::write(std::uint32_t offset, std::uint8_t value) {
         cur |= (static_cast<std::uint32_t>(value) << shift);
         writeReg32(cur);
 
-        char buf[96];
-        std::snprintf(buf, sizeof(buf), "WRITE RW offset=0x%X value=0x%02X", offset, static_cast<unsigned int>(value));
-        logger.debug(COMPONENT, buf);
+        if (ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "WRITE RW offset=0x%X value=0x%02X", offset,
+                          static_cast<unsigned int>(value));
+            logger.debug(COMPONENT, buf);
+        }
         return;
     }
 
@@ -231,9 +236,12 @@ void GpioDevice::write(std::uint32_t offset, std::uint8_t value) {
         const std::uint32_t maskPart = (static_cast<std::uint32_t>(value) << (8u * byteOff)) & pinMask_;
         writeReg32(maskPart);
 
-        char buf[96];
-        std::snprintf(buf, sizeof(buf), "WRITE WO offset=0x%X value=0x%02X", offset, static_cast<unsigned int>(value));
-        logger.debug(COMPONENT, buf);
+        if (ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "WRITE WO offset=0x%X value=0x%02X", offset,
+                          static_cast<unsigned int>(value));
+            logger.debug(COMPONENT, buf);
+        }
         return;
     }
 
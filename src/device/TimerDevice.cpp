@@ -6,6 +6,7 @@
 #include <string_view>
 
 #include "elsim/core/Logger.hpp"
+#include "elsim/core/StateStream.hpp"
 
 namespace elsim {
 
@@ -24,20 +25,21 @@ std::uint8_t TimerDevice::read(std::uint32_t offset) {
 
     std::uint8_t value = 0xFF;
     bool valid = true;
+    const std::uint32_t current = (offset < REG_COUNTER + 4) ? counter() : 0;
 
     switch (offset) {
         // COUNTER — 32-бітне значення, розбите на 4 байти (little-endian)
         case REG_COUNTER:
-            value = static_cast<std::uint8_t>((m_counter >> 0) & 0xFF);
+            value = static_cast<std::uint8_t>((current >> 0) & 0xFF);
             break;
         case REG_COUNTER + 1:
-            value = static_cast<std::uint8_t>((m_counter >> 8) & 0xFF);
+            value = static_cast<std::uint8_t>((current >> 8) & 0xFF);
             break;
         case REG_COUNTER + 2:
-            value = static_cast<std::uint8_t>((m_counter >> 16) & 0xFF);
+            value = static_cast<std::uint8_t>((current >> 16) & 0xFF);
             break;
         case REG_COUNTER + 3:
-            value = static_cast<std::uint8_t>((m_counter >> 24) & 0xFF);
+            value = static_cast<std::uint8_t>((current >> 24) & 0xFF);
             break;
 
         default: {
@@ -49,7 +51,7 @@ std::uint8_t TimerDevice::read(std::uint32_t offset) {
         }
     }
 
-    if (valid) {
+    if (valid && ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
         char buf[64];
         std::snprintf(buf, sizeof(buf), "READ offset=0x%X -> 0x%02X", offset, static_cast<unsigned int>(value));
         logger.debug(COMPONENT, buf);
@@ -68,8 +70,11 @@ void TimerDevice::write(std::uint32_t offset, std::uint8_t value) {
         case REG_CONTROL: {
             if (value == 1U) {
                 m_counter = 0;
-                logger.debug(COMPONENT, "CONTROL=1 -> counter reset");
-            } else {
+                if (m_clock != nullptr) {
+                    m_baseCycle = m_clock->now();
+                }
+                ELSIM_LOG_DEBUG(COMPONENT, "CONTROL=1 -> counter reset");
+            } else if (ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
                 char buf[64];
                 std::snprintf(buf, sizeof(buf), "WRITE CONTROL offset=0x%X value=0x%02X (ignored)", offset,
                               static_cast<unsigned int>(value));
@@ -92,15 +97,97 @@ void TimerDevice::write(std::uint32_t offset, std::uint8_t value) {
 // TICK
 // ------------------------------------------------------------
 void TimerDevice::tick() {
-    auto& logger = core::Logger::instance();
+    // З клоком час уже враховано в counter(); лишається лише лог на межі періоду.
+    if (m_clock != nullptr) {
+        advance(1);
+        return;
+    }
 
     ++m_counter;
 
     if (m_logPeriod != 0U && (m_counter % m_logPeriod) == 0U) {
-        char buf[64];
-        std::snprintf(buf, sizeof(buf), "Tick = %u", static_cast<unsigned int>(m_counter));
-        logger.debug(COMPONENT, buf);
+        logTick(m_counter);
+    }
+}
+
+// ------------------------------------------------------------
+// ADVANCE
+// ------------------------------------------------------------
+void TimerDevice::advance(std::uint64_t cycles) {
+    if (m_clock != nullptr) {
+        // Simulator будить нас рівно на межі періоду; після reset подія може бути застарілою.
+        const std::uint32_t current = counter();
+        if (m_logPeriod != 0U && current != 0U && (current % m_logPeriod) == 0U) {
+            logTick(current);
+        }
+        return;
+    }
+
+    const std::uint32_t before = m_counter;
+
+    // Лічильник 32-бітний і переповнюється так само, як при покроковому tick().
+    m_counter = static_cast<std::uint32_t>(m_counter + cycles);
+
+    // Логуємо один раз, якщо за цей проміжок перетнули хоча б одну межу періоду.
+    if (m_logPeriod != 0U && cycles != 0U) {
+        const std::uint64_t crossed = (static_cast<std::uint64_t>(before) % m_logPeriod + cycles) / m_logPeriod;
+        if (crossed != 0U) {
+            logTick(m_counter);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// SCHEDULING / CLOCK
+// ------------------------------------------------------------
+std::uint64_t TimerDevice::cyclesUntilNextEvent() const {
+    if (m_clock == nullptr) {
+        return 1;  // лічильник ведеться тіками
+    }
+
+    // Лінивий лічильник не потребує тіків; подія потрібна лише для Debug-логу "Tick = N".
+    if (m_logPeriod == 0U || !ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+        return kNoEvent;
+    }
+    return m_logPeriod - (counter() % m_logPeriod);
+}
+
+void TimerDevice::attachClock(const core::SimClock* clock) {
+    // Поточне значення COUNTER зберігається при переході між режимами.
+    const std::uint32_t current = counter();
+    m_clock = clock;
+    m_counter = current;
+    m_baseCycle = (clock != nullptr) ? clock->now() - current : 0;
+}
+
+// ------------------------------------------------------------
+// CHECKPOINT
+// ------------------------------------------------------------
+void TimerDevice::saveState(core::StateWriter& out) const { out.writeU32(counter()); }
+
+void TimerDevice::loadState(core::StateReader& in) {
+    // Simulator відновлює клок раніше за пристрої, тож базу рахуємо від уже відновленого now().
+    const std::uint32_t current = in.readU32();
+    m_counter = current;
+    m_baseCycle = (m_clock != nullptr) ? m_clock->now() - current : 0;
+}
+
+std::uint32_t TimerDevice::counter() const {
+    if (m_clock == nullptr) {
+        return m_counter;
     }
+    // Лічильник 32-бітний: переповнення — як при покроковому інкременті.
+    return static_cast<std::uint32_t>(m_clock->now() - m_baseCycle);
+}
+
+void TimerDevice::logTick(std::uint32_t value) const {
+    if (!ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+        return;
+    }
+
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "Tick = %u", static_cast<unsigned int>(value));
+    core::Logger::instance().debug(COMPONENT, buf);
 }
 
 }  // namespace elsim
@@ -26,7 +26,7 @@ std::uint8_t UartDevice::read(std::uint32_t offset) {
         return 0;
     }
 
-    logger.debug(COMPONENT, "READ offset=0x0 -> value=0x00");
+    ELSIM_LOG_DEBUG(COMPONENT, "READ offset=0x0 -> value=0x00");
     return 0;
 }
 
@@ -46,7 +46,11 @@ void UartDevice::write(std::uint32_t offset, std::uint8_t value) {
     unsigned char ch = value;
     std::putchar(ch);
 
-    // 2) Log the transmitted byte at DEBUG level.
+    // 2) Log the transmitted byte at DEBUG level (message is built only if DEBUG is enabled).
+    if (!ELSIM_LOG_ENABLED(core::LogLevel::Debug)) {
+        return;
+    }
+
     char hexBuf[8];
     std::snprintf(hexBuf, sizeof(hexBuf), "%02X", static_cast<unsigned int>(value));
 
@@ -5,6 +5,7 @@
 #include <utility>
 
 #include "elsim/core/Logger.hpp"
+#include "elsim/core/StateStream.hpp"
 
 namespace elsim {
 
@@ -70,4 +71,8 @@ void VirtualButtonDevice::release() {
         COMPONENT, name() + " released pin=" + std::to_string(pin_) + " level=" + std::to_string(level ? 1 : 0));
 }
 
+void VirtualButtonDevice::saveState(core::StateWriter& out) const { out.writeBool(pressed_); }
+
+void VirtualButtonDevice::loadState(core::StateReader& in) { pressed_ = in.readBool(); }
+
 }  // namespace elsim
@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/device/VirtualButtonDevice.hpp"
+#include "elsim/device/VirtualLedDevice.hpp"
+
+#include "test_support.hpp"
+
+namespace fs = std::filesystem;
+
+using elsim::core::BoardDescription;
+using elsim::core::FakeCpu;
+using elsim::core::MemoryBusFakeCpu;
+using elsim::core::MemoryBus;
+using elsim::core::Simulator;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "checkpoint-test";
+constexpr BoardOptions kBoardOptions{.timer = true, .gpio = true, .led = true, .button = true};
+
+// Нескінченний цикл, що лічить у R1 і пише лічильник у [0x100]:
+//   R1 += 1; [R0 + 0x100] = R1; JMP -3
+void loadCounterLoop(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 0));
+    writeWord(bus, 4, encode(OPC_ADD, 1, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_STORE, 0, 1, false, 0x100));
+    writeWord(bus, 12, encode(OPC_JMP, 0, 0, true, -3));
+    sim.cpu()->setPc(0);
+}
+
+std::uint32_t readLe32(const std::vector<std::uint8_t>& bytes, std::size_t pos) {
+    return static_cast<std::uint32_t>(bytes[pos]) | (static_cast<std::uint32_t>(bytes[pos + 1]) << 8) |
+           (static_cast<std::uint32_t>(bytes[pos + 2]) << 16) | (static_cast<std::uint32_t>(bytes[pos + 3]) << 24);
+}
+
+std::string tempPath(const std::string& name) {
+    return (fs::temp_directory_path() / ("elsim_checkpoint_" + name + ".bin")).string();
+}
+
+std::vector<std::uint8_t> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<std::uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::vector<std::uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Плата після "завантаження": програма відпрацювала, LED увімкнено, кнопка натиснута, дані в далекій сторінці RAM.
+void bootBoard(Simulator& sim) {
+    loadCounterLoop(sim);
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, kGpioBase + kGpioDir, 1u << 1);
+    writeWord(bus, kGpioBase + kGpioDataOut, 1u << 1);
+    writeWord(bus, 0xF000, 0xCAFEBABE);
+    sim.buttonDevices().at(0)->press();
+    sim.start(1234);
+}
+
+}  // namespace
+
+TEST(Checkpoint, RoundTripRestoresCpuRamTimerAndGpio) {
+    std::ostringstream logA;
+    Simulator original(logA);
+    original.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    bootBoard(original);
+
+    const std::string path = tempPath("roundtrip");
+    original.saveCheckpoint(path);
+
+    std::ostringstream logB;
+    Simulator restored(logB);
+    restored.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    restored.loadCheckpoint(path);
+
+    const auto& cpuA = dynamic_cast<const MemoryBusFakeCpu&>(*original.cpu());
+    const auto& cpuB = dynamic_cast<const MemoryBusFakeCpu&>(*restored.cpu());
+    EXPECT_EQ(cpuB.state(), cpuA.state());
+    EXPECT_EQ(cpuB.stepCount(), cpuA.stepCount());
+    EXPECT_EQ(restored.clock().now(), original.clock().now());
+
+    EXPECT_EQ(readWord(*restored.memoryBus(), 0x100), readWord(*original.memoryBus(), 0x100));
+    EXPECT_EQ(readWord(*restored.memoryBus(), 0xF000), 0xCAFEBABEu);
+    EXPECT_EQ(readWord(*restored.memoryBus(), kTimerBase), readWord(*original.memoryBus(), kTimerBase));
+
+    EXPECT_EQ(restored.gpioController()->getDirectionMask(), original.gpioController()->getDirectionMask());
+    EXPECT_EQ(restored.gpioController()->getOutputMask(), original.gpioController()->getOutputMask());
+    EXPECT_EQ(restored.gpioController()->getInputMask(), original.gpioController()->getInputMask());
+    EXPECT_TRUE(restored.ledDevices().at(0)->isOn());
+    EXPECT_TRUE(restored.buttonDevices().at(0)->isPressed());
+
+    // Обидві плати продовжують однаково: знімки після ще 500 циклів побайтово рівні.
+    original.start(500);
+    restored.start(500);
+    const std::string pathA = tempPath("continued_a");
+    const std::string pathB = tempPath("continued_b");
+    original.saveCheckpoint(pathA);
+    restored.saveCheckpoint(pathB);
+    EXPECT_EQ(readFile(pathA), readFile(pathB));
+
+    fs::remove(path);
+    fs::remove(pathA);
+    fs::remove(pathB);
+}
+
+TEST(Checkpoint, CheckpointCanBeRestoredOnDbtCpu) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+
+    std::ostringstream logA;
+    Simulator interpreter(logA);
+    interpreter.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    bootBoard(interpreter);
+
+    const std::string path = tempPath("cross_cpu");
+    interpreter.saveCheckpoint(path);
+
+    std::ostringstream logB;
+    Simulator translator(logB);
+    translator.loadBoard(makeBoard(kBoardName, "test-cpu-dbt", kBoardOptions));
+    translator.loadCheckpoint(path);
+
+    interpreter.start(777);
+    translator.start(777);
+    EXPECT_EQ(translator.cpu()->getPc(), interpreter.cpu()->getPc());
+    EXPECT_EQ(readWord(*translator.memoryBus(), 0x100), readWord(*interpreter.memoryBus(), 0x100));
+    EXPECT_EQ(readWord(*translator.memoryBus(), kTimerBase), readWord(*interpreter.memoryBus(), kTimerBase));
+
+    fs::remove(path);
+}
+
+TEST(Checkpoint, ZeroPagesAreStoredSparsely) {
+    constexpr std::uint64_t kRamSize = 1u << 20;  // 256 сторінок
+    BoardOptions options = kBoardOptions;
+    options.ramSize = kRamSize;
+
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", options));
+    loadCounterLoop(sim);
+    writeWord(*sim.memoryBus(), kRamSize - 4, 0x12345678);
+
+    const std::string path = tempPath("sparse");
+    sim.saveCheckpoint(path);
+
+    // Дві ненульові сторінки (код і остання) + заголовки чанків.
+    EXPECT_LT(fs::file_size(path), 3 * MemoryBus::kPageSize);
+
+    std::ostringstream logB;
+    Simulator restored(logB);
+    restored.loadBoard(makeBoard(kBoardName, "test-cpu", options));
+    writeWord(*restored.memoryBus(), 0x8000, 0xFFFFFFFF);  // має бути обнулено при відновленні
+    restored.loadCheckpoint(path);
+
+    EXPECT_EQ(readWord(*restored.memoryBus(), 0x8000), 0u);
+    EXPECT_EQ(readWord(*restored.memoryBus(), kRamSize - 4), 0x12345678u);
+
+    fs::remove(path);
+}
+
+TEST(Checkpoint, RejectsTruncatedForeignAndMismatchedFiles) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    bootBoard(sim);
+
+    const std::string path = tempPath("reject");
+    sim.saveCheckpoint(path);
+    const auto bytes = readFile(path);
+
+    std::ostringstream logB;
+    Simulator target(logB);
+    target.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCounterLoop(target);
+    const std::uint32_t pcBefore = target.cpu()->getPc();
+
+    // Обрізаний файл відхиляється до зміни стану.
+    writeFile(path, std::vector<std::uint8_t>(bytes.begin(), bytes.end() - 10));
+    EXPECT_THROW(target.loadCheckpoint(path), std::runtime_error);
+    EXPECT_EQ(target.cpu()->getPc(), pcBefore);
+    EXPECT_EQ(target.clock().now(), 0u);
+
+    // Чужий файл.
+    auto foreign = bytes;
+    foreign[0] = 'X';
+    writeFile(path, foreign);
+    EXPECT_THROW(target.loadCheckpoint(path), std::runtime_error);
+
+    // Плата з іншим розміром RAM.
+    writeFile(path, bytes);
+    std::ostringstream logC;
+    Simulator other(logC);
+    BoardOptions largerRam = kBoardOptions;
+    largerRam.ramSize = 0x20000;
+    other.loadBoard(makeBoard(kBoardName, "test-cpu", largerRam));
+    EXPECT_THROW(other.loadCheckpoint(path), std::runtime_error);
+
+    EXPECT_THROW(target.loadCheckpoint(tempPath("does_not_exist")), std::runtime_error);
+
+    fs::remove(path);
+}
+
+TEST(Checkpoint, CorruptedChunkLeavesBoardUntouched) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    bootBoard(sim);
+
+    const std::string path = tempPath("corrupted");
+    sim.saveCheckpoint(path);
+    const auto bytes = readFile(path);
+
+    // Зсув чанка з тегом tag (файл: magic, version, далі tag + size + payload).
+    const auto chunkAt = [&bytes](const char (&tag)[5]) {
+        std::size_t pos = 8;
+        while (pos + 8 <= bytes.size()) {
+            if (std::equal(tag, tag + 4, bytes.begin() + static_cast<std::ptrdiff_t>(pos))) {
+                return pos;
+            }
+            pos += 8 + readLe32(bytes, pos + 4);
+        }
+        ADD_FAILURE() << "chunk " << tag << " not found";
+        return pos;
+    };
+
+    std::ostringstream logB;
+    Simulator target(logB);
+    target.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCounterLoop(target);
+    target.start(100);
+    writeWord(*target.memoryBus(), 0xE000, 0x600DF00D);
+    const std::uint32_t counter = readWord(*target.memoryBus(), 0x100);
+    const std::uint32_t pc = target.cpu()->getPc();
+    const auto expectState = [&] {
+        EXPECT_EQ(target.cycleCount(), 100u);
+        EXPECT_EQ(target.clock().now(), 100u);
+        EXPECT_EQ(target.cpu()->getPc(), pc);
+        EXPECT_EQ(readWord(*target.memoryBus(), 0xE000), 0x600DF00Du);
+        EXPECT_EQ(readWord(*target.memoryBus(), 0xF000), 0u);
+        EXPECT_EQ(readWord(*target.memoryBus(), 0x100), counter);
+    };
+    expectState();
+
+    // Індекс першої сторінки RAM за межами RAM (payload: page size, RAM size, count, index...).
+    auto badPage = bytes;
+    const std::size_t ram = chunkAt("RAM ");
+    for (std::size_t i = 0; i < 4; ++i) {
+        badPage[ram + 8 + 16 + i] = 0xFF;
+    }
+    writeFile(path, badPage);
+    EXPECT_THROW(target.loadCheckpoint(path), std::runtime_error);
+    expectState();
+
+    // Стан CPU на байт коротший, ніж пише saveState().
+    auto shortCpu = bytes;
+    const std::size_t cpu = chunkAt("CPU ");
+    const std::uint32_t cpuSize = readLe32(bytes, cpu + 4);
+    shortCpu.erase(shortCpu.begin() + static_cast<std::ptrdiff_t>(cpu + 8 + cpuSize - 1));
+    shortCpu[cpu + 4] = static_cast<std::uint8_t>(cpuSize - 1);
+    writeFile(path, shortCpu);
+    EXPECT_THROW(target.loadCheckpoint(path), std::runtime_error);
+    expectState();
+
+    // Неушкоджений файл після цього відновлюється як завжди.
+    writeFile(path, bytes);
+    target.loadCheckpoint(path);
+    EXPECT_EQ(readWord(*target.memoryBus(), 0xF000), 0xCAFEBABEu);
+    EXPECT_EQ(target.clock().now(), sim.clock().now());
+
+    fs::remove(path);
+}
+
+TEST(Baseline, ResetRestoresDirtyPagesCpuDevicesAndTime) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCounterLoop(sim);
+    sim.markBaseline();
+
+    const std::string expectedPath = tempPath("baseline_expected");
+    sim.start(1000);
+    sim.saveCheckpoint(expectedPath);
+
+    // Сценарій змінює ще одну сторінку RAM, GPIO і кнопку.
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0xA000, 0xDEADBEEF);
+    writeWord(bus, kGpioBase + kGpioDir, 1u << 1);
+    writeWord(bus, kGpioBase + kGpioDataOut, 1u << 1);
+    sim.buttonDevices().at(0)->press();
+    sim.start(5000);
+
+    // Змінено сторінку коду/даних (0x100) і 0xA000.
+    EXPECT_EQ(sim.resetToBaseline(), 2u);
+    EXPECT_EQ(readWord(bus, 0xA000), 0u);
+    EXPECT_EQ(readWord(bus, 0x100), 0u);
+    EXPECT_EQ(sim.cpu()->getPc(), 0u);
+    EXPECT_EQ(sim.clock().now(), 0u);
+    EXPECT_EQ(readWord(bus, kTimerBase), 0u);
+    EXPECT_FALSE(sim.ledDevices().at(0)->isOn());
+    EXPECT_FALSE(sim.buttonDevices().at(0)->isPressed());
+    EXPECT_EQ(sim.gpioController()->getInputMask(), 0u);
+
+    // Повторний прогін з базового стану дає той самий результат, що й перший.
+    const std::string actualPath = tempPath("baseline_actual");
+    sim.start(1000);
+    sim.saveCheckpoint(actualPath);
+    EXPECT_EQ(readFile(actualPath), readFile(expectedPath));
+
+    fs::remove(expectedPath);
+    fs::remove(actualPath);
+}
+
+TEST(Baseline, ResetCatchesDirectRamStoresOfDbtCpu) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu-dbt", kBoardOptions));
+    loadCounterLoop(sim);
+    sim.markBaseline();
+
+    sim.start(1000);
+    ASSERT_NE(readWord(*sim.memoryBus(), 0x100), 0u);
+
+    EXPECT_EQ(sim.resetToBaseline(), 1u);
+    EXPECT_EQ(readWord(*sim.memoryBus(), 0x100), 0u);
+    EXPECT_EQ(sim.cpu()->getPc(), 0u);
+}
+
+TEST(Baseline, ResetWithoutBaselineThrows) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    EXPECT_THROW(sim.resetToBaseline(), std::runtime_error);
+}
@@ -0,0 +1,390 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/IMemoryMappedDevice.hpp"
+#include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/MemoryBusAdapter.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::DbtCpu;
+using elsim::core::FakeCpu;
+using elsim::core::IMemoryMappedDevice;
+using elsim::core::MemoryBus;
+using elsim::core::MemoryBusAdapter;
+using elsim::core::RunResult;
+using elsim::core::StopReason;
+using namespace elsim::test;
+
+namespace {
+
+// MMIO-регістр, що записує всі звернення (перевіряємо, що повільний шлях іде через шину).
+class RecordingDevice final : public IMemoryMappedDevice {
+   public:
+    std::uint8_t read8(std::uint32_t offset) override {
+        ++reads;
+        return static_cast<std::uint8_t>(0x40 + offset);
+    }
+    void write8(std::uint32_t offset, std::uint8_t value) override { writes.push_back((offset << 8) | value); }
+
+    int reads{0};
+    std::vector<std::uint32_t> writes;
+};
+
+constexpr std::uint32_t kRamSize = 4096;
+constexpr std::uint32_t kCodeBytes = 1024;  // програма: [0, 1024), дані: [1024, 4096)
+constexpr std::uint32_t kMmioBase = 0x0C00;
+constexpr std::uint32_t kMmioSize = 0x10;
+
+// Інтерпретатор і транслятор на двох однакових платах.
+struct Pair {
+    MemoryBus interpBus{kRamSize};
+    MemoryBus dbtBus{kRamSize};
+    std::shared_ptr<RecordingDevice> interpDev = std::make_shared<RecordingDevice>();
+    std::shared_ptr<RecordingDevice> dbtDev = std::make_shared<RecordingDevice>();
+    FakeCpu interp;
+    DbtCpu dbt;
+
+    Pair() {
+        interpBus.mapDevice(kMmioBase, kMmioSize, interpDev);
+        dbtBus.mapDevice(kMmioBase, kMmioSize, dbtDev);
+        interp.setMemoryBus(std::make_shared<MemoryBusAdapter>(&interpBus));
+        dbt.setMemoryBus(std::make_shared<MemoryBusAdapter>(&dbtBus));
+        interp.reset();
+        dbt.reset();
+    }
+
+    void load(const std::vector<std::uint32_t>& program) {
+        for (std::size_t i = 0; i < program.size(); ++i) {
+            writeWord(interpBus, static_cast<std::uint32_t>(i * 4), program[i]);
+            writeWord(dbtBus, static_cast<std::uint32_t>(i * 4), program[i]);
+        }
+        interp.setPc(0);
+        dbt.setPc(0);
+    }
+
+    void expectSameState() const {
+        EXPECT_EQ(dbt.state().regs, interp.state().regs);
+        EXPECT_EQ(dbt.getPc(), interp.getPc());
+        EXPECT_EQ(dbt.getFlags(), interp.getFlags());
+        EXPECT_EQ(dbt.isHalted(), interp.isHalted());
+    }
+
+    void expectSameMemory() {
+        for (std::uint32_t addr = 0; addr + 4 <= kRamSize; addr += 4) {
+            if (addr >= kMmioBase && addr < kMmioBase + kMmioSize) {
+                continue;
+            }
+            ASSERT_EQ(readWord(dbtBus, addr), readWord(interpBus, addr)) << "addr=0x" << std::hex << addr;
+        }
+        EXPECT_EQ(dbtDev->writes, interpDev->writes);
+        EXPECT_EQ(dbtDev->reads, interpDev->reads);
+    }
+};
+
+// Випадкова програма: ALU над R0..R6, пам'ять через базу R7 (лише область даних та MMIO),
+// переходи в межах програми, зрідка HALT і невідомі opcode.
+std::vector<std::uint32_t> randomProgram(std::mt19937& rng) {
+    constexpr std::size_t kWords = kCodeBytes / 4;
+    std::vector<std::uint32_t> program;
+    program.reserve(kWords);
+
+    // R7 = 1024 — база області даних.
+    program.push_back(encode(OPC_MOV, 7, 0, true, static_cast<std::int16_t>(kCodeBytes)));
+
+    auto pick = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+    while (program.size() < kWords) {
+        const auto rd = static_cast<std::uint8_t>(pick(0, 6));
+        const auto rs = static_cast<std::uint8_t>(pick(0, 6));
+        const auto index = static_cast<int>(program.size());
+        const int kind = pick(0, 99);
+
+        if (kind < 45) {
+            const std::uint8_t ops[] = {OPC_MOV, OPC_ADD, OPC_SUB};
+            const bool isImm = pick(0, 1) != 0;
+            program.push_back(encode(ops[pick(0, 2)], rd, rs, isImm, static_cast<std::int16_t>(pick(-8, 8))));
+        } else if (kind < 65) {
+            // Зсув від 0x400: здебільшого дані, іноді MMIO-вікно (0xC00 - 0x400 = 0x800),
+            // зрідка — вихід за кінець RAM (обидва ядра мають кинути виняток).
+            const int where = pick(0, 99);
+            int offset = pick(0, 3068);
+            if (where < 10) {
+                offset = 0x800 + pick(0, 12);
+            } else if (where == 10) {
+                offset = 3069 + pick(0, 40);
+            }
+            const std::uint8_t opcode = pick(0, 1) ? OPC_LOAD : OPC_STORE;
+            if (opcode == OPC_LOAD) {
+                program.push_back(encode(OPC_LOAD, rd, 7, true, static_cast<std::int16_t>(offset)));
+            } else {
+                program.push_back(encode(OPC_STORE, 7, rs, true, static_cast<std::int16_t>(offset)));
+            }
+        } else if (kind < 90) {
+            const std::uint8_t ops[] = {OPC_JMP, OPC_JZ, OPC_JNZ, OPC_JNZ};
+            const int target = pick(1, static_cast<int>(kWords) - 1);
+            program.push_back(encode(ops[pick(0, 3)], 0, 0, true, static_cast<std::int16_t>(target - index - 1)));
+        } else if (kind < 98) {
+            program.push_back(static_cast<std::uint32_t>(pick(0x09, 0xFE)) << 24);  // невідомий opcode
+        } else {
+            program.push_back(encode(OPC_HALT, 0, 0, false, 0));
+        }
+    }
+    return program;
+}
+
+class DbtCpuTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        if (!DbtCpu::hostSupported()) {
+            GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+        }
+    }
+};
+
+// Покроковий диференційний прогін: після кожного step() стан має збігатися з інтерпретатором.
+TEST_F(DbtCpuTest, LockstepMatchesInterpreterOnRandomPrograms) {
+    std::mt19937 rng(20240611u);
+
+    for (int seed = 0; seed < 40; ++seed) {
+        Pair pair;
+        pair.load(randomProgram(rng));
+
+        for (int i = 0; i < 3000 && !pair.interp.isHalted(); ++i) {
+            bool interpFault = false;
+            bool dbtFault = false;
+            try {
+                pair.interp.step();
+            } catch (const std::out_of_range&) {
+                interpFault = true;
+            }
+            try {
+                pair.dbt.step();
+            } catch (const std::out_of_range&) {
+                dbtFault = true;
+            }
+
+            EXPECT_EQ(dbtFault, interpFault);
+            EXPECT_EQ(pair.dbt.stepCount(), pair.interp.stepCount());
+            pair.expectSameState();
+            if (::testing::Test::HasFailure()) {
+                FAIL() << "diverged: program #" << seed << ", step " << i;
+            }
+            if (interpFault) {
+                break;  // PC стоїть на інструкції, що впала — далі те саме
+            }
+        }
+        pair.expectSameMemory();
+    }
+}
+
+// Пакетний прогін run(N) має дати той самий стан, що й N кроків інтерпретатора.
+TEST_F(DbtCpuTest, BatchedRunMatchesInterpreterOnRandomPrograms) {
+    std::mt19937 rng(777u);
+
+    for (int seed = 0; seed < 40; ++seed) {
+        Pair pair;
+        pair.load(randomProgram(rng));
+
+        bool interpFault = false;
+        std::uint64_t interpRetired = 0;
+        try {
+            for (; interpRetired < 20000; ++interpRetired) {
+                pair.interp.step();
+                if (pair.interp.isHalted()) {
+                    break;
+                }
+            }
+        } catch (const std::out_of_range&) {
+            interpFault = true;
+        }
+
+        bool dbtFault = false;
+        const RunResult dbtResult = pair.dbt.run(20000);
+        EXPECT_EQ(dbtResult.retired, interpRetired) << "program #" << seed;
+        // stepCount() переноситься в checkpoint, тож run() мусить рахувати його так само, як кроки інтерпретатора.
+        EXPECT_EQ(pair.dbt.stepCount(), pair.interp.stepCount()) << "program #" << seed;
+        if (dbtResult.reason == StopReason::Fault) {
+            EXPECT_THROW(pair.dbt.run(1), std::out_of_range) << "program #" << seed;
+            dbtFault = true;
+        }
+
+        EXPECT_EQ(dbtFault, interpFault) << "program #" << seed;
+        pair.expectSameState();
+        pair.expectSameMemory();
+    }
+}
+
+TEST_F(DbtCpuTest, LoopRunsFromChainedBlocks) {
+    Pair pair;
+    // R0 = 1000; loop: R1 += 3; R0 -= 1; JNZ loop; HALT
+    pair.load({
+        encode(OPC_MOV, 0, 0, true, 1000),
+        encode(OPC_ADD, 1, 0, true, 3),
+        encode(OPC_SUB, 0, 0, true, 1),
+        encode(OPC_JNZ, 0, 0, true, -3),
+        encode(OPC_HALT, 0, 0, false, 0),
+    });
+
+    const RunResult result = pair.dbt.run(1'000'000);
+
+    EXPECT_TRUE(pair.dbt.isHalted());
+    EXPECT_EQ(result.reason, StopReason::Halted);
+    EXPECT_EQ(result.retired, 1u + 3u * 1000u);
+    EXPECT_EQ(pair.dbt.getRegister(1), 3000u);
+    EXPECT_TRUE(pair.dbt.isFlagSet(FakeCpu::Flag::Zero));
+    EXPECT_LE(pair.dbt.translatedBlockCount(), 3u);
+}
+
+// Кеш коду W^X: після патча зшивання блок виконується з RX-сторінок, і в процесі немає RWX-відображень.
+TEST_F(DbtCpuTest, ChainPatchedBlocksRunFromWriteProtectedCache) {
+    const auto hasWritableExecutableMapping = [] {
+        std::ifstream maps("/proc/self/maps");
+        std::string address;
+        std::string perms;
+        std::string rest;
+        while (maps >> address >> perms && std::getline(maps, rest)) {
+            if (perms.find('w') != std::string::npos && perms.find('x') != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    Pair pair;
+    // R0 = 100; loop: R1 += 3; JMP +1 (повз HALT, новий блок); R0 -= 1; JNZ loop; HALT
+    const std::vector<std::uint32_t> program{
+        encode(OPC_MOV, 0, 0, true, 100),
+        encode(OPC_ADD, 1, 0, true, 3),
+        encode(OPC_JMP, 0, 0, true, 1),
+        encode(OPC_HALT, 0, 0, false, 0),
+        encode(OPC_SUB, 0, 0, true, 1),
+        encode(OPC_JNZ, 0, 0, true, -5),
+        encode(OPC_HALT, 0, 0, false, 0),
+    };
+    pair.load(program);
+
+    // Перший прохід транслює й зшиває блоки; далі вони біжать зшитими, малими порціями.
+    std::uint64_t retired = 0;
+    while (!pair.dbt.isHalted()) {
+        retired += pair.dbt.run(7).retired;
+        EXPECT_FALSE(hasWritableExecutableMapping());
+    }
+    while (!pair.interp.isHalted()) {
+        pair.interp.step();
+    }
+    EXPECT_EQ(retired, 1u + 4u * 100u);
+    EXPECT_EQ(pair.dbt.getRegister(1), 300u);
+    EXPECT_LE(pair.dbt.translatedBlockCount(), 4u);
+    pair.expectSameState();
+
+    // Після скидання кешу трансляція знову пише в той самий кеш.
+    pair.dbt.reset();
+    EXPECT_EQ(pair.dbt.run(1'000'000).reason, StopReason::Halted);
+    EXPECT_EQ(pair.dbt.getRegister(1), 300u);
+    EXPECT_FALSE(hasWritableExecutableMapping());
+}
+
+TEST_F(DbtCpuTest, SelfModifyingStoreRetranslatesCode) {
+    Pair pair;
+    // Та сама програма, що й у FakeCpuCoreTest.DecodeCacheIsFlushedBySelfModifyingStore.
+    pair.load({
+        encode(OPC_MOV, 0, 0, true, 7),
+        encode(OPC_STORE, 3, 2, true, 0),
+        encode(OPC_SUB, 1, 0, true, 1),
+        encode(OPC_JNZ, 0, 0, true, -4),
+        encode(OPC_HALT, 0, 0, false, 0),
+    });
+    pair.dbt.setRegister(1, 2);
+    pair.dbt.setRegister(2, encode(OPC_MOV, 0, 0, true, 42));
+    pair.dbt.setRegister(3, 0);
+
+    pair.dbt.run(100);
+
+    EXPECT_TRUE(pair.dbt.isHalted());
+    EXPECT_EQ(pair.dbt.getRegister(0), 42u);
+}
+
+TEST_F(DbtCpuTest, MmioAccessGoesThroughSlowPath) {
+    Pair pair;
+    // R7 = MMIO base; STORE R1 -> [R7 + 4]; LOAD R2 <- [R7 + 0]; HALT
+    pair.load({
+        encode(OPC_MOV, 7, 0, true, static_cast<std::int16_t>(kMmioBase)),
+        encode(OPC_MOV, 1, 0, true, 0x1234),
+        encode(OPC_STORE, 7, 1, true, 4),
+        encode(OPC_LOAD, 2, 7, true, 0),
+        encode(OPC_HALT, 0, 0, false, 0),
+    });
+
+    pair.dbt.run(100);
+
+    ASSERT_TRUE(pair.dbt.isHalted());
+    EXPECT_EQ(pair.dbtDev->writes, (std::vector<std::uint32_t>{0x0434, 0x0512, 0x0600, 0x0700}));
+    EXPECT_EQ(pair.dbtDev->reads, 4);
+    EXPECT_EQ(pair.dbt.getRegister(2), 0x43424140u);
+}
+
+TEST_F(DbtCpuTest, DirectStoresMarkDirtyPages) {
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+    MemoryBus bus(4 * kPage);
+    DbtCpu dbt;
+    dbt.setMemoryBus(std::make_shared<MemoryBusAdapter>(&bus));
+    dbt.reset();
+
+    // Код у сторінці 0; STORE у сторінку 3 і STORE через межу сторінок 1 і 2 — обидва швидким шляхом.
+    const std::vector<std::uint32_t> program = {
+        encode(OPC_MOV, 7, 0, true, static_cast<std::int16_t>(2 * kPage)),
+        encode(OPC_MOV, 1, 0, true, -1),  // R1 = 0xFFFFFFFF: змінюються всі чотири байти
+        encode(OPC_STORE, 7, 1, true, static_cast<std::int16_t>(kPage + 0x10)),
+        encode(OPC_STORE, 7, 1, true, -2),
+        encode(OPC_HALT, 0, 0, false, 0),
+    };
+    for (std::size_t i = 0; i < program.size(); ++i) {
+        writeWord(bus, static_cast<std::uint32_t>(i * 4), program[i]);
+    }
+    dbt.setPc(0);
+    bus.markBaseline();
+    const auto epoch = bus.openDirtyEpoch();
+
+    dbt.run(100);
+
+    ASSERT_TRUE(dbt.isHalted());
+    EXPECT_EQ(bus.dirtyPagesSince(epoch), (std::vector<std::uint32_t>{1, 2, 3}));
+    EXPECT_EQ(bus.restoreBaseline(), 3u);
+    EXPECT_EQ(readWord(bus, 3 * kPage + 0x10), 0u);
+    EXPECT_EQ(readWord(bus, 2 * kPage - 2), 0u);
+}
+
+TEST_F(DbtCpuTest, OutOfRangeLoadThrowsAndKeepsPc) {
+    Pair pair;
+    pair.load({
+        encode(OPC_MOV, 1, 0, true, 0x7FFF),
+        encode(OPC_ADD, 1, 1, false, 0),  // R1 = 0xFFFE — поза RAM
+        encode(OPC_LOAD, 0, 1, true, 0),
+        encode(OPC_HALT, 0, 0, false, 0),
+    });
+
+    // Дві інструкції до помилки виконано — run() повертає їх, виняток кидає наступний виклик.
+    const RunResult result = pair.dbt.run(100);
+    EXPECT_EQ(result.retired, 2u);
+    EXPECT_EQ(result.reason, StopReason::Fault);
+    EXPECT_EQ(pair.dbt.getPc(), 8u);
+    EXPECT_THROW(pair.dbt.run(100), std::out_of_range);
+    EXPECT_EQ(pair.dbt.getPc(), 8u);
+    EXPECT_FALSE(pair.dbt.isHalted());
+
+    // PC не рухається: step() знову впаде на тій самій інструкції.
+    EXPECT_THROW(pair.dbt.step(), std::out_of_range);
+    EXPECT_EQ(pair.dbt.getPc(), 8u);
+}
+
+}  // namespace
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "elsim/core/EventScheduler.hpp"
+#include "elsim/core/Logger.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/device/IDevice.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::EventScheduler;
+using elsim::core::LogLevel;
+using elsim::core::Simulator;
+using namespace elsim::test;
+
+namespace {
+
+// Плата з одним таймером і трьома пасивними пристроями (UART, GPIO, LED).
+constexpr BoardOptions kBoardOptions{.ramSize = 0x1000, .timer = true, .uart = true, .gpio = true, .led = true};
+
+}  // namespace
+
+TEST(EventScheduler, PopsEventsInCycleOrderAndStableForTies) {
+    EventScheduler scheduler;
+    EXPECT_TRUE(scheduler.empty());
+    EXPECT_EQ(scheduler.nextDeadline(), EventScheduler::kNever);
+
+    scheduler.schedule(1, 50);
+    scheduler.schedule(2, 10);
+    scheduler.schedule(3, 50);
+    scheduler.schedule(4, 30);
+    EXPECT_EQ(scheduler.nextDeadline(), 10u);
+
+    EventScheduler::Handle handle = 0;
+    EXPECT_FALSE(scheduler.popDue(9, handle));
+
+    std::vector<EventScheduler::Handle> order;
+    while (scheduler.popDue(50, handle)) {
+        order.push_back(handle);
+    }
+
+    EXPECT_EQ(order, (std::vector<EventScheduler::Handle>{2, 4, 1, 3}));
+    EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(EventScheduler, PassiveDevicesAreNotScheduled) {
+    auto& logger = elsim::core::Logger::instance();
+    const auto savedLevel = logger.level();
+    logger.set_level(LogLevel::Info);
+
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard("scheduler-test", "test-cpu", kBoardOptions));
+
+    // UART/GPIO/LED пасивні, а таймер рахує від SimClock і без Debug-логів теж не потребує подій.
+    EXPECT_NE(log.str().find("Timed devices: 0 of 4"), std::string::npos);
+
+    logger.set_level(savedLevel);
+}
+
+TEST(EventScheduler, TimerStaysCycleExactNextToPassiveDevices) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard("scheduler-test", "test-cpu", kBoardOptions));
+
+    // R0 = 300; loop: R0 -= 1; JNZ loop; HALT
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 300));
+    writeWord(bus, 4, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_JNZ, 0, 0, true, -2));
+    writeWord(bus, 12, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+
+    sim.start();
+
+    EXPECT_TRUE(sim.cpu()->isHalted());
+    EXPECT_EQ(sim.cycleCount(), 1u + 2u * 300u);
+    EXPECT_EQ(readWord(bus, kTimerBase), sim.cycleCount());
+}
+
+TEST(EventScheduler, MmioWriteReschedulesPassiveDevice) {
+    auto& logger = elsim::core::Logger::instance();
+    const auto savedLevel = logger.level();
+    logger.set_level(LogLevel::Info);
+
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard("scheduler-test", "test-cpu", kBoardOptions));
+    ASSERT_NE(log.str().find("Timed devices: 0 of 4"), std::string::npos);
+
+    // Debug-логи ввімкнено вже після завантаження: таймер дізнається про це лише з запису CONTROL.
+    logger.set_level(LogLevel::Debug);
+    if (!ELSIM_LOG_ENABLED(LogLevel::Debug)) {
+        logger.set_level(savedLevel);
+        GTEST_SKIP() << "debug logs are stripped from this build";
+    }
+    std::ostringstream output;
+    std::streambuf* savedBuf = std::clog.rdbuf(output.rdbuf());
+
+    // [timer + CONTROL] = 1; R0 = 1200; loop: R0 -= 1; JNZ loop; HALT
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 1, 0, true, 1));
+    writeWord(bus, 4, encode(OPC_MOV, 7, 0, true, static_cast<std::int16_t>(kTimerBase)));
+    writeWord(bus, 8, encode(OPC_STORE, 7, 1, true, 4));
+    writeWord(bus, 12, encode(OPC_MOV, 0, 0, true, 1200));
+    writeWord(bus, 16, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 20, encode(OPC_JNZ, 0, 0, true, -2));
+    writeWord(bus, 24, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+
+    sim.runFor(3000);  // runFor, на відміну від start(), розклад пристроїв не перебудовує
+
+    std::clog.rdbuf(savedBuf);
+    logger.set_level(savedLevel);
+
+    EXPECT_TRUE(sim.cpu()->isHalted());
+    EXPECT_NE(output.str().find("Tick = 1000"), std::string::npos);
+    EXPECT_NE(output.str().find("Tick = 2000"), std::string::npos);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/ExecutionProfile.hpp"
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/HostMemory.hpp"
+#include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/MemoryBusAdapter.hpp"
+#include "elsim/core/Simulator.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::BoardDescription;
+using elsim::core::ExecutionProfile;
+using elsim::core::FakeCpu;
+using elsim::core::MemoryBus;
+using elsim::core::MemoryBusAdapter;
+using elsim::core::RunResult;
+using elsim::core::Simulator;
+using elsim::core::StopReason;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "profile-test";
+constexpr BoardOptions kBoardOptions{.ramSize = 0x1000};
+
+// 0:  MOV R0, #3000
+// 4:  SUB R0, #1
+// 8:  JNZ -2        ; -> 4, 2999 разів виконується
+// 12: SUB R0, #1    ; R0 = 0xFFFFFFFF, Z = 0
+// 16: JZ 1          ; не виконується
+// 20: HALT
+void writeDelayLoop(MemoryBus& bus) {
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 3000));
+    writeWord(bus, 4, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_JNZ, 0, 0, true, -2));
+    writeWord(bus, 12, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 16, encode(OPC_JZ, 0, 0, true, 1));
+    writeWord(bus, 20, encode(OPC_HALT, 0, 0, false, 0));
+}
+
+struct CpuFixture {
+    MemoryBus bus{256};
+    FakeCpu cpu;
+
+    CpuFixture() {
+        writeDelayLoop(bus);
+        cpu.setMemoryBus(std::make_shared<MemoryBusAdapter>(&bus));
+        cpu.reset();
+    }
+};
+
+}  // namespace
+
+TEST(ExecutionProfile, CountsPerPcAndOpcode) {
+    ExecutionProfile profile(0x100, 0x40);
+    profile.record(0x104, OPC_SUB);
+    profile.record(0x104, OPC_SUB);
+    profile.record(0x108, OPC_JNZ);
+    profile.recordTaken(0x108, OPC_JNZ);
+    profile.record(0x108, OPC_JNZ);
+    profile.record(0x2000, OPC_HALT);  // поза діапазоном
+
+    EXPECT_EQ(profile.totalCount(), 5u);
+    EXPECT_EQ(profile.pcCount(0x104), 2u);
+    EXPECT_EQ(profile.pcCount(0x108), 2u);
+    EXPECT_EQ(profile.pcTakenCount(0x108), 1u);
+    EXPECT_EQ(profile.pcCount(0x2000), 0u);
+    EXPECT_EQ(profile.outsideCount(), 1u);
+    EXPECT_EQ(profile.opcodeCount(OPC_SUB), 2u);
+    EXPECT_EQ(profile.opcodeTakenCount(OPC_JNZ), 1u);
+
+    const auto top = profile.topPcs(1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].first, 0x104u);  // при рівних лічильниках — менша адреса
+
+    profile.clear();
+    EXPECT_EQ(profile.totalCount(), 0u);
+    EXPECT_TRUE(profile.topPcs(10).empty());
+
+    EXPECT_THROW(ExecutionProfile(0, 0), std::invalid_argument);
+}
+
+TEST(ExecutionProfile, FakeCpuRunCountsEveryIterationWithoutCollapsing) {
+    CpuFixture profiled;
+    CpuFixture reference;
+    ExecutionProfile profile(0, profiled.bus.ram().size());
+    profiled.cpu.setProfile(&profile);
+
+    const RunResult result = profiled.cpu.run(1'000'000);
+    reference.cpu.run(1'000'000);
+
+    EXPECT_EQ(result.reason, StopReason::Halted);
+    EXPECT_EQ(profiled.cpu.state(), reference.cpu.state());
+    EXPECT_EQ(profiled.cpu.stepCount(), reference.cpu.stepCount());
+    EXPECT_EQ(profiled.cpu.collapsedInstructionCount(), 0u);
+
+    EXPECT_EQ(profile.opcodeCount(OPC_MOV), 1u);
+    EXPECT_EQ(profile.opcodeCount(OPC_SUB), 3001u);
+    EXPECT_EQ(profile.opcodeCount(OPC_JNZ), 3000u);
+    EXPECT_EQ(profile.opcodeTakenCount(OPC_JNZ), 2999u);
+    EXPECT_EQ(profile.opcodeCount(OPC_JZ), 1u);
+    EXPECT_EQ(profile.opcodeTakenCount(OPC_JZ), 0u);
+    EXPECT_EQ(profile.opcodeCount(OPC_HALT), 1u);
+    EXPECT_EQ(profile.pcCount(4), 3000u);
+    EXPECT_EQ(profile.pcTakenCount(8), 2999u);
+    EXPECT_EQ(profile.totalCount(), result.retired + 1);  // HALT виконаний, але не входить у retired
+}
+
+TEST(ExecutionProfile, StepAndRunProduceTheSameProfile) {
+    CpuFixture stepped;
+    CpuFixture batched;
+    ExecutionProfile steppedProfile(0, 256);
+    ExecutionProfile batchedProfile(0, 256);
+    stepped.cpu.setProfile(&steppedProfile);
+    batched.cpu.setProfile(&batchedProfile);
+
+    while (!stepped.cpu.isHalted()) {
+        stepped.cpu.step();
+    }
+    while (batched.cpu.run(777).reason != StopReason::Halted) {
+    }
+
+    for (std::uint32_t pc = 0; pc < 24; pc += 4) {
+        EXPECT_EQ(steppedProfile.pcCount(pc), batchedProfile.pcCount(pc)) << "pc " << pc;
+        EXPECT_EQ(steppedProfile.pcTakenCount(pc), batchedProfile.pcTakenCount(pc)) << "pc " << pc;
+    }
+
+    // Після відключення профіль більше не змінюється.
+    batched.cpu.setProfile(nullptr);
+    batched.cpu.setPc(0);
+    batched.cpu.run(100);
+    EXPECT_EQ(batchedProfile.totalCount(), steppedProfile.totalCount());
+}
+
+TEST(ExecutionProfile, SimulatorReportsHotLoop) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    writeDelayLoop(*sim.memoryBus());
+    sim.cpu()->setPc(0);
+
+    sim.startProfile();
+    EXPECT_TRUE(sim.isProfiling());
+    sim.start();
+
+    std::ostringstream report;
+    sim.printProfile(report, 3);
+    const auto profile = sim.stopProfile();
+    EXPECT_FALSE(sim.isProfiling());
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->pcCount(4), 3000u);
+    EXPECT_FALSE(sim.stopProfile().has_value());
+
+    const std::string text = report.str();
+    EXPECT_NE(text.find("0x00000004          3000"), std::string::npos) << text;
+    EXPECT_NE(text.find("SUB R0, #1"), std::string::npos) << text;
+    EXPECT_NE(text.find("JNZ   taken 2999, not taken 1"), std::string::npos) << text;
+    EXPECT_NE(text.find("0x00000010  taken 0, not taken 1"), std::string::npos) << text;  // JZ за адресою 16
+}
+
+TEST(ExecutionProfile, LargeRamProfileCommitsOnlyTouchedCounters) {
+    constexpr std::uint64_t kDeclared = 512ULL << 20;
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", BoardOptions{.ramSize = kDeclared}));
+    writeDelayLoop(*sim.memoryBus());
+    sim.cpu()->setPc(0);
+
+    sim.startProfile();
+    sim.start();
+    const auto profile = sim.stopProfile();
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->pcCount(4), 3000u);
+
+    if (elsim::core::HostMemory(1).isSparse()) {
+        // Два масиви по 8 байтів на слово RAM — 2 GiB задекларовано, зайнято кілька сторінок.
+        EXPECT_LT(profile->residentBytes(), 1u << 20);
+        EXPECT_LT(sim.memoryBus()->residentBytes(), 4u << 20);
+    }
+}
+
+TEST(ExecutionProfile, DbtCpuRefusesProfiling) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu-dbt", kBoardOptions));
+
+    EXPECT_THROW(sim.startProfile(), std::runtime_error);
+    EXPECT_FALSE(sim.isProfiling());
+}
@@ -2,14 +2,21 @@
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 
 #include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/IMemoryMappedDevice.hpp"
 #include "elsim/core/MemoryBus.hpp"
 #include "elsim/core/MemoryBusAdapter.hpp"
 
 using elsim::core::FakeCpu;
+using elsim::core::IMemoryBus;
+using elsim::core::IMemoryMappedDevice;
 using elsim::core::MemoryBus;
 using elsim::core::MemoryBusAdapter;
+using elsim::core::MemoryBusFakeCpu;
+using elsim::core::RunResult;
+using elsim::core::StopReason;
 
 namespace {
 
@@ -300,4 +307,367 @@ TEST_F(FakeCpuCoreTest, StoreWritesWordToMemoryAndKeepsFlags) {
     EXPECT_TRUE(cpu.isFlagSet(FakeCpu::Flag::Zero));
 }
 
+// Декодер: поля розібрані, imm розширений зі знаком, ціль переходу обчислена
+TEST(FakeCpuDecodeTest, DecodeExtractsFieldsAndBranchTarget) {
+    const auto mov = FakeCpu::decode(ENCODE_I(OPC_MOV, 3, 5, -2), 0x100);
+    EXPECT_EQ(mov.opcode, OPC_MOV);
+    EXPECT_EQ(mov.rd, 3u);
+    EXPECT_EQ(mov.rs, 5u);
+    EXPECT_TRUE(mov.isImm);
+    EXPECT_EQ(mov.imm, static_cast<std::uint32_t>(-2));
+
+    // JNZ -3 за адресою 0x20 → 0x20 + 4 - 12 = 0x18
+    const auto jnz = FakeCpu::decode(JNZ_ENC(-3), 0x20);
+    EXPECT_EQ(jnz.opcode, OPC_JNZ);
+    EXPECT_EQ(jnz.target, 0x18u);
+}
+
+// Невеликий цикл: R0 = 5; do { R1 += 2; R0 -= 1; } while (R0 != 0); HALT
+void writeCountdownProgram(MemoryBus& bus) {
+    write_word32(bus, 0, MOV_IMM(0, 5));
+    write_word32(bus, 4, ADD_IMM(1, 2));
+    write_word32(bus, 8, SUB_IMM(0, 1));
+    write_word32(bus, 12, JNZ_ENC(-3));
+    write_word32(bus, 16, HALT_ENC());
+}
+
+std::size_t runUntilHalt(FakeCpu& cpu, std::size_t maxSteps) {
+    std::size_t steps = 0;
+    while (!cpu.isHalted() && steps < maxSteps) {
+        cpu.step();
+        ++steps;
+    }
+    return steps;
+}
+
+TEST_F(FakeCpuCoreTest, DecodeCacheMatchesUncachedExecution) {
+    writeCountdownProgram(bus);
+
+    cpu.setDecodeCacheEnabled(false);
+    const std::size_t uncachedSteps = runUntilHalt(cpu, 1000);
+    const auto uncachedState = cpu.state();
+    EXPECT_EQ(cpu.cachedBlockCount(), 0u);
+
+    cpu.reset();
+    cpu.setDecodeCacheEnabled(true);
+    const std::size_t cachedSteps = runUntilHalt(cpu, 1000);
+
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(cachedSteps, uncachedSteps);
+    EXPECT_EQ(cpu.state().regs, uncachedState.regs);
+    EXPECT_EQ(cpu.getPc(), uncachedState.pc);
+    EXPECT_EQ(cpu.getFlags(), uncachedState.flags);
+    EXPECT_EQ(cpu.getRegister(1), 10u);
+    EXPECT_GT(cpu.cachedBlockCount(), 0u);
+}
+
+TEST_F(FakeCpuCoreTest, DecodeCacheIsFlushedBySelfModifyingStore) {
+    // 0:  MOV R0, #7            ; STORE нижче перезапише цю інструкцію на MOV R0, #42
+    // 4:  STORE R2, [R3 + 0]
+    // 8:  SUB R1, #1
+    // 12: JNZ -4                ; назад на 0 — блок, що вже є в кеші
+    // 16: HALT
+    write_word32(bus, 0, MOV_IMM(0, 7));
+    write_word32(bus, 4, STORE_ENC(/*rs=*/2, /*rd=*/3, 0));
+    write_word32(bus, 8, SUB_IMM(1, 1));
+    write_word32(bus, 12, JNZ_ENC(-4));
+    write_word32(bus, 16, HALT_ENC());
+
+    cpu.setRegister(1, 2);
+    cpu.setRegister(2, MOV_IMM(0, 42));
+    cpu.setRegister(3, 0);
+
+    runUntilHalt(cpu, 100);
+
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(cpu.getRegister(0), 42u);
+}
+
+TEST_F(FakeCpuCoreTest, ThreadedDispatchMatchesSwitch) {
+    // Цикл з пам'яттю та невідомим opcode (має поводитись як NOP в обох ядрах):
+    // 0:  MOV R0, #4
+    // 4:  ADD R1, #3
+    // 8:  STORE R1, [R2 + 64]
+    // 12: LOAD R3, [R2 + 64]
+    // 16: <unknown 0x42>
+    // 20: SUB R0, #1
+    // 24: JNZ -6
+    // 28: HALT
+    write_word32(bus, 0, MOV_IMM(0, 4));
+    write_word32(bus, 4, ADD_IMM(1, 3));
+    write_word32(bus, 8, STORE_ENC(/*rs=*/1, /*rd=*/2, 64));
+    write_word32(bus, 12, LOAD_ENC(/*rd=*/3, /*rs=*/2, 64));
+    write_word32(bus, 16, 0x42000000u);
+    write_word32(bus, 20, SUB_IMM(0, 1));
+    write_word32(bus, 24, JNZ_ENC(-6));
+    write_word32(bus, 28, HALT_ENC());
+
+    ASSERT_EQ(cpu.dispatchMode(), FakeCpu::DispatchMode::Switch);
+    const std::size_t switchSteps = runUntilHalt(cpu, 1000);
+    const auto switchState = cpu.state();
+
+    cpu.reset();
+    cpu.setDispatchMode(FakeCpu::DispatchMode::Threaded);
+    const std::size_t threadedSteps = runUntilHalt(cpu, 1000);
+
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(threadedSteps, switchSteps);
+    EXPECT_EQ(cpu.state().regs, switchState.regs);
+    EXPECT_EQ(cpu.getPc(), switchState.pc);
+    EXPECT_EQ(cpu.getFlags(), switchState.flags);
+    EXPECT_EQ(cpu.getRegister(3), 12u);
+}
+
+TEST_F(FakeCpuCoreTest, ThreadedRunMatchesSwitchRun) {
+    // run() обирає ядро раз на пакет — пакети в обох режимах дають той самий стан.
+    writeCountdownProgram(bus);
+    const RunResult switchRun = cpu.run(1000);
+    const auto switchState = cpu.state();
+    const std::size_t switchSteps = cpu.stepCount();
+
+    cpu.reset();
+    cpu.setDispatchMode(FakeCpu::DispatchMode::Threaded);
+    const RunResult threadedRun = cpu.run(1000);
+
+    EXPECT_EQ(threadedRun.retired, switchRun.retired);
+    EXPECT_EQ(threadedRun.reason, StopReason::Halted);
+    EXPECT_EQ(cpu.state(), switchState);
+    EXPECT_EQ(cpu.stepCount(), switchSteps);
+}
+
+TEST_F(FakeCpuCoreTest, RunStopsOnBudgetAndHalt) {
+    writeCountdownProgram(bus);
+
+    // 1 + 3 * 5 інструкцій до HALT (сам HALT не рахується).
+    const RunResult first = cpu.run(10);
+    EXPECT_EQ(first.retired, 10u);
+    EXPECT_EQ(first.reason, StopReason::BudgetExhausted);
+    EXPECT_FALSE(cpu.isHalted());
+
+    const RunResult second = cpu.run(1000);
+    EXPECT_EQ(second.retired, 6u);
+    EXPECT_EQ(second.reason, StopReason::Halted);
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(cpu.getRegister(1), 10u);
+
+    const RunResult third = cpu.run(1000);
+    EXPECT_EQ(third.retired, 0u);
+    EXPECT_EQ(third.reason, StopReason::Halted);
+}
+
+TEST_F(FakeCpuCoreTest, RunDefersFaultToNextCall) {
+    // 0: MOV R1, #0x7FFF
+    // 4: ADD R1, R1          ; R1 = 0xFFFE — поза 256 байт RAM
+    // 8: LOAD R0, [R1 + 0]
+    write_word32(bus, 0, MOV_IMM(1, 0x7FFF));
+    write_word32(bus, 4, ADD_REG(1, 1));
+    write_word32(bus, 8, LOAD_ENC(0, 1, 0));
+    write_word32(bus, 12, HALT_ENC());
+
+    const RunResult result = cpu.run(100);
+    EXPECT_EQ(result.retired, 2u);
+    EXPECT_EQ(result.reason, StopReason::Fault);
+    EXPECT_EQ(cpu.getPc(), 8u);
+
+    EXPECT_THROW(cpu.run(100), std::out_of_range);
+    EXPECT_EQ(cpu.getPc(), 8u);
+
+    // Без відкладеної помилки виняток летить одразу, як і з step().
+    EXPECT_THROW(cpu.run(100), std::out_of_range);
+    EXPECT_FALSE(cpu.isHalted());
+}
+
+// MMIO-"ПЗП" з одним словом: інструкцію з нього CPU має читати через шину.
+class WordRomDevice final : public IMemoryMappedDevice {
+   public:
+    explicit WordRomDevice(std::uint32_t word) : word_(word) {}
+
+    std::uint8_t read8(std::uint32_t offset) override {
+        ++reads;
+        return static_cast<std::uint8_t>(word_ >> (8u * (offset & 3u)));
+    }
+    void write8(std::uint32_t, std::uint8_t) override {}
+
+    int reads = 0;
+
+   private:
+    std::uint32_t word_;
+};
+
+TEST_F(FakeCpuCoreTest, FetchFallsBackToBusOutsideRamWindow) {
+    // 0: MOV R1, #5 ; 4: JMP до 0x80 (MMIO) ; 0x80: HALT з девайса
+    write_word32(bus, 0, MOV_IMM(1, 5));
+    write_word32(bus, 4, JMP_ENC((0x80 - 8) / 4));
+
+    auto rom = std::make_shared<WordRomDevice>(HALT_ENC());
+    bus.mapDevice(0x80, 4, rom);
+    cpu.invalidateDecodeCache();  // карта пам'яті змінилась
+
+    runUntilHalt(cpu, 10);
+
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(cpu.getRegister(1), 5u);
+    EXPECT_EQ(cpu.getPc(), 0x80u);
+    EXPECT_EQ(rom->reads, 4);  // fetch з MMIO пройшов через шину (read32 -> 4 x read8)
+}
+
+TEST(FakeCpuNoBusTest, StepAndRunWithoutBusDoNothing) {
+    FakeCpu cpu;
+    cpu.reset();
+    EXPECT_NO_THROW(cpu.step());
+    EXPECT_NO_THROW(cpu.run(3));
+    EXPECT_EQ(cpu.getPc(), 0u);
+    EXPECT_FALSE(cpu.isHalted());
+}
+
+TEST_F(FakeCpuCoreTest, FetchSeesCodeChangedThroughBusAfterInvalidate) {
+    write_word32(bus, 0, MOV_IMM(1, 1));
+    write_word32(bus, 4, HALT_ENC());
+    runUntilHalt(cpu, 10);
+    EXPECT_EQ(cpu.getRegister(1), 1u);
+
+    // Код змінено напряму через MemoryBus, в обхід CPU.
+    write_word32(bus, 0, MOV_IMM(1, 2));
+    cpu.reset();
+    runUntilHalt(cpu, 10);
+    EXPECT_EQ(cpu.getRegister(1), 2u);
+}
+
+// 0:  MOV R0, #30000
+// 4:  NOP
+// 8:  SUB R0, #1
+// 12: NOP
+// 16: JNZ -4             ; -> 4
+// 20: ADD R1, #1
+// 24: HALT
+void writeDelayLoopProgram(MemoryBus& bus) {
+    write_word32(bus, 0, MOV_IMM(0, 30000));
+    write_word32(bus, 4, 0x00000000u);
+    write_word32(bus, 8, SUB_IMM(0, 1));
+    write_word32(bus, 12, 0x00000000u);
+    write_word32(bus, 16, JNZ_ENC(-4));
+    write_word32(bus, 20, ADD_IMM(1, 1));
+    write_word32(bus, 24, HALT_ENC());
+}
+
+TEST_F(FakeCpuCoreTest, CountedDelayLoopIsCollapsedExactly) {
+    writeDelayLoopProgram(bus);
+
+    MemoryBus referenceBus(256);
+    writeDelayLoopProgram(referenceBus);
+    FakeCpu reference;
+    reference.setMemoryBus(std::make_shared<MemoryBusAdapter>(&referenceBus));
+    reference.reset();
+    runUntilHalt(reference, 1'000'000);  // step() поза run() циклів не згортає
+
+    const RunResult result = cpu.run(1'000'000);
+
+    EXPECT_EQ(result.reason, StopReason::Halted);
+    EXPECT_EQ(result.retired, 1u + 4u * 30000u + 1u);
+    EXPECT_EQ(cpu.state(), reference.state());
+    EXPECT_EQ(cpu.stepCount(), reference.stepCount());
+    EXPECT_EQ(cpu.getRegister(1), 1u);
+    EXPECT_GT(cpu.collapsedInstructionCount(), 100'000u);
+    EXPECT_EQ(reference.collapsedInstructionCount(), 0u);
+}
+
+TEST_F(FakeCpuCoreTest, CountedDelayLoopRespectsRunBudget) {
+    writeDelayLoopProgram(bus);
+
+    MemoryBus referenceBus(256);
+    writeDelayLoopProgram(referenceBus);
+    FakeCpu reference;
+    reference.setMemoryBus(std::make_shared<MemoryBusAdapter>(&referenceBus));
+    reference.reset();
+
+    // Бюджет не кратний довжині ітерації: межі run() припадають на середину тіла циклу.
+    constexpr std::uint64_t kChunk = 777;
+    while (!cpu.isHalted()) {
+        const RunResult result = cpu.run(kChunk);
+        for (std::uint64_t i = 0; i < result.retired; ++i) {
+            reference.step();
+        }
+        ASSERT_EQ(cpu.state(), reference.state());
+        if (result.reason == StopReason::BudgetExhausted) {
+            ASSERT_EQ(result.retired, kChunk);
+        }
+    }
+    EXPECT_GT(cpu.collapsedInstructionCount(), 0u);
+}
+
+TEST_F(FakeCpuCoreTest, LoopWithOtherSideEffectsIsNotCollapsed) {
+    writeCountdownProgram(bus);  // у тілі ще й ADD R1, #2
+
+    const RunResult result = cpu.run(1000);
+
+    EXPECT_EQ(result.reason, StopReason::Halted);
+    EXPECT_EQ(cpu.getRegister(1), 10u);
+    EXPECT_EQ(cpu.collapsedInstructionCount(), 0u);
+}
+
+// 0:  MOV R2, #0x40
+// 4:  MOV R1, #7
+// 8:  STORE R1, [R2 + 0]   ; loop
+// 12: LOAD R3, [R2 + 0]
+// 16: ADD R3, #1
+// 20: STORE R3, [R2 + 4]
+// 24: SUB R1, #1
+// 28: JNZ -6               ; -> 8
+// 32: JMP до 0x80          ; HALT з MMIO-девайса
+void writeLoadStoreProgram(MemoryBus& bus) {
+    write_word32(bus, 0, MOV_IMM(2, 0x40));
+    write_word32(bus, 4, MOV_IMM(1, 7));
+    write_word32(bus, 8, STORE_ENC(1, 2, 0));
+    write_word32(bus, 12, LOAD_ENC(3, 2, 0));
+    write_word32(bus, 16, ADD_IMM(3, 1));
+    write_word32(bus, 20, STORE_ENC(3, 2, 4));
+    write_word32(bus, 24, SUB_IMM(1, 1));
+    write_word32(bus, 28, JNZ_ENC(-6));
+    write_word32(bus, 32, JMP_ENC((0x80 - 36) / 4));
+    bus.mapDevice(0x80, 4, std::make_shared<WordRomDevice>(HALT_ENC()));
+}
+
+TEST(MemoryBusFakeCpuTest, MatchesVirtualBusCpu) {
+    MemoryBus referenceBus(256);
+    writeLoadStoreProgram(referenceBus);
+    FakeCpu reference;
+    reference.setMemoryBus(std::make_shared<MemoryBusAdapter>(&referenceBus));
+    reference.reset();
+
+    MemoryBus bus(256);
+    writeLoadStoreProgram(bus);
+    MemoryBusFakeCpu cpu;
+    cpu.setMemoryBus(std::make_shared<MemoryBusAdapter>(&bus));
+    cpu.reset();
+
+    const RunResult expected = reference.run(1000);
+    const RunResult result = cpu.run(1000);
+
+    EXPECT_EQ(result.reason, StopReason::Halted);
+    EXPECT_EQ(result.retired, expected.retired);
+    EXPECT_EQ(cpu.state(), reference.state());
+    EXPECT_EQ(cpu.getPc(), 0x80u);
+    EXPECT_EQ(read_word32(bus, 0x44), 2u);  // остання ітерація: R1 = 1, R3 = 1 + 1
+    for (std::uint32_t addr = 0; addr < 0x80; addr += 4) {
+        EXPECT_EQ(read_word32(bus, addr), read_word32(referenceBus, addr)) << "addr=0x" << std::hex << addr;
+    }
+}
+
+// IMemoryBus, за яким немає MemoryBus.
+class StubBus : public IMemoryBus {
+   public:
+    std::uint8_t read8(std::uint32_t) override { return 0; }
+    void write8(std::uint32_t, std::uint8_t) override {}
+};
+
+TEST(MemoryBusFakeCpuTest, RequiresMemoryBusAdapter) {
+    MemoryBusFakeCpu cpu;
+    EXPECT_THROW(cpu.setMemoryBus(std::make_shared<StubBus>()), std::invalid_argument);
+    EXPECT_THROW(cpu.setMemoryBus(std::make_shared<MemoryBusAdapter>(nullptr)), std::invalid_argument);
+    EXPECT_NO_THROW(cpu.setMemoryBus(nullptr));
+
+    FakeCpu generic;
+    EXPECT_NO_THROW(generic.setMemoryBus(std::make_shared<StubBus>()));
+}
+
 }  // namespace
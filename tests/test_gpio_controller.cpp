@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "elsim/core/GpioController.hpp"
 using elsim::core::GpioController;
@@ -44,6 +46,23 @@ TEST(GpioController, InjectInputAndReadInput_Works) {
     EXPECT_EQ(gpio.getInputMask(), 0u);
 }
 
+TEST(GpioController, InputObserver_SeesEveryInjection) {
+    elsim::core::GpioController gpio(/*pinCount=*/8);
+
+    std::vector<std::pair<std::size_t, bool>> seen;
+    gpio.setInputObserver([&](std::size_t pin, bool level) { seen.emplace_back(pin, level); });
+    gpio.injectInput(/*pin=*/5, /*level=*/true);
+    gpio.injectInput(/*pin=*/5, /*level=*/true);
+    gpio.injectInput(/*pin=*/1, /*level=*/false);
+
+    const std::vector<std::pair<std::size_t, bool>> expected{{5, true}, {5, true}, {1, false}};
+    EXPECT_EQ(seen, expected);
+
+    gpio.setInputObserver(nullptr);
+    gpio.injectInput(/*pin=*/2, /*level=*/true);
+    EXPECT_EQ(seen.size(), 3u);
+}
+
 TEST(GpioController, InvalidPin_ThrowsOutOfRange) {
     elsim::core::GpioController gpio(/*pinCount=*/8);
 
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/InputLog.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/device/VirtualButtonDevice.hpp"
+
+#include "test_support.hpp"
+
+namespace fs = std::filesystem;
+
+using elsim::core::BoardDescription;
+using elsim::core::InputEvent;
+using elsim::core::InputKind;
+using elsim::core::InputLog;
+using elsim::core::Simulator;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "replay-test";
+constexpr BoardOptions kBoardOptions{.gpio = true, .button = true};
+
+// Інтегратор входу: кожну ітерацію додає DATA_IN до R2 і пише суму в [0x100].
+// Результат залежить від того, на якому саме циклі змінювався рівень піна.
+//   R1 = [R0 + GPIO.DATA_IN]; R2 += R1; [R0 + 0x100] = R2; JMP -4
+void loadIntegrator(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_LOAD, 1, 0, false, static_cast<std::int16_t>(kGpioBase + kGpioDataIn)));
+    writeWord(bus, 4, encode(OPC_ADD, 2, 1, false, 0));
+    writeWord(bus, 8, encode(OPC_STORE, 0, 2, false, 0x100));
+    writeWord(bus, 12, encode(OPC_JMP, 0, 0, true, -4));
+    sim.cpu()->setPc(0);
+}
+
+// Сесія "з людиною": натискання між прогонами на довільних циклах.
+InputLog recordSession(Simulator& sim) {
+    auto* button = sim.buttonDevices().at(0);
+    sim.startRecording();
+    sim.runFor(137);
+    button->press();
+    sim.runFor(1001);
+    button->release();
+    sim.runFor(59);
+    button->press();
+    sim.runFor(3);
+    button->release();
+    sim.runFor(500);
+    return sim.stopRecording();
+}
+
+}  // namespace
+
+TEST(InputLog, SerializationRoundTripIsCompact) {
+    InputLog log("board");
+    log.append(InputEvent{10, InputKind::GpioLevel, 2, 1});
+    log.append(InputEvent{10, InputKind::GpioLevel, 3, 0});
+    log.append(InputEvent{1'000'000, InputKind::GpioLevel, 2, 0});
+    EXPECT_THROW(log.append(InputEvent{5, InputKind::GpioLevel, 2, 1}), std::invalid_argument);
+
+    const auto bytes = log.serialize();
+    // Заголовок 8 + рядок 4+5 + кількість 4; події: дельта 1-3 байти, kind, channel і value по байту.
+    EXPECT_EQ(bytes.size(), 21u + (1 + 3) + (1 + 3) + (3 + 3));
+
+    const InputLog restored = InputLog::deserialize(bytes);
+    EXPECT_EQ(restored.boardName(), "board");
+    EXPECT_EQ(restored.events(), log.events());
+}
+
+TEST(InputLog, RejectsForeignAndTruncatedData) {
+    InputLog log("board");
+    log.append(InputEvent{42, InputKind::GpioLevel, 1, 1});
+    auto bytes = log.serialize();
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    EXPECT_THROW(InputLog::deserialize(truncated), std::runtime_error);
+
+    auto trailing = bytes;
+    trailing.push_back(0);
+    EXPECT_THROW(InputLog::deserialize(trailing), std::runtime_error);
+
+    auto badKind = bytes;
+    badKind[bytes.size() - 3] = 0x7F;
+    EXPECT_THROW(InputLog::deserialize(badKind), std::runtime_error);
+
+    bytes[0] ^= 0xFF;
+    EXPECT_THROW(InputLog::deserialize(bytes), std::runtime_error);
+
+    EXPECT_THROW(InputLog::loadFromFile((fs::temp_directory_path() / "elsim_no_such_log.elrp").string()),
+                 std::runtime_error);
+}
+
+TEST(InputReplay, RecordsInjectedInputsWithExactCycles) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(sim);
+
+    const InputLog inputs = recordSession(sim);
+    EXPECT_FALSE(sim.isRecording());
+    EXPECT_EQ(inputs.boardName(), "replay-test");
+
+    const std::vector<InputEvent> expected{
+        {137, InputKind::GpioLevel, kButtonPin, 1},
+        {1138, InputKind::GpioLevel, kButtonPin, 0},
+        {1197, InputKind::GpioLevel, kButtonPin, 1},
+        {1200, InputKind::GpioLevel, kButtonPin, 0},
+    };
+    EXPECT_EQ(inputs.events(), expected);
+}
+
+TEST(InputReplay, ReplayReproducesRecordedSessionInOneRun) {
+    std::ostringstream logA;
+    Simulator live(logA);
+    live.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(live);
+    const InputLog inputs = recordSession(live);
+    const std::uint32_t expected = readWord(*live.memoryBus(), 0x100);
+    ASSERT_NE(expected, 0u);
+
+    // Увесь сеанс — одним start() з великим квантом: пакети CPU мусять різатись на подіях.
+    const std::string path = (fs::temp_directory_path() / "elsim_replay_session.elrp").string();
+    inputs.saveToFile(path);
+
+    std::ostringstream logB;
+    Simulator replay(logB);
+    replay.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(replay);
+    replay.setQuantum(100'000);
+    replay.startReplay(InputLog::loadFromFile(path));
+    EXPECT_TRUE(replay.isReplaying());
+
+    replay.start(live.cycleCount());
+    EXPECT_FALSE(replay.isReplaying());
+    EXPECT_EQ(replay.cycleCount(), live.cycleCount());
+    EXPECT_EQ(readWord(*replay.memoryBus(), 0x100), expected);
+    EXPECT_EQ(replay.saveMachineState(), live.saveMachineState());
+
+    fs::remove(path);
+}
+
+TEST(InputReplay, CheckpointRestoreRepositionsReplay) {
+    std::ostringstream logA;
+    Simulator live(logA);
+    live.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(live);
+    const InputLog inputs = recordSession(live);
+
+    std::ostringstream logB;
+    Simulator replay(logB);
+    replay.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(replay);
+    replay.startReplay(inputs);
+    replay.runFor(1150);
+    const auto middle = replay.saveMachineState();
+    const auto ram = replay.memoryBus()->ram();
+    const std::vector<std::uint8_t> middleRam(ram.begin(), ram.end());
+
+    replay.runFor(live.cycleCount() - 1150);
+    const auto end = replay.saveMachineState();
+
+    // Назад у середину сеансу: події після неї подаються знову, результат той самий.
+    replay.loadMachineState(middle);
+    std::copy(middleRam.begin(), middleRam.end(), replay.memoryBus()->ram().begin());
+    EXPECT_TRUE(replay.isReplaying());
+    replay.runFor(live.cycleCount() - 1150);
+    EXPECT_EQ(replay.saveMachineState(), end);
+    EXPECT_EQ(readWord(*replay.memoryBus(), 0x100), readWord(*live.memoryBus(), 0x100));
+}
+
+TEST(InputReplay, StartReplayRejectsForeignOrPastLogs) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadIntegrator(sim);
+
+    InputLog foreign("other-board");
+    EXPECT_THROW(sim.startReplay(foreign), std::runtime_error);
+
+    InputLog badPin("replay-test");
+    badPin.append(InputEvent{10, InputKind::GpioLevel, 63, 1});
+    EXPECT_THROW(sim.startReplay(badPin), std::runtime_error);
+
+    sim.runFor(100);
+    InputLog past("replay-test");
+    past.append(InputEvent{50, InputKind::GpioLevel, kButtonPin, 1});
+    EXPECT_THROW(sim.startReplay(past), std::runtime_error);
+    EXPECT_FALSE(sim.isReplaying());
+}
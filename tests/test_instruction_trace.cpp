@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/InstructionTrace.hpp"
+#include "elsim/core/Simulator.hpp"
+
+#include "test_support.hpp"
+
+namespace fs = std::filesystem;
+
+using elsim::core::BoardDescription;
+using elsim::core::Simulator;
+using elsim::core::TraceMemAccess;
+using elsim::core::TraceReader;
+using elsim::core::TraceRecord;
+using elsim::core::TraceWriter;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "trace-test";
+constexpr BoardOptions kBoardOptions{};
+
+// Тимчасовий файл трасування, що прибирається після тесту.
+class TempTrace {
+   public:
+    explicit TempTrace(const std::string& name)
+        : path_(fs::temp_directory_path() / ("elsim-trace-" + name + ".eltrace")) {}
+    ~TempTrace() {
+        std::error_code ec;
+        fs::remove(path_, ec);
+    }
+
+    [[nodiscard]] std::string str() const { return path_.string(); }
+
+   private:
+    fs::path path_;
+};
+
+TraceRecord syntheticRecord(std::uint64_t i) {
+    TraceRecord record;
+    record.cycle = i * 3;
+    record.pc = static_cast<std::uint32_t>(i * 4);
+    record.instruction = static_cast<std::uint32_t>(i * 2654435761u);
+    if (i % 5 == 0) {
+        record.memAccess = TraceMemAccess::Write;
+        record.memAddress = static_cast<std::uint32_t>(i);
+        record.memValue = static_cast<std::uint32_t>(~i);
+    }
+    return record;
+}
+
+}  // namespace
+
+TEST(InstructionTrace, WriterAndReaderRoundTripThroughWrappingRing) {
+    TempTrace file("roundtrip");
+    constexpr std::uint64_t kRecords = 100'000;  // у багато разів більше за кільце: обгортання і очікування місця
+
+    TraceWriter writer(file.str(), TraceWriter::kFlushBlockRecords);
+    for (std::uint64_t i = 0; i < kRecords; ++i) {
+        writer.push(syntheticRecord(i));
+    }
+    writer.close();
+    EXPECT_EQ(writer.recordCount(), kRecords);
+    EXPECT_EQ(fs::file_size(file.str()), 16 + kRecords * sizeof(TraceRecord));
+
+    TraceReader reader(file.str());
+    TraceRecord record;
+    std::uint64_t count = 0;
+    while (reader.next(record)) {
+        ASSERT_EQ(record, syntheticRecord(count)) << "record " << count;
+        ++count;
+    }
+    EXPECT_EQ(count, kRecords);
+}
+
+TEST(InstructionTrace, RejectsInvalidRingSize) {
+    TempTrace file("ring");
+    EXPECT_THROW(TraceWriter(file.str(), TraceWriter::kFlushBlockRecords / 2), std::invalid_argument);
+    EXPECT_THROW(TraceWriter(file.str(), TraceWriter::kFlushBlockRecords * 3), std::invalid_argument);
+}
+
+TEST(InstructionTrace, ReaderRejectsForeignAndTruncatedFiles) {
+    TempTrace file("corrupt");
+    {
+        std::ofstream out(file.str(), std::ios::binary);
+        out << "definitely not a trace file";
+    }
+    EXPECT_THROW(TraceReader{file.str()}, std::runtime_error);
+
+    {
+        TraceWriter writer(file.str());
+        writer.push(syntheticRecord(1));
+        writer.push(syntheticRecord(2));
+        writer.close();
+    }
+    fs::resize_file(file.str(), fs::file_size(file.str()) - 5);
+
+    TraceReader reader(file.str());
+    TraceRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record, syntheticRecord(1));
+    EXPECT_THROW(reader.next(record), std::runtime_error);
+}
+
+TEST(InstructionTrace, SimulatorTracesEveryInstructionWithMemoryAccesses) {
+    TempTrace file("sim");
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+
+    // R1 += 1; [R0 + 0x100] = R1; R2 = [R0 + 0x100]; JMP -4
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_ADD, 1, 0, true, 1));
+    writeWord(bus, 4, encode(OPC_STORE, 0, 1, false, 0x100));
+    writeWord(bus, 8, encode(OPC_LOAD, 2, 0, false, 0x100));
+    writeWord(bus, 12, encode(OPC_JMP, 0, 0, true, -4));
+    sim.cpu()->setPc(0);
+
+    constexpr std::uint64_t kCycles = 40;
+    sim.startTrace(file.str());
+    EXPECT_TRUE(sim.isTracing());
+    sim.start(kCycles);
+    EXPECT_EQ(sim.stopTrace(), kCycles);
+    EXPECT_FALSE(sim.isTracing());
+
+    TraceReader reader(file.str());
+    TraceRecord record;
+    std::uint64_t cycle = 0;
+    while (reader.next(record)) {
+        const std::uint32_t slot = static_cast<std::uint32_t>(cycle % 4);
+        const std::uint32_t counter = static_cast<std::uint32_t>(cycle / 4 + 1);
+        EXPECT_EQ(record.cycle, cycle);
+        EXPECT_EQ(record.pc, slot * 4);
+
+        if (slot == 1) {
+            EXPECT_EQ(record.memAccess, TraceMemAccess::Write);
+            EXPECT_EQ(record.memAddress, 0x100u);
+            EXPECT_EQ(record.memValue, counter);
+            EXPECT_NE(elsim::core::formatTraceRecord(record).find("STORE R1, [R0 + 256]"), std::string::npos);
+        } else if (slot == 2) {
+            EXPECT_EQ(record.memAccess, TraceMemAccess::Read);
+            EXPECT_EQ(record.memValue, counter);
+        } else {
+            EXPECT_EQ(record.memAccess, TraceMemAccess::None);
+        }
+        ++cycle;
+    }
+    EXPECT_EQ(cycle, kCycles);
+}
+
+TEST(InstructionTrace, TracingDisablesDelayLoopCollapse) {
+    TempTrace file("delay");
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+
+    // MOV R0, #3000; SUB R0, #1; JNZ -2; HALT — згортався б у кілька кроків, але кожна ітерація має бути в трасі.
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 3000));
+    writeWord(bus, 4, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_JNZ, 0, 0, true, -2));
+    writeWord(bus, 12, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+
+    sim.startTrace(file.str());
+    sim.start();
+    const std::uint64_t records = sim.stopTrace();
+
+    // Кожна інструкція окремим записом, включно з HALT.
+    EXPECT_EQ(records, 1u + 2u * 3000u + 1u);
+
+    TraceReader reader(file.str());
+    TraceRecord record;
+    TraceRecord last;
+    while (reader.next(record)) {
+        last = record;
+    }
+    EXPECT_EQ(last.pc, 12u);
+    EXPECT_NE(elsim::core::formatTraceRecord(last).find("HALT"), std::string::npos);
+}
+
+TEST(InstructionTrace, DbtCpuRefusesTracing) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+    TempTrace file("dbt");
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu-dbt", kBoardOptions));
+
+    EXPECT_THROW(sim.startTrace(file.str()), std::runtime_error);
+    EXPECT_FALSE(sim.isTracing());
+}
+
+TEST(InstructionTrace, FormatsJumpTargetsAndUnknownOpcodes) {
+    TraceRecord jump;
+    jump.pc = 0x10;
+    jump.instruction = encode(OPC_JNZ, 0, 0, true, -2);
+    EXPECT_NE(elsim::core::formatTraceRecord(jump).find("JNZ -2 (-> 0x0000000c)"), std::string::npos);
+
+    TraceRecord unknown;
+    unknown.instruction = 0x42000000u;
+    EXPECT_NE(elsim::core::formatTraceRecord(unknown).find(".word 0x42000000"), std::string::npos);
+
+    EXPECT_EQ(elsim::core::traceOpcodeFromName("store"), std::optional<std::uint8_t>{OPC_STORE});
+    EXPECT_FALSE(elsim::core::traceOpcodeFromName("FOO").has_value());
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "elsim/core/Logger.hpp"
+
+using elsim::core::Logger;
+using elsim::core::LogLevel;
+
+namespace {
+
+// Рівень логера і std::clog на час тесту; обидва відновлюються в деструкторі.
+struct LoggerScope {
+    LogLevel saved{Logger::instance().level()};
+    std::ostringstream output;
+    std::streambuf* savedBuf{std::clog.rdbuf(output.rdbuf())};
+
+    explicit LoggerScope(LogLevel level) { Logger::instance().set_level(level); }
+    ~LoggerScope() {
+        std::clog.rdbuf(savedBuf);
+        Logger::instance().set_level(saved);
+    }
+};
+
+// Аргумент повідомлення з побічним ефектом: показує, чи макрос обчислив повідомлення.
+int countEvaluation(int& evaluations) { return ++evaluations; }
+
+}  // namespace
+
+TEST(LoggerMacros, DisabledLevelDoesNotEvaluateMessage) {
+    LoggerScope scope(LogLevel::Warn);
+    int evaluations = 0;
+
+    ELSIM_LOG_DEBUG("TEST", "debug " << countEvaluation(evaluations));
+    ELSIM_LOG_INFO("TEST", "info " << countEvaluation(evaluations));
+
+    EXPECT_EQ(evaluations, 0);
+    EXPECT_TRUE(scope.output.str().empty());
+    EXPECT_FALSE(ELSIM_LOG_ENABLED(LogLevel::Info));
+}
+
+TEST(LoggerMacros, EnabledLevelFormatsMessageOnce) {
+    LoggerScope scope(LogLevel::Info);
+    int evaluations = 0;
+
+    ELSIM_LOG_WARN("TEST", "value=0x" << std::hex << 255 << " n=" << std::dec << countEvaluation(evaluations));
+
+    EXPECT_EQ(evaluations, 1);
+    EXPECT_NE(scope.output.str().find("[TEST] value=0xff n=1"), std::string::npos) << scope.output.str();
+}
+
+TEST(LoggerMacros, DebugFollowsBuildConfiguration) {
+    LoggerScope scope(LogLevel::Debug);
+    int evaluations = 0;
+
+    ELSIM_LOG_DEBUG("TEST", "debug " << countEvaluation(evaluations));
+
+    // Без ELSIM_LOG_STRIP_DEBUG Debug виводиться на рівні Debug; зі стрипом — не обчислюється взагалі
+    // (див. test_logger_strip_debug.cpp).
+    EXPECT_EQ(ELSIM_LOG_ENABLED(LogLevel::Debug), !ELSIM_LOG_STRIP_DEBUG);
+    EXPECT_EQ(evaluations, ELSIM_LOG_STRIP_DEBUG ? 0 : 1);
+}
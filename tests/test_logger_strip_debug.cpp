@@ -0,0 +1,35 @@
+// Той самий Logger, але макроси ELSIM_LOG_* зібрані так, як у release-збірці з ELSIM_STRIP_DEBUG_LOGS.
+#undef ELSIM_LOG_STRIP_DEBUG
+#define ELSIM_LOG_STRIP_DEBUG 1
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+
+#include "elsim/core/Logger.hpp"
+
+using elsim::core::Logger;
+using elsim::core::LogLevel;
+
+TEST(LoggerStripDebug, DebugIsDisabledEvenAtDebugLevel) {
+    const LogLevel saved = Logger::instance().level();
+    std::ostringstream output;
+    std::streambuf* savedBuf = std::clog.rdbuf(output.rdbuf());
+    Logger::instance().set_level(LogLevel::Debug);
+
+    int evaluations = 0;
+    ELSIM_LOG_DEBUG("TEST", "debug " << ++evaluations);
+    const bool debugEnabled = ELSIM_LOG_ENABLED(LogLevel::Debug);
+    const bool infoEnabled = ELSIM_LOG_ENABLED(LogLevel::Info);
+    ELSIM_LOG_INFO("TEST", "info " << ++evaluations);
+
+    std::clog.rdbuf(savedBuf);
+    Logger::instance().set_level(saved);
+
+    EXPECT_FALSE(debugEnabled);
+    EXPECT_TRUE(infoEnabled);  // вирізається лише Debug
+    EXPECT_EQ(evaluations, 1);
+    EXPECT_EQ(output.str().find("debug"), std::string::npos) << output.str();
+    EXPECT_NE(output.str().find("info 1"), std::string::npos) << output.str();
+}
@@ -2,7 +2,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
+#include "elsim/core/HostMemory.hpp"
 #include "elsim/core/IMemoryMappedDevice.hpp"
 #include "elsim/core/MemoryBus.hpp"
 
@@ -49,6 +52,41 @@ class FakeMmioDevice final : public elsim::core::IMemoryMappedDevice {
     int unknown_write_attempts_ = 0;
 };
 
+// Device with native 32-bit registers: records each transaction with its width.
+class WideMmioDevice final : public elsim::core::IMemoryMappedDevice {
+   public:
+    std::uint8_t read8(std::uint32_t offset) override {
+        log.push_back({8, offset});
+        return static_cast<std::uint8_t>(reg_ >> (8u * (offset & 3u)));
+    }
+
+    void write8(std::uint32_t offset, std::uint8_t value) override {
+        log.push_back({8, offset});
+        const std::uint32_t shift = 8u * (offset & 3u);
+        reg_ = (reg_ & ~(0xFFu << shift)) | (static_cast<std::uint32_t>(value) << shift);
+    }
+
+    std::uint32_t read32(std::uint32_t offset) override {
+        log.push_back({32, offset});
+        return reg_;
+    }
+
+    void write32(std::uint32_t offset, std::uint32_t value) override {
+        log.push_back({32, offset});
+        reg_ = value;
+    }
+
+    struct Access {
+        int width;
+        std::uint32_t offset;
+        bool operator==(const Access&) const = default;
+    };
+    std::vector<Access> log;
+
+   private:
+    std::uint32_t reg_ = 0;
+};
+
 }  // namespace
 
 TEST(MmioContract, WriteToReadOnlyRegister_IsIgnoredAndDoesNotCrash) {
@@ -90,3 +128,494 @@ TEST(MmioContract, ReadFromUnknownOffset_ReturnsDeterministicDefaultAndDoesNotCr
     bus.write8(kBase + 0x10, 0x22);
     ASSERT_EQ(dev->unknownWriteAttempts(), 1);
 }
+
+TEST(MemoryBusHostWindow, WindowStopsAtMappedDevices) {
+    elsim::core::MemoryBus bus(/*ram_size=*/0x1000);
+
+    // Device shadows RAM in the middle: [0x600, 0x610)
+    bus.mapDevice(0x600, 0x10, std::make_shared<FakeMmioDevice>());
+
+    const auto low = bus.hostWindow(0x100);
+    ASSERT_EQ(low.base, 0x000u);
+    ASSERT_EQ(low.bytes.size(), 0x600u);
+
+    const auto high = bus.hostWindow(0x800);
+    ASSERT_EQ(high.base, 0x610u);
+    ASSERT_EQ(high.bytes.size(), 0x1000u - 0x610u);
+
+    // Direct writes through the window are visible via the bus.
+    high.bytes[0x800 - 0x610] = 0x5A;
+    ASSERT_EQ(bus.read8(0x800), 0x5A);
+
+    // Inside the device and past the end of RAM there is no direct access.
+    ASSERT_TRUE(bus.hostWindow(0x604).bytes.empty());
+    ASSERT_TRUE(bus.hostWindow(0x1000).bytes.empty());
+}
+
+TEST(MemoryBusWideAccess, RamAccessIsLittleEndian) {
+    elsim::core::MemoryBus bus(/*ram_size=*/256);
+
+    bus.write32(0x10, 0x11223344u);
+    EXPECT_EQ(bus.read8(0x10), 0x44);
+    EXPECT_EQ(bus.read8(0x13), 0x11);
+    EXPECT_EQ(bus.read16(0x11), 0x2233u);
+    EXPECT_EQ(bus.read32(0x10), 0x11223344u);
+
+    // Unaligned access is allowed.
+    bus.write16(0x21, 0xBEEF);
+    EXPECT_EQ(bus.read8(0x21), 0xEF);
+    EXPECT_EQ(bus.read8(0x22), 0xBE);
+}
+
+TEST(MemoryBusWideAccess, DeviceWithWideRegistersGetsSingleTransaction) {
+    elsim::core::MemoryBus bus(/*ram_size=*/256);
+    auto dev = std::make_shared<WideMmioDevice>();
+    bus.mapDevice(0x1000, 0x10, dev);
+
+    bus.write32(0x1000, 0xCAFEBABEu);
+    EXPECT_EQ(bus.read32(0x1000), 0xCAFEBABEu);
+
+    using Access = WideMmioDevice::Access;
+    EXPECT_EQ(dev->log, (std::vector<Access>{{32, 0}, {32, 0}}));
+}
+
+TEST(MemoryBusWideAccess, ByteOnlyDeviceFallsBackToByteSplit) {
+    elsim::core::MemoryBus bus(/*ram_size=*/256);
+    auto dev = std::make_shared<WideMmioDevice>();
+    bus.mapDevice(0x1000, 0x10, dev);
+
+    // read16/write16 are not overridden by the device -> default byte split, low byte first.
+    bus.write16(0x1002, 0x1234);
+    EXPECT_EQ(bus.read16(0x1002), 0x1234u);
+
+    using Access = WideMmioDevice::Access;
+    EXPECT_EQ(dev->log, (std::vector<Access>{{8, 2}, {8, 3}, {8, 2}, {8, 3}}));
+}
+
+TEST(MemoryBusWideAccess, AccessCrossingBoundariesIsSplitIntoBytes) {
+    elsim::core::MemoryBus bus(/*ram_size=*/0x1002);
+    auto dev = std::make_shared<WideMmioDevice>();
+    bus.mapDevice(0x80, 0x4, dev);
+
+    // RAM [0x7E..0x80) + device [0x80..0x82): bytes go to their own targets.
+    bus.write32(0x7E, 0x44332211u);
+    EXPECT_EQ(bus.read8(0x7E), 0x11);
+    EXPECT_EQ(bus.read8(0x7F), 0x22);
+    EXPECT_EQ(bus.read32(0x7E), 0x44332211u);
+
+    using Access = WideMmioDevice::Access;
+    EXPECT_EQ(dev->log, (std::vector<Access>{{8, 0}, {8, 1}, {8, 0}, {8, 1}}));
+
+    // Past the end of RAM: the first bytes are written, then out_of_range, exactly as with write8.
+    EXPECT_THROW(bus.write32(0x1000, 0xAABBCCDDu), std::out_of_range);
+    EXPECT_EQ(bus.read16(0x1000), 0xCCDDu);
+    EXPECT_THROW(bus.read32(0x1000), std::out_of_range);
+}
+
+TEST(MemoryBusPageTable, SmallDevicesSharingAPageAreDecodedExactly) {
+    elsim::core::MemoryBus bus(/*ram_size=*/0x4000);
+
+    // Three devices inside one 4 KiB page, RAM around and between them.
+    auto a = std::make_shared<WideMmioDevice>();
+    auto b = std::make_shared<WideMmioDevice>();
+    auto c = std::make_shared<WideMmioDevice>();
+    bus.mapDevice(0x1000, 0x4, a);
+    bus.mapDevice(0x1010, 0x4, b);
+    bus.mapDevice(0x1FFC, 0x8, c);  // also spills into the next page
+
+    bus.write32(0x1000, 0xA);
+    bus.write32(0x1010, 0xB);
+    bus.write32(0x1FFC, 0xC);
+    bus.write8(0x1008, 0x77);  // RAM between devices
+
+    EXPECT_EQ(bus.read32(0x1000), 0xAu);
+    EXPECT_EQ(bus.read32(0x1010), 0xBu);
+    EXPECT_EQ(bus.read32(0x1FFC), 0xCu);
+    EXPECT_EQ(bus.read8(0x2000), 0x0C);  // byte 0 of device c's register, seen through the second page
+    EXPECT_EQ(bus.read8(0x1008), 0x77);
+    EXPECT_EQ(bus.read8(0x2004), 0x00);  // RAM right after device c
+}
+
+TEST(MemoryBusPageTable, OverlapIsDetectedAcrossPages) {
+    elsim::core::MemoryBus bus(/*ram_size=*/256);
+
+    bus.mapDevice(0x10000, 0x3000, std::make_shared<FakeMmioDevice>());  // pages 0x10..0x12
+    bus.mapDevice(0x20000, 0x10, std::make_shared<FakeMmioDevice>());
+
+    EXPECT_THROW(bus.mapDevice(0x12FF0, 0x20, std::make_shared<FakeMmioDevice>()), std::runtime_error);
+    EXPECT_THROW(bus.mapDevice(0x0F000, 0x2000, std::make_shared<FakeMmioDevice>()), std::runtime_error);
+    EXPECT_THROW(bus.mapDevice(0x2000C, 0x4, std::make_shared<FakeMmioDevice>()), std::runtime_error);
+
+    // Adjacent regions (even in the same page) are fine.
+    EXPECT_NO_THROW(bus.mapDevice(0x13000, 0x10, std::make_shared<FakeMmioDevice>()));
+    EXPECT_NO_THROW(bus.mapDevice(0x20010, 0x10, std::make_shared<FakeMmioDevice>()));
+
+    // Addresses outside every device still go to RAM / out_of_range.
+    EXPECT_THROW(bus.read8(0x13010), std::out_of_range);
+    EXPECT_EQ(bus.read8(0x11234), 0xFF);  // unknown offset inside the big device
+}
+
+TEST(MemoryBusBaseline, RestoresOnlyDirtiedPages) {
+    constexpr std::uint32_t kPage = elsim::core::MemoryBus::kPageSize;
+    elsim::core::MemoryBus bus(/*ram_size=*/8 * kPage + 100);  // остання сторінка неповна
+
+    bus.write8(0x10, 0xAA);
+    bus.markBaseline();
+    EXPECT_EQ(bus.dirtyPageCount(), 0u);
+
+    bus.write8(0x10, 0xBB);
+    bus.write32(3 * kPage - 2, 0x11223344u);  // перетинає межу сторінок 2 і 3
+    bus.write8(8 * kPage + 99, 0x77);
+    bus.write8(5 * kPage, 0x00);  // запис того самого значення: сторінка відмічена, але не змінена
+    EXPECT_EQ(bus.dirtyPageCount(), 5u);
+
+    EXPECT_EQ(bus.restoreBaseline(), 4u);
+    EXPECT_EQ(bus.dirtyPageCount(), 0u);
+    EXPECT_EQ(bus.read8(0x10), 0xAA);
+    EXPECT_EQ(bus.read32(3 * kPage - 2), 0u);
+    EXPECT_EQ(bus.read8(8 * kPage + 99), 0u);
+}
+
+TEST(MemoryBusBaseline, WritableHostWindowCarriesPageEpochs) {
+    using elsim::core::HostAccess;
+    constexpr std::uint32_t kPage = elsim::core::MemoryBus::kPageSize;
+    elsim::core::MemoryBus bus(/*ram_size=*/4 * kPage);
+    bus.markBaseline();
+
+    // Read-only вікно обліку не несе: писати через нього не можна.
+    EXPECT_EQ(bus.hostWindow(0, HostAccess::ReadOnly).pageEpochs, nullptr);
+
+    // Хто пише через ReadWrite-вікно, відмічає сторінку сам — і відновлення її знаходить.
+    const auto window = bus.hostWindow(0);
+    ASSERT_NE(window.pageEpochs, nullptr);
+    EXPECT_EQ(window.pageOffset, 0u);
+    window.bytes[2 * kPage + 7] = 0x5A;
+    window.pageEpochs[(window.pageOffset + 2 * kPage + 7) >> elsim::core::HostMemoryWindow::kEpochPageBits] =
+        *window.epoch;
+    EXPECT_EQ(bus.dirtyPageCount(), 1u);
+    EXPECT_EQ(bus.restoreBaseline(), 1u);
+    EXPECT_EQ(bus.read8(2 * kPage + 7), 0u);
+}
+
+TEST(MemoryBusBaseline, SnapshotsOnlyWritablePages) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+    MemoryBus bus;
+    bus.mapRegion("flash", 0, 4 * kPage, MemoryBus::kRead | MemoryBus::kExecute);
+    bus.mapRegion("sram", 0x10000, 2 * kPage, MemoryBus::kRead | MemoryBus::kWrite);
+    bus.protect(0x10000 + kPage, kPage, MemoryBus::kRead);
+    bus.write8(0x10000, 0x11);
+    bus.markBaseline();
+
+    // ram() обходить права: змінюємо flash, захищену й записувану сторінки sram.
+    const auto memory = bus.ram();
+    const MemoryBus::Region& flash = bus.regions()[0];
+    const MemoryBus::Region& sram = bus.regions()[1];
+    memory[flash.offset + kPage] = 0xAA;
+    memory[sram.offset] = 0x22;
+    memory[sram.offset + kPage] = 0x33;
+
+    // Відновлюється лише записувана сторінка; решти в знімку немає.
+    EXPECT_EQ(bus.restoreBaseline(), 1u);
+    EXPECT_EQ(bus.read8(0x10000), 0x11);
+    EXPECT_EQ(bus.read8(kPage), 0xAA);
+    EXPECT_EQ(bus.read8(0x10000 + kPage), 0x33);
+}
+
+TEST(MemoryBusBaseline, PageMadeWritableAfterBaselineIsRestored) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+    MemoryBus bus;
+    bus.mapRegion("flash", 0, 2 * kPage, MemoryBus::kRead | MemoryBus::kExecute);
+    const std::uint8_t image[] = {0x01, 0x02};
+    bus.loadBytes(kPage, image);
+    bus.markBaseline();
+
+    bus.protect(kPage, kPage, MemoryBus::kRead | MemoryBus::kWrite);
+    bus.write8(kPage, 0xAA);
+    bus.write8(kPage + 0x100, 0xBB);
+
+    EXPECT_EQ(bus.restoreBaseline(), 1u);
+    EXPECT_EQ(bus.read8(kPage), 0x01);
+    EXPECT_EQ(bus.read8(kPage + 1), 0x02);
+    EXPECT_EQ(bus.read8(kPage + 0x100), 0x00);
+    EXPECT_EQ(bus.read8(0), 0x00);
+}
+
+TEST(MemoryBusBaseline, RestoreWithoutBaselineThrows) {
+    elsim::core::MemoryBus bus(/*ram_size=*/256);
+    EXPECT_FALSE(bus.hasBaseline());
+    EXPECT_THROW(bus.restoreBaseline(), std::logic_error);
+}
+
+TEST(MemoryBusDirtyEpoch, ReportsPagesWrittenSinceEpoch) {
+    constexpr std::uint32_t kPage = elsim::core::MemoryBus::kPageSize;
+    elsim::core::MemoryBus bus(/*ram_size=*/4 * kPage);
+
+    const auto first = bus.openDirtyEpoch();
+    bus.write8(kPage + 1, 0x01);
+    const auto second = bus.openDirtyEpoch();
+    bus.write32(3 * kPage - 2, 0xDEADBEEFu);  // сторінки 2 і 3
+
+    EXPECT_EQ(bus.dirtyPagesSince(first), (std::vector<std::uint32_t>{1, 2, 3}));
+    EXPECT_EQ(bus.dirtyPagesSince(second), (std::vector<std::uint32_t>{2, 3}));
+    EXPECT_TRUE(bus.dirtyPagesSince(bus.openDirtyEpoch()).empty());
+
+    // loadPage копіює сторінку й теж відмічає її.
+    const auto epoch = bus.openDirtyEpoch();
+    const std::vector<std::uint8_t> page(kPage, 0x3C);
+    bus.loadPage(0, page);
+    EXPECT_EQ(bus.read8(kPage - 1), 0x3C);
+    EXPECT_EQ(bus.dirtyPagesSince(epoch), (std::vector<std::uint32_t>{0}));
+    EXPECT_THROW(bus.loadPage(4, page), std::out_of_range);
+    EXPECT_THROW(bus.loadPage(0, std::span<const std::uint8_t>(page).first(10)), std::out_of_range);
+}
+
+TEST(MemoryBusWriteWatch, ReportsEveryWriteIntoRangeAndKeepsItOffHostWindows) {
+    constexpr std::uint32_t kPage = elsim::core::MemoryBus::kPageSize;
+    elsim::core::MemoryBus bus(/*ram_size=*/4 * kPage);
+
+    int hits = 0;
+    bus.setWriteWatch(kPage + 0x10, 4, [&] { ++hits; });
+
+    bus.write32(kPage + 0x10, 0);  // те саме значення — теж запис
+    bus.write8(kPage + 0x13, 0x01);
+    bus.write16(kPage + 0x0F, 0x0202);  // зачіпає перший байт діапазону
+    const std::vector<std::uint8_t> block(8, 0x33);
+    bus.writeBlock(kPage + 0x0C, block);
+    EXPECT_EQ(hits, 4);
+
+    bus.write32(kPage + 0x14, 1);
+    bus.write8(kPage + 0x0F, 1);
+    EXPECT_EQ(hits, 4);
+
+    // Сторінка під спостереженням у ReadWrite-вікна не потрапляє, сусідні — так.
+    EXPECT_TRUE(bus.hostWindow(kPage + 0x10).bytes.empty());
+    const auto low = bus.hostWindow(0);
+    EXPECT_EQ(low.base, 0u);
+    EXPECT_EQ(low.bytes.size(), kPage);
+    EXPECT_EQ(bus.hostWindow(kPage, elsim::core::HostAccess::ReadOnly).bytes.size(), 4 * kPage);
+
+    bus.clearWriteWatch();
+    bus.write32(kPage + 0x10, 5);
+    EXPECT_EQ(hits, 4);
+    EXPECT_EQ(bus.hostWindow(0).bytes.size(), 4 * kPage);
+}
+
+TEST(MemoryBusRegions, MapsRegionsAtArbitraryBases) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+
+    MemoryBus bus;
+    bus.mapRegion("flash", 0x0800'0000, 2 * kPage, MemoryBus::kRead | MemoryBus::kExecute);
+    bus.mapRegion("sram", 0x2000'0000, kPage + 0x10, MemoryBus::kRead | MemoryBus::kWrite);
+
+    ASSERT_EQ(bus.regions().size(), 2u);
+    EXPECT_EQ(bus.findRegion(0x2000'0004)->name, "sram");
+    EXPECT_EQ(bus.findRegion(0x0800'1FFF)->name, "flash");
+    EXPECT_EQ(bus.findRegion(0x0800'2000), nullptr);
+
+    bus.write32(0x2000'0000, 0x11223344u);
+    EXPECT_EQ(bus.read32(0x2000'0000), 0x11223344u);
+    EXPECT_EQ(bus.regionBytes(bus.regions()[1])[0], 0x44u);
+
+    // Остання сторінка регіону неповна: хвіст за межами — не пам'ять.
+    bus.write8(0x2000'0000 + kPage + 0x0F, 0x7E);
+    EXPECT_EQ(bus.read8(0x2000'0000 + kPage + 0x0F), 0x7E);
+    EXPECT_THROW(bus.read8(0x2000'0000 + kPage + 0x10), std::out_of_range);
+    EXPECT_THROW(bus.write32(0x2000'0000 + kPage + 0x0E, 0), std::out_of_range);
+    EXPECT_THROW(bus.read8(0x1000'0000), std::out_of_range);
+
+    // Незмеплені адреси між регіонами і невалідні регіони.
+    EXPECT_THROW(bus.mapRegion("overlap", 0x2000'0000, kPage, MemoryBus::kRead), std::invalid_argument);
+    EXPECT_THROW(bus.mapRegion("unaligned", 0x3000'0010, kPage, MemoryBus::kRead), std::invalid_argument);
+    EXPECT_THROW(bus.mapRegion("empty", 0x3000'0000, 0, MemoryBus::kRead), std::invalid_argument);
+    EXPECT_THROW(bus.mapRegion("wrap", 0xFFFF'F000, 2 * kPage, MemoryBus::kRead), std::invalid_argument);
+}
+
+TEST(MemoryBusRegions, EnforcesPagePermissions) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+
+    MemoryBus bus;
+    bus.mapRegion("rom", 0, kPage, MemoryBus::kRead | MemoryBus::kExecute);
+    bus.mapRegion("ram", 0x1'0000, 2 * kPage, MemoryBus::kRead | MemoryBus::kWrite);
+
+    // ROM пишеться лише з боку хоста.
+    const std::vector<std::uint8_t> code{0x78, 0x56, 0x34, 0x12};
+    bus.loadBytes(0, code);
+    EXPECT_EQ(bus.read32(0), 0x12345678u);
+    EXPECT_EQ(bus.fetch32(0), 0x12345678u);
+    EXPECT_THROW(bus.write8(0, 0), std::runtime_error);
+    EXPECT_THROW(bus.write32(4, 0), std::runtime_error);
+    EXPECT_EQ(bus.read32(0), 0x12345678u);
+
+    // Дані без права виконання.
+    bus.write32(0x1'0000, 0xCAFEF00Du);
+    EXPECT_THROW(bus.fetch32(0x1'0000), std::runtime_error);
+    EXPECT_TRUE(bus.hostWindow(0x1'0000, elsim::core::HostAccess::Execute).bytes.empty());
+
+    // protect() змінює права окремих сторінок; вікна не виходять за сторінки з потрібними правами.
+    bus.protect(0x1'0000 + kPage, kPage, MemoryBus::kRead);
+    EXPECT_EQ(MemoryBus::formatPermissions(bus.permissionsAt(0x1'0000 + kPage)), "r--");
+    EXPECT_THROW(bus.write8(0x1'0000 + kPage, 1), std::runtime_error);
+    EXPECT_THROW(bus.write32(0x1'0000 + kPage - 2, 1), std::runtime_error);
+    EXPECT_EQ(bus.hostWindow(0x1'0000).bytes.size(), kPage);
+    EXPECT_EQ(bus.hostWindow(0x1'0000, elsim::core::HostAccess::ReadOnly).bytes.size(), 2 * kPage);
+    EXPECT_THROW(bus.protect(0x2'0000, kPage, MemoryBus::kRead), std::invalid_argument);
+    EXPECT_THROW(bus.protect(0x1'0010, kPage, MemoryBus::kRead), std::invalid_argument);
+
+    // Без права читання сторінка все одно виконувана.
+    bus.protect(0, kPage, MemoryBus::kExecute);
+    EXPECT_THROW(bus.read32(0), std::runtime_error);
+    EXPECT_EQ(bus.fetch32(0), 0x12345678u);
+}
+
+TEST(MemoryBusRegions, DevicesOverrideRegionsAndLoadBytesRoutesToThem) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+
+    MemoryBus bus;
+    bus.mapRegion("rom", 0x4000, kPage, MemoryBus::kRead | MemoryBus::kExecute);
+    auto dev = std::make_shared<FakeMmioDevice>();
+    bus.mapDevice(0x4800, 8, dev);
+
+    // Вікно ROM обрізане девайсом; девайс у сторінці ROM працює, як і в RAM.
+    const auto window = bus.hostWindow(0x4000, elsim::core::HostAccess::Execute);
+    EXPECT_EQ(window.base, 0x4000u);
+    EXPECT_EQ(window.bytes.size(), 0x800u);
+    EXPECT_EQ(bus.read8(0x4800), 0xAB);
+    bus.write8(0x4804, 0x5C);
+    EXPECT_EQ(bus.read8(0x4804), 0x5C);
+
+    const std::vector<std::uint8_t> bytes(0x10, 0x99);
+    bus.loadBytes(0x47FC, bytes);
+    EXPECT_EQ(bus.read8(0x47FF), 0x99);
+    EXPECT_EQ(bus.read8(0x4804), 0x99);  // байт у RW-регістр девайса
+    EXPECT_EQ(dev->roWriteAttempts(), 1);
+    EXPECT_EQ(bus.read8(0x4808), 0x99);
+
+    EXPECT_THROW(bus.loadBytes(0x4000 + kPage - 2, bytes), std::out_of_range);
+}
+
+TEST(MemoryBusRegions, ParsesPermissionStrings) {
+    using elsim::core::MemoryBus;
+
+    EXPECT_EQ(MemoryBus::parsePermissions("rwx"), MemoryBus::kReadWriteExecute);
+    EXPECT_EQ(MemoryBus::parsePermissions("r-x"), MemoryBus::kRead | MemoryBus::kExecute);
+    EXPECT_EQ(MemoryBus::parsePermissions("rw"), MemoryBus::kRead | MemoryBus::kWrite);
+    EXPECT_EQ(MemoryBus::parsePermissions("---"), 0);
+    EXPECT_THROW(MemoryBus::parsePermissions(""), std::invalid_argument);
+    EXPECT_THROW(MemoryBus::parsePermissions("rwq"), std::invalid_argument);
+    EXPECT_THROW(MemoryBus::parsePermissions("rr"), std::invalid_argument);
+    EXPECT_EQ(MemoryBus::formatPermissions(MemoryBus::kRead | MemoryBus::kExecute), "r-x");
+}
+
+TEST(MemoryBusSparse, LargeRegionCostsOnlyTouchedPages) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint64_t kDeclared = 512ULL << 20;
+    MemoryBus bus;
+    bus.mapRegion("ram", 0x0, kDeclared, MemoryBus::kReadWriteExecute);
+    bus.mapRegion("sram", 0x4000'0000, 64 * 1024, MemoryBus::kRead | MemoryBus::kWrite);
+    EXPECT_EQ(bus.declaredBytes(), kDeclared + 64 * 1024);
+
+    bus.write32(0x100, 0xDEADBEEFu);
+    bus.write32(static_cast<std::uint32_t>(kDeclared - 4), 0x12345678u);
+    bus.write8(0x4000'0010, 0x5A);
+    EXPECT_EQ(bus.read32(0x100), 0xDEADBEEFu);
+    EXPECT_EQ(bus.read32(0x200'0000), 0u);  // читання нетронутої сторінки нічого не виділяє
+
+    if (elsim::core::HostMemory(1).isSparse()) {
+        EXPECT_LT(bus.residentBytes(), 4u << 20);
+    }
+
+    bus.markBaseline();  // копія для baseline теж розріджена
+    bus.write8(0x100, 0x01);
+    EXPECT_EQ(bus.restoreBaseline(), 1u);
+    EXPECT_EQ(bus.read32(0x100), 0xDEADBEEFu);
+
+    bus.resetMemory();
+    EXPECT_EQ(bus.read32(0x100), 0u);
+    EXPECT_EQ(bus.read32(static_cast<std::uint32_t>(kDeclared - 4)), 0u);
+    EXPECT_EQ(bus.read8(0x4000'0010), 0u);
+    if (elsim::core::HostMemory(1).isSparse()) {
+        EXPECT_LT(bus.residentBytes(), 4u << 20);
+    }
+}
+
+TEST(HostMemory, ResizeZeroAndAssignKeepContentsConsistent) {
+    elsim::core::HostMemory memory(64 * 1024);
+    EXPECT_THROW(memory.resize(64 * 1024 + 1), std::length_error);
+
+    memory.resize(20'000);
+    const std::uint8_t* data = memory.data();
+    memory.data()[0] = 1;
+    memory.data()[10'000] = 2;
+    memory.data()[19'999] = 3;
+
+    memory.zero(1, 19'998);  // цілі сторінки повертаються ОС, краї — memset
+    EXPECT_EQ(memory.data()[0], 1);
+    EXPECT_EQ(memory.data()[10'000], 0);
+    EXPECT_EQ(memory.data()[19'999], 3);
+
+    memory.resize(100);
+    memory.resize(20'000);
+    EXPECT_EQ(memory.data()[19'999], 0);  // хвіст обнулено при зменшенні
+    if (memory.isSparse()) {
+        EXPECT_EQ(memory.data(), data);  // резервація не переїжджає
+    }
+
+    std::vector<std::uint8_t> image(12'000, 0);
+    image[9'000] = 7;
+    memory.assign(image);
+    EXPECT_EQ(memory.size(), image.size());
+    EXPECT_EQ(memory.data()[0], 0);
+    EXPECT_EQ(memory.data()[9'000], 7);
+    EXPECT_THROW(memory.zero(11'000, 2'000), std::out_of_range);
+}
+
+TEST(MemoryBusBlock, CopiesAcrossPagesAndRegions) {
+    using elsim::core::MemoryBus;
+    constexpr std::uint32_t kPage = MemoryBus::kPageSize;
+    MemoryBus bus;
+    bus.mapRegion("low", 0x0, 2 * kPage, MemoryBus::kReadWriteExecute);
+    bus.mapRegion("high", 2 * kPage, 3 * kPage, MemoryBus::kRead | MemoryBus::kWrite);
+
+    std::vector<std::uint8_t> block(3 * kPage);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+        block[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    const auto epoch = bus.openDirtyEpoch();
+    bus.writeBlock(kPage + 100, block);  // сторінки 1..4, через межу регіонів
+    EXPECT_EQ(bus.dirtyPagesSince(epoch).size(), 4u);
+    EXPECT_EQ(bus.read8(kPage + 100 + 5), block[5]);
+
+    std::vector<std::uint8_t> back(block.size());
+    bus.readBlock(kPage + 100, back);
+    EXPECT_EQ(back, block);
+
+    // Межі й права — як у write8/read8.
+    EXPECT_THROW(bus.writeBlock(5 * kPage - 4, std::vector<std::uint8_t>(8)), std::out_of_range);
+    bus.protect(2 * kPage, kPage, MemoryBus::kRead);
+    EXPECT_THROW(bus.writeBlock(2 * kPage - 2, std::vector<std::uint8_t>(4)), std::runtime_error);
+    EXPECT_NO_THROW(bus.loadBytes(2 * kPage - 2, std::vector<std::uint8_t>(4)));
+    bus.protect(3 * kPage, kPage, 0);
+    EXPECT_THROW(bus.readBlock(3 * kPage - 2, back), std::runtime_error);
+}
+
+TEST(MemoryBusBlock, DevicesGetAlignedWordTransactions) {
+    using Access = WideMmioDevice::Access;
+    elsim::core::MemoryBus bus(/*ram_size=*/0x2000);
+    auto dev = std::make_shared<WideMmioDevice>();
+    bus.mapDevice(0x1000, 0x10, dev);
+
+    const std::vector<std::uint8_t> bytes{0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA};
+    bus.writeBlock(0x0FFE, bytes);  // 2 байти RAM, слово +0, слово +4, байт +8
+    EXPECT_EQ(dev->log, (std::vector<Access>{{32, 0x0}, {32, 0x4}, {8, 0x8}}));
+    EXPECT_EQ(bus.read8(0x0FFF), 0xA1);
+
+    dev->log.clear();
+    std::vector<std::uint8_t> out(6);
+    bus.readBlock(0x1002, out);  // байти +2, +3, слово +4
+    EXPECT_EQ(dev->log, (std::vector<Access>{{8, 0x2}, {8, 0x3}, {32, 0x4}}));
+}
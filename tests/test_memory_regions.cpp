@@ -0,0 +1,336 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "elsim/core/BoardConfigParser.hpp"
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/core/TimeTravel.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::BoardConfigErrorCode;
+using elsim::core::BoardConfigException;
+using elsim::core::BoardConfigParser;
+using elsim::core::BoardDescription;
+using elsim::core::MemoryBus;
+using elsim::core::MemoryRegion;
+using elsim::core::MemoryType;
+using elsim::core::Simulator;
+using elsim::core::TimeTravel;
+using namespace elsim::test;
+
+namespace {
+
+constexpr std::uint32_t kFlashBase = 0x1000;
+constexpr std::uint32_t kSramBase = 0x7000;
+
+std::string srcPath(const std::string& rel) {
+    const std::filesystem::path p = std::filesystem::path(ELSIM_SOURCE_DIR) / rel;
+    return p.string();
+}
+
+// Прошивка у flash: R1 = &sram; R0 = 100; loop: [R1] += R0; R0 -= 1; JNZ loop; HALT.
+// Після HALT у sram[0] — 5050.
+std::vector<std::uint8_t> firmware(std::uint32_t storeTarget = kSramBase) {
+    const std::vector<std::uint32_t> words{
+        encode(OPC_MOV, 1, 0, true, static_cast<std::int16_t>(storeTarget)),
+        encode(OPC_MOV, 0, 0, true, 100),
+        encode(OPC_LOAD, 2, 1, true, 0),
+        encode(OPC_ADD, 2, 0, false, 0),
+        encode(OPC_STORE, 1, 2, true, 0),
+        encode(OPC_SUB, 0, 0, true, 1),
+        encode(OPC_JNZ, 0, 0, true, -4),
+        encode(OPC_HALT, 0, 0, false, 0),
+    };
+    std::vector<std::uint8_t> bytes;
+    for (const std::uint32_t word : words) {
+        for (std::uint32_t i = 0; i < 4; ++i) {
+            bytes.push_back(static_cast<std::uint8_t>(word >> (8 * i)));
+        }
+    }
+    return bytes;
+}
+
+// Плата без RAM від нуля: код у flash (r-x), дані в sram (rw-).
+BoardDescription flashBoard(const std::string& cpuType) {
+    BoardDescription board = makeBoard("regions-test", cpuType, {.ramSize = 0});
+    board.memory.push_back(MemoryRegion{"flash", kFlashBase, 0x2000, MemoryType::Rom});
+    board.memory.push_back(MemoryRegion{"sram", kSramBase, 0x1000, MemoryType::Ram, "rw"});
+    return board;
+}
+
+std::vector<std::string> cpuTypes() {
+    std::vector<std::string> types{"test-cpu"};
+    if (elsim::core::DbtCpu::hostSupported()) {
+        types.push_back("test-cpu-dbt");
+    }
+    return types;
+}
+
+}  // namespace
+
+TEST(MemoryRegions, FirmwareRunsFromFlashWithDataInSram) {
+    for (const auto& cpuType : cpuTypes()) {
+        std::ostringstream log;
+        Simulator sim(log);
+        sim.loadBoard(flashBoard(cpuType));
+        sim.memoryBus()->loadBytes(kFlashBase, firmware());
+        sim.cpu()->setPc(kFlashBase);
+
+        sim.start(10'000);
+        EXPECT_TRUE(sim.cpu()->isHalted()) << cpuType;
+        EXPECT_EQ(sim.memoryBus()->read32(kSramBase), 5050u) << cpuType;
+        EXPECT_NE(log.str().find("flash @ 0x1000 size 8192 bytes r-x"), std::string::npos) << cpuType;
+    }
+}
+
+TEST(MemoryRegions, StoreIntoFlashAndExecuteFromSramFault) {
+    for (const auto& cpuType : cpuTypes()) {
+        std::ostringstream log;
+        Simulator sim(log);
+        sim.loadBoard(flashBoard(cpuType));
+        sim.memoryBus()->loadBytes(kFlashBase, firmware(kFlashBase + 0x1000));
+        sim.cpu()->setPc(kFlashBase);
+        EXPECT_THROW(sim.start(10'000), std::runtime_error) << cpuType;
+        EXPECT_EQ(sim.memoryBus()->read32(kFlashBase + 0x1000), 0u) << cpuType;
+
+        std::ostringstream log2;
+        Simulator data(log2);
+        data.loadBoard(flashBoard(cpuType));
+        data.memoryBus()->loadBytes(kSramBase, firmware());
+        data.cpu()->setPc(kSramBase);
+        EXPECT_THROW(data.start(10), std::runtime_error) << cpuType;
+    }
+}
+
+TEST(MemoryRegions, ProfileCoversRegionWithPc) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(flashBoard("test-cpu"));
+    sim.memoryBus()->loadBytes(kFlashBase, firmware());
+    sim.cpu()->setPc(kFlashBase);
+
+    sim.startProfile();
+    sim.start(10'000);
+    const auto profile = sim.stopProfile();
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->baseAddress(), kFlashBase);
+}
+
+TEST(MemoryRegions, RunBackToWriteUsesGuestAddressesOfRegion) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(flashBoard("test-cpu"));
+    sim.memoryBus()->loadBytes(kFlashBase, firmware());
+    sim.cpu()->setPc(kFlashBase);
+
+    TimeTravel tt(sim, /*interval=*/64, /*capacity=*/16);
+    tt.run(200);
+    const std::uint32_t latest = sim.memoryBus()->read32(kSramBase);
+
+    const auto cycle = tt.runBackToWrite(kSramBase);
+    ASSERT_TRUE(cycle.has_value());
+    EXPECT_EQ(sim.cpu()->getPc(), kFlashBase + 16);  // наступна інструкція — STORE
+    sim.runFor(1);
+    EXPECT_EQ(sim.memoryBus()->read32(kSramBase), latest);
+
+    EXPECT_THROW(tt.runBackToWrite(kSramBase + 0x1000 - 2), std::out_of_range);
+}
+
+TEST(MemoryRegions, BoardYamlDescribesRegionPermissions) {
+    const BoardDescription board =
+        BoardConfigParser::loadFromFile(srcPath("examples/board-examples/flash-sram-board.yaml"));
+    ASSERT_EQ(board.memory.size(), 2u);
+    EXPECT_EQ(board.memory[0].type, MemoryType::Rom);
+    EXPECT_EQ(board.memory[0].permissions, "r-x");
+    EXPECT_EQ(board.memory[1].permissions, "rw-");
+
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(board);
+    EXPECT_EQ(sim.memoryBus()->permissionsAt(kFlashBase), MemoryBus::kRead | MemoryBus::kExecute);
+    EXPECT_EQ(sim.memoryBus()->permissionsAt(kSramBase), MemoryBus::kRead | MemoryBus::kWrite);
+
+    try {
+        (void)BoardConfigParser::loadFromFile(srcPath("examples/board-examples/invalid-memory-permissions.yaml"));
+        FAIL() << "Expected BoardConfigException";
+    } catch (const BoardConfigException& ex) {
+        EXPECT_EQ(ex.code(), BoardConfigErrorCode::InvalidValue);
+    }
+}
+
+TEST(MemoryRegions, OverlappingRegionsAreRejected) {
+    BoardDescription board = flashBoard("test-cpu");
+    board.memory.push_back(MemoryRegion{"alias", kSramBase, 0x100, MemoryType::Ram});
+
+    std::ostringstream log;
+    Simulator sim(log);
+    EXPECT_THROW(sim.loadBoard(board), std::runtime_error);
+}
+
+TEST(MemoryRegions, FlashImageIsMappedFromFileAndWritesStayPrivate) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "elsim-flash-image-test";
+    fs::create_directories(dir);
+    const fs::path image = dir / "firmware.bin";
+    const std::vector<std::uint8_t> code = firmware();
+    {
+        std::ofstream out(image, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(code.data()), static_cast<std::streamsize>(code.size()));
+    }
+
+    MemoryBus bus;
+    bus.mapRegion("sram", kSramBase, 0x1000, MemoryBus::kRead | MemoryBus::kWrite);
+    bus.mapImage("flash", kFlashBase, 0x2000, image.string(), MemoryBus::kReadWriteExecute);
+    ASSERT_EQ(bus.regions().size(), 2u);
+    EXPECT_EQ(bus.regions().back().image, image.string());
+    EXPECT_EQ(bus.fetch32(kFlashBase), encode(OPC_MOV, 1, 0, true, static_cast<std::int16_t>(kSramBase)));
+    EXPECT_EQ(bus.read32(kFlashBase + static_cast<std::uint32_t>(code.size())), 0u);  // за кінцем файла — нулі
+
+    // Запис змінює лише копію сторінки в пам'яті, не файл.
+    bus.write32(kFlashBase, 0xA5A5A5A5u);
+    EXPECT_EQ(bus.read32(kFlashBase), 0xA5A5A5A5u);
+    std::ifstream in(image, std::ios::binary);
+    const std::vector<std::uint8_t> onDisk{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    EXPECT_EQ(onDisk, code);
+
+    // Файл, що не влазить у регіон, і відсутній файл — помилка без нового регіону.
+    EXPECT_THROW(bus.mapImage("tiny", 0x10000, 16, image.string(), MemoryBus::kRead), std::invalid_argument);
+    EXPECT_THROW(bus.mapImage("missing", 0x10000, 0x1000, (dir / "nope.bin").string(), MemoryBus::kRead),
+                 std::runtime_error);
+    EXPECT_EQ(bus.regions().size(), 2u);
+    bus.write8(kSramBase, 0x42);
+    EXPECT_EQ(bus.read8(kSramBase), 0x42);
+
+    fs::remove_all(dir);
+}
+
+TEST(MemoryRegions, CheckpointRestoreKeepsFlashImageFileBacked) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("elsim-flash-checkpoint-" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    const fs::path image = dir / "flash.bin";
+    std::vector<std::uint8_t> content(256 * 1024);
+    for (std::size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<std::uint8_t>(i * 7 | 1);  // жодної нульової сторінки
+    }
+    {
+        std::ofstream out(image, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    }
+
+    BoardDescription board = flashBoard("test-cpu");
+    board.memory[0] = MemoryRegion{"flash", 0x10'0000, content.size(), MemoryType::Rom, "", image.string()};
+    Simulator sim;
+    sim.loadBoard(board);
+    sim.memoryBus()->write32(kSramBase, 0x12345678u);
+    const fs::path checkpoint = dir / "state.elck";
+    sim.saveCheckpoint(checkpoint.string());
+    EXPECT_LT(fs::file_size(checkpoint), 64u * 1024);  // незмінений образ flash у checkpoint не пишеться
+
+    sim.memoryBus()->write32(kSramBase, 0u);
+    sim.loadCheckpoint(checkpoint.string());
+    EXPECT_EQ(sim.memoryBus()->read32(kSramBase), 0x12345678u);
+
+    const MemoryBus& bus = *sim.memoryBus();
+    const MemoryBus::Region* flash = bus.findRegion(0x10'0000);
+    ASSERT_NE(flash, nullptr);
+    const auto restored = bus.regionBytes(*flash);
+    EXPECT_TRUE(std::equal(restored.begin(), restored.end(), content.begin(), content.end()));
+#if defined(__linux__)
+    // Сторінки flash знову відображені з файла (кеш ОС), а не скопійовані в приватну пам'ять.
+    if (elsim::core::HostMemory(1).isSparse()) {
+        EXPECT_LT(bus.residentBytes(), content.size());
+    }
+#endif
+
+    fs::remove_all(dir);
+}
+
+TEST(MemoryRegions, CheckpointIsBoundToFlashImageContent) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("elsim-flash-rebuild-" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    const fs::path image = dir / "flash.bin";
+    const auto writeImage = [&](std::uint8_t fill) {
+        // Новий файл і rename — як при перезбиранні прошивки: старий inode лишається незмінним.
+        const fs::path next = dir / "flash.bin.new";
+        {
+            const std::vector<std::uint8_t> content(0x2000, fill);
+            std::ofstream out(next, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+        }
+        fs::rename(next, image);
+    };
+    writeImage(0x11);
+
+    BoardDescription board = flashBoard("test-cpu");
+    board.memory[0] = MemoryRegion{"flash", 0x10'0000, 0x2000, MemoryType::Rom, "", image.string()};
+    Simulator sim;
+    sim.loadBoard(board);
+    const fs::path checkpoint = dir / "state.elck";
+    sim.saveCheckpoint(checkpoint.string());
+
+    // Файл перезібрали: той самий процес відновлює flash з образу, з яким завантажувався.
+    writeImage(0x22);
+    sim.loadCheckpoint(checkpoint.string());
+    EXPECT_EQ(sim.memoryBus()->read8(0x10'0000), 0x11);
+    EXPECT_EQ(sim.memoryBus()->read8(0x10'1FFF), 0x11);
+
+    // Плата з новою прошивкою checkpoint старої не приймає.
+    Simulator rebuilt;
+    rebuilt.loadBoard(board);
+    EXPECT_THROW(rebuilt.loadCheckpoint(checkpoint.string()), std::runtime_error);
+    EXPECT_EQ(rebuilt.memoryBus()->read8(0x10'0000), 0x22);
+
+    fs::remove_all(dir);
+}
+
+TEST(MemoryRegions, BoardYamlMapsFlashImageRelativeToConfig) {
+    const BoardDescription board =
+        BoardConfigParser::loadFromFile(srcPath("examples/board-examples/flash-image-board.yaml"));
+    ASSERT_EQ(board.memory.size(), 3u);
+    EXPECT_EQ(std::filesystem::path(board.memory[0].file), std::filesystem::path(srcPath("examples/hello-rom.bin")));
+
+    for (const std::string cpuType : {"test-cpu", "test-cpu-dbt"}) {
+        if (cpuType == "test-cpu-dbt" && !elsim::core::DbtCpu::hostSupported()) {
+            continue;
+        }
+        BoardDescription copy = board;
+        copy.cpu.type = cpuType;
+        std::ostringstream log;
+        Simulator sim(log);
+        sim.loadBoard(copy);
+        sim.start();
+        EXPECT_TRUE(sim.cpu()->isHalted()) << cpuType;
+        EXPECT_NE(log.str().find("image '"), std::string::npos);
+    }
+
+    // file — лише для ROM.
+    const std::filesystem::path yaml = std::filesystem::temp_directory_path() / "elsim-ram-image.yaml";
+    {
+        std::ofstream out(yaml);
+        out << "board:\n  name: bad\n  cpu: {type: test-cpu, frequency_hz: 1000000}\n"
+               "  memory:\n    - {name: ram, type: ram, base: 0, size: 4096, file: fw.bin}\n  devices: []\n";
+    }
+    try {
+        (void)BoardConfigParser::loadFromFile(yaml.string());
+        FAIL() << "Expected BoardConfigException";
+    } catch (const BoardConfigException& ex) {
+        EXPECT_EQ(ex.code(), BoardConfigErrorCode::InvalidValue);
+        EXPECT_NE(std::string(ex.what()).find("memory[0].file"), std::string::npos);
+    }
+    std::filesystem::remove(yaml);
+}
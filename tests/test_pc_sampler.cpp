@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/PcSampler.hpp"
+#include "elsim/core/ProgramLoader.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/core/SymbolMap.hpp"
+
+#include "test_support.hpp"
+
+namespace fs = std::filesystem;
+
+using elsim::core::BoardDescription;
+using elsim::core::PcSampler;
+using elsim::core::ProgramLoader;
+using elsim::core::Simulator;
+using elsim::core::SymbolMap;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "sampler-test";
+constexpr BoardOptions kBoardOptions{.ramSize = 0x1000};
+
+// R1 += 1; NOP; NOP; JMP -4 — PC на циклі c дорівнює (c % 4) * 4.
+void loadLoop(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_ADD, 1, 0, true, 1));
+    writeWord(bus, 4, 0);
+    writeWord(bus, 8, 0);
+    writeWord(bus, 12, encode(OPC_JMP, 0, 0, true, -4));
+    sim.cpu()->setPc(0);
+}
+
+std::map<std::uint32_t, std::uint64_t> sampleLoop(const std::string& cpuType, std::uint64_t quantum) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+    sim.setQuantum(quantum);
+    loadLoop(sim);
+
+    sim.startSampling(10);
+    sim.start(1000);
+    return sim.stopSampling()->samples();
+}
+
+}  // namespace
+
+TEST(SymbolMap, NestedRangesFormAStack) {
+    std::istringstream text(
+        "# firmware symbols\n"
+        "0x0000 0x0100 main\n"
+        "\n"
+        "0x0040 0x0060 delay   # inner loop\n"
+        "256 512 isr\n");
+    const SymbolMap map = SymbolMap::parse(text);
+
+    ASSERT_EQ(map.symbols().size(), 3u);
+    EXPECT_EQ(map.stackAt(0x10), (std::vector<std::string_view>{"main"}));
+    EXPECT_EQ(map.stackAt(0x48), (std::vector<std::string_view>{"main", "delay"}));
+    EXPECT_EQ(map.stackAt(0x100), (std::vector<std::string_view>{"isr"}));
+    EXPECT_TRUE(map.stackAt(0x200).empty());
+}
+
+TEST(SymbolMap, RejectsMalformedLinesWithLineNumber) {
+    const auto parseError = [](const std::string& text) -> std::string {
+        std::istringstream in(text);
+        try {
+            SymbolMap::parse(in, "fw.sym");
+        } catch (const std::runtime_error& ex) {
+            return ex.what();
+        }
+        return {};
+    };
+
+    EXPECT_NE(parseError("0x0 0x10 main\n0x20 broken\n").find("fw.sym:2"), std::string::npos);
+    EXPECT_NE(parseError("0x10 0x10 empty\n").find("fw.sym:1"), std::string::npos);
+    EXPECT_NE(parseError("0x0 0x10 a\n0x8 0x18 b\n").find("partially overlaps"), std::string::npos);
+    EXPECT_NE(parseError("0x0 0x1ffffffff big\n").find("invalid address range"), std::string::npos);
+    EXPECT_NE(parseError("0x0 0x10 a b\n").find("expected"), std::string::npos);
+}
+
+TEST(PcSampler, WritesCollapsedStacks) {
+    PcSampler sampler(100);
+    sampler.record(0x48);
+    sampler.record(0x4C);
+    sampler.record(0x10);
+    sampler.record(0x300);
+
+    std::istringstream text("0x0 0x100 main\n0x40 0x60 delay\n");
+    const SymbolMap symbols = SymbolMap::parse(text);
+
+    std::ostringstream withSymbols;
+    sampler.writeCollapsedStacks(withSymbols, &symbols);
+    EXPECT_EQ(withSymbols.str(), "0x00000300 1\nmain 1\nmain;delay 2\n");
+
+    std::ostringstream bare;
+    sampler.writeCollapsedStacks(bare);
+    EXPECT_EQ(bare.str(), "0x00000010 1\n0x00000048 1\n0x0000004c 1\n0x00000300 1\n");
+
+    EXPECT_THROW(PcSampler(0), std::invalid_argument);
+}
+
+TEST(PcSampler, SimulatorSamplesEveryIntervalRegardlessOfQuantum) {
+    // Семпли на циклах 0, 10, ..., 990: c % 4 чергується між 0 і 2.
+    const std::map<std::uint32_t, std::uint64_t> expected{{0, 50}, {8, 50}};
+
+    EXPECT_EQ(sampleLoop("test-cpu", 1), expected);
+    EXPECT_EQ(sampleLoop("test-cpu", Simulator::kDefaultQuantum), expected);
+    if (elsim::core::DbtCpu::hostSupported()) {
+        EXPECT_EQ(sampleLoop("test-cpu-dbt", Simulator::kDefaultQuantum), expected);
+    }
+}
+
+TEST(PcSampler, SamplingStopsWithStopSampling) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadLoop(sim);
+
+    EXPECT_FALSE(sim.stopSampling().has_value());
+    sim.startSampling(7);
+    EXPECT_TRUE(sim.isSampling());
+    sim.runFor(70);
+    const auto samples = sim.stopSampling();
+    EXPECT_FALSE(sim.isSampling());
+    ASSERT_TRUE(samples.has_value());
+    EXPECT_EQ(samples->sampleCount(), 10u);  // цикли 0, 7, ..., 63
+
+    sim.runFor(70);  // без семплінгу нічого не змінюється і не падає
+    EXPECT_EQ(samples->sampleCount(), 10u);
+}
+
+TEST(ProgramLoader, LoadsOptionalSymbolSidecar) {
+    const fs::path dir = fs::temp_directory_path() / "elsim-sidecar-test";
+    fs::create_directories(dir);
+    const std::string binary = (dir / "firmware.elsim-bin").string();
+
+    EXPECT_EQ(ProgramLoader::symbolSidecarPath(binary), (dir / "firmware.sym").string());
+
+    ProgramLoader loader;
+    fs::remove(dir / "firmware.sym");
+    EXPECT_FALSE(loader.loadSidecarSymbols(binary).has_value());
+
+    {
+        std::ofstream sym(dir / "firmware.sym");
+        sym << "0x0 0x20 main\n";
+    }
+    const auto symbols = loader.loadSidecarSymbols(binary);
+    ASSERT_TRUE(symbols.has_value());
+    EXPECT_EQ(symbols->stackAt(0x4), (std::vector<std::string_view>{"main"}));
+
+    {
+        std::ofstream sym(dir / "firmware.sym");
+        sym << "not a symbol line\n";
+    }
+    EXPECT_THROW(loader.loadSidecarSymbols(binary), std::runtime_error);
+
+    fs::remove_all(dir);
+}
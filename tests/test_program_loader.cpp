@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "elsim/core/MemoryBus.hpp"
+#include "elsim/core/ProgramLoader.hpp"
+
+namespace fs = std::filesystem;
+
+using elsim::core::ELSIM_BINARY_MAGIC;
+using elsim::core::MemoryBus;
+using elsim::core::ProgramLoader;
+
+namespace {
+
+class ProgramLoaderTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        // Окрема тека на тест і процес: ctest -j запускає тести паралельно.
+        const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        dir_ = fs::temp_directory_path() / ("elsim-program-loader-" + name + "-" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    // Заголовок (magic, entry, size) + payload; size за замовчуванням — розмір payload.
+    std::string writeBinary(const std::vector<std::uint8_t>& payload, std::uint32_t entry,
+                            std::uint32_t magic = ELSIM_BINARY_MAGIC, std::int64_t codeSize = -1) {
+        const std::uint32_t size = codeSize < 0 ? static_cast<std::uint32_t>(payload.size())
+                                                : static_cast<std::uint32_t>(codeSize);
+        std::vector<std::uint8_t> bytes;
+        for (const std::uint32_t field : {magic, entry, size}) {
+            for (std::uint32_t i = 0; i < 4; ++i) {
+                bytes.push_back(static_cast<std::uint8_t>(field >> (8 * i)));
+            }
+        }
+        bytes.insert(bytes.end(), payload.begin(), payload.end());
+
+        const fs::path path = dir_ / "program.elsim-bin";
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return path.string();
+    }
+
+    std::string loadError(const std::string& path, MemoryBus& bus) {
+        std::uint32_t entry = 0;
+        try {
+            ProgramLoader{}.loadBinary(path, bus, entry);
+        } catch (const std::runtime_error& ex) {
+            return ex.what();
+        }
+        return {};
+    }
+
+    fs::path dir_;
+};
+
+}  // namespace
+
+TEST_F(ProgramLoaderTest, LoadsLargePayloadIntoFlash) {
+    MemoryBus bus;
+    bus.mapRegion("flash", 0x10000, 4u << 20, MemoryBus::kRead | MemoryBus::kExecute);
+
+    std::vector<std::uint8_t> payload((3u << 20) + 12);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<std::uint8_t>(i * 31 + 7);
+    }
+    const std::string path = writeBinary(payload, 0x10000);
+
+    std::uint32_t entry = 0;
+    ProgramLoader{}.loadBinary(path, bus, entry);
+    EXPECT_EQ(entry, 0x10000u);
+
+    std::vector<std::uint8_t> loaded(payload.size());
+    bus.readBlock(0x10000, loaded);
+    EXPECT_EQ(loaded, payload);
+}
+
+TEST_F(ProgramLoaderTest, ReportsMalformedFiles) {
+    MemoryBus bus(/*ram_size=*/0x1000);
+    const std::vector<std::uint8_t> code(16, 0xAA);
+
+    EXPECT_NE(loadError((dir_ / "missing.elsim-bin").string(), bus).find("failed to open"), std::string::npos);
+
+    {
+        std::ofstream out(dir_ / "short.elsim-bin", std::ios::binary);
+        out.write("ELSB\0\0", 6);
+    }
+    EXPECT_NE(loadError((dir_ / "short.elsim-bin").string(), bus).find("too short"), std::string::npos);
+
+    EXPECT_NE(loadError(writeBinary(code, 0, 0x12345678u), bus).find("invalid magic"), std::string::npos);
+    EXPECT_NE(loadError(writeBinary({}, 0), bus).find("code_size is zero"), std::string::npos);
+
+    const std::string truncated = loadError(writeBinary(code, 0, ELSIM_BINARY_MAGIC, 64), bus);
+    EXPECT_NE(truncated.find("truncated"), std::string::npos);
+    EXPECT_NE(truncated.find("expected 64 bytes, got 16"), std::string::npos);
+
+    // Нічого з обрізаного файла не записано.
+    EXPECT_EQ(bus.read8(0), 0u);
+
+    std::uint32_t entry = 0;
+    EXPECT_THROW(ProgramLoader{}.loadBinary(writeBinary(code, 0x0FF8), bus, entry), std::out_of_range);
+}
@@ -0,0 +1,324 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/FakeCpu.hpp"
+#include "elsim/core/Simulator.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::BoardDescription;
+using elsim::core::Simulator;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "quantum-test";
+constexpr BoardOptions kBoardOptions{.ramSize = 0x1000, .timer = true, .gpio = true};
+
+// R0 = 2500; loop: R0 -= 1; JNZ loop; HALT  =>  1 + 2 * 2500 інструкцій до HALT.
+constexpr std::uint64_t kProgramCycles = 1 + 2 * 2500;
+
+void loadCountdown(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 2500));
+    writeWord(bus, 4, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_JNZ, 0, 0, true, -2));
+    writeWord(bus, 12, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+}
+
+// Цикл, що читає COUNTER таймера і складає значення в RAM починаючи з kSamplesBase:
+//   R1 = timer; R3 = samples; R0 = kSamples
+//   loop: LOAD R2,[R1]; STORE R2,[R3]; R3 += 4; R0 -= 1; JNZ loop; HALT
+// i-те читання виконується на циклі 3 + 5 * i.
+constexpr std::uint32_t kSamplesBase = 0x100;
+constexpr std::uint32_t kSamples = 200;
+
+void loadTimerSampler(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 1, 0, true, static_cast<std::int16_t>(kTimerBase)));
+    writeWord(bus, 4, encode(OPC_MOV, 3, 0, true, static_cast<std::int16_t>(kSamplesBase)));
+    writeWord(bus, 8, encode(OPC_MOV, 0, 0, true, static_cast<std::int16_t>(kSamples)));
+    writeWord(bus, 12, encode(OPC_LOAD, 2, 1, true, 0));
+    writeWord(bus, 16, encode(OPC_STORE, 3, 2, true, 0));
+    writeWord(bus, 20, encode(OPC_ADD, 3, 0, true, 4));
+    writeWord(bus, 24, encode(OPC_SUB, 0, 0, true, 1));
+    writeWord(bus, 28, encode(OPC_JNZ, 0, 0, true, -5));
+    writeWord(bus, 32, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+}
+
+void expectExactTimerSamples(const Simulator& sim, const std::string& label) {
+    for (std::uint32_t i = 0; i < kSamples; ++i) {
+        ASSERT_EQ(readWord(*sim.memoryBus(), kSamplesBase + 4 * i), 3 + 5 * i) << label << ", sample " << i;
+    }
+}
+
+// Цикл опитування MMIO за адресою mmio (без записів):
+//   R1 = mmio; R4 = 7
+//   loop: LOAD R2,[R1]; ADD R3,R4; MOV R3,#0; SUB R2,#0; JZ/JNZ loop
+// Для GPIO DATA_IN (0 без входу) крутиться через JZ; для таймера (не 0) — через JNZ.
+void loadPollLoop(Simulator& sim, std::uint32_t mmio, std::uint8_t branch) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 1, 0, true, static_cast<std::int16_t>(mmio)));
+    writeWord(bus, 4, encode(OPC_MOV, 4, 0, true, 7));
+    writeWord(bus, 8, encode(OPC_LOAD, 2, 1, true, 0));
+    writeWord(bus, 12, encode(OPC_ADD, 3, 4, false, 0));
+    writeWord(bus, 16, encode(OPC_MOV, 3, 0, true, 0));
+    writeWord(bus, 20, encode(OPC_SUB, 2, 0, true, 0));
+    writeWord(bus, 24, encode(branch, 0, 0, true, -5));
+    writeWord(bus, 28, encode(OPC_HALT, 0, 0, false, 0));
+    sim.cpu()->setPc(0);
+}
+
+// Прогнати цикл опитування maxCycles у режимі mode; повертає стан CPU.
+elsim::core::FakeCpu::CpuState runPollLoop(Simulator& sim, std::uint32_t mmio, std::uint8_t branch,
+                                           std::uint64_t maxCycles, Simulator::RunMode mode) {
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadPollLoop(sim, mmio, branch);
+    sim.start(maxCycles, mode);
+    return dynamic_cast<const elsim::core::MemoryBusFakeCpu&>(*sim.cpu()).state();
+}
+
+// MOV R0, #1; JMP за межі RAM — третя інструкція падає на fetch.
+void loadFetchFault(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_MOV, 0, 0, true, 1));
+    writeWord(bus, 4, encode(OPC_JMP, 0, 0, true, 0x7FFF));
+    sim.cpu()->setPc(0);
+}
+
+// Прогнати loadFetchFault() з квантом quantum до помилки; повертає {stepCount, cycleCount}.
+std::pair<std::size_t, std::uint64_t> runUntilFault(const std::string& cpuType, std::uint64_t quantum) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+    sim.setQuantum(quantum);
+    loadFetchFault(sim);
+
+    EXPECT_ANY_THROW(sim.start()) << cpuType << ", quantum " << quantum;
+    EXPECT_EQ(sim.cpu()->getPc(), 0x20004u) << cpuType << ", quantum " << quantum;
+
+    std::size_t steps = 0;
+    if (const auto* fake = dynamic_cast<const elsim::core::MemoryBusFakeCpu*>(sim.cpu())) {
+        steps = fake->stepCount();
+    } else if (const auto* dbt = dynamic_cast<const elsim::core::DbtCpu*>(sim.cpu())) {
+        steps = dbt->stepCount();
+    }
+    return {steps, sim.cycleCount()};
+}
+
+}  // namespace
+
+TEST(SimulatorQuantum, DeferredFaultIsCountedOnceLikeSingleStep) {
+    std::vector<std::string> cpuTypes{"test-cpu"};
+    if (elsim::core::DbtCpu::hostSupported()) {
+        cpuTypes.emplace_back("test-cpu-dbt");
+    }
+    for (const std::string& cpuType : cpuTypes) {
+        const auto exact = runUntilFault(cpuType, 1);
+        const auto batched = runUntilFault(cpuType, 1000);
+        EXPECT_EQ(exact.first, 3u) << cpuType;  // дві виконані інструкції + та, що впала
+        EXPECT_EQ(batched.first, exact.first) << cpuType;
+        EXPECT_EQ(batched.second, exact.second) << cpuType;
+    }
+}
+
+TEST(SimulatorQuantum, QuantumDoesNotChangeCycleCountOrDeviceTime) {
+    for (std::uint64_t quantum : {1ull, 7ull, 1000ull, 1'000'000ull}) {
+        std::ostringstream log;
+        Simulator sim(log);
+        sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+        sim.setQuantum(quantum);
+        loadCountdown(sim);
+
+        sim.start();
+
+        EXPECT_TRUE(sim.cpu()->isHalted()) << "quantum " << quantum;
+        EXPECT_EQ(sim.cycleCount(), kProgramCycles) << "quantum " << quantum;
+        EXPECT_EQ(readWord(*sim.memoryBus(), kTimerBase), kProgramCycles) << "quantum " << quantum;
+    }
+}
+
+TEST(SimulatorQuantum, StartMatchesRunOneTick) {
+    std::ostringstream log;
+    Simulator exact(log);
+    exact.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCountdown(exact);
+    while (!exact.cpu()->isHalted()) {
+        exact.runOneTick();
+    }
+
+    Simulator batched(log);
+    batched.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCountdown(batched);
+    batched.start();
+
+    EXPECT_EQ(batched.cycleCount(), exact.cycleCount());
+    EXPECT_EQ(readWord(*batched.memoryBus(), kTimerBase), readWord(*exact.memoryBus(), kTimerBase));
+}
+
+TEST(SimulatorQuantum, MaxCyclesIsExactAcrossQuanta) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    sim.setQuantum(1000);
+    loadCountdown(sim);
+
+    sim.start(2500);
+
+    EXPECT_FALSE(sim.cpu()->isHalted());
+    EXPECT_EQ(sim.cycleCount(), 2500u);
+    EXPECT_EQ(readWord(*sim.memoryBus(), kTimerBase), 2500u);
+}
+
+TEST(SimulatorQuantum, ZeroQuantumIsRejected) {
+    std::ostringstream log;
+    Simulator sim(log);
+    EXPECT_THROW(sim.setQuantum(0), std::invalid_argument);
+    EXPECT_EQ(sim.quantum(), Simulator::kDefaultQuantum);
+}
+
+TEST(SimulatorQuantum, TimerReadsSeeExactCycleInsideBatch) {
+    std::vector<std::string> cpuTypes{"test-cpu"};
+    if (elsim::core::DbtCpu::hostSupported()) {
+        cpuTypes.push_back("test-cpu-dbt");
+    }
+
+    for (const auto& cpuType : cpuTypes) {
+        for (std::uint64_t quantum : {1ull, 7ull, 1000ull}) {
+            std::ostringstream log;
+            Simulator sim(log);
+            sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+            sim.setQuantum(quantum);
+            loadTimerSampler(sim);
+
+            sim.start();
+
+            ASSERT_TRUE(sim.cpu()->isHalted());
+            expectExactTimerSamples(sim, cpuType + " quantum " + std::to_string(quantum));
+        }
+
+        std::ostringstream log;
+        Simulator sim(log);
+        sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+        loadTimerSampler(sim);
+        while (!sim.cpu()->isHalted()) {
+            sim.runOneTick();
+        }
+        expectExactTimerSamples(sim, cpuType + " runOneTick");
+    }
+}
+
+TEST(SimulatorQuantum, TimerKeepsCountingAcrossRestartAndResetsOnControl) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCountdown(sim);
+
+    sim.start(100);
+    EXPECT_EQ(sim.clock().now(), 100u);
+
+    // start() обнуляє cycleCount(), але час пристроїв іде далі.
+    sim.start(50);
+    EXPECT_EQ(sim.cycleCount(), 50u);
+    EXPECT_EQ(sim.clock().now(), 150u);
+    EXPECT_EQ(readWord(*sim.memoryBus(), kTimerBase), 150u);
+
+    // CONTROL=1 — лічильник рахує від поточного циклу.
+    sim.memoryBus()->write8(kTimerBase + 4, 1);
+    sim.start(30);
+    EXPECT_EQ(readWord(*sim.memoryBus(), kTimerBase), 30u);
+}
+
+TEST(SimulatorQuantum, SkipIdleFastForwardsStableMmioPollLoop) {
+    constexpr std::uint64_t kMaxCycles = 1'000'003;
+
+    std::ostringstream log;
+    Simulator exact(log);
+    const auto exactState = runPollLoop(exact, kGpioBase + kGpioDataIn, OPC_JZ, kMaxCycles, Simulator::RunMode::Exact);
+
+    Simulator skipping(log);
+    const auto skippedState =
+        runPollLoop(skipping, kGpioBase + kGpioDataIn, OPC_JZ, kMaxCycles, Simulator::RunMode::SkipIdle);
+
+    EXPECT_EQ(exact.skippedCycles(), 0u);
+    EXPECT_EQ(skipping.cycleCount(), exact.cycleCount());
+    EXPECT_EQ(skippedState, exactState);
+    EXPECT_GT(skipping.skippedCycles(), kMaxCycles - 100);
+    EXPECT_LE(skipping.skippedCycles(), skipping.cycleCount());
+}
+
+TEST(SimulatorQuantum, SkipIdleFastForwardsTimerPollLoop) {
+    constexpr std::uint64_t kMaxCycles = 20'003;
+
+    std::ostringstream log;
+    Simulator exact(log);
+    const auto exactState = runPollLoop(exact, kTimerBase, OPC_JNZ, kMaxCycles, Simulator::RunMode::Exact);
+
+    Simulator skipping(log);
+    const auto skippedState = runPollLoop(skipping, kTimerBase, OPC_JNZ, kMaxCycles, Simulator::RunMode::SkipIdle);
+
+    // COUNTER росте на 1 за цикл, тож ітерації однакові з точністю до нього: цикл (вихід лише після
+    // переповнення лічильника) перемотується до кінця бюджету з тим самим кінцевим R2 і прапорцями.
+    EXPECT_EQ(skipping.cycleCount(), exact.cycleCount());
+    EXPECT_EQ(skippedState, exactState);
+    EXPECT_GT(skipping.skippedCycles(), kMaxCycles - 100);
+}
+
+TEST(SimulatorQuantum, SkipIdleJumpsToCycleWhenTimerReachesValue) {
+    // R1 = timer; loop: [NOP...] LOAD R2,[R1]; SUB R2,#target; JNZ loop; HALT
+    // Перше читання — на циклі 1 + nops, далі через кожні length циклів.
+    struct Case {
+        std::uint32_t nops;
+        std::int16_t target;
+        bool halts;  // чи потрапляє якесь читання рівно на target
+    };
+    constexpr std::uint64_t kMaxCycles = 50'000;
+
+    for (const Case& c : {Case{0, 4999, true}, Case{1, 4002, true}, Case{1, 4003, false}}) {
+        const auto load = [&c](Simulator& sim) {
+            sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+            auto& bus = *sim.memoryBus();
+            std::uint32_t pc = 0;
+            writeWord(bus, pc, encode(OPC_MOV, 1, 0, true, static_cast<std::int16_t>(kTimerBase)));
+            for (std::uint32_t i = 0; i < c.nops; ++i) {
+                writeWord(bus, pc += 4, 0);
+            }
+            writeWord(bus, pc += 4, encode(OPC_LOAD, 2, 1, true, 0));
+            writeWord(bus, pc += 4, encode(OPC_SUB, 2, 0, true, c.target));
+            writeWord(bus, pc += 4, encode(OPC_JNZ, 0, 0, true, static_cast<std::int16_t>(-3 - c.nops)));
+            writeWord(bus, pc += 4, encode(OPC_HALT, 0, 0, false, 0));
+            sim.cpu()->setPc(0);
+        };
+        const std::string label = "nops " + std::to_string(c.nops) + ", target " + std::to_string(c.target);
+
+        std::ostringstream log;
+        Simulator exact(log);
+        load(exact);
+        exact.start(kMaxCycles, Simulator::RunMode::Exact);
+
+        Simulator skipping(log);
+        load(skipping);
+        skipping.start(kMaxCycles, Simulator::RunMode::SkipIdle);
+
+        const auto& exactCpu = dynamic_cast<const elsim::core::MemoryBusFakeCpu&>(*exact.cpu());
+        const auto& skippingCpu = dynamic_cast<const elsim::core::MemoryBusFakeCpu&>(*skipping.cpu());
+        EXPECT_EQ(exactCpu.isHalted(), c.halts) << label;
+        EXPECT_EQ(skippingCpu.isHalted(), c.halts) << label;
+        EXPECT_EQ(skipping.cycleCount(), exact.cycleCount()) << label;
+        EXPECT_EQ(skippingCpu.state(), exactCpu.state()) << label;
+        EXPECT_EQ(skippingCpu.stepCount(), exactCpu.stepCount()) << label;
+        // Майже весь час до виходу (або до maxCycles) — одним стрибком, а не покроково.
+        EXPECT_GT(skipping.skippedCycles(), (c.halts ? static_cast<std::uint64_t>(c.target) : kMaxCycles) - 100)
+            << label;
+    }
+}
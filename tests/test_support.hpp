@@ -0,0 +1,99 @@
+#pragma once
+
+// Спільні помічники тестів симулятора: кодування інструкцій FakeCPU, послівний доступ до шини
+// і типова плата. Прошивки (фрагменти коду) лишаються у своїх тестах.
+
+#include <cstdint>
+#include <string>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/MemoryBus.hpp"
+
+namespace elsim::test {
+
+inline constexpr std::uint8_t OPC_MOV = 0x01;
+inline constexpr std::uint8_t OPC_ADD = 0x02;
+inline constexpr std::uint8_t OPC_SUB = 0x03;
+inline constexpr std::uint8_t OPC_LOAD = 0x04;
+inline constexpr std::uint8_t OPC_STORE = 0x05;
+inline constexpr std::uint8_t OPC_JMP = 0x06;
+inline constexpr std::uint8_t OPC_JZ = 0x07;
+inline constexpr std::uint8_t OPC_JNZ = 0x08;
+inline constexpr std::uint8_t OPC_HALT = 0xFF;
+
+// Адреси MMIO типової плати (makeBoard).
+inline constexpr std::uint32_t kTimerBase = 0x4000;
+inline constexpr std::uint32_t kUartBase = 0x5000;
+inline constexpr std::uint32_t kGpioBase = 0x6000;
+inline constexpr std::uint32_t kGpioDir = 0x00;
+inline constexpr std::uint32_t kGpioDataIn = 0x04;
+inline constexpr std::uint32_t kGpioDataOut = 0x08;
+inline constexpr std::uint32_t kLedPin = 1;
+inline constexpr std::uint32_t kButtonPin = 2;
+
+inline std::uint32_t encode(std::uint8_t opcode, std::uint8_t rd, std::uint8_t rs, bool isImm, std::int16_t imm) {
+    return (static_cast<std::uint32_t>(opcode) << 24) | ((rd & 0x7u) << 21) | ((rs & 0x7u) << 18) |
+           (isImm ? (1u << 17) : 0u) | static_cast<std::uint16_t>(imm);
+}
+
+// Слово little-endian побайтово (write8/read8), тож адреса може бути й невирівняною.
+inline void writeWord(core::MemoryBus& bus, std::uint32_t addr, std::uint32_t value) {
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        bus.write8(addr + i, static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline std::uint32_t readWord(const core::MemoryBus& bus, std::uint32_t addr) {
+    std::uint32_t value = 0;
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(bus.read8(addr + i)) << (8 * i);
+    }
+    return value;
+}
+
+// Склад типової плати: RAM від адреси 0 (ramSize == 0 — без неї) і вибрані пристрої.
+struct BoardOptions {
+    std::uint64_t ramSize{0x10000};
+    bool timer{false};   // timer0 @ kTimerBase
+    bool uart{false};    // uart0 @ kUartBase
+    bool gpio{false};    // gpio0 @ kGpioBase
+    bool led{false};     // led0 на піні kLedPin
+    bool button{false};  // btn0 на піні kButtonPin
+};
+
+inline core::BoardDescription makeBoard(const std::string& name, const std::string& cpuType = "test-cpu",
+                                        const BoardOptions& options = {}) {
+    using core::DeviceDescription;
+    using core::MemoryRegion;
+    using core::MemoryType;
+
+    core::BoardDescription board;
+    board.name = name;
+    board.cpu.type = cpuType;
+    board.cpu.frequencyHz = 1'000'000;
+    board.cpu.endianness = "little";
+    if (options.ramSize != 0) {
+        board.memory.push_back(MemoryRegion{"ram", 0x0, options.ramSize, MemoryType::Ram});
+    }
+    if (options.timer) {
+        board.memory.push_back(MemoryRegion{"timer", kTimerBase, 8, MemoryType::Mmio});
+        board.devices.push_back(DeviceDescription{"timer", "timer0", kTimerBase, {}});
+    }
+    if (options.uart) {
+        board.memory.push_back(MemoryRegion{"uart", kUartBase, 0x0C, MemoryType::Mmio});
+        board.devices.push_back(DeviceDescription{"uart", "uart0", kUartBase, {}});
+    }
+    if (options.gpio) {
+        board.memory.push_back(MemoryRegion{"gpio", kGpioBase, 0x18, MemoryType::Mmio});
+        board.devices.push_back(DeviceDescription{"gpio", "gpio0", kGpioBase, {}});
+    }
+    if (options.led) {
+        board.devices.push_back(DeviceDescription{"led", "led0", 0, {{"pin", std::to_string(kLedPin)}}});
+    }
+    if (options.button) {
+        board.devices.push_back(DeviceDescription{"button", "btn0", 0, {{"pin", std::to_string(kButtonPin)}}});
+    }
+    return board;
+}
+
+}  // namespace elsim::test
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "elsim/core/BoardDescription.hpp"
+#include "elsim/core/DbtCpu.hpp"
+#include "elsim/core/Simulator.hpp"
+#include "elsim/core/TimeTravel.hpp"
+#include "elsim/device/VirtualButtonDevice.hpp"
+
+#include "test_support.hpp"
+
+using elsim::core::BoardDescription;
+using elsim::core::Simulator;
+using elsim::core::TimeTravel;
+using namespace elsim::test;
+
+namespace {
+
+constexpr const char* kBoardName = "time-travel-test";
+constexpr BoardOptions kBoardOptions{.timer = true, .gpio = true, .button = true};
+
+// Цикл, що лічить у R1, пише лічильник у [0x100] і "повзе" по RAM, залишаючи слід у нових сторінках:
+//   R1 += 1; [R0 + 0x100] = R1; R2 += 0x10; [R2 + 0x7000] = R1; JMP -5
+// Ітерація — 5 інструкцій; за 6000 циклів слід доходить до 0xBB00 — вище MMIO і в межах RAM.
+void loadCrawler(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_ADD, 1, 0, true, 1));
+    writeWord(bus, 4, encode(OPC_STORE, 0, 1, false, 0x100));
+    writeWord(bus, 8, encode(OPC_ADD, 2, 0, true, 0x10));
+    writeWord(bus, 12, encode(OPC_STORE, 2, 1, false, 0x7000));
+    writeWord(bus, 16, encode(OPC_JMP, 0, 0, true, -5));
+    sim.cpu()->setPc(0);
+}
+
+// Запис того самого значення — теж запис: [0x200] лишається нулем, але STORE виконується щоітерації.
+//   [R0 + 0x200] = R0; R1 += 1; JMP -3
+void loadSameValueStore(Simulator& sim) {
+    auto& bus = *sim.memoryBus();
+    writeWord(bus, 0, encode(OPC_STORE, 0, 0, false, 0x200));
+    writeWord(bus, 4, encode(OPC_ADD, 1, 0, true, 1));
+    writeWord(bus, 8, encode(OPC_JMP, 0, 0, true, -3));
+    sim.cpu()->setPc(0);
+}
+
+// Повний відбиток стану: стан машини (CPU, GPIO, пристрої, час) + вся RAM.
+struct Fingerprint {
+    std::vector<std::uint8_t> machine;
+    std::vector<std::uint8_t> ram;
+
+    bool operator==(const Fingerprint&) const = default;
+};
+
+Fingerprint fingerprint(const Simulator& sim) {
+    const auto ram = sim.memoryBus()->ram();
+    return Fingerprint{sim.saveMachineState(), std::vector<std::uint8_t>(ram.begin(), ram.end())};
+}
+
+// Еталон: відбиток після прямого прогону програми loadProgram на cycle циклів від старту.
+Fingerprint straightRun(const std::string& cpuType, std::uint64_t cycle,
+                        void (*loadProgram)(Simulator&) = loadCrawler) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+    loadProgram(sim);
+    sim.runFor(cycle);
+    return fingerprint(sim);
+}
+
+void expectReplayMatchesStraightRun(const std::string& cpuType) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+    loadCrawler(sim);
+
+    TimeTravel tt(sim, /*interval=*/500, /*capacity=*/32);
+    EXPECT_EQ(tt.run(6000), 6000u);
+    EXPECT_EQ(tt.now(), 6000u);
+
+    for (const std::uint64_t target : {1234u, 5999u, 3000u, 0u, 4500u, 6000u}) {
+        ASSERT_TRUE(tt.gotoCycle(target)) << target;
+        EXPECT_EQ(tt.now(), target);
+        EXPECT_TRUE(fingerprint(sim) == straightRun(cpuType, target)) << "cycle " << target;
+    }
+
+    ASSERT_TRUE(tt.gotoCycle(2001));
+    ASSERT_TRUE(tt.stepBack());
+    EXPECT_TRUE(fingerprint(sim) == straightRun(cpuType, 2000));
+}
+
+void expectRunBackFindsSameValueStore(const std::string& cpuType) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, cpuType, kBoardOptions));
+    loadSameValueStore(sim);
+
+    TimeTravel tt(sim, /*interval=*/256, /*capacity=*/16);
+    tt.run(1001);  // STORE виконується на циклах, кратних 3; останній — 999
+
+    const auto cycle = tt.runBackToWrite(0x200);
+    ASSERT_TRUE(cycle.has_value());
+    EXPECT_EQ(*cycle, 999u);
+    EXPECT_EQ(tt.now(), 999u);
+    EXPECT_EQ(sim.cpu()->getPc(), 0u);  // наступна інструкція — той самий STORE
+    EXPECT_TRUE(fingerprint(sim) == straightRun(cpuType, 999, loadSameValueStore));
+}
+
+}  // namespace
+
+TEST(TimeTravel, GotoCycleReproducesStraightRun) { expectReplayMatchesStraightRun("test-cpu"); }
+
+TEST(TimeTravel, GotoCycleReproducesStraightRunOnDbtCpu) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+    expectReplayMatchesStraightRun("test-cpu-dbt");
+}
+
+TEST(TimeTravel, RunBackToWriteStopsRightBeforeTheStore) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCrawler(sim);
+
+    TimeTravel tt(sim, /*interval=*/256, /*capacity=*/16);
+    tt.run(1003);  // посеред ітерації: останній STORE у [0x100] був кілька інструкцій тому
+    const std::uint32_t latest = readWord(*sim.memoryBus(), 0x100);
+
+    const auto cycle = tt.runBackToWrite(0x100);
+    ASSERT_TRUE(cycle.has_value());
+    EXPECT_EQ(*cycle, tt.now());
+    EXPECT_LT(*cycle, 1003u);
+    EXPECT_EQ(sim.cpu()->getPc(), 4u);  // наступна інструкція — той самий STORE
+    EXPECT_EQ(readWord(*sim.memoryBus(), 0x100), latest - 1);
+
+    sim.runFor(1);
+    EXPECT_EQ(readWord(*sim.memoryBus(), 0x100), latest);
+
+    // Адреса, яку програма ніколи не змінювала: стан лишається на місці.
+    const std::uint64_t before = tt.now();
+    EXPECT_FALSE(tt.runBackToWrite(0xF000).has_value());
+    EXPECT_EQ(tt.now(), before);
+}
+
+TEST(TimeTravel, RunBackToWriteFindsStoreOfUnchangedValue) { expectRunBackFindsSameValueStore("test-cpu"); }
+
+TEST(TimeTravel, RunBackToWriteFindsStoreOfUnchangedValueOnDbtCpu) {
+    if (!elsim::core::DbtCpu::hostSupported()) {
+        GTEST_SKIP() << "DbtCpu requires an x86-64 Linux host";
+    }
+    expectRunBackFindsSameValueStore("test-cpu-dbt");
+}
+
+TEST(TimeTravel, EvictionKeepsOldestCycleAndReplayExact) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCrawler(sim);
+
+    TimeTravel tt(sim, /*interval=*/100, /*capacity=*/4);
+    tt.run(1000);
+
+    // Знімки на 0, 100, ..., 1000 — лишаються чотири останні.
+    EXPECT_EQ(tt.snapshotCount(), 4u);
+    EXPECT_EQ(tt.oldestCycle(), 700u);
+
+    EXPECT_FALSE(tt.gotoCycle(650));
+    EXPECT_EQ(tt.now(), 1000u);
+
+    ASSERT_TRUE(tt.gotoCycle(750));
+    EXPECT_TRUE(fingerprint(sim) == straightRun("test-cpu", 750));
+}
+
+TEST(TimeTravel, ExternalInputBetweenRunsSurvivesGoingBack) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCrawler(sim);
+    auto& bus = *sim.memoryBus();
+
+    TimeTravel tt(sim, /*interval=*/128, /*capacity=*/32);
+    tt.run(300);
+    sim.buttonDevices().at(0)->press();
+    writeWord(bus, 0xF000, 0xCAFEBABE);
+    tt.run(300);
+    const Fingerprint head = fingerprint(sim);
+
+    ASSERT_TRUE(tt.gotoCycle(200));
+    EXPECT_FALSE(sim.buttonDevices().at(0)->isPressed());
+    EXPECT_EQ(readWord(bus, 0xF000), 0u);
+
+    ASSERT_TRUE(tt.gotoCycle(450));
+    EXPECT_TRUE(sim.buttonDevices().at(0)->isPressed());
+    EXPECT_EQ(readWord(bus, 0xF000), 0xCAFEBABEu);
+
+    ASSERT_TRUE(tt.gotoCycle(600));
+    EXPECT_TRUE(fingerprint(sim) == head);
+}
+
+TEST(TimeTravel, RunAfterGoingBackStartsNewBranch) {
+    std::ostringstream log;
+    Simulator sim(log);
+    sim.loadBoard(makeBoard(kBoardName, "test-cpu", kBoardOptions));
+    loadCrawler(sim);
+
+    TimeTravel tt(sim, /*interval=*/100, /*capacity=*/32);
+    tt.run(1000);
+    ASSERT_TRUE(tt.gotoCycle(400));
+
+    writeWord(*sim.memoryBus(), 0xF000, 0x12345678);
+    tt.run(100);
+    EXPECT_EQ(tt.now(), 500u);
+
+    // Старе майбутнє відкинуто: ціль попереду виконується заново в новій гілці.
+    ASSERT_TRUE(tt.gotoCycle(800));
+    EXPECT_EQ(readWord(*sim.memoryBus(), 0xF000), 0x12345678u);
+    ASSERT_TRUE(tt.gotoCycle(300));
+    EXPECT_EQ(readWord(*sim.memoryBus(), 0xF000), 0u);
+}